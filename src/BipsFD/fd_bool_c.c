@@ -1300,7 +1300,7 @@ Set_Eq(WamWord *exp, int result, WamWord *load_word)
   cur_op = (pl_full_ac) ? "truth#=#" : "truth#=";
 #endif
 
-  if (!Pl_Load_Left_Right(FALSE, le_word, re_word, &mask, &c, &l_word, &r_word)
+  if (!Pl_Load_Left_Right(LINEAR_NONE, le_word, re_word, &mask, &c, &l_word, &r_word)
       || !Pl_Term_Math_Loading(l_word, r_word))
     return FALSE;
 
@@ -1372,7 +1372,7 @@ Set_Neq(WamWord *exp, int result, WamWord *load_word)
   cur_op = (pl_full_ac) ? "truth#\\=#" : "truth#\\=";
 #endif
 
-  if (!Pl_Load_Left_Right(FALSE, le_word, re_word, &mask, &c, &l_word, &r_word)
+  if (!Pl_Load_Left_Right(LINEAR_NONE, le_word, re_word, &mask, &c, &l_word, &r_word)
       || !Pl_Term_Math_Loading(l_word, r_word))
     return FALSE;
 
@@ -1445,7 +1445,7 @@ Set_Lt(WamWord *exp, int result, WamWord *load_word)
   cur_op = (pl_full_ac) ? "truth#<#" : "truth#<";
 #endif
 
-  if (!Pl_Load_Left_Right(FALSE, le_word, re_word, &mask, &c, &l_word, &r_word)
+  if (!Pl_Load_Left_Right(LINEAR_NONE, le_word, re_word, &mask, &c, &l_word, &r_word)
       || !Pl_Term_Math_Loading(l_word, r_word))
     return FALSE;
 
@@ -1517,7 +1517,7 @@ Set_Lte(WamWord *exp, int result, WamWord *load_word)
   cur_op = (pl_full_ac) ? "truth#=<#" : "truth#=<";
 #endif
 
-  if (!Pl_Load_Left_Right(FALSE, le_word, re_word, &mask, &c, &l_word, &r_word)
+  if (!Pl_Load_Left_Right(LINEAR_NONE, le_word, re_word, &mask, &c, &l_word, &r_word)
       || !Pl_Term_Math_Loading(l_word, r_word))
     return FALSE;
 
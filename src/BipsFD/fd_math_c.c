@@ -59,6 +59,19 @@
  * Function Prototypes             *
  *---------------------------------*/
 
+static Bool Linear_Tell(WamWord *fdv_adr, int64_t a, int64_t lo, int64_t hi);
+
+static int64_t Div_Floor(int64_t a, int64_t b);
+
+static int64_t Div_Ceil(int64_t a, int64_t b);
+
+
+#define Monom_Min(a, fdv_adr)						\
+  ((a) > 0 ? (a) * (int64_t) Min(fdv_adr) : (a) * (int64_t) Max(fdv_adr))
+
+#define Monom_Max(a, fdv_adr)						\
+  ((a) > 0 ? (a) * (int64_t) Max(fdv_adr) : (a) * (int64_t) Min(fdv_adr))
+
 
 
 
@@ -91,7 +104,7 @@ Pl_Fd_Eq_2(WamWord le_word, WamWord re_word)
   cur_op = (pl_full_ac) ? "#=#" : "#=";
 #endif
 
-  if (!Pl_Load_Left_Right(TRUE, le_word, re_word, &mask, &c, &l_word, &r_word))
+  if (!Pl_Load_Left_Right(LINEAR_EQ, le_word, re_word, &mask, &c, &l_word, &r_word))
     return FALSE;
 
   switch (mask)
@@ -114,6 +127,9 @@ Pl_Fd_Eq_2(WamWord le_word, WamWord re_word)
 
       PRIM_CSTR_2(pl_x_eq_c, r_word, Tag_INT(c));
       goto term_load;
+
+    case MASK_LINEAR:
+      goto term_load;
     }
 
   if (c > 0)
@@ -151,7 +167,7 @@ Pl_Fd_Neq_2(WamWord le_word, WamWord re_word)
   cur_op = (pl_full_ac) ? "#\\=#" : "#\\=";
 #endif
 
-  if (!Pl_Load_Left_Right(FALSE, le_word, re_word, &mask, &c, &l_word, &r_word))
+  if (!Pl_Load_Left_Right(LINEAR_NEQ, le_word, re_word, &mask, &c, &l_word, &r_word))
     return FALSE;
 
   switch (mask)
@@ -180,6 +196,9 @@ Pl_Fd_Neq_2(WamWord le_word, WamWord re_word)
 
       PRIM_CSTR_2(pl_x_neq_c, r_word, Tag_INT(c));
       goto term_load;
+
+    case MASK_LINEAR:
+      goto term_load;
     }
 
   if (c > 0)
@@ -219,7 +238,7 @@ Pl_Fd_Lt_2(WamWord le_word, WamWord re_word)
   cur_op = (pl_full_ac) ? "#<#" : "#<";
 #endif
 
-  if (!Pl_Load_Left_Right(FALSE, le_word, re_word, &mask, &c, &l_word,
+  if (!Pl_Load_Left_Right(LINEAR_LT, le_word, re_word, &mask, &c, &l_word,
 		       &r_word))
     return FALSE;
 
@@ -246,6 +265,9 @@ Pl_Fd_Lt_2(WamWord le_word, WamWord re_word)
 
       PRIM_CSTR_2(pl_x_gte_c, r_word, Tag_INT(c + 1));
       goto term_load;
+
+    case MASK_LINEAR:
+      goto term_load;
     }
 
   if (c > 0)
@@ -285,7 +307,7 @@ Pl_Fd_Lte_2(WamWord le_word, WamWord re_word)
   cur_op = (pl_full_ac) ? "#=<#" : "#=<";
 #endif
 
-  if (!Pl_Load_Left_Right(FALSE, le_word, re_word, &mask, &c, &l_word,
+  if (!Pl_Load_Left_Right(LINEAR_LTE, le_word, re_word, &mask, &c, &l_word,
 		       &r_word))
     return FALSE;
 
@@ -312,6 +334,9 @@ Pl_Fd_Lte_2(WamWord le_word, WamWord re_word)
 
       PRIM_CSTR_2(pl_x_gte_c, r_word, Tag_INT(c));
       goto term_load;
+
+    case MASK_LINEAR:
+      goto term_load;
     }
 
   if (c > 0)
@@ -331,3 +356,244 @@ Pl_Fd_Lte_2(WamWord le_word, WamWord re_word)
 term_load:
   return Pl_Term_Math_Loading(l_word, r_word);
 }
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * The n-ary linear constraints below (see fd_math_fd.fd) are posted by    *
+ * math_supp.c for sums of many monomials instead of a chain of ternary    *
+ * constraints. a = [n+1, C, A1, ..., An] and x = [n, X1, ..., Xn] encode  *
+ * A1*X1 + ... + An*Xn op C. Only bounds are reasoned on. The sums are     *
+ * computed on 64 bits (math_supp.c checks they cannot overflow).          *
+ *-------------------------------------------------------------------------*/
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_LINEAR_EQ                                                         *
+ *                                                                         *
+ * With L (resp. U) the sum of the min (resp. max) of the Ai*Xi, each      *
+ * Ai*Xi is reduced to C-(U-max(Ai*Xi)) .. C-(L-min(Ai*Xi)), L and U being *
+ * updated after each reduction, until a fix-point is reached.             *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Linear_Eq(WamWord *a, WamWord **x)
+{
+  int n = (int) (PlLong) x[0];
+  int64_t c = (PlLong) a[1];
+  int64_t l, u, span, lo, hi, ai;
+  WamWord *fdv_adr;
+  Bool changed;
+  int i;
+
+  do
+    {
+      l = u = span = 0;
+      for (i = 0; i < n; i++)
+	{
+	  ai = (PlLong) a[i + 2];
+	  fdv_adr = x[i + 1];
+	  lo = Monom_Min(ai, fdv_adr);
+	  hi = Monom_Max(ai, fdv_adr);
+	  l += lo;
+	  u += hi;
+	  if (hi - lo > span)
+	    span = hi - lo;
+	}
+
+      if (l > c || u < c)
+	return FALSE;
+
+      if (span <= c - l && span <= u - c)	/* no reduction possible */
+	return TRUE;
+
+      changed = FALSE;
+      for (i = 0; i < n; i++)
+	{
+	  ai = (PlLong) a[i + 2];
+	  fdv_adr = x[i + 1];
+	  lo = Monom_Min(ai, fdv_adr);
+	  hi = Monom_Max(ai, fdv_adr);
+	  if (lo >= c - (u - hi) && hi <= c - (l - lo))
+	    continue;
+
+	  if (!Linear_Tell(fdv_adr, ai, c - (u - hi), c - (l - lo)))
+	    return FALSE;
+
+	  l += Monom_Min(ai, fdv_adr) - lo;
+	  u += Monom_Max(ai, fdv_adr) - hi;
+	  changed = TRUE;
+	}
+    }
+  while (changed);
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_LINEAR_LTE                                                        *
+ *                                                                         *
+ * Each Ai*Xi is bounded by C-(L-min(Ai*Xi)). This does not change L, so   *
+ * a single pass reaches the fix-point.                                    *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Linear_Lte(WamWord *a, WamWord **x)
+{
+  int n = (int) (PlLong) x[0];
+  int64_t c = (PlLong) a[1];
+  int64_t l, u, lo, hi, ai;
+  WamWord *fdv_adr;
+  int i;
+
+  l = u = 0;
+  for (i = 0; i < n; i++)
+    {
+      ai = (PlLong) a[i + 2];
+      fdv_adr = x[i + 1];
+      l += Monom_Min(ai, fdv_adr);
+      u += Monom_Max(ai, fdv_adr);
+    }
+
+  if (l > c)
+    return FALSE;
+
+  if (u <= c)			/* entailed */
+    return TRUE;
+
+  for (i = 0; i < n; i++)
+    {
+      ai = (PlLong) a[i + 2];
+      fdv_adr = x[i + 1];
+      lo = Monom_Min(ai, fdv_adr);
+      hi = Monom_Max(ai, fdv_adr);
+      if (hi > c - (l - lo) && !Linear_Tell(fdv_adr, ai, lo, c - (l - lo)))
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_LINEAR_NEQ                                                        *
+ *                                                                         *
+ * Only acts when at most one variable is not ground.                      *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Linear_Neq(WamWord *a, WamWord **x)
+{
+  int n = (int) (PlLong) x[0];
+  int64_t r = (PlLong) a[1];
+  int64_t ai, aj = 0, v;
+  WamWord *fdv_adr;
+  int i, j = -1;
+
+  for (i = 0; i < n; i++)
+    {
+      ai = (PlLong) a[i + 2];
+      fdv_adr = x[i + 1];
+      if (Fd_Variable_Is_Ground(fdv_adr))
+	{
+	  r -= ai * Min(fdv_adr);
+	  continue;
+	}
+
+      if (j >= 0)
+	return TRUE;
+
+      j = i;
+      aj = ai;
+    }
+
+  if (j < 0)
+    return r != 0;
+
+  if (r % aj != 0)
+    return TRUE;
+
+  fdv_adr = x[j + 1];
+  v = r / aj;
+  if (v < Min(fdv_adr) || v > Max(fdv_adr))
+    return TRUE;
+
+  return Pl_Fd_Tell_Not_Value(fdv_adr, (int) v);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LINEAR_TELL                                                             *
+ *                                                                         *
+ * Reduces X (given by fdv_adr) so that a*X is in lo..hi.                  *
+ *-------------------------------------------------------------------------*/
+static Bool
+Linear_Tell(WamWord *fdv_adr, int64_t a, int64_t lo, int64_t hi)
+{
+  int64_t min, max;
+
+  if (a > 0)
+    {
+      min = Div_Ceil(lo, a);
+      max = Div_Floor(hi, a);
+    }
+  else
+    {
+      min = Div_Ceil(hi, a);
+      max = Div_Floor(lo, a);
+    }
+
+  if (min < Min(fdv_adr))
+    min = Min(fdv_adr);
+
+  if (max > Max(fdv_adr))
+    max = Max(fdv_adr);
+
+  if (min > max)
+    return FALSE;
+
+  if (min == Min(fdv_adr) && max == Max(fdv_adr))
+    return TRUE;
+
+  return Pl_Fd_Tell_Interval(fdv_adr, (int) min, (int) max);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DIV_FLOOR                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int64_t
+Div_Floor(int64_t a, int64_t b)
+{
+  int64_t q = a / b;
+
+  if (a % b != 0 && (a < 0) != (b < 0))
+    q--;
+
+  return q;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DIV_CEIL                                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int64_t
+Div_Ceil(int64_t a, int64_t b)
+{
+  int64_t q = a / b;
+
+  if (a % b != 0 && (a < 0) == (b < 0))
+    q++;
+
+  return q;
+}
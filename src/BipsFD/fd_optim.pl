@@ -41,24 +41,40 @@
 '$use_fd_optim'.
 
 
+% The objective variable is restricted to [Min..Max] (with Min initially 0
+% and Max the fd_max_integer) and these bounds are enforced at each
+% propagation phase (see Pl_Fd_Push_Bound in fd_inst.c). Two search methods:
+%
+%   branch_and_bound: each solution tightens the bound and the search
+%      continues (backtracking) in the same search tree until exhausted.
+%
+%   dichotomic: a first solution is found, then the remaining interval
+%      is bisected: the better half is probed (restarting the search),
+%      if it contains a solution the bound is tightened else the other
+%      half is kept.
+%
+% A copy of each solution with the best value is recorded (a better one
+% discards them). With branch_and_bound the bound only excludes worse values
+% so that all the optimal solutions are met by the search. At the end the
+% objective is unified with the optimal value and the goal with each
+% recorded solution on backtracking (the goal is not executed again).
+
 :- meta_predicate(fd_minimize(0, ?)).
 
 fd_minimize(Goal, Var) :-
-	fd_max_integer(Inf),
-	g_assign('$cur_min', Inf),
-	repeat,
-	g_read('$cur_min', B),
-	B1 is B - 1,
 	set_bip_name(fd_minimize, 2),
-	(   '$fd_domain'(Var, 0, B1),
-	    '$call'(Goal, fd_minimize, 2, true) ->
-	    fd_min(Var, C),
-	    g_assign('$cur_min', C),
-	    fail
-	;   !,
-	    Var = B,
-	    '$call'(Goal, fd_minimize, 2, true)
-	).
+	'$fd_optimize'(branch_and_bound, 1, Goal, Var, fd_minimize, 2).
+
+
+
+
+:- meta_predicate(fd_minimize(0, ?, +)).
+
+fd_minimize(Goal, Var, Options) :-
+	set_bip_name(fd_minimize, 3),
+	'$check_list'(Options),
+	'$get_optimize_options'(Options, branch_and_bound, Search),
+	'$fd_optimize'(Search, 1, Goal, Var, fd_minimize, 3).
 
 
 
@@ -66,18 +82,110 @@ fd_minimize(Goal, Var) :-
 :- meta_predicate(fd_maximize(0, ?)).
 
 fd_maximize(Goal, Var) :-
-	fd_max_integer(Inf),
-	g_assign('$cur_max', 0),
-	repeat,
-	g_read('$cur_max', B),
-	B1 is B + 1,
 	set_bip_name(fd_maximize, 2),
-	(   '$fd_domain'(Var, B1, Inf),
-	    '$call'(Goal, fd_maximize, 2, true) ->
-	    fd_max(Var, C),
-	    g_assign('$cur_max', C),
+	'$fd_optimize'(branch_and_bound, 0, Goal, Var, fd_maximize, 2).
+
+
+
+
+:- meta_predicate(fd_maximize(0, ?, +)).
+
+fd_maximize(Goal, Var, Options) :-
+	set_bip_name(fd_maximize, 3),
+	'$check_list'(Options),
+	'$get_optimize_options'(Options, branch_and_bound, Search),
+	'$fd_optimize'(Search, 0, Goal, Var, fd_maximize, 3).
+
+
+
+
+'$get_optimize_options'([], Search, Search).
+
+'$get_optimize_options'([X|_], _, _) :-
+	var(X),
+	'$pl_err_instantiation'.
+
+'$get_optimize_options'([search(X)|Options], _, Search) :-
+	'$check_nonvar'(X),
+	(   X = branch_and_bound
+	;   X = dichotomic
+	), !,
+	'$get_optimize_options'(Options, X, Search).
+
+'$get_optimize_options'([X|_], _, _) :-
+	'$pl_err_domain'(fd_optimization_option, X).
+
+
+
+
+'$fd_optimize'(Search, Minimize, Goal, Var, Func, Arity) :-
+	fd_max_integer(Inf),
+	'$fd_domain'(Var, 0, Inf),
+	(   Search = branch_and_bound ->
+	    All = 1
+	;   All = 0
+	),
+	'$call_c_test'('Pl_Fd_Optim_Begin_4'(Var, Minimize, All, Ctx)),
+	catch('$fd_optimize1'(Search, Ctx, Goal, Func, Arity), Err,
+	      '$fd_optim_abort'(Ctx, Err)),
+	'$call_c_test'('Pl_Fd_Optim_End_3'(Ctx, Var, [Sol|Sols])),
+	'$fd_optim_member'(Sols, Goal, Sol).
+
+
+'$fd_optim_member'([], Goal, Goal).
+
+'$fd_optim_member'([_|_], Goal, Goal).
+
+'$fd_optim_member'([Sol|Sols], Goal, _) :-
+	'$fd_optim_member'(Sols, Goal, Sol).
+
+
+'$fd_optim_abort'(Ctx, Err) :-
+	'$call_c'('Pl_Fd_Optim_Abort_1'(Ctx)),
+	throw(Err).
+
+
+
+
+'$fd_optimize1'(branch_and_bound, Ctx, Goal, Func, Arity) :-
+	(   '$call'(Goal, Func, Arity, true),
+	    '$call_c_test'('Pl_Fd_Optim_Solution_2'(Ctx, Goal)),
+	    fail
+	;   true
+	).
+
+'$fd_optimize1'(dichotomic, Ctx, Goal, Func, Arity) :-
+	(   '$fd_optim_probe'(Ctx, Goal, Func, Arity) ->
+	    '$fd_optim_bisect'(Ctx, Goal, Func, Arity)
+	;   true
+	).
+
+
+
+
+'$fd_optim_bisect'(Ctx, Goal, Func, Arity) :-
+	'$call_c_test'('Pl_Fd_Optim_Bisect_1'(Ctx)), !,
+	(   '$fd_optim_probe'(Ctx, Goal, Func, Arity) ->
+	    true
+	;   '$call_c'('Pl_Fd_Optim_Bisect_Failed_1'(Ctx))
+	),
+	'$fd_optim_bisect'(Ctx, Goal, Func, Arity).
+
+'$fd_optim_bisect'(_, _, _, _).
+
+
+
+
+'$fd_optim_probe'(Ctx, Goal, Func, Arity) :-     % i.e. \+ \+ (undo bindings)
+	(   '$fd_optim_no_solution'(Ctx, Goal, Func, Arity) ->
+	    fail
+	;   true
+	).
+
+
+'$fd_optim_no_solution'(Ctx, Goal, Func, Arity) :-
+	(   '$call'(Goal, Func, Arity, true),
+	    '$call_c_test'('Pl_Fd_Optim_Solution_2'(Ctx, Goal)) ->
 	    fail
-	;   !,
-	    Var = B,
-	    '$call'(Goal, fd_maximize, 2, true)
+	;   true
 	).
@@ -0,0 +1,400 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : FD constraint solver buit-in predicates                         *
+ * File  : fd_optim_c.c                                                    *
+ * Descr.: optimization predicate management - C part                      *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+
+#define OBJ_INIT Fd_Optim_Initializer
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+#include "engine_fd.h"
+#include "bips_fd.h"
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct optimsol *OptimSolP;
+
+typedef struct optimsol		/* a recorded solution               */
+{
+  OptimSolP prev;		/* previous solution (same value)    */
+  int size;			/* size of the copied goal (words)   */
+  WamWord goal_word;		/* the copied goal (size words)      */
+}
+OptimSol;
+
+
+typedef struct			/* an optimization in progress       */
+{				/* (same index as its FD bound)      */
+  WamWord *fdv_adr;		/* the objective FD variable         */
+  Bool minimize;		/* minimize or maximize ?            */
+  Bool all;			/* record all the optimal solutions? */
+  int other_min;		/* other half of a bisection         */
+  int other_max;
+  int value;			/* value of the best solutions       */
+  OptimSol *last;		/* last best solution or NULL        */
+  int nb_sol;			/* number of recorded solutions      */
+}
+OptimInf;
+
+
+#define OPTIM_SOL_SIZE(size)	\
+  (sizeof(OptimSol) + ((size) - 1) * sizeof(WamWord))
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static OptimInf *optim_tbl;
+static int optim_size;
+static int nb_optim;
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static void Fd_Optim_Atom_GC_Roots(void);
+
+static OptimInf *Get_Optim(WamWord ctx_word);
+
+static void Free_Solutions(OptimInf *o);
+
+static void Pop_Optim(int i);
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FD_OPTIM_INITIALIZER                                                    *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Fd_Optim_Initializer(void)
+{
+  Pl_Atom_GC_Add_Root_Fct(Fd_Optim_Atom_GC_Roots);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FD_OPTIM_ATOM_GC_ROOTS                                                  *
+ *                                                                         *
+ * Called by the atom garbage collector: mark the atoms of the recorded    *
+ * solutions.                                                              *
+ *-------------------------------------------------------------------------*/
+static void
+Fd_Optim_Atom_GC_Roots(void)
+{
+  OptimInf *o;
+  OptimSol *s;
+
+  for (o = optim_tbl; o < optim_tbl + nb_optim; o++)
+    for (s = o->last; s; s = s->prev)
+      Pl_Atom_GC_Mark_Words(&s->goal_word, s->size);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GET_OPTIM                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static OptimInf *
+Get_Optim(WamWord ctx_word)
+{
+  return optim_tbl + Pl_Rd_C_Int(ctx_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FREE_SOLUTIONS                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Free_Solutions(OptimInf *o)
+{
+  OptimSol *s;
+
+  while ((s = o->last) != NULL)
+    {
+      o->last = s->prev;
+      Free(s);
+    }
+
+  o->nb_sol = 0;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * POP_OPTIM                                                               *
+ *                                                                         *
+ * Pops the optimization i and all (nested) optimizations started after    *
+ * it (e.g. left by an exception).                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Pop_Optim(int i)
+{
+  while (nb_optim > i)
+    Free_Solutions(optim_tbl + --nb_optim);
+
+  Pl_Fd_Pop_Bound(i);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_OPTIM_BEGIN_4                                                     *
+ *                                                                         *
+ * Starts an optimization on the objective variable var_word. From now on  *
+ * each propagation phase restricts it to the bounds of the optimization.  *
+ * If all_word is 1 all the optimal solutions are recorded (else only one).*
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Optim_Begin_4(WamWord var_word, WamWord minimize_word,
+		    WamWord all_word, WamWord ctx_word)
+{
+  WamWord *fdv_adr;
+  OptimInf *o;
+  int i;
+
+  fdv_adr = Pl_Fd_Prolog_To_Fd_Var(var_word, FALSE);
+
+  i = Pl_Fd_Push_Bound(fdv_adr, Min(fdv_adr), Max(fdv_adr));
+
+  if (i >= optim_size)
+    {
+      optim_size = (optim_size == 0) ? 8 : optim_size * 2;
+      optim_tbl = (OptimInf *) Realloc((char *) optim_tbl,
+				       optim_size * sizeof(OptimInf));
+    }
+
+  o = optim_tbl + i;
+  o->fdv_adr = fdv_adr;
+  o->minimize = Pl_Rd_Integer(minimize_word);
+  o->all = Pl_Rd_Integer(all_word);
+  o->last = NULL;
+  o->nb_sol = 0;
+  nb_optim = i + 1;
+
+  return Pl_Un_Integer(i, ctx_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_OPTIM_SOLUTION_2                                                  *
+ *                                                                         *
+ * Records a copy of the solution goal_word if it is at least as good as   *
+ * the best ones (a better one discards them). The bound is then tightened *
+ * for the rest of the search: to the best value when all the optimal      *
+ * solutions are recorded, strictly better otherwise. If the objective is  *
+ * not instantiated its current min (or max) is its value.                 *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Optim_Solution_2(WamWord ctx_word, WamWord goal_word)
+{
+  OptimInf *o = Get_Optim(ctx_word);
+  int i = o - optim_tbl;
+  int min, max, v, size;
+  OptimSol *s;
+  static WamWord fix_bug;	/* see Pl_Store_Solution_1 (all_solut_c.c) */
+
+  v = (o->minimize) ? Min(o->fdv_adr) : Max(o->fdv_adr);
+  Pl_Fd_Get_Bound(i, &min, &max);
+  if (v < min || v > max)
+    return FALSE;
+
+  if (!o->all || o->last == NULL || v != o->value)
+    Free_Solutions(o);
+
+  size = Pl_Term_Size(goal_word);
+  s = (OptimSol *) Malloc(OPTIM_SOL_SIZE(size));
+  s->size = size;
+  fix_bug = goal_word;
+  Pl_Copy_Term(&s->goal_word, &fix_bug);
+  s->prev = o->last;
+  o->last = s;
+  o->nb_sol++;
+  o->value = v;
+
+  if (o->all)
+    {
+      min = (o->minimize) ? min : v;
+      max = (o->minimize) ? v : max;
+    }
+  else if (o->minimize)
+    max = v - 1;
+  else
+    min = v + 1;
+
+  Pl_Fd_Set_Bound(i, min, max);
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_OPTIM_BISECT_1                                                    *
+ *                                                                         *
+ * Restricts the bounds to their better half (dichotomic search). Fails if *
+ * the bounds are empty (the best solution found is optimal).              *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Optim_Bisect_1(WamWord ctx_word)
+{
+  OptimInf *o = Get_Optim(ctx_word);
+  int i = o - optim_tbl;
+  int min, max, mid;
+
+  Pl_Fd_Get_Bound(i, &min, &max);
+  if (min > max)
+    return FALSE;
+
+  if (o->minimize)
+    {
+      mid = min + (max - min) / 2;
+      Pl_Fd_Set_Bound(i, min, mid);
+      o->other_min = mid + 1;
+      o->other_max = max;
+    }
+  else
+    {
+      mid = max - (max - min) / 2;
+      Pl_Fd_Set_Bound(i, mid, max);
+      o->other_min = min;
+      o->other_max = mid - 1;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_OPTIM_BISECT_FAILED_1                                             *
+ *                                                                         *
+ * The better half has no solution: continue with the other half.          *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Optim_Bisect_Failed_1(WamWord ctx_word)
+{
+  OptimInf *o = Get_Optim(ctx_word);
+
+  Pl_Fd_Set_Bound(o - optim_tbl, o->other_min, o->other_max);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_OPTIM_END_3                                                       *
+ *                                                                         *
+ * Ends the optimization and returns the optimal value and the list of the *
+ * recorded solutions (in the order they were found). Fails if no solution *
+ * has been found.                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_Optim_End_3(WamWord ctx_word, WamWord value_word, WamWord list_word)
+{
+  OptimInf *o = Get_Optim(ctx_word);
+  int i = o - optim_tbl;
+  WamWord word, list;
+  OptimSol *s;
+  int v = o->value;
+
+  if (o->last == NULL)
+    {
+      Pop_Optim(i);
+      return FALSE;
+    }
+
+  list = NIL_WORD;
+  for (s = o->last; s; s = s->prev)
+    {
+      Pl_Copy_Contiguous_Term(H, &s->goal_word);
+      word = *H;
+      H += s->size;
+
+      Car(H) = word;
+      Cdr(H) = list;
+      list = Tag_LST(H);
+      H += 2;
+    }
+
+  Pop_Optim(i);
+
+  return Pl_Un_Integer(v, value_word) && Pl_Unify(list, list_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_OPTIM_ABORT_1                                                     *
+ *                                                                         *
+ * Also pops the (nested) optimizations started after it (e.g. left by an  *
+ * exception).                                                             *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Optim_Abort_1(WamWord ctx_word)
+{
+  Pop_Optim(Pl_Rd_C_Int(ctx_word));
+}
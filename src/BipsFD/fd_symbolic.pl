@@ -43,7 +43,46 @@
 
 fd_all_different(L) :-
 	set_bip_name(fd_all_different, 1),
-	'$call_c_test'('Pl_Fd_All_Different_1'(L, L)).
+	fd_tell(pl_fd_all_different_value(L)).
+
+
+
+
+fd_all_different(L, Options) :-
+	set_bip_name(fd_all_different, 2),
+	'$check_list'(Options),
+	'$get_all_different_options'(Options, value, Consistency),
+	'$fd_all_different'(Consistency, L).
+
+
+'$fd_all_different'(value, L) :-
+	fd_tell(pl_fd_all_different_value(L)).
+
+'$fd_all_different'(bounds, L) :-
+	fd_tell(pl_fd_all_different_bounds(L)).
+
+'$fd_all_different'(domain, L) :-
+	fd_tell(pl_fd_all_different_domain(L)).
+
+
+
+
+'$get_all_different_options'([], Consistency, Consistency).
+
+'$get_all_different_options'([X|_], _, _) :-
+	var(X),
+	'$pl_err_instantiation'.
+
+'$get_all_different_options'([consistency(X)|Options], _, Consistency) :-
+	'$check_nonvar'(X),
+	(   X = value
+	;   X = bounds
+	;   X = domain
+	), !,
+	'$get_all_different_options'(Options, X, Consistency).
+
+'$get_all_different_options'([X|_], _, _) :-
+	'$pl_err_domain'(fd_all_different_option, X).
 
 
 
@@ -36,6 +36,10 @@
  *-------------------------------------------------------------------------*/
 
 
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
 #include "engine_pl.h"
 #include "bips_pl.h"
 
@@ -49,98 +53,852 @@
  * Constants                       *
  *---------------------------------*/
 
+#define ALL_DIFF_MAX_VALUES        65536 /* domain consistency limit */
+#define ALL_DIFF_CACHE_SIZE        64
+
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
 
+typedef struct			/* an interval for bounds consistency */
+{				/* ---------------------------------- */
+  int min;			/* min of the variable                */
+  int max;			/* max of the variable + 1            */
+  int min_rank;			/* rank of min in bounds[]            */
+  int max_rank;			/* rank of max in bounds[]            */
+}
+AllDiffIntv;
+
+
+typedef struct			/* state after the last execution     */
+{				/* ---------------------------------- */
+  WamWord **array;		/* the constraint (its list of vars)  */
+  PlULong date;			/* propagation phase                  */
+  PlLong nb_elem;		/* sum of the domain sizes            */
+}
+AllDiffCache;
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
 
+static AllDiffCache ad_cache[ALL_DIFF_CACHE_SIZE];
+
+static int ad_size;		/* allocated nb of vars for the arrays */
+static AllDiffIntv *ad_intv;
+static AllDiffIntv **ad_min_sorted;
+static AllDiffIntv **ad_max_sorted;
+static int *ad_bounds;		/* bounds[], t[], d[] and h[] have     */
+static int *ad_t;		/* 2 * ad_size + 2 elements            */
+static int *ad_d;
+static int *ad_h;
+
+static int ad_nb_bounds;
+
+static int ad_gr_size;		/* allocated nb of nodes for the graph */
+static int *ad_var_match;	/* value matched to each var (or -1)   */
+static int *ad_val_match;	/* var matched to each value (or -1)   */
+static int *ad_visited;
+static int ad_stamp;
+static int *ad_var_adj;		/* values of each var (CSR)            */
+static int *ad_var_first;
+static int *ad_val_adj;		/* vars of each value (CSR)            */
+static int *ad_val_first;
+static int ad_adj_size;
+static int *ad_dfn;		/* for Tarjan's SCC algorithm          */
+static int *ad_low;
+static int *ad_scc;
+static int *ad_stack;
+static int ad_sp;
+static int ad_cur_dfn;
+static int ad_nb_scc;
+
+static int ad_n;		/* nb of vars and of values (graph)    */
+static int ad_m;
+
 /*---------------------------------*
  * Function Prototypes             *
  *---------------------------------*/
 
-static Bool Fd_All_Different_Rec(WamWord list_word, PlLong x_tag, WamWord x_word,
-				 WamWord save_list_word);
+static PlLong All_Diff_Nb_Elem(int n, WamWord **array);
+
+static Bool All_Diff_Unchanged(WamWord **array, PlLong nb_elem);
+
+static Bool All_Diff_Fix_Point(WamWord **array,
+			       Bool (*propag)(int n, WamWord **array));
+
+static void All_Diff_Alloc(int n);
+
+static Bool All_Diff_Bounds(int n, WamWord **array);
+
+static Bool All_Diff_Domain(int n, WamWord **array);
+
+static Bool All_Diff_Value(WamWord **array);
+
+static int All_Diff_Compare_Min(const void *p1, const void *p2);
+
+static int All_Diff_Compare_Max(const void *p1, const void *p2);
+
+static void All_Diff_Sort(int n);
+
+static Bool All_Diff_Filter_Lower(int n);
+
+static Bool All_Diff_Filter_Upper(int n);
+
+static Bool All_Diff_Augment(int x);
+
+static void All_Diff_SCC(int node);
 
 
 
 
 /*-------------------------------------------------------------------------*
- * PL_FD_ALL_DIFFERENT_1                                                   *
+ * The global fd_all_different propagators below maintain one constraint   *
+ * for the whole list (instead of a pl_x_neq_y per pair of variables).     *
  *                                                                         *
+ * Pl_Fd_All_Different_Bounds: removes the values of ground variables     *
+ *   from the other ones and ensures bounds consistency with the algorithm *
+ *   of Lopez-Ortiz, Quimper, Tromp and van Beek (IJCAI 2003). Hall        *
+ *   intervals are detected in O(n log n) with union-find structures on    *
+ *   the sorted bounds of the variables.                                   *
+ *                                                                         *
+ * Pl_Fd_All_Different_Domain: ensures domain consistency with Regin's     *
+ *   algorithm (AAAI 1994): a maximum matching variables/values is found   *
+ *   (augmenting paths) then a value v is removed from a variable x if the *
+ *   edge x-v belongs neither to the matching nor to a strongly connected  *
+ *   component nor to an even alternating path starting at a free value.  *
+ *   The last case is handled by a node T with edges value->T for the     *
+ *   matched values and T->value for the free ones.                        *
+ *                                                                         *
+ * Such a constraint is reexecuted for each variable of the list modified  *
+ * in the propagation phase. Since it iterates until its own fix-point, it *
+ * can be skipped when no domain changed since its last execution in the  *
+ * same propagation phase (the domains only decrease inside a phase).      *
  *-------------------------------------------------------------------------*/
-Bool
-Pl_Fd_All_Different_1(WamWord list_word, WamWord save_list_word)
+
+#define In_Dom(r, v)   (Is_Interval(r) || (r)->min == (r)->max || \
+                        Vector_Test_Value((r)->vec, v))
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_NB_ELEM                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static PlLong
+All_Diff_Nb_Elem(int n, WamWord **array)
+{
+  PlLong nb_elem = 0;
+  int i;
+
+  for (i = 0; i < n; i++)
+    nb_elem += Nb_Elem(array[i]);
+
+  return nb_elem;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_UNCHANGED                                                      *
+ *                                                                         *
+ * Has the constraint already reached its fix-point for these domains ?    *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Unchanged(WamWord **array, PlLong nb_elem)
 {
-  WamWord word, tag_mask;
-  WamWord *lst_adr;
+  AllDiffCache *c = ad_cache + (((PlULong) array >> 3) % ALL_DIFF_CACHE_SIZE);
+
+  return c->array == array && c->date == Pl_Fd_Propagation_Date() &&
+    c->nb_elem == nb_elem;
+}
 
 
-  DEREF(list_word, word, tag_mask);
-  if (tag_mask == TAG_REF_MASK)
-    Pl_Err_Instantiation();
 
-  if (word == NIL_WORD)
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_FIX_POINT                                                      *
+ *                                                                         *
+ * Executes a propagator until its fix-point (and records it).             *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Fix_Point(WamWord **array, Bool (*propag)(int n, WamWord **array))
+{
+  AllDiffCache *c = ad_cache + (((PlULong) array >> 3) % ALL_DIFF_CACHE_SIZE);
+  PlLong nb_elem, nb_elem0;
+  int n;
+
+  n = (int) (PlLong) (array[0]);
+  nb_elem = All_Diff_Nb_Elem(n, array + 1);
+  if (All_Diff_Unchanged(array, nb_elem))
     return TRUE;
 
-  if (tag_mask != TAG_LST_MASK)
-    Pl_Err_Type(pl_type_list, save_list_word);
+  do
+    {
+      nb_elem0 = nb_elem;
+      if (!All_Diff_Value(array))
+	return FALSE;
+
+      n = (int) (PlLong) (array[0]);
+      if (n > 1 && !(*propag) (n, array + 1))
+	return FALSE;
 
-  lst_adr = UnTag_LST(word);
-  DEREF(Car(lst_adr), word, tag_mask);
+      nb_elem = All_Diff_Nb_Elem(n, array + 1);
+    }
+  while (nb_elem != nb_elem0);
 
-  if (tag_mask != TAG_REF_MASK && tag_mask != TAG_INT_MASK &&
-      tag_mask != TAG_FDV_MASK)
-    Pl_Err_Type(pl_type_fd_variable, word);
+  c->array = array;
+  c->date = Pl_Fd_Propagation_Date();
+  c->nb_elem = nb_elem;
 
-  return Fd_All_Different_Rec(Cdr(lst_adr), tag_mask, word, save_list_word) &&
-    Pl_Fd_All_Different_1(Cdr(lst_adr), save_list_word);
+  return TRUE;
 }
 
 
 
 
 /*-------------------------------------------------------------------------*
- * FD_ALL_DIFFERENT_REC                                                    *
+ * ALL_DIFF_ALLOC                                                          *
  *                                                                         *
  *-------------------------------------------------------------------------*/
+static void
+All_Diff_Alloc(int n)
+{
+  int size;
+
+  if (n <= ad_size)
+    return;
+
+  ad_size = n + n / 2;
+  size = 2 * ad_size + 2;
+
+  ad_intv = (AllDiffIntv *) Realloc(ad_intv, ad_size * sizeof(AllDiffIntv));
+  ad_min_sorted = (AllDiffIntv **) Realloc(ad_min_sorted, ad_size * sizeof(AllDiffIntv *));
+  ad_max_sorted = (AllDiffIntv **) Realloc(ad_max_sorted, ad_size * sizeof(AllDiffIntv *));
+  ad_bounds = (int *) Realloc(ad_bounds, size * sizeof(int));
+  ad_t = (int *) Realloc(ad_t, size * sizeof(int));
+  ad_d = (int *) Realloc(ad_d, size * sizeof(int));
+  ad_h = (int *) Realloc(ad_h, size * sizeof(int));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_VALUE                                                          *
+ *                                                                         *
+ * Removes the value of each ground variable from the other variables (the *
+ * pruning of the pairwise decomposition). array[0] is the number of the   *
+ * active variables: a ground variable whose value has been removed from   *
+ * the others is moved after them (the array is updated with trailing).    *
+ *-------------------------------------------------------------------------*/
 static Bool
-Fd_All_Different_Rec(WamWord list_word, PlLong x_tag, WamWord x_word,
-		     WamWord save_list_word)
+All_Diff_Value(WamWord **array)
 {
-  WamWord word, tag_mask;
-  WamWord *lst_adr;
-  int ret;
+  int n = (int) (PlLong) (array[0]);
+  WamWord **a = array + 1;
+  WamWord *fdv_adr;
+  Bool new_ground;
+  int i, j, v;
 
+  do
+    {
+      new_ground = FALSE;
+      for (i = 0; i < n; i++)
+	{
+	  fdv_adr = a[i];
+	  if (!Fd_Variable_Is_Ground(fdv_adr))
+	    continue;
+
+	  n--;
+	  FD_Bind_OV((WamWord *) &a[i], (WamWord) a[n]);
+	  FD_Bind_OV((WamWord *) &a[n], (WamWord) fdv_adr);
+	  i--;
+
+	  v = Min(fdv_adr);
+	  for (j = 0; j < n; j++)
+	    {
+	      fdv_adr = a[j];
+	      if (v < Min(fdv_adr) || v > Max(fdv_adr))
+		continue;
+
+	      if (!Pl_Fd_Tell_Not_Value(fdv_adr, v))
+		return FALSE;
+
+	      if (j <= i && Fd_Variable_Is_Ground(fdv_adr))
+		new_ground = TRUE;
+	    }
+	}
+    }
+  while (new_ground);
 
-  DEREF(list_word, word, tag_mask);
-  if (tag_mask == TAG_REF_MASK)
-    Pl_Err_Instantiation();
+  if (n != (int) (PlLong) (array[0]))
+    FD_Bind_OV((WamWord *) &array[0], (WamWord) n);
 
-  if (word == NIL_WORD)
-    return TRUE;
+  return TRUE;
+}
 
-  if (tag_mask != TAG_LST_MASK)
-    Pl_Err_Type(pl_type_list, save_list_word);
 
-  lst_adr = UnTag_LST(word);
-  DEREF(Car(lst_adr), word, tag_mask);
 
-  if (tag_mask != TAG_REF_MASK && tag_mask != TAG_INT_MASK &&
-      tag_mask != TAG_FDV_MASK)
-    Pl_Err_Type(pl_type_fd_variable, word);
 
-  if (x_tag == TAG_INT_MASK)
-    ret = (tag_mask == TAG_INT_MASK) ? x_word != word :
-             pl_x_neq_c(word, x_word);
-  else
-    ret = (tag_mask == TAG_INT_MASK) ? pl_x_neq_c(x_word, word) :
-             pl_x_neq_y(x_word, word);
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_COMPARE_MIN                                                    *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+All_Diff_Compare_Min(const void *p1, const void *p2)
+{
+  int m1 = (*(AllDiffIntv **) p1)->min;
+  int m2 = (*(AllDiffIntv **) p2)->min;
+
+  return (m1 < m2) ? -1 : (m1 > m2);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_COMPARE_MAX                                                    *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+All_Diff_Compare_Max(const void *p1, const void *p2)
+{
+  int m1 = (*(AllDiffIntv **) p1)->max;
+  int m2 = (*(AllDiffIntv **) p2)->max;
+
+  return (m1 < m2) ? -1 : (m1 > m2);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_SORT                                                           *
+ *                                                                         *
+ * Sorts the intervals by min and by max and computes the ranks of their   *
+ * bounds in the sorted array (without duplicates) ad_bounds[1..nb].       *
+ *-------------------------------------------------------------------------*/
+static void
+All_Diff_Sort(int n)
+{
+  int i, j, nb;
+  int min, max, last;
+
+  for (i = 0; i < n; i++)
+    ad_min_sorted[i] = ad_max_sorted[i] = &ad_intv[i];
+
+  qsort(ad_min_sorted, n, sizeof(AllDiffIntv *), All_Diff_Compare_Min);
+  qsort(ad_max_sorted, n, sizeof(AllDiffIntv *), All_Diff_Compare_Max);
+
+  min = ad_min_sorted[0]->min;
+  max = ad_max_sorted[0]->max;
+  last = min - 2;
+  nb = 0;
+  ad_bounds[0] = last;
+
+  i = j = 0;
+  for (;;)
+    {
+      if (i < n && min <= max)
+	{
+	  if (min != last)
+	    ad_bounds[++nb] = last = min;
+	  ad_min_sorted[i]->min_rank = nb;
+	  if (++i < n)
+	    min = ad_min_sorted[i]->min;
+	}
+      else
+	{
+	  if (max != last)
+	    ad_bounds[++nb] = last = max;
+	  ad_max_sorted[j]->max_rank = nb;
+	  if (++j == n)
+	    break;
+	  max = ad_max_sorted[j]->max;
+	}
+    }
+
+  ad_nb_bounds = nb;
+  ad_bounds[nb + 1] = ad_bounds[nb] + 2;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * Path operations on the union-find trees t[] and h[]                     *
+ *-------------------------------------------------------------------------*/
+
+static void
+All_Diff_Path_Set(int *t, int start, int end, int to)
+{
+  int k, l = start;
+
+  while ((k = l) != end)
+    {
+      l = t[k];
+      t[k] = to;
+    }
+}
+
+
+static int
+All_Diff_Path_Min(int *t, int i)
+{
+  while (t[i] < i)
+    i = t[i];
+
+  return i;
+}
+
+
+static int
+All_Diff_Path_Max(int *t, int i)
+{
+  while (t[i] > i)
+    i = t[i];
+
+  return i;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_FILTER_LOWER                                                   *
+ *                                                                         *
+ * Updates the min of the intervals (visited by increasing max).           *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Filter_Lower(int n)
+{
+  int *t = ad_t, *d = ad_d, *h = ad_h, *bounds = ad_bounds;
+  int i, j, w, x, y, z;
+
+  for (i = 1; i <= ad_nb_bounds + 1; i++)
+    {
+      t[i] = h[i] = i - 1;
+      d[i] = bounds[i] - bounds[i - 1];
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      x = ad_max_sorted[i]->min_rank;
+      y = ad_max_sorted[i]->max_rank;
+      z = All_Diff_Path_Max(t, x + 1);
+      j = t[z];
+
+      if (--d[z] == 0)
+	{
+	  t[z] = z + 1;
+	  z = All_Diff_Path_Max(t, t[z]);
+	  t[z] = j;
+	}
+
+      All_Diff_Path_Set(t, x + 1, z, z);
+
+      if (d[z] < bounds[z] - bounds[y])
+	return FALSE;
+
+      if (h[x] > x)
+	{
+	  w = All_Diff_Path_Max(h, h[x]);
+	  ad_max_sorted[i]->min = bounds[w];
+	  All_Diff_Path_Set(h, x, w, w);
+	}
+
+      if (d[z] == bounds[z] - bounds[y])
+	{
+	  All_Diff_Path_Set(h, h[y], j - 1, y);	/* Hall interval */
+	  h[y] = j - 1;
+	}
+    }
 
-  return ret &&
-    Fd_All_Different_Rec(Cdr(lst_adr), x_tag, x_word, save_list_word);
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_FILTER_UPPER                                                   *
+ *                                                                         *
+ * Updates the max of the intervals (visited by decreasing min).           *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Filter_Upper(int n)
+{
+  int *t = ad_t, *d = ad_d, *h = ad_h, *bounds = ad_bounds;
+  int i, j, w, x, y, z;
+
+  for (i = 0; i <= ad_nb_bounds; i++)
+    {
+      t[i] = h[i] = i + 1;
+      d[i] = bounds[i + 1] - bounds[i];
+    }
+
+  for (i = n - 1; i >= 0; i--)
+    {
+      x = ad_min_sorted[i]->max_rank;
+      y = ad_min_sorted[i]->min_rank;
+      z = All_Diff_Path_Min(t, x - 1);
+      j = t[z];
+
+      if (--d[z] == 0)
+	{
+	  t[z] = z - 1;
+	  z = All_Diff_Path_Min(t, t[z]);
+	  t[z] = j;
+	}
+
+      All_Diff_Path_Set(t, x - 1, z, z);
+
+      if (d[z] < bounds[y] - bounds[z])
+	return FALSE;
+
+      if (h[x] < x)
+	{
+	  w = All_Diff_Path_Min(h, h[x]);
+	  ad_min_sorted[i]->max = bounds[w];
+	  All_Diff_Path_Set(h, x, w, w);
+	}
+
+      if (d[z] == bounds[y] - bounds[z])
+	{
+	  All_Diff_Path_Set(h, h[y], j + 1, y);	/* Hall interval */
+	  h[y] = j + 1;
+	}
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_ALL_DIFFERENT_VALUE                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_All_Different_Value(WamWord **array)
+{
+  return All_Diff_Value(array);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_ALL_DIFFERENT_BOUNDS                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_All_Different_Bounds(WamWord **array)
+{
+  return All_Diff_Fix_Point(array, All_Diff_Bounds);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_BOUNDS                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Bounds(int n, WamWord **array)
+{
+  WamWord *fdv_adr;
+  AllDiffIntv *iv;
+  int i;
+
+  All_Diff_Alloc(n);
+
+  for (i = 0; i < n; i++)
+    {
+      ad_intv[i].min = Min(array[i]);
+      ad_intv[i].max = Max(array[i]) + 1;
+    }
+
+  All_Diff_Sort(n);
+
+  if (!All_Diff_Filter_Lower(n) || !All_Diff_Filter_Upper(n))
+    return FALSE;
+
+  for (i = 0; i < n; i++)
+    {
+      fdv_adr = array[i];
+      iv = &ad_intv[i];
+      if ((iv->min != Min(fdv_adr) || iv->max - 1 != Max(fdv_adr)) &&
+	  !Pl_Fd_Tell_Interval(fdv_adr, iv->min, iv->max - 1))
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_AUGMENT                                                        *
+ *                                                                         *
+ * Searches an augmenting path from the variable x (depth-first).          *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Augment(int x)
+{
+  int k, v;
+
+  for (k = ad_var_first[x]; k < ad_var_first[x + 1]; k++)
+    {
+      v = ad_var_adj[k];
+      if (ad_visited[v] == ad_stamp)
+	continue;
+
+      ad_visited[v] = ad_stamp;
+      if (ad_val_match[v] < 0 || All_Diff_Augment(ad_val_match[v]))
+	{
+	  ad_var_match[x] = v;
+	  ad_val_match[v] = x;
+	  return TRUE;
+	}
+    }
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_SCC                                                            *
+ *                                                                         *
+ * Tarjan's algorithm on the residual graph. The nodes are the variables   *
+ * (0..n-1), the values (n..n+m-1) and T (n+m). The edges are:             *
+ *   var x -> value matched to x                                           *
+ *   value v -> var x if v is in the domain of x and not matched to x      *
+ *   value v -> T if v is matched, T -> value v if v is free               *
+ *-------------------------------------------------------------------------*/
+static void
+All_Diff_SCC(int node)
+{
+  int n = ad_n, m = ad_m;
+  int k, succ, x;
+
+  ad_dfn[node] = ad_low[node] = ++ad_cur_dfn;
+  ad_stack[ad_sp++] = node;
+
+#define Visit_Succ(s)						\
+  do								\
+    {								\
+      succ = (s);						\
+      if (ad_dfn[succ] == 0)					\
+	{							\
+	  All_Diff_SCC(succ);					\
+	  if (ad_low[succ] < ad_low[node])			\
+	    ad_low[node] = ad_low[succ];			\
+	}							\
+      else if (ad_scc[succ] < 0 && ad_dfn[succ] < ad_low[node])	\
+	ad_low[node] = ad_dfn[succ];				\
+    }								\
+  while (0)
+
+  if (node < n)			/* a variable */
+    Visit_Succ(n + ad_var_match[node]);
+  else if (node < n + m)	/* a value */
+    {
+      for (k = ad_val_first[node - n]; k < ad_val_first[node - n + 1]; k++)
+	{
+	  x = ad_val_adj[k];
+	  if (ad_var_match[x] != node - n)
+	    Visit_Succ(x);
+	}
+      if (ad_val_match[node - n] >= 0)
+	Visit_Succ(n + m);
+    }
+  else				/* T */
+    {
+      for (k = 0; k < m; k++)
+	if (ad_val_match[k] < 0 && ad_val_first[k] < ad_val_first[k + 1])
+	  Visit_Succ(n + k);
+    }
+
+#undef Visit_Succ
+
+  if (ad_low[node] == ad_dfn[node])
+    {
+      do
+	ad_scc[x = ad_stack[--ad_sp]] = ad_nb_scc;
+      while (x != node);
+      ad_nb_scc++;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_ALL_DIFFERENT_DOMAIN                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Fd_All_Different_Domain(WamWord **array)
+{
+  return All_Diff_Fix_Point(array, All_Diff_Domain);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_DIFF_DOMAIN                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+All_Diff_Domain(int n, WamWord **array)
+{
+  WamWord *fdv_adr;
+  Range *r;
+  int min, max, m, nb_edges;
+  int i, k, v, size;
+
+  min = INT_MAX;
+  max = INT_MIN;
+  nb_edges = 0;
+  for (i = 0; i < n; i++)
+    {
+      r = Range(array[i]);
+      if (r->min < min)
+	min = r->min;
+      if (r->max > max)
+	max = r->max;
+      nb_edges += Nb_Elem(array[i]);
+    }
+
+  if ((PlLong) max - min + 1 > ALL_DIFF_MAX_VALUES)
+    return All_Diff_Bounds(n, array);
+
+  m = max - min + 1;
+  if (m < n)			/* pigeonhole */
+    return FALSE;
+
+  size = n + m + 1;
+  if (size > ad_gr_size)
+    {
+      ad_gr_size = size + size / 2;
+      ad_var_match = (int *) Realloc(ad_var_match, ad_gr_size * sizeof(int));
+      ad_val_match = (int *) Realloc(ad_val_match, ad_gr_size * sizeof(int));
+      ad_visited = (int *) Realloc(ad_visited, ad_gr_size * sizeof(int));
+      ad_var_first = (int *) Realloc(ad_var_first, ad_gr_size * sizeof(int));
+      ad_val_first = (int *) Realloc(ad_val_first, ad_gr_size * sizeof(int));
+      ad_dfn = (int *) Realloc(ad_dfn, ad_gr_size * sizeof(int));
+      ad_low = (int *) Realloc(ad_low, ad_gr_size * sizeof(int));
+      ad_scc = (int *) Realloc(ad_scc, ad_gr_size * sizeof(int));
+      ad_stack = (int *) Realloc(ad_stack, ad_gr_size * sizeof(int));
+      ad_stamp = 0;
+      memset(ad_visited, 0, ad_gr_size * sizeof(int));
+    }
+
+  if (nb_edges > ad_adj_size)
+    {
+      ad_adj_size = nb_edges + nb_edges / 2;
+      ad_var_adj = (int *) Realloc(ad_var_adj, ad_adj_size * sizeof(int));
+      ad_val_adj = (int *) Realloc(ad_val_adj, ad_adj_size * sizeof(int));
+    }
+
+				/* build the bipartite graph */
+  for (v = 0; v <= m; v++)
+    ad_val_first[v] = 0;
+
+  k = 0;
+  for (i = 0; i < n; i++)
+    {
+      r = Range(array[i]);
+      ad_var_first[i] = k;
+      for (v = r->min; v <= r->max; v++)
+	if (In_Dom(r, v))
+	  {
+	    ad_var_adj[k++] = v - min;
+	    ad_val_first[v - min + 1]++;
+	  }
+    }
+  ad_var_first[n] = k;
+
+  for (v = 0; v < m; v++)
+    ad_val_first[v + 1] += ad_val_first[v];
+
+  for (i = 0; i < n; i++)	/* ad_val_first used as a fill pointer */
+    for (k = ad_var_first[i]; k < ad_var_first[i + 1]; k++)
+      {
+	v = ad_var_adj[k];
+	ad_val_adj[ad_val_first[v]++] = i;
+      }
+
+  for (v = m; v > 0; v--)
+    ad_val_first[v] = ad_val_first[v - 1];
+  ad_val_first[0] = 0;
+
+				/* maximum matching */
+  for (v = 0; v < m; v++)
+    ad_val_match[v] = -1;
+
+  for (i = 0; i < n; i++)
+    {
+      ad_var_match[i] = -1;
+      for (k = ad_var_first[i]; k < ad_var_first[i + 1]; k++)
+	if (ad_val_match[v = ad_var_adj[k]] < 0)
+	  {
+	    ad_var_match[i] = v;
+	    ad_val_match[v] = i;
+	    break;
+	  }
+    }
+
+  for (i = 0; i < n; i++)
+    if (ad_var_match[i] < 0)
+      {
+	if (++ad_stamp == 0)
+	  {
+	    memset(ad_visited, 0, ad_gr_size * sizeof(int));
+	    ad_stamp = 1;
+	  }
+	if (!All_Diff_Augment(i))
+	  return FALSE;
+      }
+
+				/* strongly connected components */
+  ad_n = n;
+  ad_m = m;
+  for (k = 0; k < size; k++)
+    {
+      ad_dfn[k] = 0;
+      ad_scc[k] = -1;
+    }
+  ad_sp = ad_cur_dfn = ad_nb_scc = 0;
+
+  for (k = 0; k < size; k++)
+    if (ad_dfn[k] == 0)
+      All_Diff_SCC(k);
+
+				/* pruning */
+  for (i = 0; i < n; i++)
+    {
+      fdv_adr = array[i];
+      for (k = ad_var_first[i]; k < ad_var_first[i + 1]; k++)
+	{
+	  v = ad_var_adj[k];
+	  if (v != ad_var_match[i] && ad_scc[n + v] != ad_scc[i] &&
+	      !Pl_Fd_Tell_Not_Value(fdv_adr, v + min))
+	    return FALSE;
+	}
+    }
+
+  return TRUE;
 }
 
 
@@ -63,7 +63,14 @@
 #define DELAY_CSTR_STACK_SIZE      1000
 #define VARS_STACK_SIZE            100000
 
-#define MAX_MONOMS                 2000
+#define MONOM_STACK_SIZE           1024	/* initial size (grows) */
+
+#define LINEAR_MIN_MONOMS          4	/* below: ternary constraints     */
+#if WORD_SIZE == 32		/* max sum of |coefs| (no overflow) */
+#define LINEAR_MAX_SUM_COEF        INT_GREATEST_VALUE
+#else
+#define LINEAR_MAX_SUM_COEF        ((PlLong) 1 << 33)
+#endif
 
 #define MAX_COEF_FOR_SORT          100
 
@@ -124,8 +131,8 @@ Monom;
 typedef struct			/* Polynomial term information    */
 {				/* ------------------------------ */
   PlLong c;			/* the constant                   */
+  int base;			/* its 1st monom in monom_stack   */
   int nb_monom;			/* nb of monomial terms           */
-  Monom m[MAX_MONOMS];		/* table of monomial terms        */
 }
 Poly;
 
@@ -157,6 +164,13 @@ static WamWord vars_tbl[VARS_STACK_SIZE];
 static WamWord *vars_sp;
 
 
+		/* the monomial terms of the polys: a poly being */
+		/* normalized is always at the top of the stack  */
+static Monom *monom_stack;
+static int monom_stack_size;
+static int monom_top;
+
+
 static Bool sort;
 
 
@@ -166,11 +180,21 @@ static Bool sort;
  * Function Prototypes             *
  *---------------------------------*/
 
-static Bool Load_Left_Right_Rec(Bool optim_eq,
+static Bool Load_Left_Right_Rec(int linear,
 				WamWord le_word, WamWord re_word,
-				int *mask, WamWord *c_word,
+				int *mask, PlLong *c,
 				WamWord *l_word, WamWord *r_word);
 
+static void Monom_Stack_Reserve(int n);
+
+static void Merge_Monoms(Poly *p);
+
+static int Compar_Monom_Var(Monom *m1, Monom *m2);
+
+static Bool Linear_Applicable(Poly *p);
+
+static Bool Load_Linear(int linear, Poly *p);
+
 static int Compar_Monom(Monom *m1, Monom *m2);
 
 static Bool Load_Term_Into_Word(WamWord e_word, WamWord *load_word);
@@ -203,7 +227,9 @@ void Pl_Write_1(WamWord term_word);
 
 #define New_Tagged_Fd_Variable  (Tag_REF(Pl_Fd_New_Variable()))
 
-#define New_Poly(p)             ((p).c = (p).nb_monom = 0)
+#define New_Poly(p)             ((p).c = (p).nb_monom = 0, (p).base = monom_top)
+
+#define Poly_Monoms(p)          (monom_stack + (p).base)
 
 #define Add_Cst_To_Poly(p, s, w)  (p->c += s * w)
 
@@ -231,6 +257,9 @@ Math_Supp_Initializer(void)
   arith_tbl[QUOT_2] = Functor_Arity(Pl_Create_Atom("//"), 2);
   arith_tbl[REM_2] = Functor_Arity(Pl_Create_Atom("rem"), 2);
   arith_tbl[QUOT_REM_3] = Functor_Arity(Pl_Create_Atom("quot_rem"), 3);
+
+  monom_stack_size = MONOM_STACK_SIZE;
+  monom_stack = (Monom *) Malloc(monom_stack_size * sizeof(Monom));
 }
 
 
@@ -242,8 +271,11 @@ Math_Supp_Initializer(void)
  * This function loads the left and right term of a constraint into (new)  *
  * variables.                                                              *
  * Input:                                                                  *
- *    optim_eq: is used to optimize loadings of a term1 #= term2 constraint*
- *              when the constant is zero.                                 *
+ *    linear  : the constraint (LINEAR_EQ,...) or LINEAR_NONE. A long      *
+ *              linear constraint is directly posted as an n-ary one (mask *
+ *              is then MASK_LINEAR). LINEAR_EQ is also used to optimize   *
+ *              loadings of a term1 #= term2 constraint when the constant  *
+ *              is zero.                                                   *
  *    le_word : left  term of the constraint                               *
  *    re_word : right term of the constraint                               *
  *                                                                         *
@@ -254,7 +286,7 @@ Math_Supp_Initializer(void)
  *   r_word   : the variable containing the right part  (tagged <REF,adr>) *
  *-------------------------------------------------------------------------*/
 Bool
-Pl_Load_Left_Right(Bool optim_eq, WamWord le_word, WamWord re_word,
+Pl_Load_Left_Right(int linear, WamWord le_word, WamWord re_word,
 		int *mask, PlLong *c, WamWord *l_word, WamWord *r_word)
 {
 #ifdef DEBUG
@@ -267,8 +299,9 @@ Pl_Load_Left_Right(Bool optim_eq, WamWord le_word, WamWord re_word,
 
   delay_sp = delay_cstr_stack;
   vars_sp = vars_tbl;
+  monom_top = 0;
 
-  return Load_Left_Right_Rec(optim_eq, le_word, re_word, mask, c,
+  return Load_Left_Right_Rec(linear, le_word, re_word, mask, c,
 			     l_word, r_word);
 }
 
@@ -318,14 +351,16 @@ Pl_Term_Math_Loading(WamWord l_word, WamWord r_word)
  * Load_Term_Into_Word(). In that case, re_word is simply ignored.         *
  *-------------------------------------------------------------------------*/
 static Bool
-Load_Left_Right_Rec(Bool optim_eq, WamWord le_word, WamWord re_word,
+Load_Left_Right_Rec(int linear, WamWord le_word, WamWord re_word,
 		    int *mask, PlLong *c, WamWord *l_word, WamWord *r_word)
 {
   Poly p;
+  Monom *m;
   Monom *l_m, *r_m;
   Monom *cur, *pos, *neg, *end;
   int l_nb_monom, r_nb_monom;
   WamWord pref_load_word;	/* to optimize equalities (#=) */
+  Bool optim_eq = (linear == LINEAR_EQ);
   int i;
 
   sort = FALSE;
@@ -337,30 +372,48 @@ Load_Left_Right_Rec(Bool optim_eq, WamWord le_word, WamWord re_word,
   if (re_word != NOT_A_WAM_WORD && !Normalize(re_word, -1, &p))
     return FALSE;
 
-  if (sort || p.nb_monom > MAX_MONOMS / 2)
+  Merge_Monoms(&p);
+
+  if (linear != LINEAR_NONE && Linear_Applicable(&p))
     {
-      qsort(p.m, p.nb_monom, sizeof(Monom),
+      *mask = MASK_LINEAR;
+      *c = 0;
+      *l_word = *r_word = NOT_A_WAM_WORD;
+      if (!Load_Linear(linear, &p))
+	return FALSE;
+
+      monom_top = p.base;
+      return TRUE;
+    }
+
+  m = Poly_Monoms(p);
+
+  if (sort)
+    {
+      qsort(m, p.nb_monom, sizeof(Monom),
 	    (int (*)(const void *, const void *)) Compar_Monom);
 
       for (i = 0; i < p.nb_monom; i++)	/* find left monomial terms */
-	if (p.m[i].a <= 0)
+	if (m[i].a <= 0)
 	  break;
 
-      l_m = p.m;
+      l_m = m;
       l_nb_monom = i;
 
       for (; i < p.nb_monom; i++)	/* find right monomial terms */
-	if (p.m[i].a >= 0)
+	if (m[i].a >= 0)
 	  break;
 	else
-	  p.m[i].a = -p.m[i].a;	        /* only positive coefs now */
+	  m[i].a = -m[i].a;	        /* only positive coefs now */
 
       r_m = l_m + l_nb_monom;
       r_nb_monom = i - l_nb_monom;
     }
   else
     {
-      pos = p.m;
+      Monom_Stack_Reserve(p.nb_monom);	/* negative ones are copied after */
+      m = Poly_Monoms(p);
+      pos = m;
       end = pos + p.nb_monom;
       neg = end;
 
@@ -382,7 +435,7 @@ Load_Left_Right_Rec(Bool optim_eq, WamWord le_word, WamWord re_word,
 	    }
 	}
 
-      l_m = p.m;
+      l_m = m;
       l_nb_monom = (int) (pos - l_m);
       r_m = end;
       r_nb_monom = (int) (neg - r_m);
@@ -456,6 +509,104 @@ Load_Left_Right_Rec(Bool optim_eq, WamWord le_word, WamWord re_word,
 
   *c = p.c;
 
+  monom_top = p.base;		/* pop the poly */
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LINEAR_APPLICABLE                                                       *
+ *                                                                         *
+ * Should the (merged) poly be posted as an n-ary linear constraint ? Only *
+ * long ones are (the others do not need intermediate variables), if the   *
+ * bounds of the sum cannot overflow (see Pl_Fd_Linear_Eq in fd_math_c.c). *
+ * The ternary decomposition is kept for full AC (#=#,...) constraints.    *
+ *-------------------------------------------------------------------------*/
+static Bool
+Linear_Applicable(Poly *p)
+{
+  Monom *m = Poly_Monoms(*p);
+  PlLong sum = 0;
+  int i;
+
+  if (pl_full_ac || p->nb_monom < LINEAR_MIN_MONOMS)
+    return FALSE;
+
+  if (p->c < -INT_GREATEST_VALUE || p->c > INT_GREATEST_VALUE)
+    return FALSE;
+
+  for (i = 0; i < p->nb_monom; i++)
+    {
+      if (m[i].a < -LINEAR_MAX_SUM_COEF || m[i].a > LINEAR_MAX_SUM_COEF)
+	return FALSE;
+
+      sum += (m[i].a >= 0) ? m[i].a : -m[i].a;
+      if (sum > LINEAR_MAX_SUM_COEF)
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * LOAD_LINEAR                                                             *
+ *                                                                         *
+ * Posts c + a1*X1 + ... + an*Xn op 0 (op given by linear) as the n-ary    *
+ * constraint a1*X1 + ... + an*Xn op' C. Its arguments are the lists       *
+ * [C, a1, ..., an] and [X1, ..., Xn] (see fd_math_fd.fd).                 *
+ *-------------------------------------------------------------------------*/
+static Bool
+Load_Linear(int linear, Poly *p)
+{
+  Monom *m = Poly_Monoms(*p);
+  WamWord a_word, x_word;
+  PlLong c = -p->c;
+  int i;
+
+  if (linear == LINEAR_LT)
+    c--;
+
+  a_word = Tag_LST(H);
+  H[0] = Tag_INT(c);
+  H[1] = Tag_LST(H + 2);
+  H += 2;
+  for (i = 0; i < p->nb_monom; i++)
+    {
+      H[0] = Tag_INT(m[i].a);
+      H[1] = Tag_LST(H + 2);
+      H += 2;
+    }
+  H[-1] = NIL_WORD;
+
+  x_word = Tag_LST(H);
+  for (i = 0; i < p->nb_monom; i++)
+    {
+      H[0] = m[i].x_word;
+      H[1] = Tag_LST(H + 2);
+      H += 2;
+    }
+  H[-1] = NIL_WORD;
+
+  switch (linear)
+    {
+    case LINEAR_EQ:
+      PRIM_CSTR_2(pl_linear_eq, a_word, x_word);
+      break;
+
+    case LINEAR_NEQ:
+      PRIM_CSTR_2(pl_linear_neq, a_word, x_word);
+      break;
+
+    default:			/* LINEAR_LT, LINEAR_LTE */
+      PRIM_CSTR_2(pl_linear_lte, a_word, x_word);
+      break;
+    }
+
   return TRUE;
 }
 
@@ -484,7 +635,7 @@ Load_Term_Into_Word(WamWord e_word, WamWord *load_word)
   PlLong c;
 
 
-  if (!Load_Left_Right_Rec(FALSE, e_word, NOT_A_WAM_WORD, &mask, &c,
+  if (!Load_Left_Right_Rec(LINEAR_NONE, e_word, NOT_A_WAM_WORD, &mask, &c,
 			   &l_word, &r_word))
     return FALSE;
 
@@ -600,39 +751,119 @@ Push_Delayed_Cstr(int cstr, WamWord a1, WamWord a2, WamWord a3)
 
 
 
+/*-------------------------------------------------------------------------*
+ * MONOM_STACK_RESERVE                                                     *
+ *                                                                         *
+ * Ensures there is room for n monomial terms above the top of the stack.  *
+ * Can move the stack (pointers to monomial terms must be recomputed).     *
+ *-------------------------------------------------------------------------*/
+static void
+Monom_Stack_Reserve(int n)
+{
+  if (monom_top + n <= monom_stack_size)
+    return;
+
+  monom_stack_size = math_max(2 * monom_stack_size, monom_top + n);
+  monom_stack = (Monom *) Realloc(monom_stack, monom_stack_size * sizeof(Monom));
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * ADD_MONOM                                                               *
  *                                                                         *
+ * p must be at the top of the monom stack. Several monomial terms on the  *
+ * same variable are merged later (see Merge_Monoms).                      *
  *-------------------------------------------------------------------------*/
 static void
 Add_Monom(Poly *p, int sign, PlLong a, WamWord x_word)
 {
-  int i;
-
   if (a == 0)
     return;
 
   if (sign < 0)
     a = -a;
 
-  for (i = 0; i < p->nb_monom; i++)
-    if (p->m[i].x_word == x_word)
-      {
-	p->m[i].a += a;
-	return;
-      }
-
-  if (p->nb_monom >= MAX_MONOMS)
-    Pl_Err_Resource(pl_resource_too_big_fd_constraint);
+  Monom_Stack_Reserve(1);
 
-  p->m[p->nb_monom].a = a;
-  p->m[p->nb_monom].x_word = x_word;
+  monom_stack[monom_top].a = a;
+  monom_stack[monom_top].x_word = x_word;
+  monom_top++;
   p->nb_monom++;
 }
 
 
 
 
+/*-------------------------------------------------------------------------*
+ * MERGE_MONOMS                                                            *
+ *                                                                         *
+ * Merges the monomial terms on a same variable into the first one and     *
+ * removes null ones (the order of the others is kept). A copy of the      *
+ * terms is sorted on the variables (its coefs record the original ranks). *
+ *-------------------------------------------------------------------------*/
+static void
+Merge_Monoms(Poly *p)
+{
+  Monom *m, *s;
+  int n = p->nb_monom;
+  int i, j, k;
+
+  if (n > 1)
+    {
+      Monom_Stack_Reserve(n);
+      m = Poly_Monoms(*p);
+      s = m + n;
+      for (i = 0; i < n; i++)
+	{
+	  s[i].a = i;
+	  s[i].x_word = m[i].x_word;
+	}
+
+      qsort(s, n, sizeof(Monom),
+	    (int (*)(const void *, const void *)) Compar_Monom_Var);
+
+      for (i = 0; i < n; i = j)
+	{
+	  k = (int) s[i].a;	/* 1st occurrence of this variable */
+	  for (j = i + 1; j < n && s[j].x_word == s[i].x_word; j++)
+	    {
+	      m[k].a += m[s[j].a].a;
+	      m[s[j].a].a = 0;
+	    }
+	}
+    }
+
+  m = Poly_Monoms(*p);
+  for (i = j = 0; i < n; i++)
+    if (m[i].a != 0)
+      m[j++] = m[i];
+
+  p->nb_monom = j;
+  monom_top = p->base + j;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COMPAR_MONOM_VAR                                                        *
+ *                                                                         *
+ * Called by qsort (see Merge_Monoms): by variable then by rank.           *
+ *-------------------------------------------------------------------------*/
+static int
+Compar_Monom_Var(Monom *m1, Monom *m2)
+{
+  if (m1->x_word != m2->x_word)
+    return (m1->x_word < m2->x_word) ? -1 : 1;
+
+  return (m1->a < m2->a) ? -1 : (m1->a > m2->a);
+}
+
+
+
+
 #ifdef DEVELOP_TIMES_2
 /*-------------------------------------------------------------------------*
  * ADD_MULTIPLY_MONOM                                                      *
@@ -823,29 +1054,46 @@ Normalize(WamWord e_word, int sign, Poly *p)
       return TRUE;
     any:
 #endif
-      {
-	Poly p1, p2;
+      {				/* p1, p2 then p3 are pushed above p */
+	Poly p1, p2, p3;	/* p3 (the result) is then moved to p */
+	Monom *m1, *m2;
 	int i1, i2;
 
 	New_Poly(p1);
-	New_Poly(p2);
+	if (!Normalize(le_word, 1, &p1))
+	  return FALSE;
+	Merge_Monoms(&p1);
 
-	if (!Normalize(le_word, 1, &p1) || !Normalize(re_word, 1, &p2))
+	New_Poly(p2);
+	if (!Normalize(re_word, 1, &p2))
 	  return FALSE;
+	Merge_Monoms(&p2);
 
 	Add_Cst_To_Poly(p, sign, p1.c * p2.c);
 
+	New_Poly(p3);
 	for (i1 = 0; i1 < p1.nb_monom; i1++)
 	  {
-	    Add_Monom(p, sign, p1.m[i1].a * p2.c, p1.m[i1].x_word);
+	    m1 = Poly_Monoms(p1) + i1;	/* the stack can move */
+	    Add_Monom(&p3, sign, m1->a * p2.c, m1->x_word);
 	    for (i2 = 0; i2 < p2.nb_monom; i2++)
-	      if (!Add_Multiply_Monom(p, sign, p1.m + i1, p2.m + i2))
-		return FALSE;
+	      {
+		m1 = Poly_Monoms(p1) + i1;
+		m2 = Poly_Monoms(p2) + i2;
+		if (!Add_Multiply_Monom(&p3, sign, m1, m2))
+		  return FALSE;
+	      }
 	  }
 
 	for (i2 = 0; i2 < p2.nb_monom; i2++)
-	  Add_Monom(p, sign, p2.m[i2].a * p1.c, p2.m[i2].x_word);
+	  {
+	    m2 = Poly_Monoms(p2) + i2;
+	    Add_Monom(&p3, sign, m2->a * p1.c, m2->x_word);
+	  }
 
+	memmove(Poly_Monoms(p1), Poly_Monoms(p3), p3.nb_monom * sizeof(Monom));
+	p->nb_monom += p3.nb_monom;
+	monom_top = p->base + p->nb_monom;
 	return TRUE;
       }
 #else
@@ -43,6 +43,14 @@
 #define MASK_EMPTY                 0
 #define MASK_LEFT                  1
 #define MASK_RIGHT                 2
+#define MASK_LINEAR                4	/* n-ary linear constraint posted */
+
+
+#define LINEAR_NONE                0	/* see Pl_Load_Left_Right */
+#define LINEAR_EQ                  1
+#define LINEAR_NEQ                 2
+#define LINEAR_LT                  3
+#define LINEAR_LTE                 4
 
 
 
@@ -86,7 +94,7 @@ extern Bool pl_full_ac;
  * Function Prototypes             *
  *---------------------------------*/
 
-Bool Pl_Load_Left_Right(Bool optim_eq, WamWord le_word, WamWord re_word,
+Bool Pl_Load_Left_Right(int linear, WamWord le_word, WamWord re_word,
 		     int *mask, PlLong *c, WamWord *l_word, WamWord *r_word);
 
 Bool Pl_Term_Math_Loading(WamWord l_word, WamWord r_word);
@@ -178,6 +186,14 @@ Bool pl_ax_plus_by_plus_z_eq_t_F(WamWord a, WamWord x, WamWord b, WamWord y,
 
 
 
+Bool pl_linear_eq(WamWord a, WamWord x);
+
+Bool pl_linear_neq(WamWord a, WamWord x);
+
+Bool pl_linear_lte(WamWord a, WamWord x);
+
+
+
 Bool pl_zero_power_n_eq_y(WamWord n, WamWord y);
 
 Bool pl_a_power_n_eq_y(WamWord a, WamWord n, WamWord y);
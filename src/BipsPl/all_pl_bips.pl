@@ -46,6 +46,7 @@
 	'$use_arith_inl',
 	'$use_assert',
 	'$use_all_solut',
+	'$use_tabling',
 	'$use_sort',
 	'$use_list',
 	'$use_stream',
@@ -64,6 +65,7 @@
 	'$use_type_inl',
 	'$use_g_var_inl',
 	'$use_stat',
+	'$use_prof',
 	'$use_dec10io',
 	'$use_format',
 	'$use_os_interf',
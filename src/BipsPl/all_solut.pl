@@ -54,8 +54,13 @@ findall(Template, Generator, Instances, Tail) :-
 '$findall'(Template, Generator, Instances, Tail, Func, Arity) :-
 	'$check_list_arg'(Instances, Func, Arity),
 	'$check_list_arg'(Tail, Func, Arity),
-	'$store_solutions'(Template, Generator, Stop, Func, Arity),
-	'$call_c_test'('Pl_Recover_Solutions_4'(Stop, 0, Instances, Tail)).
+	'$call_c'('Pl_Open_Solutions_0'),
+	(   '$get_current_B'(B),
+	    '$call'(Generator, Func, Arity, true),
+	    % stores and fails unless the generator is determinate
+	    '$call_c_test'('Pl_Store_Solution_4'(Template, B, Instances, Tail))
+	;   '$call_c_test'('Pl_Recover_Solutions_3'(0, Instances, Tail))
+	).
 
 
 
@@ -79,9 +84,9 @@ bagof(Template, Generator, Instances) :-
 
 '$bagof'(Template, Generator, Instances, Func, Arity) :-
 	'$call_c_test'('Pl_Free_Variables_4'(Template, Generator, Generator1, Key)), !,
-	'$store_solutions'(Key - Template, Generator1, Stop, Func, Arity),
+	'$store_solutions'(Key - Template, Generator1, Func, Arity),
 	set_bip_name(Func, Arity),   % for error too_many_variables in C function
-	'$call_c_test'('Pl_Recover_Solutions_4'(Stop, 1, AllInstances, [])),
+	'$call_c_test'('Pl_Recover_Solutions_3'(1, AllInstances, [])),
 	(   Func = bagof ->
 	    keysort(AllInstances)
 	;   sort(AllInstances)
@@ -100,8 +105,8 @@ bagof(Template, Generator, Instances) :-
 
 
 
-'$store_solutions'(Template, Generator, Stop, Func, Arity) :-
-	'$call_c'('Pl_Stop_Mark_1'(Stop)),
+'$store_solutions'(Template, Generator, Func, Arity) :-
+	'$call_c'('Pl_Open_Solutions_0'),
 	(   '$call'(Generator, Func, Arity, true),
 	    '$call_c'('Pl_Store_Solution_1'(Template)),
 	    fail
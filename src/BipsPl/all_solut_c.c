@@ -55,22 +55,56 @@
  * Constants                       *
  *---------------------------------*/
 
+#define SOL_CHUNK_MIN_WORDS        4096
+#define SOL_CHUNK_MAX_WORDS        (1 << 20)
+#define SOL_SPARE_MAX_WORDS        (1 << 16)
+
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
 
 typedef struct onesol *OneSolP;
 
-typedef struct onesol
+typedef struct onesol		/* a stored solution (in the arena)    */
 {
-  OneSolP prev;
-  int sol_no;
-  int term_size;
-  WamWord term_word;
+  OneSolP prev;			/* previous solution of the collector  */
+  int term_size;		/* size of the copied term (in words)  */
+  WamWord term_word;		/* the copied term (term_size words)   */
 }
 OneSol;
 
 
+typedef struct solchunk *SolChunkP;
+
+typedef struct solchunk		/* a chunk of the solution arena       */
+{
+  SolChunkP prev;		/* previous chunk (older solutions)    */
+  WamWord *end;			/* end of the chunk                    */
+  WamWord word[1];		/* the data (up to end)                */
+}
+SolChunk;
+
+
+typedef struct solframe *SolFrameP;
+
+typedef struct solframe		/* a running collector (findall,...)   */
+{
+  SolFrameP prev;		/* enclosing collector                 */
+  WamWord *b;			/* B when the collector started        */
+  int nb_sol;			/* number of stored solutions          */
+  OneSol *last;			/* last stored solution (or NULL)      */
+  SolChunk *chunk;		/* arena top before this frame         */
+  WamWord *top;
+}
+SolFrame;
+
+
+#define SOL_FRAME_WORDS            (sizeof(SolFrame) / sizeof(WamWord))
+
+#define ONE_SOL_WORDS(size)	\
+  ((sizeof(OneSol) - sizeof(WamWord)) / sizeof(WamWord) + (size))
+
+
 
 
 /*---------------------------------*
@@ -79,7 +113,7 @@ OneSol;
 
 static WamWord exist_2;
 
-static WamWord new_gen_word;
+static WamWord new_gen_word = NOT_A_WAM_WORD;	/* a GC root */
 
 
 
@@ -88,8 +122,11 @@ static WamWord *free_var_base;
 
 
 
-static OneSol dummy = { NULL, 0, 0 };
-static OneSol *sol = &dummy;
+static SolChunk *chunk;		/* current chunk of the arena */
+static WamWord *top;		/* first free word in chunk */
+static SolChunk *spare;		/* a free chunk kept for reuse */
+
+static SolFrame *frame;		/* innermost running collector */
 
 static PlLong *key_var_ptr;
 static PlLong *save_key_var_ptr;
@@ -108,6 +145,24 @@ static WamWord Existential_Variables(WamWord start_word);
 
 static Bool Free_Var(WamWord *adr, WamWord var_word);
 
+static void All_Solut_GC_Roots(GCVisitFct visit);
+
+static void All_Solut_Atom_GC_Roots(void);
+
+static void All_Solut_Atom_GC_Engine(void);
+
+static void All_Solut_Destroy_Engine(void);
+
+static void All_Solut_Unwind(WamWord *b);
+
+
+
+static WamWord *Arena_Alloc(int n);
+
+static void Arena_Release(SolChunk *c, WamWord *t);
+
+static void Close_Frame(void);
+
 
 
 static void Handle_Key_Variables(WamWord start_word);
@@ -135,6 +190,102 @@ static void
 All_Solut_Initializer(void)
 {
   exist_2 = Functor_Arity(ATOM_CHAR('^'), 2);
+
+  Pl_GC_Add_Root_Fct(All_Solut_GC_Roots);
+  Pl_Atom_GC_Add_Root_Fct(All_Solut_Atom_GC_Roots);
+  Pl_Add_Unwind_Fct(All_Solut_Unwind);
+
+  /* each engine has its own arena */
+  Pl_Engine_Add_State(&new_gen_word, sizeof(new_gen_word));
+  Pl_Engine_Add_State(&chunk, sizeof(chunk));
+  Pl_Engine_Add_State(&top, sizeof(top));
+  Pl_Engine_Add_State(&spare, sizeof(spare));
+  Pl_Engine_Add_State(&frame, sizeof(frame));
+  Pl_Engine_Add_Destroy_Fct(All_Solut_Destroy_Engine);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_SOLUT_GC_ROOTS                                                      *
+ *                                                                         *
+ * new_gen_word is kept between Pl_Free_Variables_4 and                    *
+ * Pl_Recover_Generator_1 (2nd clause of '$bagof'/5).                      *
+ *-------------------------------------------------------------------------*/
+static void
+All_Solut_GC_Roots(GCVisitFct visit)
+{
+  if (new_gen_word != NOT_A_WAM_WORD)
+    (*visit) (&new_gen_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_SOLUT_ATOM_GC_ROOTS                                                 *
+ *                                                                         *
+ * Called by the atom garbage collector: mark the atoms of the stored      *
+ * solutions (not yet recovered) of all engines.                           *
+ *-------------------------------------------------------------------------*/
+static void
+All_Solut_Atom_GC_Roots(void)
+{
+  All_Solut_Atom_GC_Engine();
+  Pl_Engine_For_Each_Suspended(All_Solut_Atom_GC_Engine);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_SOLUT_ATOM_GC_ENGINE                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+All_Solut_Atom_GC_Engine(void)
+{
+  SolFrame *f;
+  OneSol *s;
+
+  for (f = frame; f; f = f->prev)
+    for (s = f->last; s; s = s->prev)
+      Pl_Atom_GC_Mark_Words(&s->term_word, s->term_size);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_SOLUT_DESTROY_ENGINE                                                *
+ *                                                                         *
+ * Frees the arena of an engine being destroyed.                           *
+ *-------------------------------------------------------------------------*/
+static void
+All_Solut_Destroy_Engine(void)
+{
+  frame = NULL;
+  Arena_Release(NULL, NULL);
+  if (spare != NULL)
+    Free(spare);
+  spare = NULL;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ALL_SOLUT_UNWIND                                                        *
+ *                                                                         *
+ * Called when an exception unwinds the choice points above b: the         *
+ * collectors started above b are abandoned, release their solutions.     *
+ *-------------------------------------------------------------------------*/
+static void
+All_Solut_Unwind(WamWord *b)
+{
+  while (frame && frame->b >= b)
+    Close_Frame();
 }
 
 
@@ -162,7 +313,7 @@ Bool
 Pl_Free_Variables_4(WamWord templ_word, WamWord gen_word, WamWord gen1_word,
 		    WamWord key_word)
 {
-  WamWord gl_key_word;
+  WamWord word, gl_key_word;
   WamWord *save_H, *arg;
   int nb_free_var = 0;
 
@@ -181,6 +332,9 @@ Pl_Free_Variables_4(WamWord templ_word, WamWord gen_word, WamWord gen1_word,
   if (nb_free_var == 0)
     return FALSE;
 
+  word = new_gen_word;
+  new_gen_word = NOT_A_WAM_WORD;	/* not needed by Pl_Recover_Generator_1 */
+
   if (nb_free_var <= MAX_ARITY)
     {
       *save_H = Functor_Arity(ATOM_CHAR('.'), nb_free_var);
@@ -192,7 +346,7 @@ Pl_Free_Variables_4(WamWord templ_word, WamWord gen_word, WamWord gen1_word,
       gl_key_word = Pl_Mk_Proper_List(nb_free_var, arg);
     }
 
-  Pl_Unify(new_gen_word, gen1_word);
+  Pl_Unify(word, gen1_word);
   return Pl_Unify(gl_key_word, key_word);
 }
 
@@ -206,7 +360,10 @@ Pl_Free_Variables_4(WamWord templ_word, WamWord gen_word, WamWord gen1_word,
 void
 Pl_Recover_Generator_1(WamWord gen1_word)
 {
-  Pl_Unify(new_gen_word, gen1_word);
+  WamWord word = new_gen_word;
+
+  new_gen_word = NOT_A_WAM_WORD;
+  Pl_Unify(word, gen1_word);
 }
 
 
@@ -291,11 +448,19 @@ Free_Var(WamWord *adr, WamWord var_word)
 
 
 /*-------------------------------------------------------------------------*
- * This part saves and restores all solutions found. A stack of solutions  *
- * is used (each solution is copied to a Mallocated memory area). To handle*
- * nested findall and al, each solution receive a sequential number. At the*
- * start, the number of the solution on the top of the stack serves as a   *
- * stop mark.                                                              *
+ * This part saves and restores all solutions found. Each solution is     *
+ * copied into an arena: a stack of Mallocated chunks (growing in size)    *
+ * where storing a solution only moves the top. Each running collector     *
+ * (findall and al.) pushes a frame recording the top of the arena, so     *
+ * nested collectors are handled as a stack and all the solutions of a     *
+ * collector are released at once when it ends. A collector abandoned by   *
+ * an exception is released when the exception unwinds the choice point    *
+ * which was the top one at its start (see All_Solut_Unwind).              *
+ *                                                                         *
+ * For findall/3-4, when the generator succeeds for the first time without *
+ * leaving any choice point (determinate generator), the solution is       *
+ * directly copied to the heap, the bindings are undone and the choice     *
+ * point of the collector is removed (see Pl_Store_Solution_4).            *
  *                                                                         *
  * Recovering the solutions: a space for the list of (nb_sol) solutions is *
  * reserved on the top of the heap (nb_sol*2 WamWords) then each term is   *
@@ -340,13 +505,120 @@ Free_Var(WamWord *adr, WamWord var_word)
 
 
 /*-------------------------------------------------------------------------*
- * PL_STOP_MARK_1                                                          *
+ * ARENA_ALLOC                                                             *
+ *                                                                         *
+ * Allocate n words on the top of the arena.                               *
+ *-------------------------------------------------------------------------*/
+static WamWord *
+Arena_Alloc(int n)
+{
+  SolChunk *c;
+  PlLong size;
+  WamWord *p;
+
+  if (chunk == NULL || top + n > chunk->end)
+    {
+      size = (chunk == NULL) ? SOL_CHUNK_MIN_WORDS : 2 * (chunk->end - chunk->word);
+      if (size > SOL_CHUNK_MAX_WORDS)
+	size = SOL_CHUNK_MAX_WORDS;
+      if (size < n)
+	size = n;
+
+      if (spare != NULL && spare->end - spare->word >= n)
+	{
+	  c = spare;
+	  spare = NULL;
+	}
+      else
+	{
+	  c = (SolChunk *) Malloc(sizeof(SolChunk) - sizeof(WamWord) +
+				  size * sizeof(WamWord));
+	  c->end = c->word + size;
+	}
+
+      c->prev = chunk;
+      chunk = c;
+      top = c->word;
+    }
+
+  p = top;
+  top += n;
+  return p;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ARENA_RELEASE                                                           *
+ *                                                                         *
+ * Reset the top of the arena to t (in chunk c). Released chunks are freed *
+ * except a small one which is kept as spare to avoid Malloc/Free cycles   *
+ * on repeated findall.                                                    *
+ *-------------------------------------------------------------------------*/
+static void
+Arena_Release(SolChunk *c, WamWord *t)
+{
+  SolChunk *c1;
+
+  while (chunk != c)
+    {
+      c1 = chunk;
+      chunk = c1->prev;
+
+      if (c1->end - c1->word > SOL_SPARE_MAX_WORDS)
+	Free(c1);
+      else
+	{
+	  if (spare != NULL)
+	    Free(spare);
+	  spare = c1;
+	}
+    }
+
+  top = t;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CLOSE_FRAME                                                             *
  *                                                                         *
+ * Pop the innermost collector and release its solutions.                  *
+ *-------------------------------------------------------------------------*/
+static void
+Close_Frame(void)
+{
+  SolFrame *f = frame;
+
+  frame = f->prev;
+  Arena_Release(f->chunk, f->top);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_OPEN_SOLUTIONS_0                                                     *
+ *                                                                         *
+ * Start a new collector.                                                  *
  *-------------------------------------------------------------------------*/
 void
-Pl_Stop_Mark_1(WamWord stop_word)
+Pl_Open_Solutions_0(void)
 {
-  Pl_Get_Integer(sol->sol_no, stop_word);
+  SolChunk *c = chunk;
+  WamWord *t = top;
+  SolFrame *f;
+
+  f = (SolFrame *) Arena_Alloc(SOL_FRAME_WORDS);
+  f->prev = frame;
+  f->b = B;
+  f->nb_sol = 0;
+  f->last = NULL;
+  f->chunk = c;
+  f->top = t;
+  frame = f;
 }
 
 
@@ -366,40 +638,97 @@ Pl_Store_Solution_1(WamWord term_word)
  * This corrupts ebp on ix86 */
   static WamWord fix_bug;
 
+  if (frame == NULL)		/* collector already released */
+    return;
+
   size = Pl_Term_Size(term_word);
 
-  s = (OneSol *) Malloc(sizeof(OneSol) - sizeof(WamWord) +
-			size * sizeof(WamWord));
-  s->prev = sol;
-  s->sol_no = sol->sol_no + 1;
+  s = (OneSol *) Arena_Alloc(ONE_SOL_WORDS(size));
   s->term_size = size;
   fix_bug = term_word;
   Pl_Copy_Term(&s->term_word, &fix_bug);
-  sol = s;
+  s->prev = frame->last;
+  frame->last = s;
+  frame->nb_sol++;
 }
 
 
 
 
 /*-------------------------------------------------------------------------*
- * PL_RECOVER_SOLUTIONS_4                                                  *
+ * PL_STORE_SOLUTION_4                                                     *
  *                                                                         *
+ * Store a solution of findall/3-4. b is the choice point of the collector.*
+ * If it is the top choice point and there is no stored solution, the      *
+ * generator is determinate: the instance list is directly built in the    *
+ * heap and the collector ends (succeeds or fails). Otherwise the solution *
+ * is stored and this function fails (to get the next solutions).          *
  *-------------------------------------------------------------------------*/
 Bool
-Pl_Recover_Solutions_4(WamWord stop_word, WamWord handle_key_word,
-		       WamWord list_word, WamWord tail_word)
+Pl_Store_Solution_4(WamWord term_word, WamWord b_word, WamWord list_word,
+		    WamWord tail_word)
+{
+  WamWord word, tag_mask;
+  WamWord *b;
+  int size;
+  static WamWord fix_bug;	/* see Pl_Store_Solution_1 */
+
+  DEREF(b_word, word, tag_mask);
+  b = From_WamWord_To_B(word);
+
+  if (frame == NULL)		/* collector already released */
+    return FALSE;
+
+  if (B != b || frame->nb_sol > 0)
+    {
+      Pl_Store_Solution_1(term_word);
+      return FALSE;
+    }
+
+  size = Pl_Term_Size(term_word);
+  fix_bug = term_word;
+  Pl_Copy_Term(H, &fix_bug);
+  word = *H;
+  H += size;
+
+  Pl_Untrail(TRB(b));		/* undo the bindings of the generator */
+  Delete_Last_Choice_Point();
+  Close_Frame();
+
+  Car(H) = word;
+  Cdr(H) = tail_word;
+  H += 2;
+
+  return Pl_Unify(Tag_LST(H - 2), list_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_RECOVER_SOLUTIONS_3                                                  *
+ *                                                                         *
+ * Build the list of the solutions of the innermost collector and end it.  *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Recover_Solutions_3(WamWord handle_key_word, WamWord list_word,
+		       WamWord tail_word)
 {
-  int stop;
   int nb_sol;
   WamWord *p, *q;
   OneSol *s;
   Bool handle_key;
 
-  stop = Pl_Rd_C_Int(stop_word);
-  nb_sol = sol->sol_no - stop;
+  if (frame == NULL)		/* collector already released */
+    return Pl_Unify(list_word, tail_word);
+
+  nb_sol = frame->nb_sol;
 
   if (nb_sol == 0)
-    return Pl_Unify(list_word, tail_word);
+    {
+      Close_Frame();
+      return Pl_Unify(list_word, tail_word);
+    }
 
   handle_key = Pl_Rd_C_Int(handle_key_word);
   key_var_ptr = pl_glob_dico_var;	/* pl_glob_dico_var: key vars */
@@ -417,22 +746,21 @@ Pl_Recover_Solutions_4(WamWord stop_word, WamWord handle_key_word,
 
   p = q = H;
 
-  while (nb_sol--)
+  for (s = frame->last; nb_sol--; s = s->prev)
     {
       p--;
       *p = Tag_LST(p + 1);
       *--p = Tag_REF(H);
-      Pl_Copy_Contiguous_Term(H, &sol->term_word);
+      Pl_Copy_Contiguous_Term(H, &s->term_word);
 
       if (handle_key)
 	Handle_Key_Variables(*H);
 
-      H += sol->term_size;
-      s = sol;
-      sol = sol->prev;
-      Free(s);
+      H += s->term_size;
     }
 
+  Close_Frame();
+
   q[-1] = tail_word;
   return Pl_Unify(Tag_LST(p), list_word);
 }
@@ -0,0 +1,68 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : all_solut_test.pl                                               *
+ * Descr.: findall/bagof checks (run by make check)                        *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+check(Name, Goal) :-
+	(   catch(Goal, E, (write(Name), write(' raised '), write(E), nl, fail)) ->
+	    true
+	;   write(Name), write(' failed'), nl,
+	    halt(1)
+	).
+
+
+		% an uncaught error inside findall/3 (reported as a system_error
+		% and then ignored) must not release the running collectors
+
+uncaught :-
+	findall(R, (member(I, [1, 2, 3]), R is 2.5 mod I), _).
+
+uncaught :-
+	true.
+
+check_after_uncaught :-
+	findall(X-Y, (member(X, [a, b]), member(Y, [c, d])), L),
+	L == [a-c, a-d, b-c, b-d].
+
+
+:- initialization(main).
+
+main :-
+	write('All solutions tests started...'), nl,
+	uncaught, uncaught, uncaught,	% not under catch/3
+	check(after_uncaught, check_after_uncaught),
+	write('All solutions checks succeeded'), nl,
+	halt.
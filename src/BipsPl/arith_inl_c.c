@@ -1416,10 +1416,9 @@ Pl_Current_Evaluable_1(WamWord func_indic_word)
 				/* non deterministic case */
   A(0) = name_word;
   A(1) = arity_word;
-  A(2) = (WamWord) scan.endt;
-  A(3) = (WamWord) scan.cur_t;
-  A(4) = (WamWord) scan.cur_p;
-  Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(CURRENT_EVALUABLE_ALT, 0), 5);
+  A(2) = (WamWord) scan.tbl;
+  A(3) = (WamWord) scan.cur;
+  Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(CURRENT_EVALUABLE_ALT, 0), 4);
 
   return Pl_Get_Atom(Functor_Of(evaluable->f_n), name_word) &&
     Pl_Get_Integer(Arity_Of(evaluable->f_n), arity_word);
@@ -1450,9 +1449,8 @@ Pl_Current_Evaluable_Alt_0(void)
 
   name_word = AB(B, 0);
   arity_word = AB(B, 1);
-  scan.endt = (char *) AB(B, 2);
-  scan.cur_t = (char *) AB(B, 3);
-  scan.cur_p = (char *) AB(B, 4);
+  scan.tbl = (char *) AB(B, 2);
+  scan.cur = (PlLong) AB(B, 3);
 
   func = Tag_Mask_Of(name_word) == TAG_REF_MASK ? -1 : UnTag_ATM(name_word);
   arity = Tag_Mask_Of(arity_word) == TAG_REF_MASK ? -1 : (int) UnTag_INT(arity_word);
@@ -1481,10 +1479,9 @@ Pl_Current_Evaluable_Alt_0(void)
 #if 0				/* the following data is unchanged */
   AB(B, 0) = name_word;
   AB(B, 1) = arity_word;
-  AB(B, 2) = (WamWord) scan.endt;
+  AB(B, 2) = (WamWord) scan.tbl;
 #endif
-  AB(B, 3) = (WamWord) scan.cur_t;
-  AB(B, 4) = (WamWord) scan.cur_p;
+  AB(B, 3) = (WamWord) scan.cur;
 
   return Pl_Get_Atom(Functor_Of(evaluable->f_n), name_word) &&
     Pl_Get_Integer(Arity_Of(evaluable->f_n), arity_word);
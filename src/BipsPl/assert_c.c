@@ -145,13 +145,10 @@ Pl_Clause_3(WamWord head_word, WamWord body_word, WamWord for_what_word)
   if (dyn == NULL)		/* no dynamic info */
     return FALSE;
 
-  if (arity > 0)
-    word = *first_arg_adr;
-
   w[0] = head_word;
   w[1] = body_word;
 
-  clause = Pl_Scan_Dynamic_Pred(-1, 0, pred->dyn, word,
+  clause = Pl_Scan_Dynamic_Pred(-1, 0, pred->dyn, first_arg_adr,
 				Clause_Alt, DYN_ALT_FCT_FOR_TEST, 2, w);
   if (clause == NULL)
     return FALSE;
@@ -231,13 +228,10 @@ Pl_Retract_2(WamWord head_word, WamWord body_word)
   if (dyn == NULL)		/* no dynamic info */
     return FALSE;
 
-  if (arity > 0)
-    word = *first_arg_adr;
-
   w[0] = head_word;
   w[1] = body_word;
 
-  clause = Pl_Scan_Dynamic_Pred(-1, 0, pred->dyn, word,
+  clause = Pl_Scan_Dynamic_Pred(-1, 0, pred->dyn, first_arg_adr,
 				Retract_Alt, DYN_ALT_FCT_FOR_TEST, 2, w);
   if (clause == NULL)
     return FALSE;
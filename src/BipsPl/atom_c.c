@@ -214,7 +214,7 @@ Pl_Atom_Concat_3(WamWord atom1_word, WamWord atom2_word, WamWord atom3_word)
     {
       A(0) = atom1_word;
       A(1) = atom2_word;
-      A(2) = (WamWord) patom3;
+      A(2) = Tag_ATM(patom3 - pl_atom_tbl); /* keep it visible to the atom GC */
       A(3) = (WamWord) (patom3->name + 1);
       Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(ATOM_CONCAT_ALT, 0), 4);
     }
@@ -244,7 +244,7 @@ Pl_Atom_Concat_Alt_0(void)
 
   atom1_word = AB(B, 0);
   atom2_word = AB(B, 1);
-  patom3 = (AtomInf *) AB(B, 2);
+  patom3 = pl_atom_tbl + UnTag_ATM(AB(B, 2));
   p = (char *) AB(B, 3);
 
   if (*p == '\0')
@@ -254,7 +254,7 @@ Pl_Atom_Concat_Alt_0(void)
 #if 0 /* the following data is unchanged */
       AB(B, 0) = atom1_word;
       AB(B, 1) = atom2_word;
-      AB(B, 2) = (WamWord) patom3;
+      AB(B, 2) = Tag_ATM(patom3 - pl_atom_tbl);
 #endif
       AB(B, 3) = (WamWord) (p + 1);
     }
@@ -268,7 +268,7 @@ Pl_Atom_Concat_Alt_0(void)
   if (!Pl_Get_Atom(Create_Malloc_Atom(str), atom1_word))
     return FALSE;
 
-  l = patom3->prop.length - l;
+  l = (int) strlen(p);		/* patom3 is stale if the atom table has grown */
   MALLOC_STR(l);
   strcpy(str, p);
   return Pl_Get_Atom(Create_Malloc_Atom(str), atom2_word);
@@ -404,8 +404,8 @@ Pl_Sub_Atom_5(WamWord atom_word, WamWord before_word, WamWord length_word,
       A(1) = length_word;
       A(2) = after_word;
       A(3) = sub_atom_word;
-      A(4) = (WamWord) patom;
-      A(5) = (WamWord) psub_atom;
+      A(4) = Tag_ATM(patom - pl_atom_tbl); /* keep them visible to the atom GC */
+      A(5) = (psub_atom) ? Tag_ATM(psub_atom - pl_atom_tbl) : NOT_A_WAM_WORD;
       A(6) = mask;
       A(7) = b1;
       A(8) = l1;
@@ -450,8 +450,8 @@ Pl_Sub_Atom_Alt_0(void)
   length_word = AB(B, 1);
   after_word = AB(B, 2);
   sub_atom_word = AB(B, 3);
-  patom = (AtomInf *) AB(B, 4);
-  psub_atom = (AtomInf *) AB(B, 5);
+  patom = pl_atom_tbl + UnTag_ATM(AB(B, 4));
+  psub_atom = (AB(B, 5) == NOT_A_WAM_WORD) ? NULL : pl_atom_tbl + UnTag_ATM(AB(B, 5));
   mask = AB(B, 6);
   b = AB(B, 7);
   l = AB(B, 8);
@@ -467,8 +467,8 @@ Pl_Sub_Atom_Alt_0(void)
       AB(B, 1) = length_word;
       AB(B, 2) = after_word;
       AB(B, 3) = sub_atom_word;
-      AB(B, 4) = (WamWord) patom;
-      AB(B, 5) = (WamWord) psub_atom;
+      AB(B, 4) = Tag_ATM(patom - pl_atom_tbl);
+      AB(B, 5) = (psub_atom) ? Tag_ATM(psub_atom - pl_atom_tbl) : NOT_A_WAM_WORD;
       AB(B, 6) = mask;
 #endif
       AB(B, 7) = b1;
@@ -565,7 +565,7 @@ Create_Malloc_Atom(char *str)
   int atom;
   PlULong nb = pl_nb_atom;
 
-  atom = Pl_Create_Atom(str);
+  atom = Pl_Create_Collectable_Atom(str, FALSE);
   if (nb == pl_nb_atom)
     Free(str);
   return atom;
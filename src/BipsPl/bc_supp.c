@@ -62,6 +62,12 @@
 #define MAX_OP                     100
 #define BC_BLOCK_SIZE              1024
 
+#define BC_PRED_CACHE_SIZE         (1 + WORD_SIZE / 32)	/* stamp + PredInf * */
+
+#if defined(__GNUC__) && !defined(NO_USE_THREADED_BC)
+#define USE_THREADED_BC		/* dispatch with computed gotos */
+#endif
+
 #define ERR_UNKNOWN_INSTRUCTION    "bc_supp: Unknown WAM instruction: %s"
 
 
@@ -138,7 +144,20 @@ typedef enum
   CUT_Y,
 
   SOFT_CUT_X,
-  SOFT_CUT_Y
+  SOFT_CUT_Y,
+
+				/* superinstructions (see Super_Inst) */
+  PUT_Y_VALUE_Y_VALUE,
+  GET_Y_VARIABLE_Y_VARIABLE,
+  ALLOCATE_GET_Y_VARIABLE,
+  ALLOCATE_GET_Y_VARIABLE_Y_VARIABLE,
+  GET_LIST_UNIFY_X_VARIABLE,
+  GET_LIST_UNIFY_X_VARIABLE_X_VARIABLE,
+  GET_LIST_UNIFY_X_VARIABLE_Y_VARIABLE,
+  GET_LIST_UNIFY_Y_VARIABLE,
+  DEALLOCATE_EXECUTE,
+
+  NB_BC_OP
 }
 BCCodOp;
 
@@ -165,6 +184,16 @@ BCWord;
 
 
 
+typedef struct
+{
+  BCCodOp op1;			/* head (maybe already a superinst)  */
+  BCCodOp op2;			/* next instruction                  */
+  BCCodOp super;		/* resulting superinstruction        */
+}
+BCSuperInst;
+
+
+
 typedef union
 {
   double d;
@@ -190,6 +219,20 @@ static int nb_op;
 static BCWord *bc;
 static BCWord *bc_sp;
 static int bc_nb_block;
+static int bc_head;		/* index in bc of the last head or -1   */
+
+	  /* derived from the most frequent pairs of a dynamic profile */
+static BCSuperInst super_tbl[] = {
+  {PUT_Y_VALUE, PUT_Y_VALUE, PUT_Y_VALUE_Y_VALUE},
+  {GET_Y_VARIABLE, GET_Y_VARIABLE, GET_Y_VARIABLE_Y_VARIABLE},
+  {ALLOCATE, GET_Y_VARIABLE, ALLOCATE_GET_Y_VARIABLE},
+  {ALLOCATE_GET_Y_VARIABLE, GET_Y_VARIABLE, ALLOCATE_GET_Y_VARIABLE_Y_VARIABLE},
+  {GET_LIST, UNIFY_X_VARIABLE, GET_LIST_UNIFY_X_VARIABLE},
+  {GET_LIST_UNIFY_X_VARIABLE, UNIFY_X_VARIABLE, GET_LIST_UNIFY_X_VARIABLE_X_VARIABLE},
+  {GET_LIST_UNIFY_X_VARIABLE, UNIFY_Y_VARIABLE, GET_LIST_UNIFY_X_VARIABLE_Y_VARIABLE},
+  {GET_LIST, UNIFY_Y_VARIABLE, GET_LIST_UNIFY_Y_VARIABLE},
+  {DEALLOCATE, EXECUTE, DEALLOCATE_EXECUTE}
+};
 
 static int atom_dynamic;
 static int atom_public;
@@ -218,6 +261,8 @@ static int Find_Inst_Code_Op(int inst);
 
 static int Compar_Inst_Code_Op(BCWord *w1, BCWord *w2);
 
+static int Super_Inst(int op1, int op2);
+
 static int BC_Arg_X_Or_Y(WamWord arg_word, int *op);
 
 static int BC_Arg_Func_Arity(WamWord arg_word, int *arity);
@@ -230,7 +275,7 @@ static WamCont BC_Emulate_Pred_Alt(DynCInf *clause, WamWord *w, Bool is_last);
 
 static WamCont BC_Emulate_Clause(DynCInf *clause);
 
-static WamCont BC_Emulate_Byte_Code(BCWord *bc);
+static WamCont BC_Emulate_Byte_Code(BCWord *bc, int clause_arity);
 
 static void Prep_Debug_Call(int func, int arity, int caller_func, int caller_arity);
 
@@ -465,6 +510,7 @@ void
 Pl_BC_Start_Emit_0(void)
 {
   bc_sp = bc;
+  bc_head = -1;
 }
 
 
@@ -477,7 +523,6 @@ Pl_BC_Start_Emit_0(void)
 void
 Pl_BC_Stop_Emit_0(void)
 {
-  int pl_byte_code_len;		/* could be declared in bc_supp.h if needed elsewhere */
   int i;
   
   pl_byte_code_len = (int) (bc_sp - bc);
@@ -539,6 +584,7 @@ Pl_BC_Emit_Inst_1(WamWord inst_word)
   PlLong l;
   int nb_word;
   C64To32 cv;
+  int super;
 
   PredInf *pred;
 
@@ -547,7 +593,7 @@ Pl_BC_Emit_Inst_1(WamWord inst_word)
   op = Find_Inst_Code_Op(func);
 
   size_bc = (int) (bc_sp - bc);
-  if (size_bc + 3 >= bc_nb_block * BC_BLOCK_SIZE)
+  if (size_bc + 4 + BC_PRED_CACHE_SIZE >= bc_nb_block * BC_BLOCK_SIZE)
     {
       bc_nb_block++;
       bc = (BCWord *) Realloc((char *) bc, bc_nb_block * BC_BLOCK_SIZE * sizeof(BCWord));
@@ -711,8 +757,9 @@ Pl_BC_Emit_Inst_1(WamWord inst_word)
 	}
       else
 	{
-	  nb_word = 3;
-	  w2 = (unsigned) Functor_Arity(caller_func, caller_arity);
+	  nb_word = 4;		/* f/n does not fit in 32 bits */
+	  w2 = caller_func;
+	  w3 = caller_arity;
 	}
       break;
     }
@@ -720,6 +767,16 @@ Pl_BC_Emit_Inst_1(WamWord inst_word)
 
   ASSEMBLE_INST(bc_sp, op, nb_word, w, w1, w2, w3);
 
+  if (op == CALL || op == EXECUTE)	/* room for the PredInf cache */
+    for (nb_word = 0; nb_word < BC_PRED_CACHE_SIZE; nb_word++)
+      (bc_sp++)->word = 0;
+
+		/* peephole: merge with the head into a superinstruction */
+  if (bc_head >= 0 && (super = Super_Inst(BC_Op(bc[bc_head]), op)) >= 0)
+    BC_Op(bc[bc_head]) = super;
+  else
+    bc_head = size_bc;
+
 
 #ifdef DEBUG
   DBGPRINTF("   op: %3d  bc: %10.10x  ", op, w.word);
@@ -778,6 +835,7 @@ Pl_BC_Emit_Inst_Execute_Native(int func, int arity, PlLong *codep)
   w3 = cv.u[1];
 #endif
 
+  bc_head = -1;
   ASSEMBLE_INST(bc_sp, EXECUTE_NATIVE, nb_word, w, w1, w2, w3);
 }
 
@@ -802,6 +860,31 @@ Pl_Emit_BC_Execute_Wrapper(int func, int arity, PlLong *codep)
 
 
 
+/*-------------------------------------------------------------------------*
+ * SUPER_INST                                                              *
+ *                                                                         *
+ * Returns the superinstruction for op1 (the head, possibly already a      *
+ * superinstruction) followed by op2, or -1. The words of the instructions *
+ * are kept as is, only the code-op of the head changes: the emulator      *
+ * then runs them without dispatching between them. This is safe since    *
+ * a clause has no jump inside (only the instruction after a CALL is a     *
+ * continuation and CALL is never a head).                                 *
+ *-------------------------------------------------------------------------*/
+static int
+Super_Inst(int op1, int op2)
+{
+  int i;
+
+  for (i = 0; i < (int) (sizeof(super_tbl) / sizeof(super_tbl[0])); i++)
+    if (super_tbl[i].op1 == op1 && super_tbl[i].op2 == op2)
+      return super_tbl[i].super;
+
+  return -1;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * BC_ARG_X_OR_Y                                                           *
  *                                                                         *
@@ -908,20 +991,30 @@ Pl_BC_Emulate_Pred(int func, DynPInf *dyn)
 {
   DynCInf *clause;
   WamCont codep;
+  WamWord *b = NULL;		/* init for the compiler */
   int arity;
 
   while (dyn)
     {
       arity = dyn->arity;
+      if (pl_prof_on)		/* before the cut register is read */
+	{
+	  Pl_Prof_Call(Pl_Prof_BC_Counters(dyn));
+	  b = B;
+	}
+
       A(arity) = Pl_Get_Current_Choice();	/* init cut register */
       A(arity + 1) = debug_call;
 
-      clause = Pl_Scan_Dynamic_Pred(func, arity, dyn, A(0),
+      clause = Pl_Scan_Dynamic_Pred(func, arity, dyn, &A(0),
 				    (ScanFct) BC_Emulate_Pred_Alt,
 				    DYN_ALT_FCT_FOR_JUMP, arity + 2, &A(0));
       if (clause == NULL)
 	break;			/* fail */
 
+      if (pl_prof_on && B != b)
+	Pl_Prof_BC_Counters(dyn)[PROF_CHOICE]++;
+
       codep = BC_Emulate_Clause(clause);
       if (codep)
 	return (codep);
@@ -987,8 +1080,9 @@ BC_Emulate_Clause(DynCInf *clause)
    * To fix the issue: either do not use BC if debug is active (use interpreted code - see below)
    * or do not call the debugger inside EXECUTE_NATIVE (and CALL_NATIVE for consistency ?)
    */
-  if (bc && !debug_call)	/* emulated code (see above for test !debug_call) */
-    return BC_Emulate_Byte_Code(bc);
+  if (bc && !(debug_call && pl_debug_call_code != NULL))	/* emulated code (see above) */
+    return BC_Emulate_Byte_Code(bc, clause->dyn->arity);
+
 				/* interpreted code */
   Pl_Copy_Clause_To_Heap(clause, &head_word, &body_word);
 
@@ -1007,12 +1101,35 @@ BC_Emulate_Clause(DynCInf *clause)
 
 
 
+#ifdef USE_THREADED_BC
+
+#define BC_Case(op)                case op: lbl_##op
+#define BC_Label(op)               [op] = &&lbl_##op
+#define BC_Next                    w = *bc++; goto *bc_label[BC_Op(w)]
+#define BC_Goto(op)                goto lbl_##op
+
+#else
+
+#define BC_Case(op)                case op
+#define BC_Next                    w = *bc++; goto bc_switch
+#define BC_Goto(op)                goto bc_switch
+
+#endif
+
+
+
+
 /*-------------------------------------------------------------------------*
  * BC_EMULATE_BYTE_CODE                                                    *
  *                                                                         *
+ * With gcc each instruction dispatches the next one itself through a      *
+ * table of label addresses (one indirect jump per instruction, better     *
+ * predicted than the single jump of the switch). Else the switch is used. *
+ * A superinstruction runs its instructions in sequence: w = *bc++ reads   *
+ * the next one (whose code-op is ignored).                                *
  *-------------------------------------------------------------------------*/
 static WamCont
-BC_Emulate_Byte_Code(BCWord *bc)
+BC_Emulate_Byte_Code(BCWord *bc, int clause_arity)
 {
   BCWord w;
   int x0, x, y;
@@ -1022,59 +1139,109 @@ BC_Emulate_Byte_Code(BCWord *bc)
   int func, arity;
   PredInf *pred;
   C64To32 cv;
+#ifdef USE_THREADED_BC
+  static void *bc_label[NB_BC_OP] = {
+    BC_Label(GET_X_VARIABLE), BC_Label(GET_Y_VARIABLE),
+    BC_Label(GET_X_VALUE), BC_Label(GET_Y_VALUE),
+    BC_Label(GET_ATOM), BC_Label(GET_ATOM_BIG),
+    BC_Label(GET_INTEGER), BC_Label(GET_INTEGER_BIG),
+    BC_Label(GET_FLOAT), BC_Label(GET_NIL),
+    BC_Label(GET_LIST), BC_Label(GET_STRUCTURE),
+
+    BC_Label(PUT_X_VARIABLE), BC_Label(PUT_Y_VARIABLE),
+    BC_Label(PUT_VOID), BC_Label(PUT_X_VALUE),
+    BC_Label(PUT_Y_VALUE), BC_Label(PUT_Y_UNSAFE_VALUE),
+    BC_Label(PUT_ATOM), BC_Label(PUT_ATOM_BIG),
+    BC_Label(PUT_INTEGER), BC_Label(PUT_INTEGER_BIG),
+    BC_Label(PUT_FLOAT), BC_Label(PUT_NIL),
+    BC_Label(PUT_LIST), BC_Label(PUT_STRUCTURE),
+
+    BC_Label(MATH_LOAD_X_VALUE), BC_Label(MATH_LOAD_Y_VALUE),
+
+    BC_Label(UNIFY_X_VARIABLE), BC_Label(UNIFY_Y_VARIABLE),
+    BC_Label(UNIFY_VOID), BC_Label(UNIFY_X_VALUE),
+    BC_Label(UNIFY_Y_VALUE), BC_Label(UNIFY_X_LOCAL_VALUE),
+    BC_Label(UNIFY_Y_LOCAL_VALUE), BC_Label(UNIFY_ATOM),
+    BC_Label(UNIFY_ATOM_BIG), BC_Label(UNIFY_INTEGER),
+    BC_Label(UNIFY_INTEGER_BIG), BC_Label(UNIFY_NIL),
+    BC_Label(UNIFY_LIST), BC_Label(UNIFY_STRUCTURE),
+
+    BC_Label(ALLOCATE), BC_Label(DEALLOCATE),
+
+    BC_Label(CALL), BC_Label(CALL_NATIVE),
+    BC_Label(EXECUTE), BC_Label(EXECUTE_NATIVE),
+    BC_Label(PROCEED), BC_Label(FAIL),
+
+    BC_Label(GET_CURRENT_CHOICE_X), BC_Label(GET_CURRENT_CHOICE_Y),
+    BC_Label(CUT_X), BC_Label(CUT_Y),
+    BC_Label(SOFT_CUT_X), BC_Label(SOFT_CUT_Y),
+
+    BC_Label(PUT_Y_VALUE_Y_VALUE),
+    BC_Label(GET_Y_VARIABLE_Y_VARIABLE),
+    BC_Label(ALLOCATE_GET_Y_VARIABLE),
+    BC_Label(ALLOCATE_GET_Y_VARIABLE_Y_VARIABLE),
+    BC_Label(GET_LIST_UNIFY_X_VARIABLE),
+    BC_Label(GET_LIST_UNIFY_X_VARIABLE_X_VARIABLE),
+    BC_Label(GET_LIST_UNIFY_X_VARIABLE_Y_VARIABLE),
+    BC_Label(GET_LIST_UNIFY_Y_VARIABLE),
+    BC_Label(DEALLOCATE_EXECUTE)
+  };
+#endif
 
 
-bc_loop:
   w = *bc++;
+#ifndef USE_THREADED_BC
+bc_switch:
+#endif
   switch (BC_Op(w))
     {
-    case GET_X_VARIABLE:
+    BC_Case(GET_X_VARIABLE):
       x0 = BC1_X0(w);
       x = BC1_XY(w);
       X(x) = X(x0);
-      goto bc_loop;
+      BC_Next;
 
-    case GET_Y_VARIABLE:
+    BC_Case(GET_Y_VARIABLE):
       x0 = BC1_X0(w);
       y = BC1_XY(w);
       Y(E, y) = X(x0);
-      goto bc_loop;
+      BC_Next;
 
-    case GET_X_VALUE:
+    BC_Case(GET_X_VALUE):
       x0 = BC1_X0(w);
       x = BC1_XY(w);
       if (!Pl_Unify(X(x), X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case GET_Y_VALUE:
+    BC_Case(GET_Y_VALUE):
       x0 = BC1_X0(w);
       y = BC1_XY(w);
       if (!Pl_Unify(Y(E, y), X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case GET_ATOM:
+    BC_Case(GET_ATOM):
       x0 = BC1_X0(w);
       if (!Pl_Get_Atom(BC1_Atom(w), X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case GET_ATOM_BIG:
+    BC_Case(GET_ATOM_BIG):
       x0 = BC1_X0(w);
       w1 = bc->word;
       bc++;
       if (!Pl_Get_Atom(w1, X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case GET_INTEGER:
+    BC_Case(GET_INTEGER):
       x0 = BC1_X0(w);
       if (!Pl_Get_Integer(BC1_Int(w), X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case GET_INTEGER_BIG:
+    BC_Case(GET_INTEGER_BIG):
       x0 = BC1_X0(w);
 #if WORD_SIZE == 32
       l = bc->word;
@@ -1088,9 +1255,9 @@ bc_loop:
 #endif
       if (!Pl_Get_Integer(l, X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case GET_FLOAT:
+    BC_Case(GET_FLOAT):
       x0 = BC1_X0(w);
       cv.u[0] = bc->word;
       bc++;
@@ -1098,83 +1265,83 @@ bc_loop:
       bc++;
       if (!Pl_Get_Float(cv.d, X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case GET_NIL:
+    BC_Case(GET_NIL):
       x0 = BC1_X0(w);
       if (!Pl_Get_Nil(X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case GET_LIST:
+    BC_Case(GET_LIST):
       x0 = BC1_X0(w);
       if (!Pl_Get_List(X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case GET_STRUCTURE:
+    BC_Case(GET_STRUCTURE):
       x0 = BC1_X0(w);
       arity = BC1_Arity(w);
       func = bc->word;
       bc++;
       if (!Pl_Get_Structure(func, arity, X(x0)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
 
-    case PUT_X_VARIABLE:
+    BC_Case(PUT_X_VARIABLE):
       x0 = BC1_X0(w);
       x = BC1_XY(w);
       X(x) = X(x0) = Pl_Put_X_Variable();
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_Y_VARIABLE:
+    BC_Case(PUT_Y_VARIABLE):
       x0 = BC1_X0(w);
       y = BC1_XY(w);
       X(x0) = Pl_Put_Y_Variable(&Y(E, y));
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_VOID:
+    BC_Case(PUT_VOID):
       x0 = BC1_X0(w);
       X(x0) = Pl_Put_X_Variable();
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_X_VALUE:
+    BC_Case(PUT_X_VALUE):
       x0 = BC1_X0(w);
       x = BC1_XY(w);
       X(x0) = X(x);
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_Y_VALUE:
+    BC_Case(PUT_Y_VALUE):
       x0 = BC1_X0(w);
       y = BC1_XY(w);
       X(x0) = Y(E, y);
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_Y_UNSAFE_VALUE:
+    BC_Case(PUT_Y_UNSAFE_VALUE):
       x0 = BC1_X0(w);
       y = BC1_XY(w);
       X(x0) = Pl_Put_Unsafe_Value(Y(E, y));
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_ATOM:
+    BC_Case(PUT_ATOM):
       x0 = BC1_X0(w);
       X(x0) = Pl_Put_Atom(BC1_Atom(w));
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_ATOM_BIG:
+    BC_Case(PUT_ATOM_BIG):
       x0 = BC1_X0(w);
       w1 = bc->word;
       bc++;
       X(x0) = Pl_Put_Atom(w1);
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_INTEGER:
+    BC_Case(PUT_INTEGER):
       x0 = BC1_X0(w);
       X(x0) = Pl_Put_Integer(BC1_Int(w));
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_INTEGER_BIG:
+    BC_Case(PUT_INTEGER_BIG):
       x0 = BC1_X0(w);
 #if WORD_SIZE == 32
       l = bc->word;
@@ -1187,34 +1354,34 @@ bc_loop:
       l = cv.l;
 #endif
       X(x0) = Pl_Put_Integer(l);
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_FLOAT:
+    BC_Case(PUT_FLOAT):
       x0 = BC1_X0(w);
       cv.u[0] = bc->word;
       bc++;
       cv.u[1] = bc->word;
       bc++;
       X(x0) = Pl_Put_Float(cv.d);
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_NIL:
+    BC_Case(PUT_NIL):
       x0 = BC1_X0(w);
       X(x0) = NIL_WORD;		/* faster than Pl_Put_Nil() */
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_LIST:
+    BC_Case(PUT_LIST):
       x0 = BC1_X0(w);
       X(x0) = Pl_Put_List();
-      goto bc_loop;
+      BC_Next;
 
-    case PUT_STRUCTURE:
+    BC_Case(PUT_STRUCTURE):
       x0 = BC1_X0(w);
       arity = BC1_Arity(w);
       func = bc->word;
       bc++;
       X(x0) = Pl_Put_Structure(func, arity);
-      goto bc_loop;
+      BC_Next;
 /*
     case PUT_META_TERM:
       x0 = BC1_X0(w);
@@ -1222,76 +1389,76 @@ bc_loop:
       module = bc->word;
       bc++;
       X(x) = Pl_Put_Meta_Term(module, X(x0));
-      goto bc_loop;
+      BC_Next;
 */
-    case MATH_LOAD_X_VALUE:
+    BC_Case(MATH_LOAD_X_VALUE):
       x0 = BC1_X0(w);
       x = BC1_XY(w);
       Pl_Math_Load_Value(X(x), &X(x0));
-      goto bc_loop;
+      BC_Next;
 
-    case MATH_LOAD_Y_VALUE:
+    BC_Case(MATH_LOAD_Y_VALUE):
       x0 = BC1_X0(w);
       y = BC1_XY(w);
       Pl_Math_Load_Value(Y(E, y), &X(x0));
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_X_VARIABLE:
+    BC_Case(UNIFY_X_VARIABLE):
       x = BC2_XY(w);
       X(x) = Pl_Unify_Variable();
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_Y_VARIABLE:
+    BC_Case(UNIFY_Y_VARIABLE):
       y = BC2_XY(w);
       Y(E, y) = Pl_Unify_Variable();
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_VOID:
+    BC_Case(UNIFY_VOID):
       Pl_Unify_Void(BC2_Int(w));
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_X_VALUE:
+    BC_Case(UNIFY_X_VALUE):
       x = BC2_XY(w);
       if (!Pl_Unify_Value(X(x)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_Y_VALUE:
+    BC_Case(UNIFY_Y_VALUE):
       y = BC2_XY(w);
       if (!Pl_Unify_Value(Y(E, y)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_X_LOCAL_VALUE:
+    BC_Case(UNIFY_X_LOCAL_VALUE):
       x = BC2_XY(w);
       if (!Pl_Unify_Local_Value(X(x)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_Y_LOCAL_VALUE:
+    BC_Case(UNIFY_Y_LOCAL_VALUE):
       y = BC2_XY(w);
       if (!Pl_Unify_Local_Value(Y(E, y)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_ATOM:
+    BC_Case(UNIFY_ATOM):
       if (!Pl_Unify_Atom(BC2_Atom(w)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_ATOM_BIG:
+    BC_Case(UNIFY_ATOM_BIG):
       w1 = bc->word;
       bc++;
       if (!Pl_Unify_Atom(w1))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_INTEGER:
+    BC_Case(UNIFY_INTEGER):
       if (!Pl_Unify_Integer(BC2_Int(w)))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_INTEGER_BIG:
+    BC_Case(UNIFY_INTEGER_BIG):
 #if WORD_SIZE == 32
       l = bc->word;
       bc++;
@@ -1304,56 +1471,75 @@ bc_loop:
 #endif
       if (!Pl_Unify_Integer(l))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_NIL:
+    BC_Case(UNIFY_NIL):
       if (!Pl_Unify_Nil())
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_LIST:
+    BC_Case(UNIFY_LIST):
       if (!Pl_Unify_List())
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case UNIFY_STRUCTURE:
+    BC_Case(UNIFY_STRUCTURE):
       arity = BC2_Arity(w);
       func = bc->word;
       bc++;
       if (!Pl_Unify_Structure(func, arity))
 	goto fail;
-      goto bc_loop;
+      BC_Next;
 
-    case ALLOCATE:
-      Pl_Allocate(BC2_Int(w));
-      goto bc_loop;
+    BC_Case(ALLOCATE):
+      Pl_Allocate(BC2_Int(w), clause_arity + 1); /* +1: cut register */
+      BC_Next;
 
-    case DEALLOCATE:
+    BC_Case(DEALLOCATE):
       Pl_Deallocate();
-      goto bc_loop;
+      BC_Next;
 
-    case CALL:
-      BCI = (WamWord) (bc + 2) | debug_call;	/* use low bit of adr */
+    BC_Case(CALL):
+      BCI = (WamWord) (bc + 3 + BC_PRED_CACHE_SIZE) | debug_call;	/* use low bit of adr */
       CP = Adjust_CP(Prolog_Predicate(BC_EMULATE_CONT, 0));
-    case EXECUTE:
+    BC_Case(EXECUTE):
       arity = BC2_Arity(w);
       func = bc->word;
       bc++;
       if (pl_debug_call_code != NULL && debug_call &&
 	  Pl_Detect_If_Aux_Name(func) == NULL)
 	{
-	  w1 = bc->word;
-	  caller_func = Functor_Of(w1);
-	  caller_arity = Arity_Of(w1);
+	  caller_func = bc[0].word;
+	  caller_arity = bc[1].word;
 	  Prep_Debug_Call(func, arity, caller_func, caller_arity);
 	  return pl_debug_call_code;
 	}
 
-      if ((pred = Pl_Lookup_Pred(func, arity)) == NULL)
+      if (bc[2].word == pl_pred_stamp)	/* PredInf cached by a previous call */
+	{
+#if WORD_SIZE == 32
+	  pred = (PredInf *) (bc[3].word);
+#else
+	  cv.u[0] = bc[3].word;
+	  cv.u[1] = bc[4].word;
+	  pred = (PredInf *) (cv.p);
+#endif
+	}
+      else if ((pred = Pl_Lookup_Pred(func, arity)) != NULL)
 	{
-	  w1 = bc->word;
-	  caller_func = Functor_Of(w1);
-	  caller_arity = Arity_Of(w1);
+	  bc[2].word = pl_pred_stamp;
+#if WORD_SIZE == 32
+	  bc[3].word = (unsigned) pred;
+#else
+	  cv.p = (int *) pred;
+	  bc[3].word = cv.u[0];
+	  bc[4].word = cv.u[1];
+#endif
+	}
+      else
+	{
+	  caller_func = bc[0].word;
+	  caller_arity = bc[1].word;
 	  Pl_Set_Bip_Name_2(Tag_ATM(caller_func),
 			 Tag_INT(caller_arity));
 	  Pl_Unknown_Pred_Error(func, arity);
@@ -1367,7 +1553,7 @@ bc_loop:
       glob_dyn = pred->dyn;
       return NULL;		/* to then call BC_Emulate_Pred */
 
-    case CALL_NATIVE:
+    BC_Case(CALL_NATIVE):
       arity = BC2_Arity(w);
       func = bc->word;
       bc++;
@@ -1390,7 +1576,7 @@ bc_loop:
 	}
       return codep;
 
-    case EXECUTE_NATIVE:
+    BC_Case(EXECUTE_NATIVE):
       arity = BC2_Arity(w);
       func = bc->word;
       bc++;
@@ -1412,10 +1598,10 @@ bc_loop:
 	}
       return codep;
 
-    case PROCEED:
+    BC_Case(PROCEED):
       return UnAdjust_CP(CP);
 
-    case FAIL:
+    BC_Case(FAIL):
       if (pl_debug_call_code != NULL && debug_call)
 	{			/* invoke the debugger which will then call fail/0 */
 	  Prep_Debug_Call(atom_fail, 0, 0, 0);
@@ -1423,35 +1609,99 @@ bc_loop:
 	}
       goto fail;
 
-    case GET_CURRENT_CHOICE_X:
+    BC_Case(GET_CURRENT_CHOICE_X):
       x = BC2_XY(w);
       X(x) = Pl_Get_Current_Choice();
-      goto bc_loop;
+      BC_Next;
 
-    case GET_CURRENT_CHOICE_Y:
+    BC_Case(GET_CURRENT_CHOICE_Y):
       y = BC2_XY(w);
       Y(E, y) = Pl_Get_Current_Choice();
-      goto bc_loop;
+      BC_Next;
 
-    case CUT_X:
+    BC_Case(CUT_X):
       x = BC2_XY(w);
       Pl_Cut(X(x));
-      goto bc_loop;
+      BC_Next;
 
-    case CUT_Y:
+    BC_Case(CUT_Y):
       y = BC2_XY(w);
       Pl_Cut(Y(E, y));
-      goto bc_loop;
+      BC_Next;
 
-    case SOFT_CUT_X:
+    BC_Case(SOFT_CUT_X):
       x = BC2_XY(w);
       Pl_Soft_Cut(X(x));
-      goto bc_loop;
+      BC_Next;
 
-    case SOFT_CUT_Y:
+    BC_Case(SOFT_CUT_Y):
       y = BC2_XY(w);
       Pl_Soft_Cut(Y(E, y));
-      goto bc_loop;
+      BC_Next;
+
+
+    BC_Case(PUT_Y_VALUE_Y_VALUE):
+      X(BC1_X0(w)) = Y(E, BC1_XY(w));
+      w = *bc++;
+      X(BC1_X0(w)) = Y(E, BC1_XY(w));
+      BC_Next;
+
+    BC_Case(GET_Y_VARIABLE_Y_VARIABLE):
+      Y(E, BC1_XY(w)) = X(BC1_X0(w));
+      w = *bc++;
+      Y(E, BC1_XY(w)) = X(BC1_X0(w));
+      BC_Next;
+
+    BC_Case(ALLOCATE_GET_Y_VARIABLE):
+      Pl_Allocate(BC2_Int(w), clause_arity + 1);
+      w = *bc++;
+      Y(E, BC1_XY(w)) = X(BC1_X0(w));
+      BC_Next;
+
+    BC_Case(ALLOCATE_GET_Y_VARIABLE_Y_VARIABLE):
+      Pl_Allocate(BC2_Int(w), clause_arity + 1);
+      w = *bc++;
+      Y(E, BC1_XY(w)) = X(BC1_X0(w));
+      w = *bc++;
+      Y(E, BC1_XY(w)) = X(BC1_X0(w));
+      BC_Next;
+
+    BC_Case(GET_LIST_UNIFY_X_VARIABLE):
+      if (!Pl_Get_List(X(BC1_X0(w))))
+	goto fail;
+      w = *bc++;
+      X(BC2_XY(w)) = Pl_Unify_Variable();
+      BC_Next;
+
+    BC_Case(GET_LIST_UNIFY_X_VARIABLE_X_VARIABLE):
+      if (!Pl_Get_List(X(BC1_X0(w))))
+	goto fail;
+      w = *bc++;
+      X(BC2_XY(w)) = Pl_Unify_Variable();
+      w = *bc++;
+      X(BC2_XY(w)) = Pl_Unify_Variable();
+      BC_Next;
+
+    BC_Case(GET_LIST_UNIFY_X_VARIABLE_Y_VARIABLE):
+      if (!Pl_Get_List(X(BC1_X0(w))))
+	goto fail;
+      w = *bc++;
+      X(BC2_XY(w)) = Pl_Unify_Variable();
+      w = *bc++;
+      Y(E, BC2_XY(w)) = Pl_Unify_Variable();
+      BC_Next;
+
+    BC_Case(GET_LIST_UNIFY_Y_VARIABLE):
+      if (!Pl_Get_List(X(BC1_X0(w))))
+	goto fail;
+      w = *bc++;
+      Y(E, BC2_XY(w)) = Pl_Unify_Variable();
+      BC_Next;
+
+    BC_Case(DEALLOCATE_EXECUTE):
+      Pl_Deallocate();
+      w = *bc++;
+      BC_Goto(EXECUTE);
     }
 
 fail:
@@ -1474,7 +1724,7 @@ Pl_BC_Emulate_Cont_0(void)
   debug_call = BCI & 1;
   bc = (BCWord *) ((BCI >> 1) << 1);
 
-  codep = BC_Emulate_Byte_Code(bc);
+  codep = BC_Emulate_Byte_Code(bc, 0);	/* no allocate after a call */
   return (codep) ? codep : Pl_BC_Emulate_Pred(glob_func, glob_dyn);
 }
 
@@ -53,6 +53,7 @@
 				/* inclusion of bc_supp.o if not needed    */
 				/* (dynam_supp.c uses pl_byte_code)        */
 unsigned *pl_byte_code;
+int pl_byte_code_len;
 
 
 
@@ -53,3 +53,4 @@
 #include "dynam_supp.h"
 #include "callinf_supp.h"
 #include "bc_supp.h"
+#include "prof_supp.h"
@@ -68,12 +68,13 @@ consult(File, Options) :-
 	'$add_args_for_flags'([bf(0 = 0, show_information = informational, '--compile-msg'),
 			       f(suspicious_warning = off, '--no-susp-warn'),
 			       f(singleton_warning = off, '--no-singl-warn')], Pl2WamArgs1),
+	'$sys_var_get_bit'(0, 1, UseCache),
 	(   atom(File), File \== [] ->
 	    LFile = [File]
 	;   LFile = File
 	),
 	member(File1, LFile),
-	\+ '$consult1'(File1, Pl2WamArgs, Arity),
+	\+ '$consult1'(File1, Pl2WamArgs, UseCache, Arity),
 	!,
 	fail.
 
@@ -84,9 +85,9 @@ consult(File, Options) :-
 
           % option mask in sys_var[0]:
           %
-          %  b0
-          %  0/1
-          % quiet
+          %    b1    b0
+          %   0/1   0/1
+          %  cache quiet
 
 '$set_consult_defaults' :-
 	'$sys_var_write'(0, 0).
@@ -118,6 +119,12 @@ consult(File, Options) :-
 	'$check_nonvar'(X),
 	atom(X).
 
+'$get_consult_options2'(cache(false), Pl2WamArgs, Pl2WamArgs) :-
+	'$sys_var_reset_bit'(0, 1).
+
+'$get_consult_options2'(cache(true), Pl2WamArgs, Pl2WamArgs) :-
+	'$sys_var_set_bit'(0, 1).
+
 '$get_consult_options2'(X, _, _) :-
 	'$pl_err_domain'(consult_option, X).
 
@@ -141,7 +148,7 @@ consult(File, Options) :-
 
 
 
-'$consult1'(File, Pl2WamArgs1, Arity) :-
+'$consult1'(File, Pl2WamArgs1, UseCache, Arity) :-
 	'$call_c_test'('Pl_Prolog_File_Name_2'(File, File1)),
 	(   File1 = user ->
 	    File2 = File1
@@ -154,18 +161,14 @@ consult(File, Options) :-
 	),
 	PipedConsult = piped,	% can be spawn, exec (Prolog) or piped (see consult_c.c)
 	temporary_file('', gplc, TmpFile),
-	atom_concat(TmpFile, '.wbc', TmpByteCodeFile),
 	atom_concat(TmpFile, '.pl', TmpIncludeFile),
 	'$create_include_file'(PipedConsult, TmpIncludeFile),
-	Pl2WamArgs = ['-w', File2, '--include', TmpIncludeFile, '-o', TmpByteCodeFile|Pl2WamArgs1],
-%	Pl2WamArgs = ['-w', File2, '-o', TmpByteCodeFile|Pl2WamArgs1], % without --include (for debug)
+	Pl2WamArgs = ['-w', File2, '--include', TmpIncludeFile|Pl2WamArgs1],
+%	Pl2WamArgs = ['-w', File2|Pl2WamArgs1], % without --include (for debug)
 	set_bip_name(consult, Arity),	
-	(   '$consult2'(PipedConsult, Pl2WamArgs) ->
-	    '$load_file'(TmpByteCodeFile),
-	    unlink(TmpByteCodeFile),
+	(   '$consult_cache'(UseCache, File2, Pl2WamArgs, PipedConsult, TmpFile) ->
 	    unlink(TmpIncludeFile)
-	;   unlink(TmpByteCodeFile),
-	    unlink(TmpIncludeFile),
+	;   unlink(TmpIncludeFile),
 	    format(top_level_output, 'compilation failed~n', []),
 	    fail
 	).
@@ -235,16 +238,87 @@ write_default_include_file(_).
 
 
 
-'$consult2'(spawn, Pl2WamArgs) :-
+	% cache(true): the byte-code is loaded from (or saved to) a binary cache
+	% file next to the source, used while the source is unchanged (see consult_c.c)
+
+'$consult_cache'(1, PlFile, Pl2WamArgs, PipedConsult, TmpFile) :-
+	PlFile \== user, !,
+	'$consult_cache_file'(PlFile, CacheFile),
+	(   '$call_c_test'('Pl_Consult_Cache_Open_Read_4'(CacheFile, PlFile, Pl2WamArgs, Cache)) ->
+	    (   memberchk('--compile-msg', Pl2WamArgs) ->
+	        format(top_level_output, '~a loaded from byte-code cache ~a~n', [PlFile, CacheFile])
+	    ;   true
+	    ),
+	    catch('$load_stream'('$bc_cache_in'(Cache)), Err, '$consult_cache_abort'(read, Cache, Err)),
+	    '$call_c'('Pl_Consult_Cache_Close_Read_1'(Cache))
+	;   '$call_c_test'('Pl_Consult_Cache_Open_Write_4'(CacheFile, PlFile, Pl2WamArgs, Cache)) ->
+	    (   catch('$consult2'(PipedConsult, Pl2WamArgs, TmpFile, Cache), Err,
+		      '$consult_cache_abort'(write, Cache, Err)) ->
+	        '$call_c'('Pl_Consult_Cache_Close_Write_2'(Cache, true))
+	    ;   '$call_c'('Pl_Consult_Cache_Close_Write_2'(Cache, false)),
+	        fail
+	    )
+	;   '$consult2'(PipedConsult, Pl2WamArgs, TmpFile, none)
+	).
+
+'$consult_cache'(_, _, Pl2WamArgs, PipedConsult, TmpFile) :-
+	'$consult2'(PipedConsult, Pl2WamArgs, TmpFile, none).
+
+
+
+
+'$consult_cache_file'(PlFile, CacheFile) :-
+	decompose_file_name(PlFile, Dir, Prefix, _),
+	atom_concat(Dir, Prefix, CacheFile1),
+	atom_concat(CacheFile1, '.wbo', CacheFile).
+
+
+
+
+'$consult_cache_abort'(read, Cache, Err) :-
+	'$call_c'('Pl_Consult_Cache_Close_Read_1'(Cache)),
+	throw(Err).
+
+'$consult_cache_abort'(write, Cache, Err) :-
+	'$call_c'('Pl_Consult_Cache_Close_Write_2'(Cache, false)),
+	throw(Err).
+
+
+
+
+	% piped: the byte-code produced by pl2wam is kept in memory (no .wbc
+	% file) and only loaded if the compilation succeeds (see consult_c.c)
+
+'$consult2'(piped, Pl2WamArgs, _, Cache) :-
+	!,
+	'$call_c_test'('Pl_Consult_Open_2'(['--pipe'|Pl2WamArgs], Stm)),
+	'$load_source'('$stream'(Stm), Cache, Src),
+	catch('$load_stream'(Src), Err, '$consult_abort'(Stm, Err)),
+	'$call_c'('Pl_Consult_Close_1'(Stm)).
+
+'$consult2'(SpawnOrExec, Pl2WamArgs, TmpFile, Cache) :-
+	atom_concat(TmpFile, '.wbc', TmpByteCodeFile),
+	(   '$consult3'(SpawnOrExec, ['-o', TmpByteCodeFile|Pl2WamArgs]) ->
+	    '$load_file'(TmpByteCodeFile, Cache),
+	    unlink(TmpByteCodeFile)
+	;   unlink(TmpByteCodeFile),
+	    fail
+	).
+
+
+'$consult3'(spawn, Pl2WamArgs) :-
 	spawn(pl2wam, Pl2WamArgs, 0).
 
-'$consult2'(exec, Pl2WamArgs) :-
+'$consult3'(exec, Pl2WamArgs) :-
 	'$list_to_atom'([pl2wam|Pl2WamArgs], Cmd),
 	exec(Cmd, top_level_input, top_level_output, top_level_output, Pid),
 	wait(Pid, 0).
 
-'$consult2'(piped, Pl2WamArgs) :-
-	'$call_c_test'('Pl_Consult_1'(Pl2WamArgs)).
+
+'$consult_abort'(Stm, Err) :-
+	'$call_c'('Pl_Consult_Close_1'(Stm)),
+	throw(Err).
+
 
 
 '$list_to_atom'(List, Atom) :-
@@ -259,15 +333,50 @@ write_default_include_file(_).
 
 
 '$load_file'(BCFile) :-
+	'$load_file'(BCFile, none).
+
+
+'$load_file'(BCFile, Cache) :-
 	open(BCFile, read, Stream),
+	'$load_source'(Stream, Cache, Src),
+	'$load_stream'(Src),
+	close(Stream).
+
+
+
+
+	% a byte-code source is a stream, '$bc_cache_in'(Cache) or
+	% '$bc_cache_out'(Stream, Cache) (a stream whose terms are saved to Cache)
+
+'$load_source'(Stream, none, Stream) :-
+	!.
+
+'$load_source'(Stream, Cache, '$bc_cache_out'(Stream, Cache)).
+
+
+'$load_read'('$bc_cache_in'(Cache), T) :-
+	!,
+	'$call_c_test'('Pl_Consult_Cache_Read_2'(Cache, T)).
+
+'$load_read'('$bc_cache_out'(Stream, Cache), T) :-
+	!,
+	read(Stream, T),
+	'$call_c'('Pl_Consult_Cache_Write_2'(Cache, T)).
+
+'$load_read'(Stream, T) :-
+	read(Stream, T).
+
+
+
+
+'$load_stream'(Src) :-
 	repeat,
-	read(Stream, P),
+	'$load_read'(Src, P),
 	(   P = end_of_file ->
 	    !
-	;   '$load_pred'(P, Stream),
+	;   '$load_pred'(P, Src),
 	    fail
-	),
-	close(Stream).
+	).
 
 
 
@@ -283,7 +392,7 @@ write_default_include_file(_).
 	).
 
 
-'$load_pred'(predicate(PI, PlLine, StaDyn, PubPriv, MonoMulti, UsBplBfd, NbCl), Stream) :-
+'$load_pred'(predicate(PI, PlLine, StaDyn, PubPriv, MonoMulti, UsBplBfd, NbCl), Src) :-
 	PI = Pred / N,
 	g_read('$pl_file', PlFile),
 	'$check_pred_type'(Pred, N, PlFile, PlLine),
@@ -300,7 +409,7 @@ write_default_include_file(_).
 	g_assign('$ctr', Ctr1),
 	(   Ctr = NbCl ->
 	    true
-	;   read(Stream, clause(Cl, WamCl)),
+	;   '$load_read'(Src, clause(Cl, WamCl)),
 	    '$add_clause_term_and_bc'(Cl, PlFile, WamCl),
 	    fail
 	), !.
@@ -36,8 +36,25 @@
  *-------------------------------------------------------------------------*/
 
 
+#include <stdio.h>
+#include <string.h>
 #include <errno.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+
+#include "gp_config.h"
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+#if defined(HAVE_MMAP) && !defined(_WIN32)
+#include <sys/mman.h>
+#define USE_MMAP_FOR_CACHE
+#endif
 
 #include "engine_pl.h"
 #include "bips_pl.h"
@@ -47,40 +64,191 @@
  * Constants                       *
  *---------------------------------*/
 
+#define CACHE_MAGIC                "GPWBO\n\032"
+#define CACHE_FORMAT               1
+
+#define CACHE_TERM_VAR             0	/* term encoding (1st byte) */
+#define CACHE_TERM_NEW_VAR         1
+#define CACHE_TERM_ATM             2
+#define CACHE_TERM_INT             3
+#define CACHE_TERM_FLT             4
+#define CACHE_TERM_LST             5
+#define CACHE_TERM_STC             6
+#define CACHE_TERM_END             7
+
+#define HASH_FILE_BUFFER_SIZE      65536
+
+#define BYTE_CODE_BUFFER_SIZE      65536	/* initial size (doubled) */
+
+
+
+
+#define Cache_Get_Value(p, x)      (memcpy(&(x), (p), sizeof(x)), (p) += sizeof(x))
+
+#define Cache_Put_Value(f, x)      fwrite(&(x), sizeof(x), 1, (f))
+
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
 
+typedef struct			/* Piped consult information      */
+{				/* ------------------------------ */
+  int pid;			/* pid of pl2wam                  */
+  FILE *f_in;			/* pl2wam stdin (or NULL)         */
+  FILE *f_out;			/* pl2wam stdout + stderr         */
+  Bool in_byte_code;		/* inside a byte-code chunk ?     */
+  unsigned char *p_eof;		/* end_of_file sent to pl2wam     */
+  unsigned char *buff;		/* the whole byte-code            */
+  unsigned char *ptr;		/* next char to read in buff      */
+  unsigned char *end;		/* end of the byte-code in buff   */
+}
+ConsultInf;
+
+
+
+
+typedef struct			/* Byte-code cache header         */
+{				/* ------------------------------ */
+  char magic[8];		/* CACHE_MAGIC                    */
+  uint32_t format;		/* CACHE_FORMAT                   */
+  uint32_t word_size;		/* WORD_SIZE of the writer        */
+  uint32_t endian;		/* 0x01020304 as written          */
+  uint32_t key;			/* hash of the compilation input  */
+  char version[16];		/* PROLOG_VERSION of the writer   */
+  uint32_t nb_dep;		/* nb of included files           */
+  uint32_t nb_atom;		/* nb of atoms in the atom table  */
+  uint64_t dep_offset;		/* offset of included file table  */
+  uint64_t atom_offset;		/* offset of the atom table       */
+}
+CacheHeader;
+
+
+
+
+typedef struct			/* Included file (dependency)     */
+{				/* ------------------------------ */
+  char *path;			/* absolute file name             */
+  uint32_t hash;		/* hash of its content            */
+  uint64_t size;		/* its size                       */
+}
+CacheDep;
+
+
+
+
+typedef struct			/* Byte-code cache information    */
+{				/* ------------------------------ */
+  char *file;			/* cache file name                */
+  uint32_t key;			/* hash of the compilation input  */
+  char **key_file;		/* files whose content is in key  */
+  int nb_key_file;		/* nb of such files               */
+				/* --- read mode --------------- */
+  unsigned char *base;		/* mapped (or loaded) cache file  */
+  size_t size;			/* size of the cache file         */
+  unsigned char *p;		/* next term to decode            */
+  int *atom;			/* cache atom -> atom             */
+				/* --- write mode -------------- */
+  char *tmp_file;		/* file written (renamed at end)  */
+  FILE *f;			/* stream to tmp_file             */
+  int *atom_rank;		/* atom -> cache atom + 1 (or 0)  */
+  PlULong rank_size;		/* size of atom_rank              */
+  int *atom_list;		/* cache atom -> atom             */
+  int nb_atom;			/* nb of atoms in atom_list       */
+  int max_atom;			/* size of atom_list              */
+  CacheDep *dep;		/* included files                 */
+  int nb_dep;			/* nb of included files           */
+  int max_dep;			/* size of dep                    */
+  Bool error;			/* cannot be written ?            */
+}
+CacheInf;
+
+
+
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
 
+static CacheInf **cache_tbl;	/* opened caches (nested consults) */
+static int cache_tbl_size;
+
+static int atom_file_name;
+
+static WamWord **cache_var;	/* variables of the current term   */
+static int cache_nb_var;
+static int cache_max_var;
+
 /*---------------------------------*
  * Function Prototypes             *
  *---------------------------------*/
 
-#if 1
+static int Consult_Getc(ConsultInf *ci);
+
+static int Consult_Buff_Getc(ConsultInf *ci);
+
+static void Send_Char_To_Pl2wam(ConsultInf *ci);
+
+static CacheInf *Cache_Alloc(WamWord cache_file_word, WamWord pl_file_word,
+			     WamWord pl2wam_args_word, WamWord cache_word);
+
+static CacheInf *Cache_Get(WamWord cache_word);
+
+static void Cache_Free(CacheInf *cache);
+
+static Bool Hash_File(char *path, uint32_t *hash, uint64_t *size);
+
+static Bool Check_Cache(CacheInf *cache);
+
+static void Decode_Term(CacheInf *cache, WamWord *dst_adr);
+
+static void Encode_Term(CacheInf *cache, WamWord start_word);
+
+static int Cache_Atom(CacheInf *cache, int atom);
+
+static void Cache_Add_Dep(CacheInf *cache, char *path);
+
+static WamWord **Cache_Var(void);
+
+
+
+/*
+ * consult/1 runs pl2wam (with --pipe) whose stdout and stderr are read
+ * through a pipe. The byte-code is emitted by pl2wam on its stdout inside
+ * chunks delimited by CHAR_BEGIN_BYTE_CODE / CHAR_END_BYTE_CODE. Other
+ * characters are messages, copied to top_level_output. When pl2wam reads
+ * its stdin (consult(user)) it emits CHAR_TO_EMIT_ON_PIPED_GETC (see
+ * SYS_VAR_SAY_GETC) and a character is read from top_level_input and sent
+ * to pl2wam. The byte-code is kept in memory (no intermediate .wbc file)
+ * until pl2wam terminates: it is only loaded (by '$load_stream'/1, through
+ * a Prolog stream on this buffer) if the compilation succeeds, so a file
+ * with a compilation error does not change the loaded predicates.
+ */
+
 
 /*-------------------------------------------------------------------------*
- * PL_CONSULT_3                                                            *
+ * PL_CONSULT_OPEN_2                                                       *
  *                                                                         *
+ * Runs pl2wam and returns a stream on the byte-code. Fails if the         *
+ * compilation failed.                                                     *
  *-------------------------------------------------------------------------*/
 Bool
-Pl_Consult_1(WamWord pl2wam_args_word)
+Pl_Consult_Open_2(WamWord pl2wam_args_word, WamWord stm_word)
 {
-  StmInf *pstm_o = pl_stm_tbl[pl_stm_top_level_output];
-  StmInf *pstm_i = pl_stm_tbl[pl_stm_top_level_input];
+  ConsultInf *ci;
   int pid;
+  int status;
+  int c;
+  PlLong size;
   FILE *f_in = M_SPAWN_REDIRECT_CREATE;
   FILE *f_out = M_SPAWN_REDIRECT_CREATE;
   FILE **pf_in;
-  unsigned char *p = NULL;
-  int status, c;
-  int save_use_le_prompt;
   char *arg[2 + Pl_List_Length(pl2wam_args_word)];
   WamWord word, tag_mask;
   WamWord *lst_adr;
   int n = 0;
+  StmProp prop;
+  char open_str[10];
+  int stm;
 
   arg[n++] = "pl2wam";
 
@@ -114,61 +282,894 @@ Pl_Consult_1(WamWord pl2wam_args_word)
     Os_Test_Error(pid); /* ENOENT is for Windows */
   if (pid < 0)
     {
-    error_pl2wam:
       Pl_Err_System(Pl_Create_Atom("error trying to execute pl2wam (maybe not found)"));
       return FALSE;
     }
 
-  save_use_le_prompt = pl_use_le_prompt;
-  pl_use_le_prompt = 0;
+  ci = (ConsultInf *) Malloc(sizeof(ConsultInf));
+  ci->pid = pid;
+  ci->f_in = f_in;
+  ci->f_out = f_out;
+  ci->in_byte_code = FALSE;
+  ci->p_eof = NULL;
+
+  size = BYTE_CODE_BUFFER_SIZE;
+  ci->buff = ci->end = (unsigned char *) Malloc(size);
+
+  while ((c = Consult_Getc(ci)) != EOF)
+    {
+      if (ci->end - ci->buff == size)
+	{
+	  ci->buff = (unsigned char *) Realloc(ci->buff, size * 2);
+	  ci->end = ci->buff + size;
+	  size *= 2;
+	}
+      *ci->end++ = (unsigned char) c;
+    }
+
+  if (ci->f_in)
+    fclose(ci->f_in);
+  fclose(ci->f_out);
+
+  status = Pl_M_Get_Status(ci->pid);
+  if (status != 0)
+    {
+      Free(ci->buff);
+      Free(ci);
+      if (status < 0)
+	Pl_Err_System(Pl_Create_Atom("error trying to execute pl2wam (maybe not found)"));
+      return FALSE;
+    }
+
+  ci->ptr = ci->buff;
+
+  prop = Pl_Prop_And_Stdio_Mode(STREAM_MODE_READ, TRUE, open_str);
+  prop.reposition = FALSE;
+  prop.special_close = TRUE;	/* see Pl_Consult_Close_1 */
+
+  stm = Pl_Add_Stream(Pl_Create_Atom("pl2wam_stream"), (void *) ci, -1, prop,
+		      (StmFct) Consult_Buff_Getc, STREAM_FCT_UNDEFINED,
+		      STREAM_FCT_UNDEFINED, STREAM_FCT_UNDEFINED,
+		      STREAM_FCT_UNDEFINED, STREAM_FCT_UNDEFINED,
+		      STREAM_FCT_UNDEFINED);
+
+  return Pl_Get_Integer(stm, stm_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_CONSULT_CLOSE_1                                                      *
+ *                                                                         *
+ * Frees the byte-code and deletes the stream.                             *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Consult_Close_1(WamWord stm_word)
+{
+  int stm = Pl_Rd_Integer(stm_word);
+  ConsultInf *ci = (ConsultInf *) pl_stm_tbl[stm]->file;
+
+  Free(ci->buff);
+  Free(ci);
+  Pl_Delete_Stream(stm, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CONSULT_GETC                                                            *
+ *                                                                         *
+ * Returns the next byte-code character read from pl2wam (copying the     *
+ * messages on the way).                                                   *
+ *-------------------------------------------------------------------------*/
+static int
+Consult_Getc(ConsultInf *ci)
+{
+  StmInf *pstm_o = pl_stm_tbl[pl_stm_top_level_output];
+  int c;
+
   for (;;)
     {
-#if 1
-      c = fgetc(f_out);
-#else
-      char c0;
-      c = (read(fileno(f_out), &c0, 1) == 1) ? c0 : EOF;
+      c = fgetc(ci->f_out);
+      switch (c)
+	{
+	case EOF:
+	  return EOF;
+
+#ifndef NO_USE_PIPED_STDIN_FOR_CONSULT
+	case CHAR_TO_EMIT_ON_PIPED_GETC:
+	  Send_Char_To_Pl2wam(ci);
+	  break;
 #endif
+
+	case CHAR_BEGIN_BYTE_CODE:
+	  ci->in_byte_code = TRUE;
+	  break;
+
+	case CHAR_END_BYTE_CODE:
+	  ci->in_byte_code = FALSE;
+	  break;
+
+	default:
+	  if (ci->in_byte_code)
+	    return c;
+	  Pl_Stream_Putc(c, pstm_o);
+	}
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CONSULT_BUFF_GETC                                                       *
+ *                                                                         *
+ * Returns the next character of the byte-code (the stream function).      *
+ *-------------------------------------------------------------------------*/
+static int
+Consult_Buff_Getc(ConsultInf *ci)
+{
+  return (ci->ptr < ci->end) ? *ci->ptr++ : EOF;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SEND_CHAR_TO_PL2WAM                                                     *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Send_Char_To_Pl2wam(ConsultInf *ci)
+{
+  StmInf *pstm_i = pl_stm_tbl[pl_stm_top_level_input];
+  int save_use_le_prompt;
+  int c;
+
+  if (ci->p_eof == NULL)
+    {
+      save_use_le_prompt = pl_use_le_prompt;
+      pl_use_le_prompt = 0;
+      c = Pl_Stream_Getc(pstm_i);
+      pl_use_le_prompt = save_use_le_prompt;
       if (c == EOF)
-	break;
+	{
+	  ci->p_eof = (unsigned char *) "end_of_file.\n";
+	  c = *ci->p_eof++;
+	}
+    }
+  else if (*ci->p_eof == '\0')
+    {
+      ci->p_eof = (unsigned char *) "end_of_file.\n";
+      c = *ci->p_eof++;
+    }
+  else
+    c = *ci->p_eof++;
 
-#ifndef NO_USE_PIPED_STDIN_FOR_CONSULT
-      if (c == CHAR_TO_EMIT_ON_PIPED_GETC)
+  fputc(c, ci->f_in);
+  fflush(ci->f_in);
+}
+
+
+
+
+/*
+ * consult(File, [cache(true)]) keeps the byte-code of File in a binary
+ * cache file (see '$consult_cache_file'/2 in consult.pl). It is a sequence
+ * of terms (those of the textual .wbc format) in a binary encoding: atoms
+ * and functors refer to a table (at the end of the file) relocated to the
+ * atoms of the running process when the cache is opened. The cache is
+ * valid if its key (a hash of the gprolog version, the pl2wam arguments
+ * and the content of the source and of the --include files) is unchanged
+ * and if the files included by the source (recorded as they appear in
+ * file_name/1 terms) are unchanged. The file is mapped in memory and the
+ * terms are decoded directly on the heap (no parsing), then loaded by
+ * '$load_pred'/2 as usual. The cache is written while the byte-code
+ * streamed from pl2wam is loaded (in a temporary file renamed only if the
+ * compilation succeeds). A cache which cannot be written is simply ignored.
+ */
+
+
+/*-------------------------------------------------------------------------*
+ * PL_CONSULT_CACHE_OPEN_READ_4                                            *
+ *                                                                         *
+ * Fails if the cache does not exist or is not valid.                      *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Consult_Cache_Open_Read_4(WamWord cache_file_word, WamWord pl_file_word,
+			     WamWord pl2wam_args_word, WamWord cache_word)
+{
+  CacheInf *cache;
+  FILE *f;
+  struct stat st;
+
+  cache = Cache_Alloc(cache_file_word, pl_file_word, pl2wam_args_word, cache_word);
+  if (cache == NULL)
+    return FALSE;
+
+  if ((f = fopen(cache->file, "rb")) == NULL)
+    goto err;
+
+  if (fstat(fileno(f), &st) != 0 || st.st_size < (off_t) sizeof(CacheHeader))
+    {
+      fclose(f);
+      goto err;
+    }
+
+  cache->size = st.st_size;
+#ifdef USE_MMAP_FOR_CACHE
+  cache->base = mmap(NULL, cache->size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+  if (cache->base == MAP_FAILED)
+    cache->base = NULL;
+#else
+  cache->base = (unsigned char *) Malloc(cache->size);
+  if (fread(cache->base, 1, cache->size, f) != cache->size)
+    {
+      Free(cache->base);
+      cache->base = NULL;
+    }
+#endif
+  fclose(f);
+
+  if (cache->base != NULL && Check_Cache(cache))
+    return TRUE;
+
+err:
+  Cache_Free(cache);
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_CONSULT_CACHE_READ_2                                                 *
+ *                                                                         *
+ * Unifies term_word with the next term (end_of_file at the end).          *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Consult_Cache_Read_2(WamWord cache_word, WamWord term_word)
+{
+  CacheInf *cache = Cache_Get(cache_word);
+  WamWord *adr = H++;
+
+  cache_nb_var = 0;
+  Decode_Term(cache, adr);
+
+  return Pl_Unify(*adr, term_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_CONSULT_CACHE_CLOSE_READ_1                                           *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Consult_Cache_Close_Read_1(WamWord cache_word)
+{
+  Cache_Free(Cache_Get(cache_word));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_CONSULT_CACHE_OPEN_WRITE_4                                           *
+ *                                                                         *
+ * Fails if the cache cannot be created.                                   *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Consult_Cache_Open_Write_4(WamWord cache_file_word, WamWord pl_file_word,
+			      WamWord pl2wam_args_word, WamWord cache_word)
+{
+  CacheInf *cache;
+  CacheHeader header;
+
+  cache = Cache_Alloc(cache_file_word, pl_file_word, pl2wam_args_word, cache_word);
+  if (cache == NULL)
+    return FALSE;
+
+  cache->tmp_file = (char *) Malloc(strlen(cache->file) + 32);
+  sprintf(cache->tmp_file, "%s.%d", cache->file, (int) getpid());
+
+  if ((cache->f = fopen(cache->tmp_file, "wb")) == NULL)
+    {
+      Cache_Free(cache);
+      return FALSE;
+    }
+
+  if (atom_file_name == 0)
+    atom_file_name = Pl_Create_Atom("file_name");
+
+  memset(&header, 0, sizeof(header)); /* completed by Close_Write */
+  Cache_Put_Value(cache->f, header);
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_CONSULT_CACHE_WRITE_2                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Consult_Cache_Write_2(WamWord cache_word, WamWord term_word)
+{
+  CacheInf *cache = Cache_Get(cache_word);
+  WamWord word, tag_mask;
+  WamWord *adr;
+
+  cache_nb_var = 0;
+  Encode_Term(cache, term_word);
+
+  DEREF(term_word, word, tag_mask);
+  if (tag_mask != TAG_STC_MASK)
+    return;
+
+  adr = UnTag_STC(word);
+  if (Functor_And_Arity(adr) == Functor_Arity(atom_file_name, 1))
+    Cache_Add_Dep(cache, Pl_Rd_String(Arg(adr, 0)));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_CONSULT_CACHE_CLOSE_WRITE_2                                          *
+ *                                                                         *
+ * If commit_word is true the cache is completed, else it is discarded.    *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Consult_Cache_Close_Write_2(WamWord cache_word, WamWord commit_word)
+{
+  CacheInf *cache = Cache_Get(cache_word);
+  Bool commit = Pl_Rd_Boolean(commit_word) && !cache->error;
+  CacheHeader header;
+  FILE *f = cache->f;
+  unsigned char c = CACHE_TERM_END;
+  uint32_t len;
+  int i;
+
+  if (commit)
+    {
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+      header.format = CACHE_FORMAT;
+      header.word_size = WORD_SIZE;
+      header.endian = 0x01020304;
+      header.key = cache->key;
+      strncpy(header.version, PROLOG_VERSION, sizeof(header.version) - 1);
+      header.nb_dep = cache->nb_dep;
+      header.nb_atom = cache->nb_atom;
+
+      Cache_Put_Value(f, c);
+
+      header.dep_offset = ftell(f);
+      for (i = 0; i < cache->nb_dep; i++)
 	{
-	  if (p == NULL)
-	    {
-	      c = Pl_Stream_Getc(pstm_i);
-	      if (c == EOF)
-		{
-		eof_reached:
-		  p = (unsigned char *) "end_of_file.\n";
-		  c = *p++;
-		}
-	    }
-	  else
-	    {
-	      if (*p == '\0')
-		goto eof_reached;
-	      else
-		c = *p++;
-	    }
-	  fputc(c, f_in);
-	  fflush(f_in);
-	  continue;
+	  len = strlen(cache->dep[i].path);
+	  Cache_Put_Value(f, cache->dep[i].hash);
+	  Cache_Put_Value(f, cache->dep[i].size);
+	  Cache_Put_Value(f, len);
+	  fwrite(cache->dep[i].path, len + 1, 1, f);
 	}
+
+      header.atom_offset = ftell(f);
+      for (i = 0; i < cache->nb_atom; i++)
+	{
+	  len = strlen(pl_atom_tbl[cache->atom_list[i]].name);
+	  Cache_Put_Value(f, len);
+	  fwrite(pl_atom_tbl[cache->atom_list[i]].name, len + 1, 1, f);
+	}
+
+      fseek(f, 0, SEEK_SET);
+      Cache_Put_Value(f, header);
+      commit = !ferror(f);
+    }
+
+  if (fclose(f) != 0)
+    commit = FALSE;
+  cache->f = NULL;
+
+  if (commit)
+    {
+#ifdef _WIN32
+      remove(cache->file);	/* rename() does not replace under Windows */
 #endif
-      Pl_Stream_Putc(c, pstm_o);
+      commit = (rename(cache->tmp_file, cache->file) == 0);
+    }
+
+  if (!commit)
+    remove(cache->tmp_file);
+
+  Cache_Free(cache);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CACHE_ALLOC                                                             *
+ *                                                                         *
+ * Allocates a cache (unified with cache_word) and computes its key.       *
+ * Returns NULL if a file of the key cannot be read.                       *
+ *-------------------------------------------------------------------------*/
+static CacheInf *
+Cache_Alloc(WamWord cache_file_word, WamWord pl_file_word,
+	    WamWord pl2wam_args_word, WamWord cache_word)
+{
+  CacheInf *cache;
+  HashIncrInfo hi;
+  WamWord word, tag_mask;
+  WamWord *lst_adr;
+  Bool include = FALSE;
+  uint32_t hash;
+  uint64_t size;
+  char *str;
+  int i;
+
+  cache = (CacheInf *) Calloc(1, sizeof(CacheInf));
+  cache->file = Strdup(Pl_Rd_String(cache_file_word));
+  cache->key_file = (char **) Malloc((1 + Pl_List_Length(pl2wam_args_word)) * sizeof(char *));
+
+  for (i = 0; i < cache_tbl_size && cache_tbl[i] != NULL; i++)
+    ;
+  if (i == cache_tbl_size)
+    {
+      cache_tbl_size += 8;
+      cache_tbl = (CacheInf **) Realloc(cache_tbl, cache_tbl_size * sizeof(CacheInf *));
+      memset(cache_tbl + i, 0, 8 * sizeof(CacheInf *));
+    }
+  cache_tbl[i] = cache;
+  Pl_Get_Integer(i, cache_word);
+
+  Pl_Hash_Incr_Init(&hi);
+  Pl_Hash_Incr_Buffer(&hi, PROLOG_VERSION, sizeof(PROLOG_VERSION));
+
+  str = Pl_Rd_String(pl_file_word);
+  cache->key_file[cache->nb_key_file++] = str;
+  if (!Hash_File(str, &hash, &size))
+    goto err;
+  Pl_Hash_Incr_Int32(&hi, hash);
+  Pl_Hash_Incr_Int64(&hi, size);
+
+  for (;;)			/* the name of an --include file is not in key */
+    {
+      DEREF(pl2wam_args_word, word, tag_mask);
+      if (word == NIL_WORD)
+	break;
+
+      lst_adr = UnTag_LST(word);
+      str = Pl_Rd_String(Car(lst_adr));
+      if (include)
+	{
+	  cache->key_file[cache->nb_key_file++] = str;
+	  if (!Hash_File(str, &hash, &size))
+	    goto err;
+	  Pl_Hash_Incr_Int32(&hi, hash);
+	  Pl_Hash_Incr_Int64(&hi, size);
+	}
+      else
+	Pl_Hash_Incr_Buffer(&hi, str, strlen(str) + 1);
+
+      include = (strcmp(str, "--include") == 0);
+      pl2wam_args_word = Cdr(lst_adr);
     }
-  pl_use_le_prompt = save_use_le_prompt;
-  if (f_in)
-    fclose(f_in);
-  fclose(f_out);
 
-  status = Pl_M_Get_Status(pid);
-  if (status < 0)
-    goto error_pl2wam;
+  cache->key = Pl_Hash_Incr_Term(&hi);
+  return cache;
 
-  return status == 0;
+err:
+  Cache_Free(cache);
+  return NULL;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CACHE_GET                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static CacheInf *
+Cache_Get(WamWord cache_word)
+{
+  return cache_tbl[Pl_Rd_Integer(cache_word)];
 }
 
+
+
+
+/*-------------------------------------------------------------------------*
+ * CACHE_FREE                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Cache_Free(CacheInf *cache)
+{
+  int i;
+
+  for (i = 0; cache_tbl[i] != cache; i++)
+    ;
+  cache_tbl[i] = NULL;
+
+  if (cache->base)
+    {
+#ifdef USE_MMAP_FOR_CACHE
+      munmap(cache->base, cache->size);
+#else
+      Free(cache->base);
 #endif
+    }
+
+  if (cache->f)
+    {
+      fclose(cache->f);
+      remove(cache->tmp_file);
+    }
+
+  for (i = 0; i < cache->nb_dep; i++)
+    Free(cache->dep[i].path);
+
+  if (cache->dep)
+    Free(cache->dep);
+  if (cache->atom)
+    Free(cache->atom);
+  if (cache->atom_rank)
+    Free(cache->atom_rank);
+  if (cache->atom_list)
+    Free(cache->atom_list);
+  if (cache->tmp_file)
+    Free(cache->tmp_file);
+  Free(cache->key_file);
+  Free(cache->file);
+  Free(cache);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * HASH_FILE                                                               *
+ *                                                                         *
+ * Computes the hash and the size of the content of a file.                *
+ *-------------------------------------------------------------------------*/
+static Bool
+Hash_File(char *path, uint32_t *hash, uint64_t *size)
+{
+  static char buff[HASH_FILE_BUFFER_SIZE];
+  HashIncrInfo hi;
+  FILE *f;
+  size_t n;
+
+  if ((f = fopen(path, "rb")) == NULL)
+    return FALSE;
+
+  Pl_Hash_Incr_Init(&hi);
+  *size = 0;
+  while ((n = fread(buff, 1, sizeof(buff), f)) > 0)
+    {
+      Pl_Hash_Incr_Buffer(&hi, buff, n);
+      *size += n;
+    }
+
+  fclose(f);
+  *hash = Pl_Hash_Incr_Term(&hi);
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CHECK_CACHE                                                             *
+ *                                                                         *
+ * Checks the header and the included files, then relocates the atoms.    *
+ *-------------------------------------------------------------------------*/
+static Bool
+Check_Cache(CacheInf *cache)
+{
+  CacheHeader header;
+  unsigned char *p = cache->base;
+  unsigned char *end = cache->base + cache->size;
+  uint32_t hash, dep_hash, len;
+  uint64_t size, dep_size;
+  uint32_t i;
+
+  Cache_Get_Value(p, header);
+  cache->p = p;
+
+  if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.format != CACHE_FORMAT || header.word_size != WORD_SIZE ||
+      header.endian != 0x01020304 || header.key != cache->key ||
+      strncmp(header.version, PROLOG_VERSION, sizeof(header.version)) != 0 ||
+      header.dep_offset > header.atom_offset || header.atom_offset > cache->size)
+    return FALSE;
+
+  p = cache->base + header.dep_offset;
+  for (i = 0; i < header.nb_dep; i++)
+    {
+      if (p + sizeof(dep_hash) + sizeof(dep_size) + sizeof(len) > end)
+	return FALSE;
+      Cache_Get_Value(p, dep_hash);
+      Cache_Get_Value(p, dep_size);
+      Cache_Get_Value(p, len);
+      if (p + len >= end || p[len] != '\0' ||
+	  !Hash_File((char *) p, &hash, &size) || hash != dep_hash || size != dep_size)
+	return FALSE;
+      p += len + 1;
+    }
+
+  cache->atom = (int *) Malloc((header.nb_atom + 1) * sizeof(int));
+  p = cache->base + header.atom_offset;
+  for (i = 0; i < header.nb_atom; i++)
+    {
+      if (p + sizeof(len) > end)
+	return FALSE;
+      Cache_Get_Value(p, len);
+      if (p + len >= end || p[len] != '\0')
+	return FALSE;
+      cache->atom[i] = Pl_Create_Allocate_Atom((char *) p);
+      p += len + 1;
+    }
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DECODE_TERM                                                             *
+ *                                                                         *
+ * Decodes the next term of the cache on the heap and stores it in dst_adr *
+ * (which is in the heap).                                                 *
+ *-------------------------------------------------------------------------*/
+static void
+Decode_Term(CacheInf *cache, WamWord *dst_adr)
+{
+  WamWord *q;
+  uint32_t i, n;
+  PlLong x;
+  double d;
+
+terminal_rec:
+
+  switch (*cache->p++)
+    {
+    case CACHE_TERM_VAR:
+      Cache_Get_Value(cache->p, i);
+      *dst_adr = Tag_REF(cache_var[i]);
+      return;
+
+    case CACHE_TERM_NEW_VAR:
+      *dst_adr = Tag_REF(dst_adr);
+      *Cache_Var() = dst_adr;
+      return;
+
+    case CACHE_TERM_ATM:
+      Cache_Get_Value(cache->p, i);
+      *dst_adr = Tag_ATM(cache->atom[i]);
+      return;
+
+    case CACHE_TERM_INT:
+      Cache_Get_Value(cache->p, x);
+      *dst_adr = Tag_INT(x);
+      return;
+
+    case CACHE_TERM_FLT:
+      Cache_Get_Value(cache->p, d);
+      *dst_adr = Pl_Put_Float(d);
+      return;
+
+    case CACHE_TERM_LST:
+      q = H;
+      *dst_adr = Tag_LST(q);
+      H = &Cdr(q) + 1;
+      Decode_Term(cache, &Car(q));
+      dst_adr = &Cdr(q);
+      goto terminal_rec;
+
+    case CACHE_TERM_STC:
+      Cache_Get_Value(cache->p, i);
+      Cache_Get_Value(cache->p, n);
+      q = H;
+      *dst_adr = Tag_STC(q);
+      Functor_And_Arity(q) = Functor_Arity(cache->atom[i], n);
+      H = &Arg(q, n - 1) + 1;
+      q = &Arg(q, 0);
+      while (--n)
+	Decode_Term(cache, q++);
+      dst_adr = q;
+      goto terminal_rec;
+
+    default:			/* CACHE_TERM_END (stays at the end) */
+      cache->p--;
+      *dst_adr = Tag_ATM(pl_atom_end_of_file);
+      return;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ENCODE_TERM                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Encode_Term(CacheInf *cache, WamWord start_word)
+{
+  FILE *f = cache->f;
+  WamWord word, tag_mask;
+  WamWord *adr;
+  WamWord **p;
+  unsigned char c;
+  uint32_t i, n;
+  PlLong x;
+  double d;
+
+terminal_rec:
+
+  DEREF(start_word, word, tag_mask);
+
+  switch (Tag_From_Tag_Mask(tag_mask))
+    {
+    case ATM:
+      c = CACHE_TERM_ATM;
+      i = Cache_Atom(cache, UnTag_ATM(word));
+      Cache_Put_Value(f, c);
+      Cache_Put_Value(f, i);
+      return;
+
+    case INT:
+      c = CACHE_TERM_INT;
+      x = UnTag_INT(word);
+      Cache_Put_Value(f, c);
+      Cache_Put_Value(f, x);
+      return;
+
+    case FLT:
+      c = CACHE_TERM_FLT;
+      d = Pl_Obtain_Float(UnTag_FLT(word));
+      Cache_Put_Value(f, c);
+      Cache_Put_Value(f, d);
+      return;
+
+    case LST:
+      adr = UnTag_LST(word);
+      c = CACHE_TERM_LST;
+      Cache_Put_Value(f, c);
+      Encode_Term(cache, Car(adr));
+      start_word = Cdr(adr);
+      goto terminal_rec;
+
+    case STC:
+      adr = UnTag_STC(word);
+      c = CACHE_TERM_STC;
+      i = Cache_Atom(cache, Functor(adr));
+      n = Arity(adr);
+      Cache_Put_Value(f, c);
+      Cache_Put_Value(f, i);
+      Cache_Put_Value(f, n);
+      adr = &Arg(adr, 0);
+      while (--n)
+	Encode_Term(cache, *adr++);
+      start_word = *adr;
+      goto terminal_rec;
+
+    default:			/* a variable (FD variables are not expected) */
+      adr = UnTag_Address(word);
+      for (p = cache_var; p < cache_var + cache_nb_var; p++)
+	if (*p == adr)
+	  {
+	    c = CACHE_TERM_VAR;
+	    i = p - cache_var;
+	    Cache_Put_Value(f, c);
+	    Cache_Put_Value(f, i);
+	    return;
+	  }
+      *Cache_Var() = adr;
+      c = CACHE_TERM_NEW_VAR;
+      Cache_Put_Value(f, c);
+      return;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CACHE_ATOM                                                              *
+ *                                                                         *
+ * Returns the index of an atom in the atom table of the cache.            *
+ *-------------------------------------------------------------------------*/
+static int
+Cache_Atom(CacheInf *cache, int atom)
+{
+  if ((PlULong) atom >= cache->rank_size) /* the atom table has grown */
+    {
+      cache->atom_rank = (int *) Realloc(cache->atom_rank, pl_max_atom * sizeof(int));
+      memset(cache->atom_rank + cache->rank_size, 0,
+	     (pl_max_atom - cache->rank_size) * sizeof(int));
+      cache->rank_size = pl_max_atom;
+    }
+
+  if (cache->atom_rank[atom] == 0)
+    {
+      if (cache->nb_atom == cache->max_atom)
+	{
+	  cache->max_atom = (cache->max_atom == 0) ? 1024 : cache->max_atom * 2;
+	  cache->atom_list = (int *) Realloc(cache->atom_list, cache->max_atom * sizeof(int));
+	}
+      cache->atom_list[cache->nb_atom++] = atom;
+      cache->atom_rank[atom] = cache->nb_atom;
+    }
+
+  return cache->atom_rank[atom] - 1;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CACHE_ADD_DEP                                                           *
+ *                                                                         *
+ * Records an included file (if not already recorded or in the key).      *
+ *-------------------------------------------------------------------------*/
+static void
+Cache_Add_Dep(CacheInf *cache, char *path)
+{
+  CacheDep *dep;
+  int i;
+
+  for (i = 0; i < cache->nb_key_file; i++)
+    if (strcmp(cache->key_file[i], path) == 0)
+      return;
+
+  for (i = 0; i < cache->nb_dep; i++)
+    if (strcmp(cache->dep[i].path, path) == 0)
+      return;
+
+  if (cache->nb_dep == cache->max_dep)
+    {
+      cache->max_dep += 8;
+      cache->dep = (CacheDep *) Realloc(cache->dep, cache->max_dep * sizeof(CacheDep));
+    }
+
+  dep = cache->dep + cache->nb_dep;
+  if (!Hash_File(path, &dep->hash, &dep->size))
+    {
+      cache->error = TRUE;
+      return;
+    }
+
+  dep->path = Strdup(path);
+  cache->nb_dep++;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CACHE_VAR                                                               *
+ *                                                                         *
+ * Returns the slot of a new variable of the current term.                 *
+ *-------------------------------------------------------------------------*/
+static WamWord **
+Cache_Var(void)
+{
+  if (cache_nb_var == cache_max_var)
+    {
+      cache_max_var = (cache_max_var == 0) ? 256 : cache_max_var * 2;
+      cache_var = (WamWord **) Realloc(cache_var, cache_max_var * sizeof(WamWord *));
+    }
+
+  return cache_var + cache_nb_var++;
+}
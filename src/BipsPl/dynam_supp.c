@@ -40,6 +40,7 @@
 #include <stddef.h>
 #include <string.h>
 
+#define OBJ_INIT Dynam_Supp_Initializer
 
 #include "engine_pl.h"
 #include "bips_pl.h"
@@ -73,7 +74,9 @@
 #define MAX_CLAUSES_BEFORE_CLEAN   1000
 
 
-#define START_DYNAMIC_SWT_SIZE     32
+#define START_DYNAMIC_SWT_SIZE     8
+
+#define MIN_CLAUSES_FOR_ARG_INDEX  8
 
 #define NO_INDEX                   0
 #define VAR_INDEX                  1
@@ -101,6 +104,9 @@ typedef struct			/* Dynamic clause scanning info   */
   Bool xxx_is_seq_chain;        /* scan all clauses ?             */
   DynCInf *xxx_ind_chain;	/* current assoc idx (->clause)   */
   DynCInf *var_ind_chain;	/* current var   idx (->clause)   */
+  Bool is_arg_index;		/* scan an argument index ?       */
+  DynICell *xxx_cell;		/* current assoc arg idx (->cell) */
+  DynICell *var_cell;		/* current var   arg idx (->cell) */
   DynCInf *clause;		/* current clause                 */
 }
 DynScan;
@@ -130,12 +136,26 @@ static int nb_erased_clauses = 0;   /* number of clauses waiting to be cleaned *
 
 static DynPInf *Alloc_Init_Dyn_Info(int func, int arity);
 
-static int Index_From_First_Arg(WamWord first_arg_word, PlLong *key);
+static int Index_From_Arg(WamWord arg_word, PlLong *key);
 
 static void Add_To_2Chain(D2ChHdr *hdr, DynCInf *clause, Bool in_seq_chain, Bool asserta);
 
 static void Remove_From_2Chain(D2ChHdr *hdr, DynCInf *clause, Bool in_seq_chain);
 
+static DynAIdx *Select_Arg_Index(DynPInf *dyn, WamWord *arg_adr, int *index_no,
+				 PlLong *key);
+
+static DynAIdx *Create_Arg_Index(DynPInf *dyn, int arg_no);
+
+static void Add_To_Arg_Index(DynAIdx *aidx, DynCInf *clause, WamWord arg_word,
+			     Bool asserta);
+
+static DIChHdr *Find_Arg_Index_Chain(DynAIdx *aidx, int index_no, PlLong key);
+
+static void Remove_From_Arg_Indexes(DynCInf *clause);
+
+static void Free_Arg_Indexes(DynPInf *dyn);
+
 static void Free_Clause(DynCInf *clause);
 
 static void Unlink_And_Free_Clause(DynCInf *clause);
@@ -150,6 +170,10 @@ static DynScan *Get_Scan_Choice_Point(WamWord *b);
 
 static void Clean_Erased_Clauses(void);
 
+static void Dynam_Atom_GC_Roots(void);
+
+static void Dynam_Atom_GC_Mark_Clauses(DynPInf *dyn);
+
 
 #if DEBUG_LEVEL != 0
 
@@ -214,6 +238,17 @@ Prolog_Prototype(SCAN_DYN_JUMP_ALT, 0);
  *   - lst_ind_chain: a chain to the first clause with a list as 1st arg
  *   - stc_htbl     : a hash table: key=f_n, info=chain to the first clause
  *
+ * When the first argument of a call is a variable, another bound argument
+ * can be used for indexing. Such argument indexes (DynAIdx) are built on
+ * demand: the first time a call with a bound (non first) argument is done
+ * on a predicate with at least MIN_CLAUSES_FOR_ARG_INDEX clauses, an index
+ * on this argument is created (from the sequential chain) and kept up to
+ * date by subsequent asserts/retracts. An argument index has the same
+ * structure as the first argument index (var chain, atm/int/stc hash
+ * tables, lst chain) but, since a clause can be in several of them, its
+ * chains link cells (DynICell) pointing to the clauses. All the cells of a
+ * clause are linked (arg_cells) to unlink/free them with the clause.
+ *
  * We follow the ISO logical database update view (LDUV): the different 
  * altenatives of a predicate are not influenced by subsequent actions 
  * (assert/retract). NB: LDUV only applies for dynamic predicates with 
@@ -267,6 +302,19 @@ Prolog_Prototype(SCAN_DYN_JUMP_ALT, 0);
  * (first/next_dyn_with_erase).
  */
 
+/*-------------------------------------------------------------------------*
+ * DYNAM_SUPP_INITIALIZER                                                  *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Dynam_Supp_Initializer(void)
+{
+  Pl_Atom_GC_Add_Root_Fct(Dynam_Atom_GC_Roots);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_ADD_DYNAMIC_CLAUSE                                                   *
  *                                                                         *
@@ -287,6 +335,7 @@ Pl_Add_Dynamic_Clause(WamWord head_word, WamWord body_word, Bool asserta,
   D2ChHdr *p_ind_hdr;
   DSwtInf swt_info;
   DSwtInf *swt;
+  DynAIdx *aidx;
   int size;
   WamWord lst_h_b;
 
@@ -316,7 +365,7 @@ Pl_Add_Dynamic_Clause(WamWord head_word, WamWord body_word, Bool asserta,
   dyn = pred->dyn;
 
 
-  index_no = (dyn->arity) ? Index_From_First_Arg(*first_arg_adr, &key) : NO_INDEX;
+  index_no = (dyn->arity) ? Index_From_Arg(*first_arg_adr, &key) : NO_INDEX;
 
   lst_h_b = Tag_LST(H);
   H[0] = head_word;
@@ -342,6 +391,7 @@ Pl_Add_Dynamic_Clause(WamWord head_word, WamWord body_word, Bool asserta,
   Pl_Copy_Term(&clause->term_word, &lst_h_b);
 
   clause->byte_code = pl_byte_code;
+  clause->byte_code_len = (pl_byte_code) ? pl_byte_code_len : 0;
   pl_byte_code = NULL;
 
 #if DEBUG_LEVEL >= 1
@@ -409,6 +459,10 @@ Pl_Add_Dynamic_Clause(WamWord head_word, WamWord body_word, Bool asserta,
   if (p_ind_hdr)
     Add_To_2Chain(p_ind_hdr, clause, FALSE, asserta);
 
+  clause->arg_cells = NULL;
+  for (aidx = dyn->arg_idx; aidx; aidx = aidx->next)
+    Add_To_Arg_Index(aidx, clause, first_arg_adr[aidx->arg_no], asserta);
+
 #if DEBUG_LEVEL >= 5
   Print_Dynamic_Info(dyn, __func__, FALSE);
 #endif
@@ -434,12 +488,15 @@ Alloc_Init_Dyn_Info(int func, int arity)
   INIT_2CHAIN_HDR(dyn->var_ind_chain);
   INIT_2CHAIN_HDR(dyn->lst_ind_chain);
   dyn->atm_htbl = dyn->int_htbl = dyn->stc_htbl = NULL;
+  dyn->arg_idx = NULL;
   dyn->func = func;
   dyn->arity = arity;
   dyn->count_a = -1;
   dyn->count_z = 0;
+  dyn->curr_stamp = 0;
   dyn->first_erased_cl = NULL;
   dyn->next_dyn_with_erase = NULL;
+  dyn->prof = NULL;
 
   return dyn;
 }
@@ -448,17 +505,17 @@ Alloc_Init_Dyn_Info(int func, int arity)
 
 
 /*-------------------------------------------------------------------------*
- * INDEX_FROM_FIRST_ARG                                                    *
+ * INDEX_FROM_ARG                                                          *
  *                                                                         *
  *-------------------------------------------------------------------------*/
 static int
-Index_From_First_Arg(WamWord first_arg_word, PlLong *key)
+Index_From_Arg(WamWord arg_word, PlLong *key)
 {
   WamWord word, tag_mask;
   int index_no;
 
 
-  DEREF(first_arg_word, word, tag_mask);
+  DEREF(arg_word, word, tag_mask);
   switch (Tag_From_Tag_Mask(tag_mask))
     {
     case REF:
@@ -574,6 +631,287 @@ Remove_From_2Chain(D2ChHdr *hdr, DynCInf *clause, Bool in_seq_chain)
 
 
 
+/*-------------------------------------------------------------------------*
+ * SELECT_ARG_INDEX                                                        *
+ *                                                                         *
+ * Called when the 1st argument of a call cannot be used for indexing.     *
+ * Returns the index on a bound argument (preferring an existing one, else *
+ * creating it for the first bound argument) or NULL if none is possible.  *
+ * The index type and the key of the argument are stored in index_no/key.  *
+ *-------------------------------------------------------------------------*/
+static DynAIdx *
+Select_Arg_Index(DynPInf *dyn, WamWord *arg_adr, int *index_no, PlLong *key)
+{
+  DynAIdx *aidx;
+  int i, arg_no = -1;
+  int i_index_no;
+  PlLong i_key;
+
+  if (dyn->count_z - dyn->count_a - 1 < MIN_CLAUSES_FOR_ARG_INDEX)
+    return NULL;
+
+  for (i = 1; i < dyn->arity; i++)
+    {
+      i_index_no = Index_From_Arg(arg_adr[i], &i_key);
+      if (i_index_no == VAR_INDEX || i_index_no == NO_INDEX)
+	continue;
+
+      for (aidx = dyn->arg_idx; aidx; aidx = aidx->next)
+	if (aidx->arg_no == i)
+	  break;
+
+      if (aidx || arg_no < 0)
+	{
+	  arg_no = i;
+	  *index_no = i_index_no;
+	  *key = i_key;
+	}
+
+      if (aidx)
+	return aidx;
+    }
+
+  if (arg_no < 0)
+    return NULL;
+
+  return Create_Arg_Index(dyn, arg_no);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CREATE_ARG_INDEX                                                        *
+ *                                                                         *
+ * All clauses (including erased ones not yet freed) are added so that the *
+ * cells of a clause can be removed when it is unlinked.                   *
+ *-------------------------------------------------------------------------*/
+static DynAIdx *
+Create_Arg_Index(DynPInf *dyn, int arg_no)
+{
+  DynAIdx *aidx;
+  DynCInf *clause;
+  WamWord *arg_adr;
+  int func, arity;
+
+#if DEBUG_LEVEL >= 1
+  DBGPRINTF("Create index on arg %d of %s/%d\n", arg_no + 1,
+	    pl_atom_tbl[dyn->func].name, dyn->arity);
+#endif
+
+  aidx = (DynAIdx *) Malloc(sizeof(DynAIdx));
+
+  aidx->arg_no = arg_no;
+  aidx->var_chain.first = aidx->var_chain.last = NULL;
+  aidx->lst_chain.first = aidx->lst_chain.last = NULL;
+  aidx->atm_htbl = aidx->int_htbl = aidx->stc_htbl = NULL;
+  aidx->next = dyn->arg_idx;
+  dyn->arg_idx = aidx;
+
+  for (clause = dyn->seq_chain.first; clause; clause = clause->seq_chain.next)
+    {
+      arg_adr = Pl_Rd_Callable_Check(clause->head_word, &func, &arity);
+      Add_To_Arg_Index(aidx, clause, arg_adr[arg_no], FALSE);
+    }
+
+  return aidx;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ADD_TO_ARG_INDEX                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Add_To_Arg_Index(DynAIdx *aidx, DynCInf *clause, WamWord arg_word, Bool asserta)
+{
+  PlLong key = 0;		/* init for the compiler */
+  char **p_htbl = NULL;
+  DIChHdr *hdr = NULL;
+  DASwtInf swt_info;
+  DASwtInf *swt;
+  DynICell *cell;
+
+  switch (Index_From_Arg(arg_word, &key))
+    {
+    case NO_INDEX:		/* a float only matches a var or a float */
+      return;
+
+    case VAR_INDEX:
+      hdr = &(aidx->var_chain);
+      break;
+
+    case LST_INDEX:
+      hdr = &(aidx->lst_chain);
+      break;
+
+    case ATM_INDEX:
+      p_htbl = &(aidx->atm_htbl);
+      break;
+
+    case INT_INDEX:
+      p_htbl = &(aidx->int_htbl);
+      break;
+
+    case STC_INDEX:
+      p_htbl = &(aidx->stc_htbl);
+      break;
+    }
+
+  if (p_htbl)
+    {
+      if (*p_htbl == NULL)
+	*p_htbl = Pl_Hash_Alloc_Table(START_DYNAMIC_SWT_SIZE, sizeof(DASwtInf));
+
+      swt_info.key = key;
+      swt_info.chain.first = swt_info.chain.last = NULL;
+
+      Pl_Extend_Table_If_Needed(p_htbl);
+      swt = (DASwtInf *) Pl_Hash_Insert(*p_htbl, (char *) &swt_info, FALSE);
+
+      hdr = &(swt->chain);
+    }
+
+  cell = (DynICell *) Malloc(sizeof(DynICell));
+  cell->clause = clause;
+  cell->p_hdr = hdr;
+  cell->p_htbl = p_htbl;
+  cell->next_of_clause = clause->arg_cells;
+  clause->arg_cells = cell;
+
+  if (hdr->first == NULL)	/* empty chain ? */
+    {
+      hdr->first = hdr->last = cell;
+      cell->next = cell->prev = NULL;
+    }
+  else if (asserta)
+    {
+      cell->next = hdr->first;
+      cell->prev = NULL;
+      hdr->first->prev = cell;
+      hdr->first = cell;
+    }
+  else
+    {
+      cell->next = NULL;
+      cell->prev = hdr->last;
+      hdr->last->next = cell;
+      hdr->last = cell;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FIND_ARG_INDEX_CHAIN                                                    *
+ *                                                                         *
+ * Returns the chain of an argument index for a bound argument (or NULL).  *
+ *-------------------------------------------------------------------------*/
+static DIChHdr *
+Find_Arg_Index_Chain(DynAIdx *aidx, int index_no, PlLong key)
+{
+  char *htbl;
+  DASwtInf *swt;
+
+  switch (index_no)
+    {
+    case LST_INDEX:
+      return &(aidx->lst_chain);
+
+    case ATM_INDEX:
+      htbl = aidx->atm_htbl;
+      break;
+
+    case INT_INDEX:
+      htbl = aidx->int_htbl;
+      break;
+
+    default:			/* STC_INDEX */
+      htbl = aidx->stc_htbl;
+      break;
+    }
+
+  if (htbl && (swt = (DASwtInf *) Pl_Hash_Find(htbl, key)) != NULL)
+    return &(swt->chain);
+
+  return NULL;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * REMOVE_FROM_ARG_INDEXES                                                 *
+ *                                                                         *
+ * Unlinks the cells of a clause (they are freed with the clause).         *
+ *-------------------------------------------------------------------------*/
+static void
+Remove_From_Arg_Indexes(DynCInf *clause)
+{
+  DynICell *cell;
+  DIChHdr *hdr;
+  PlLong *p_key;
+
+  for (cell = clause->arg_cells; cell; cell = cell->next_of_clause)
+    {
+      hdr = cell->p_hdr;
+
+      if (cell->prev == NULL)	/* first cell ? */
+	hdr->first = cell->next;
+      else
+	cell->prev->next = cell->next;
+
+      if (cell->next == NULL)	/* last cell ? */
+	hdr->last = cell->prev;
+      else
+	cell->next->prev = cell->prev;
+
+      if (cell->p_htbl && hdr->first == NULL)
+	{
+	  p_key = (PlLong *) ((char *) hdr - offsetof(DASwtInf, chain));
+	  Pl_Hash_Delete(*cell->p_htbl, *p_key);
+	}
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FREE_ARG_INDEXES                                                        *
+ *                                                                         *
+ * The cells have been freed with their clauses.                           *
+ *-------------------------------------------------------------------------*/
+static void
+Free_Arg_Indexes(DynPInf *dyn)
+{
+  DynAIdx *aidx, *aidx1;
+
+  for (aidx = dyn->arg_idx; aidx; aidx = aidx1)
+    {
+      aidx1 = aidx->next;
+
+      if (aidx->atm_htbl)
+	Pl_Hash_Free_Table(aidx->atm_htbl);
+
+      if (aidx->int_htbl)
+	Pl_Hash_Free_Table(aidx->int_htbl);
+
+      if (aidx->stc_htbl)
+	Pl_Hash_Free_Table(aidx->stc_htbl);
+
+      Free(aidx);
+    }
+
+  dyn->arg_idx = NULL;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * FREE_CLAUSE                                                             *
  *                                                                         *
@@ -581,9 +919,17 @@ Remove_From_2Chain(D2ChHdr *hdr, DynCInf *clause, Bool in_seq_chain)
 static void
 Free_Clause(DynCInf *clause)
 {
+  DynICell *cell, *cell1;
+
   if (clause->byte_code)
     Free(clause->byte_code);
 
+  for (cell = clause->arg_cells; cell; cell = cell1)
+    {
+      cell1 = cell->next_of_clause;
+      Free(cell);
+    }
+
 #if DEBUG_LEVEL >= 4
   DBGPRINTF("Free clause no: %d at %p\n", clause->cl_no, clause);
 #endif
@@ -621,6 +967,8 @@ Unlink_And_Free_Clause(DynCInf *clause)
 #endif
       Pl_Hash_Delete(*clause->p_ind_htbl, *p_key);
     }
+
+  Remove_From_Arg_Indexes(clause);
 #if DEBUG_LEVEL >= 3
   Print_Dynamic_Info(dyn, __func__, FALSE);
 #endif
@@ -817,7 +1165,7 @@ Pl_Update_Dynamic_Pred(int func, int arity, int what_to_do, int pl_file_for_mult
  *-------------------------------------------------------------------------*/
 DynCInf *
 Pl_Scan_Dynamic_Pred(int owner_func, int owner_arity,
-		     DynPInf *dyn, WamWord first_arg_word,
+		     DynPInf *dyn, WamWord *arg_adr,
 		     ScanFct alt_fct, int alt_fct_type,
 		     int alt_info_size, WamWord *alt_info)
 {
@@ -825,6 +1173,8 @@ Pl_Scan_Dynamic_Pred(int owner_func, int owner_arity,
   PlLong key;
   char **p_ind_htbl;
   DSwtInf *swt;
+  DynAIdx *aidx = NULL;
+  DIChHdr *hdr;
   DynScan scan;
   DynCInf *clause;
   WamWord *adr;
@@ -853,7 +1203,10 @@ Pl_Scan_Dynamic_Pred(int owner_func, int owner_arity,
   if (owner_func < 0)
     owner_func = Pl_Get_Current_Bip(&owner_arity);
 
-  index_no = (dyn->arity) ? Index_From_First_Arg(first_arg_word, &key) : NO_INDEX;
+  index_no = (dyn->arity) ? Index_From_Arg(*arg_adr, &key) : NO_INDEX;
+
+  if ((index_no == VAR_INDEX || index_no == NO_INDEX) && dyn->arity > 1)
+    aidx = Select_Arg_Index(dyn, arg_adr, &index_no, &key);
 
   scan.alt_fct = alt_fct;
   scan.alt_size_info = alt_info_size;
@@ -867,6 +1220,15 @@ Pl_Scan_Dynamic_Pred(int owner_func, int owner_arity,
   Print_Scan_Info("SCAN DYNAMIC", &scan);
 #endif
 
+  scan.is_arg_index = (aidx != NULL);
+  if (aidx)
+    {
+      hdr = Find_Arg_Index_Chain(aidx, index_no, key);
+      scan.xxx_cell = (hdr) ? hdr->first : NULL;
+      scan.var_cell = aidx->var_chain.first;
+      index_no = NO_INDEX;	/* no clause chain is used */
+    }
+
   switch (index_no)
     {
     case NO_INDEX:
@@ -947,7 +1309,6 @@ Pl_Scan_Dynamic_Pred(int owner_func, int owner_arity,
 static DynCInf *
 Scan_Dynamic_Pred_Next(DynScan *scan)
 {
-  DynCInf *xxx_ind_chain, *var_ind_chain;
   DynCInf *xxx_clause, *var_clause;
   PlLong xxx_nb, var_nb;
   DynCInf *clause;
@@ -967,23 +1328,19 @@ Scan_Dynamic_Pred_Next(DynScan *scan)
     {
       nb_skip_erased++;
 
-      xxx_ind_chain = scan->xxx_ind_chain;
-      if (xxx_ind_chain)
+      if (scan->is_arg_index)
 	{
-	  xxx_clause = xxx_ind_chain;
-	  xxx_nb = xxx_clause->cl_no;
+	  xxx_clause = (scan->xxx_cell) ? scan->xxx_cell->clause : NULL;
+	  var_clause = (scan->var_cell) ? scan->var_cell->clause : NULL;
 	}
       else
-	xxx_nb = INT_GREATEST_VALUE;
-
-      var_ind_chain = scan->var_ind_chain;
-      if (var_ind_chain)
 	{
-	  var_clause = var_ind_chain;
-	  var_nb = var_clause->cl_no;
+	  xxx_clause = scan->xxx_ind_chain;
+	  var_clause = scan->var_ind_chain;
 	}
-      else
-	var_nb = INT_GREATEST_VALUE;
+
+      xxx_nb = (xxx_clause) ? xxx_clause->cl_no : INT_GREATEST_VALUE;
+      var_nb = (var_clause) ? var_clause->cl_no : INT_GREATEST_VALUE;
 
       if (xxx_nb <= var_nb)
 	{
@@ -991,15 +1348,20 @@ Scan_Dynamic_Pred_Next(DynScan *scan)
 	    return NULL;
 
 	  clause = xxx_clause;
-	  if (scan->xxx_is_seq_chain)
-	    scan->xxx_ind_chain = xxx_ind_chain->seq_chain.next;
+	  if (scan->is_arg_index)
+	    scan->xxx_cell = scan->xxx_cell->next;
+	  else if (scan->xxx_is_seq_chain)
+	    scan->xxx_ind_chain = xxx_clause->seq_chain.next;
 	  else
-	    scan->xxx_ind_chain = xxx_ind_chain->ind_chain.next;
+	    scan->xxx_ind_chain = xxx_clause->ind_chain.next;
 	}
       else
 	{
 	  clause = var_clause;
-	  scan->var_ind_chain = var_ind_chain->ind_chain.next;
+	  if (scan->is_arg_index)
+	    scan->var_cell = scan->var_cell->next;
+	  else
+	    scan->var_ind_chain = var_clause->ind_chain.next;
 	}
 
       /* Detect when remaining clauses are beyond the scan point (created after it) */
@@ -1225,6 +1587,9 @@ Clean_Erased_Clauses(void)
 	  if (dyn->stc_htbl)
 	    Pl_Hash_Free_Table(dyn->stc_htbl);
 
+	  Free_Arg_Indexes(dyn);
+	  if (dyn->prof)
+	    Pl_Prof_Free_Counters(dyn->prof);
 	  Free(dyn);		/* has been re-allocated if needed, so it is safe to free */
 	  continue;
 	}
@@ -1249,6 +1614,7 @@ Clean_Erased_Clauses(void)
 	    Pl_Hash_Free_Table(dyn->stc_htbl);
 
 	  dyn->atm_htbl = dyn->int_htbl = dyn->stc_htbl = NULL;
+	  Free_Arg_Indexes(dyn);
 	  dyn->count_a = -1;
 	  dyn->count_z = 0;
 	}
@@ -1268,6 +1634,51 @@ Clean_Erased_Clauses(void)
 
 
 
+/*-------------------------------------------------------------------------*
+ * DYNAM_ATOM_GC_ROOTS                                                     *
+ *                                                                         *
+ * Called by the atom garbage collector: mark the atoms of the clauses of  *
+ * all dynamic predicates (including erased clauses not yet freed and the  *
+ * clauses of abolished predicates still scanned).                         *
+ *-------------------------------------------------------------------------*/
+static void
+Dynam_Atom_GC_Roots(void)
+{
+  HashScan scan;
+  PredInf *pred;
+  DynPInf *dyn;
+
+  for (pred = (PredInf *) Pl_Hash_First(pl_pred_tbl, &scan); pred;
+       pred = (PredInf *) Pl_Hash_Next(&scan))
+    if (pred->dyn)
+      Dynam_Atom_GC_Mark_Clauses((DynPInf *) pred->dyn);
+
+  for (dyn = first_dyn_with_erase; dyn; dyn = dyn->next_dyn_with_erase)
+    Dynam_Atom_GC_Mark_Clauses(dyn);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * DYNAM_ATOM_GC_MARK_CLAUSES                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Dynam_Atom_GC_Mark_Clauses(DynPInf *dyn)
+{
+  DynCInf *clause;
+
+  for (clause = dyn->seq_chain.first; clause; clause = clause->seq_chain.next)
+    {
+      Pl_Atom_GC_Mark(clause->pl_file);
+      Pl_Atom_GC_Mark_Words(&clause->term_word, clause->term_size);
+    }
+}
+
+
+
+
 #if DEBUG_LEVEL != 0
 
 /*-------------------------------------------------------------------------*
@@ -64,6 +64,10 @@ typedef struct dynpinf DynPInf;
 
 typedef struct dyncinf DynCInf;
 
+typedef struct dynicell DynICell;
+
+typedef struct dynaidx DynAIdx;
+
 typedef PlLong (*ScanFct) (DynCInf *clause, WamWord *alt_ino, Bool is_last);
 
 typedef struct			/* Double-linked chain header    */
@@ -90,11 +94,13 @@ struct dyncinf			/* Dynamic clause information     */
   DynPInf *dyn;			/* back ptr to associated dyn inf */
   D2ChHdr *p_ind_hdr;		/* back ptr to ind_chain header   */
   char **p_ind_htbl;		/* back ptr to ind htbl (or NULL) */
+  DynICell *arg_cells;		/* cells in the argument indexes  */
   int cl_no;			/* clause number                  */
   int pl_file;			/* file name of its def (or -1)   */
   DynStamp erase_stamp;		/* erase stamp or FFF...F if not  */
   DynCInf *next_erased_cl;	/* pointer to next erased clause  */
   unsigned *byte_code;		/* bc pointer (NULL=interpreted)  */
+  int byte_code_len;		/* bc length (in words)           */
   int term_size;		/* size of the term of the clause */
   WamWord term_word;		/* clause [Head|Body]=<LST,adr+1> */
   WamWord head_word;		/* adr+1 = Car = clause term Head */
@@ -111,6 +117,44 @@ typedef struct			/* Dynamic switch item info       */
 DSwtInf;
 
 
+typedef struct			/* Argument index chain header    */
+{				/* ----------------------------- */
+  DynICell *first;		/* first cell (or NULL)          */
+  DynICell *last;		/* last  cell (or NULL)          */
+}DIChHdr;
+
+
+struct dynicell			/* Argument index chain cell      */
+{				/* ------------------------------ */
+  DynCInf *clause;		/* associated clause              */
+  DynICell *next;		/* next     cell (or NULL)        */
+  DynICell *prev;		/* previous cell (or NULL)        */
+  DIChHdr *p_hdr;		/* back ptr to chain header       */
+  char **p_htbl;		/* back ptr to htbl (or NULL)     */
+  DynICell *next_of_clause;	/* next cell of the same clause   */
+};
+
+
+typedef struct			/* Arg index switch item info     */
+{				/* ------------------------------ */
+  PlLong key;			/* key: atm, int, f/n             */
+  DIChHdr chain;		/* chain of cells                 */
+}
+DASwtInf;
+
+
+struct dynaidx			/* Argument index (on demand)     */
+{				/* ------------------------------ */
+  int arg_no;			/* argument number (0 = 1st arg)  */
+  DIChHdr var_chain;		/* index if arg=VAR (chain)       */
+  char *atm_htbl;		/* index if arg=ATM (htable)      */
+  char *int_htbl;		/* index if arg=INT (htable)      */
+  DIChHdr lst_chain;		/* index if arg=LST (chain)       */
+  char *stc_htbl;		/* index if arg=STC (htable)      */
+  DynAIdx *next;		/* next argument index (or NULL)  */
+};
+
+
 struct dynpinf			/* Dynamic predicate information  */
 {				/* ------------------------------ */
   D2ChHdr seq_chain;		/* sequential chain               */
@@ -119,6 +163,7 @@ struct dynpinf			/* Dynamic predicate information  */
   char *int_htbl;		/* index if 1st arg=INT (htable)  */
   D2ChHdr lst_ind_chain;	/* index if 1st arg=LST (chain)   */
   char *stc_htbl;		/* index if 1st arg=STC (htable)  */
+  DynAIdx *arg_idx;		/* indexes on other args (or NULL)*/
   int func;			/* functor (redundant but for dbg)*/
   int arity;			/* arity (redundant but faster)   */
   int count_a;			/* next clause no for asserta, < 0*/
@@ -127,6 +172,7 @@ struct dynpinf			/* Dynamic predicate information  */
   DynStamp curr_stamp;		/* erase stamp or FFF...F if not  */
   DynCInf *first_erased_cl;	/* 1st erased clause, NULL if none*/
   DynPInf *next_dyn_with_erase;	/* next dyn with erased clauses   */
+  PlLong *prof;			/* profiler counters (or NULL)    */
 };
 
 
@@ -148,7 +194,7 @@ void Pl_Delete_Dynamic_Clause(DynCInf *clause);
 PredInf *Pl_Update_Dynamic_Pred(int func, int arity, int what_to_do, int pl_file_for_multi);
 
 DynCInf *Pl_Scan_Dynamic_Pred(int owner_func, int owner_arity,
-			      DynPInf *dyn, WamWord first_arg_word,
+			      DynPInf *dyn, WamWord *arg_adr,
 			      ScanFct alt_fct, int alt_fct_type,
 			      int alt_info_size, WamWord *alt_info);
 
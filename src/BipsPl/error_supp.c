@@ -263,6 +263,7 @@ Pl_Set_Bip_Name_2(WamWord func_word, WamWord arity_word)
   Pl_Set_C_Bip_Name("set_bip_name", 2);
 
   cur_bip_func = Pl_Rd_Atom_Check(func_word);
+  Pl_Pin_Atom(cur_bip_func);
   arity = Pl_Rd_Integer_Check(arity_word);
   if (arity > MAX_ARITY)
     arity = -1;
@@ -314,6 +314,10 @@ void Pl_Err_Syntax(int pl_atom_error);
 
 void Pl_Err_System(int pl_atom_error);
 
+typedef void (*UnwindFct) (WamWord *b);
+
+void Pl_Add_Unwind_Fct(UnwindFct fct);	/* see throw_c.c */
+
 #define Os_Test_Error_Null(tst)			\
   do {						\
     if ((tst) == NULL)				\
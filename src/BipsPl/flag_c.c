@@ -114,6 +114,10 @@ static int atom_informational;
 
 static Bool Fct_Set_Debug(FlagInf *flag, WamWord value_word);
 
+static Bool Fct_Set_GC(FlagInf *flag, WamWord value_word);
+
+static WamWord Fct_Get_Max_Atom(FlagInf *flag);
+
 static WamWord Fct_Get_Version_Data(FlagInf *flag);
 static Bool Fct_Chk_Version_Data(FlagInf *flag, WamWord tag_mask, WamWord value_word);
 
@@ -185,7 +189,7 @@ Flag_Initializer(void)
   NEW_FLAG_R_ATOM_TBL(integer_rounding_function, ((-3 / 2) == -1) ? 0 : 1, atom_toward_zero, atom_down);
 
   NEW_FLAG_R_INTEGER (max_arity,                 MAX_ARITY);
-  NEW_FLAG_R_INTEGER (max_atom,                  pl_max_atom);
+  NEW_FLAG_R         (max_atom,                  PF_TYPE_INTEGER, 0, Fct_Get_Max_Atom, NULL, NULL);
   NEW_FLAG_R_INTEGER (max_unget,                 STREAM_PB_SIZE);
 
   NEW_FLAG_R_ATOM    (home,                      pl_home ? pl_home : "");
@@ -220,6 +224,7 @@ Flag_Initializer(void)
 #else  /* to have a customized Set function */
   NEW_FLAG_W         (debug,                     PF_TYPE_ATOM_TBL, 0, NULL, NULL, Fct_Set_Debug, atom_off, atom_on, -1);
 #endif
+  NEW_FLAG_W         (gc,                        PF_TYPE_ATOM_TBL, 0, NULL, NULL, Fct_Set_GC, atom_off, atom_on, -1);
 
 
   NEW_FLAG_W_ATOM_TBL(double_quotes,             PF_QUOT_AS_CODES, atom_codes, atom_chars, atom_atom,
@@ -237,6 +242,8 @@ Flag_Initializer(void)
   NEW_FLAG_W_ATOM_TBL(os_error,                  PF_ERR_ERROR, atom_error, atom_warning, atom_fail);
 
   SYS_VAR_LINEDIT = pl_stream_use_linedit;
+
+  Pl_Engine_Add_State(pl_sys_var, MAX_SYS_VARS * sizeof(PlLong));
 }
 
 
@@ -271,6 +278,39 @@ Fct_Set_Debug(FlagInf *flag, WamWord value_word)
 
 
 
+/*-------------------------------------------------------------------------*
+ * FCT_SET_GC                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Fct_Set_GC(FlagInf *flag, WamWord value_word)
+{
+  int atom = UnTag_ATM(value_word);
+  PlLong value = (atom == atom_on);
+
+  Pl_GC_Set_Enabled(value);
+  flag->value = value;
+
+  return TRUE;
+}
+
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FCT_GET_MAX_ATOM                                                        *
+ *                                                                         *
+ * The atom table grows when it is full (see atom.c).                      *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Fct_Get_Max_Atom(FlagInf *flag)
+{
+  return Tag_INT(pl_max_atom);
+}
+
+
+
 
 /*-------------------------------------------------------------------------*
  * FCT_GET_VERSION_DATA FCT_CHK_VERSION_DATA                               *
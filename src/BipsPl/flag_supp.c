@@ -150,6 +150,7 @@ static Bool
 Fct_Set_Atom(FlagInf *flag, WamWord value_word)
 {
   flag->value = UnTag_ATM(value_word);
+  Pl_Pin_Atom(flag->value);
   return TRUE;
 }
 
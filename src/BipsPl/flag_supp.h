@@ -186,6 +186,8 @@ FlagInf *Pl_New_Prolog_Flag(char *name, Bool modifiable, FlagType type, PlLong v
 
 #define SYS_VAR_SAY_GETC            (pl_sys_var[20]) /* is it activated (0 or 1) */
 #define CHAR_TO_EMIT_ON_PIPED_GETC  '\1'
+#define CHAR_BEGIN_BYTE_CODE        '\2' /* pl2wam --pipe brackets byte-code */
+#define CHAR_END_BYTE_CODE          '\3' /* with these chars (see consult_c.c)*/
 
 
 
@@ -198,6 +200,7 @@ FlagInf *pl_flag_back_quotes;
 FlagInf *pl_flag_char_conversion;
 FlagInf *pl_flag_debug;
 FlagInf *pl_flag_double_quotes;
+FlagInf *pl_flag_gc;
 FlagInf *pl_flag_multifile_warning;
 FlagInf *pl_flag_os_error;
 FlagInf *pl_flag_singleton_warning;
@@ -217,6 +220,7 @@ extern FlagInf *pl_flag_back_quotes;
 extern FlagInf *pl_flag_char_conversion;
 extern FlagInf *pl_flag_debug;
 extern FlagInf *pl_flag_double_quotes;
+extern FlagInf *pl_flag_gc;
 extern FlagInf *pl_flag_multifile_warning;
 extern FlagInf *pl_flag_os_error;
 extern FlagInf *pl_flag_singleton_warning;
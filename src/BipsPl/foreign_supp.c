@@ -89,6 +89,8 @@ WamWord pl_query_exception;		/* overwrite var of throw_c.c */
  * Function Prototypes             *
  *---------------------------------*/
 
+static void Reserve_Goal_Space(void);
+
 static CodePtr Prepare_Call(int func, int arity, WamWord *arg_adr);
 
 
@@ -112,6 +114,27 @@ Prolog_Prototype(PL_QUERY_RECOVER_ALT, 0);
  *-------------------------------------------------------------------------*/
 static void
 Foreign_Initializer(void)
+{
+  Pl_Engine_Add_State(&goal_H, sizeof(goal_H));
+  Pl_Engine_Add_State(query_stack, sizeof(query_stack));
+  Pl_Engine_Add_State(&query_stack_top, sizeof(query_stack_top));
+  Pl_Engine_Add_State(&pl_query_top_b, sizeof(pl_query_top_b));
+  Pl_Engine_Add_State(&pl_query_exception, sizeof(pl_query_exception));
+
+  Pl_Engine_Add_Init_Fct(Reserve_Goal_Space);
+  Reserve_Goal_Space();
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RESERVE_GOAL_SPACE                                                      *
+ *                                                                         *
+ * Reserves the heap space of the meta-call goal (also for a new engine).  *
+ *-------------------------------------------------------------------------*/
+static void
+Reserve_Goal_Space(void)
 {
   goal_H = H;
   H = H + MAX_ARITY + 1;
@@ -326,6 +349,8 @@ Pl_Query_Begin(Bool recoverable)
 
   if (recoverable)
     Pl_Create_Choice_Point(Prolog_Predicate(PL_QUERY_RECOVER_ALT, 0), 0);
+
+  Pl_GC_Inhibit(TRUE);		/* the C caller holds heap pointers */
 }
 
 
@@ -409,6 +434,8 @@ Pl_Query_End(int op)
   query_b = *--query_stack_top;
   pl_query_top_b = query_stack_top[-1];
 
+  Pl_GC_Inhibit(FALSE);
+
   recoverable =
     (ALTB(query_b) == Prolog_Predicate(PL_QUERY_RECOVER_ALT, 0));
   prev_b = BB(query_b);
@@ -213,8 +213,10 @@ Format(StmInf *pstm, char *format, WamWord args_word)
 
           if (*format != '~')
             {
-              Pl_Stream_Putc(*format, pstm);
-              format++;
+              for (p = format + 1; *p && *p != '~' && *p != '%'; p++)
+                ;
+              Pl_Stream_Write_Block(format, (int) (p - format), pstm);
+              format = p;
               continue;
             }
 
@@ -37,6 +37,7 @@
 
 
 #include <stdlib.h>
+#include <string.h>
 
 #define OBJ_INIT G_Var_Initializer
 
@@ -105,6 +106,9 @@ typedef struct			/* Target designator record       */
 
 static GTarget g_target;
 
+static GVarElt **g_var_tbl;	/* atom -> its global variable (or NULL) */
+static PlULong g_var_tbl_size;	/* (both specific to each engine)  */
+
 static int atom_g_array;
 static int atom_g_array_auto;
 static int atom_g_array_extend;
@@ -149,6 +153,21 @@ static void G_Trail_For_Backtrack(GVarElt *g_elem, PlLong  save_size, WamWord sa
 
 static void G_Untrail(int n, WamWord *arg_frame);
 
+static void G_GC_Roots(GCVisitFct visit);
+
+static void G_GC_Trail(WamWord fct, int nb, WamWord *arg_frame,
+		       GCVisitFct visit);
+
+static void G_GC_Element(GVarElt *g_elem, GCVisitFct visit);
+
+static void G_Atom_GC_Roots(void);
+
+static void G_Atom_GC_Engine(void);
+
+static void G_Destroy_Engine(void);
+
+static void G_Atom_GC_Element(GVarElt *g_elem);
+
 static Bool G_Read(WamWord gvar_word, WamWord gval_word);
 
 static Bool G_Read_Element(GVarElt *g_elem, WamWord gval_word);
@@ -179,6 +198,14 @@ G_Var_Initializer(void)
   atom_g_array = Pl_Create_Atom("g_array");
   atom_g_array_auto = Pl_Create_Atom("g_array_auto");
   atom_g_array_extend = Pl_Create_Atom("g_array_extend");
+
+  Pl_GC_Add_Root_Fct(G_GC_Roots);
+  Pl_GC_Add_Trail_Fct(G_GC_Trail);
+  Pl_Atom_GC_Add_Root_Fct(G_Atom_GC_Roots);
+
+  Pl_Engine_Add_State(&g_var_tbl, sizeof(g_var_tbl));
+  Pl_Engine_Add_State(&g_var_tbl_size, sizeof(g_var_tbl_size));
+  Pl_Engine_Add_Destroy_Fct(G_Destroy_Engine);
 }
 
 
@@ -473,6 +500,7 @@ Pl_Blt_G_Test_Reset_Bit(WamWord x, WamWord y)
  * Global variable management                                              *
  *                                                                         *
  * A global variable allows the user to associate an information to an atom*
+ * in the current engine (g_var_tbl is indexed by the atom, see engine.c). *
  * There are 3 types of information (2 basic types + 1 constructor):       *
  *                                                                         *
  *   - copy of a term,   builtin: g_assign[b](Gvar, Term)                  *
@@ -849,15 +877,22 @@ Get_Target_From_Gvar(WamWord gvar_word)
   if (atom == ATOM_CHAR('-') && arity == 2)
     return Get_Target_From_Selector(arg_adr - OFFSET_ARG);
 
-  g_elem = (GVarElt *) pl_atom_tbl[atom].info;
+  g_elem = ((PlULong) atom < g_var_tbl_size) ? g_var_tbl[atom] : NULL;
 
   if (g_elem == NULL)
     {
-      g_elem = (GVarElt *) Malloc(sizeof(GVarElt)); /* NB: never recovered */
+      if ((PlULong) atom >= g_var_tbl_size) /* the atom table has grown */
+	{
+	  g_var_tbl = (GVarElt **) Realloc(g_var_tbl, pl_max_atom * sizeof(GVarElt *));
+	  memset(g_var_tbl + g_var_tbl_size, 0,
+		 (pl_max_atom - g_var_tbl_size) * sizeof(GVarElt *));
+	  g_var_tbl_size = pl_max_atom;
+	}
+      g_elem = (GVarElt *) Malloc(sizeof(GVarElt)); /* NB: freed with the engine */
       g_elem->size = 0;
       g_elem->val = G_INITIAL_VALUE;
       g_elem->undo = NULL;
-      pl_atom_tbl[atom].info = g_elem;
+      g_var_tbl[atom] = g_elem;
     }
 
   if (arity > 0 && g_elem->size >= 0)
@@ -1211,6 +1246,197 @@ G_Untrail(int n, WamWord *arg_frame)
 
 
 
+/*-------------------------------------------------------------------------*
+ * G_GC_ROOTS                                                              *
+ *                                                                         *
+ * Called by the garbage collector to visit the links to heap terms.       *
+ *-------------------------------------------------------------------------*/
+static void
+G_GC_Roots(GCVisitFct visit)
+{
+  PlULong atom;
+
+  for (atom = 0; atom < g_var_tbl_size; atom++)
+    if (g_var_tbl[atom])
+      G_GC_Element(g_var_tbl[atom], visit);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * G_GC_TRAIL                                                              *
+ *                                                                         *
+ * Called by the garbage collector for each TFC trail entry: visit the     *
+ * links saved in a (valid) undo record.                                   *
+ *-------------------------------------------------------------------------*/
+static void
+G_GC_Trail(WamWord fct, int nb, WamWord *arg_frame, GCVisitFct visit)
+{
+  GUndo *u;
+  GVarElt save;
+
+  if (fct != (WamWord) G_Untrail)
+    return;
+
+  u = (GUndo *) arg_frame[0];
+  if (u->g_elem == NULL)	/* invalid entry */
+    return;
+
+  save.size = u->save_size;
+  save.val = u->save_val;
+  G_GC_Element(&save, visit);
+  u->save_val = save.val;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * G_GC_ELEMENT                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+G_GC_Element(GVarElt *g_elem, GCVisitFct visit)
+{
+  PlLong size, i;
+  GVarElt *p;
+
+  size = g_elem->size;
+
+  if (size == 0)		/* a link */
+    {
+      (*visit) (&g_elem->val);
+      return;
+    }
+
+  if (size > 0)			/* a copy: not in the heap */
+    return;
+
+  size = -size;
+  p = (GVarElt *) (g_elem->val);
+
+  for (i = 0; i < size; i++)
+    G_GC_Element(p++, visit);
+
+  if (p->size != G_IMPOSSIBLE_SIZE)	/* last elem */
+    G_GC_Element(p, visit);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * G_ATOM_GC_ROOTS                                                         *
+ *                                                                         *
+ * Called by the atom garbage collector to mark the names and the atoms of *
+ * the values (and of the values saved for backtracking) of the global     *
+ * variables of all engines.                                               *
+ *-------------------------------------------------------------------------*/
+static void
+G_Atom_GC_Roots(void)
+{
+  G_Atom_GC_Engine();
+  Pl_Engine_For_Each_Suspended(G_Atom_GC_Engine);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * G_ATOM_GC_ENGINE                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+G_Atom_GC_Engine(void)
+{
+  PlULong atom;
+
+  for (atom = 0; atom < g_var_tbl_size; atom++)
+    if (g_var_tbl[atom])
+      {
+	Pl_Atom_GC_Mark((int) atom);
+	G_Atom_GC_Element(g_var_tbl[atom]);
+      }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * G_DESTROY_ENGINE                                                        *
+ *                                                                         *
+ * Frees the global variables of an engine being destroyed (its trail, and *
+ * thus the undo records, are lost).                                       *
+ *-------------------------------------------------------------------------*/
+static void
+G_Destroy_Engine(void)
+{
+  PlULong atom;
+
+  for (atom = 0; atom < g_var_tbl_size; atom++)
+    if (g_var_tbl[atom])
+      {
+	G_Free_Element(g_var_tbl[atom], FALSE);
+	Free(g_var_tbl[atom]);
+      }
+
+  if (g_var_tbl)
+    Free(g_var_tbl);
+  g_var_tbl = NULL;
+  g_var_tbl_size = 0;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * G_ATOM_GC_ELEMENT                                                       *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+G_Atom_GC_Element(GVarElt *g_elem)
+{
+  PlLong size, i;
+  GVarElt *p;
+  GUndo *u;
+  GVarElt save;
+
+  for (u = g_elem->undo; u; u = u->next)
+    {
+      save.size = u->save_size;
+      save.val = u->save_val;
+      save.undo = NULL;
+      G_Atom_GC_Element(&save);
+    }
+
+  size = g_elem->size;
+
+  if (size == 0)		/* a link */
+    {
+      Pl_Atom_GC_Mark_Words(&g_elem->val, 1);
+      return;
+    }
+
+  if (size > 0)			/* a copy */
+    {
+      Pl_Atom_GC_Mark_Words((WamWord *) g_elem->val, size);
+      return;
+    }
+
+  size = -size;
+  p = (GVarElt *) (g_elem->val);
+
+  for (i = 0; i < size; i++)
+    G_Atom_GC_Element(p++);
+
+  if (p->size != G_IMPOSSIBLE_SIZE)	/* last elem */
+    G_Atom_GC_Element(p);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * G_READ                                                                  *
  *                                                                         *
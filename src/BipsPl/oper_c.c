@@ -261,10 +261,9 @@ Pl_Current_Op_3(WamWord prec_word, WamWord specif_word, WamWord oper_word)
       A(0) = prec_word;
       A(1) = specif_word;
       A(2) = oper_word;
-      A(3) = (WamWord) scan.endt;
-      A(4) = (WamWord) scan.cur_t;
-      A(5) = (WamWord) scan.cur_p;
-      Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(CURRENT_OP_ALT, 0), 6);
+      A(3) = (WamWord) scan.tbl;
+      A(4) = (WamWord) scan.cur;
+      Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(CURRENT_OP_ALT, 0), 5);
     }
 
   return Pl_Get_Integer(oper->prec, prec_word) &&
@@ -311,9 +310,8 @@ Pl_Current_Op_Alt_0(void)
     }
   else
     {
-      scan.endt = (char *) AB(B, 3);
-      scan.cur_t = (char *) AB(B, 4);
-      scan.cur_p = (char *) AB(B, 5);
+      scan.tbl = (char *) AB(B, 3);
+      scan.cur = (PlLong) AB(B, 4);
 
       oper = (OperInf *) Pl_Hash_Next(&scan);
       if (oper == NULL)
@@ -327,10 +325,9 @@ Pl_Current_Op_Alt_0(void)
       AB(B, 0) = prec_word;
       AB(B, 1) = specif_word;
       AB(B, 2) = oper_word;
-      AB(B, 3) = (WamWord) scan.endt;
+      AB(B, 3) = (WamWord) scan.tbl;
 #endif
-      AB(B, 4) = (WamWord) scan.cur_t;
-      AB(B, 5) = (WamWord) scan.cur_p;
+      AB(B, 4) = (WamWord) scan.cur;
     }
 
   return Pl_Get_Integer(oper->prec, prec_word) &&
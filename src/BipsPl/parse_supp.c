@@ -352,7 +352,7 @@ Parse_Term(int cur_prec, int context, Bool comma_is_punct)
 
       if (flag_value == PF_QUOT_AS_ATOM || flag_value == PF_QUOT_AS_ATOM_NO_ESCAPE)
 	{
-	  atom = Pl_Create_Allocate_Atom(pl_token.name);
+	  atom = Pl_Create_Collectable_Atom(pl_token.name, TRUE);
 	  goto a_name;
 	}
 
@@ -389,7 +389,7 @@ Parse_Term(int cur_prec, int context, Bool comma_is_punct)
       break;
 
     case TOKEN_NAME:
-      atom = Pl_Create_Allocate_Atom(pl_token.name);
+      atom = Pl_Create_Collectable_Atom(pl_token.name, TRUE);
 
     a_name:
       bracket = (Pl_Scan_Peek_Char(pstm_i, TRUE) == '(');
@@ -486,7 +486,7 @@ Parse_Term(int cur_prec, int context, Bool comma_is_punct)
 	  if (pl_token.type != TOKEN_NAME)
 	    break;
 
-	  atom = Pl_Create_Allocate_Atom(pl_token.name);
+	  atom = Pl_Create_Collectable_Atom(pl_token.name, TRUE);
 	  if ((oper = Pl_Lookup_Oper(atom, INFIX)))
 	    infix_op = TRUE;
 	  else if ((oper = Pl_Lookup_Oper(atom, POSTFIX)))
@@ -784,7 +784,7 @@ Pl_Read_Atom(StmInf *pstm)
 
   Update_Last_Read_Position;
 
-  return Pl_Put_Atom(Pl_Create_Allocate_Atom(pl_token.name));
+  return Pl_Put_Atom(Pl_Create_Collectable_Atom(pl_token.name, TRUE));
 }
 
 
@@ -870,7 +870,7 @@ Pl_Read_Token(StmInf *pstm)
     case TOKEN_VARIABLE:
       func = atom_var;
     arg_of_struct:
-      atom = Pl_Create_Allocate_Atom(pl_token.name);
+      atom = Pl_Create_Collectable_Atom(pl_token.name, TRUE);
       arg = Pl_Put_Atom(atom);
       break;
 
@@ -895,7 +895,7 @@ Pl_Read_Token(StmInf *pstm)
       break;
 
     case TOKEN_NAME:
-      atom = Pl_Create_Allocate_Atom(pl_token.name);
+      atom = Pl_Create_Collectable_Atom(pl_token.name, TRUE);
       term = Pl_Put_Atom(atom);
       break;
 
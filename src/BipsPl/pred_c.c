@@ -125,10 +125,9 @@ Pl_Current_Predicate_2(WamWord pred_indic_word, WamWord which_preds_word)
   A(0) = name_word;
   A(1) = arity_word;
   A(2) = which_preds;
-  A(3) = (WamWord) scan.endt;
-  A(4) = (WamWord) scan.cur_t;
-  A(5) = (WamWord) scan.cur_p;
-  Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(CURRENT_PREDICATE_ALT, 0), 6);
+  A(3) = (WamWord) scan.tbl;
+  A(4) = (WamWord) scan.cur;
+  Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(CURRENT_PREDICATE_ALT, 0), 5);
 
   return Pl_Get_Atom(Functor_Of(pred->f_n), name_word) &&
     Pl_Get_Integer(Arity_Of(pred->f_n), arity_word);
@@ -161,9 +160,8 @@ Pl_Current_Predicate_Alt_0(void)
   name_word = AB(B, 0);
   arity_word = AB(B, 1);
   which_preds = (int) AB(B, 2);
-  scan.endt = (char *) AB(B, 3);
-  scan.cur_t = (char *) AB(B, 4);
-  scan.cur_p = (char *) AB(B, 5);
+  scan.tbl = (char *) AB(B, 3);
+  scan.cur = (PlLong) AB(B, 4);
 
   func = Tag_Mask_Of(name_word) == TAG_REF_MASK ? -1 : UnTag_ATM(name_word);
   arity = Tag_Mask_Of(arity_word) == TAG_REF_MASK ? -1 : (int) UnTag_INT(arity_word);
@@ -194,10 +192,9 @@ Pl_Current_Predicate_Alt_0(void)
   AB(B, 0) = name_word;
   AB(B, 1) = arity_word;
   AB(B, 2) = which_preds;
-  AB(B, 3) = (WamWord) scan.endt;
+  AB(B, 3) = (WamWord) scan.tbl;
 #endif
-  AB(B, 4) = (WamWord) scan.cur_t;
-  AB(B, 5) = (WamWord) scan.cur_p;
+  AB(B, 4) = (WamWord) scan.cur;
 
   return Pl_Get_Atom(Functor_Of(pred->f_n), name_word) &&
     Pl_Get_Integer(Arity_Of(pred->f_n), arity_word);
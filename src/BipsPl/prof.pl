@@ -0,0 +1,199 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : prof.pl                                                         *
+ * Descr.: predicate profiler                                              *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+
+:-	built_in.
+
+'$use_prof'.
+
+
+	% Port counts are collected in byte-code (consulted code) and in
+	% native code compiled with gplc --profile (see prof_supp.c). Each
+	% profiled call pushes a frame whose continuation is '$prof_exit_cont'
+	% and whose choice-point is '$prof_fail_alt' ('$prof_redo_alt' is
+	% pushed at a non-deterministic exit).
+	% Time is sampled every Period microseconds of CPU (or wall) time,
+	% a sample is charged to the current predicate (self) and to all
+	% predicates found in the continuation chain (total).
+
+:- meta_predicate(profile(0)).
+:- meta_predicate(profile(0, +)).
+
+profile(Goal) :-
+	set_bip_name(profile, 1),
+	'$profile'(Goal, [], 1).
+
+
+profile(Goal, Options) :-
+	set_bip_name(profile, 2),
+	'$profile'(Goal, Options, 2).
+
+
+
+
+'$profile'(Goal, Options, Arity) :-
+	'$check_list'(Options),
+	'$get_prof_options'(Options, o(cpu, 1000, flat), o(Time, Period, Report)), !,
+	'$call_c'('Pl_Prof_Start_2'(Time, Period)),
+	'$prof_run'(Goal, Arity, Report).
+
+
+'$prof_run'(Goal, Arity, Report) :-
+	catch('$call'(Goal, profile, Arity, true), Err, '$prof_abort'(Err)), !,
+	'$call_c'('Pl_Prof_Stop_0'),
+	'$prof_report'(Report).
+
+'$prof_run'(_, _, Report) :-
+	'$call_c'('Pl_Prof_Stop_0'),
+	'$prof_report'(Report),
+	fail.
+
+
+'$prof_abort'(Err) :-                  % '$call_c' cannot be meta-called
+	'$call_c'('Pl_Prof_Stop_0'),
+	throw(Err).
+
+
+
+
+'$get_prof_options'([], O, O).
+
+'$get_prof_options'([X|Options], O, O2) :-
+	'$get_prof_options1'(X, O, O1), !,
+	'$get_prof_options'(Options, O1, O2).
+
+
+'$get_prof_options1'(X, _, _) :-
+	var(X),
+	'$pl_err_instantiation'.
+
+'$get_prof_options1'(time(X), o(_, P, R), o(X, P, R)) :-
+	'$check_nonvar'(X),
+	(   X = cpu
+	;   X = wall
+	).
+
+'$get_prof_options1'(period(X), o(T, _, R), o(T, X, R)) :-
+	'$check_nonvar'(X),
+	integer(X),
+	X >= 0.
+
+'$get_prof_options1'(report(X), o(T, P, _), o(T, P, X)) :-
+	'$check_nonvar'(X),
+	(   X = flat
+	;   X = call_graph
+	;   X = none
+	).
+
+'$get_prof_options1'(X, _, _) :-
+	'$pl_err_domain'(profile_option, X).
+
+
+
+
+profile_data(PI, Key, Value) :-
+	set_bip_name(profile_data, 3),
+	'$prof_ms'(Ms),
+	'$call_c_test'('Pl_Prof_Pred_List_1'(L)),
+	member(p(PI, Calls, Exits, Redos, Fails, Choices, Self, Total), L),
+	'$prof_data'(Key, Value, Calls, Exits, Redos, Fails, Choices, Self, Total, Ms).
+
+
+'$prof_data'(calls, Calls, Calls, _, _, _, _, _, _, _).
+
+'$prof_data'(exits, Exits, _, Exits, _, _, _, _, _, _).
+
+'$prof_data'(redos, Redos, _, _, Redos, _, _, _, _, _).
+
+'$prof_data'(fails, Fails, _, _, _, Fails, _, _, _, _).
+
+'$prof_data'(choice_points, Choices, _, _, _, _, Choices, _, _, _).
+
+'$prof_data'(self, X, _, _, _, _, _, Self, _, Ms) :-
+	X is Self * Ms.
+
+'$prof_data'(total, X, _, _, _, _, _, _, Total, Ms) :-
+	X is Total * Ms.
+
+
+
+
+'$prof_ms'(Ms) :-                      % milliseconds per sample
+	'$call_c_test'('Pl_Prof_Info_2'(Period, _)),
+	Ms is Period / 1000.0.
+
+
+
+
+profile_report :-
+	set_bip_name(profile_report, 0),
+	'$prof_report'(flat).
+
+
+profile_report(Kind) :-
+	set_bip_name(profile_report, 1),
+	'$check_nonvar'(Kind),
+	(   (   Kind = flat
+	    ;   Kind = call_graph
+	    ) ->
+	    '$prof_report'(Kind)
+	;   '$pl_err_domain'(profile_report, Kind)
+	).
+
+
+
+
+'$prof_report'(none) :-
+	!.
+
+'$prof_report'(Kind) :-
+	'$call_c'('Pl_Prof_Report_1'(Kind)).
+
+
+
+
+'$prof_exit_cont' :-                   % used by C code to set a continuation
+	'$call_c_jump'('Pl_Prof_Exit_Cont_0').
+
+
+'$prof_redo_alt' :-                    % used by C code to create a choice-point
+	'$call_c_test'('Pl_Prof_Redo_Alt_0').
+
+
+'$prof_fail_alt' :-                    % used by C code to create a choice-point
+	'$call_c_test'('Pl_Prof_Fail_Alt_0').
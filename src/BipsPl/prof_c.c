@@ -0,0 +1,375 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : prof_c.c                                                        *
+ * Descr.: predicate profiler - C part                                     *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct			/* a line of the report               */
+{				/* ---------------------------------- */
+  PlLong f_n;			/* key is <functor_atom,arity>        */
+  PlLong *cnt;			/* counters (or NULL)                 */
+  ProfEnt *ent;			/* samples (or NULL)                  */
+}ProfLine;
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static WamWord Pred_Indicator(PlLong f_n);
+
+static ProfLine *Collect_Lines(int *nb_line);
+
+static int Compar_Line(const void *l1, const void *l2);
+
+static char *Pred_Name(PlLong f_n);
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_START_2                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Prof_Start_2(WamWord time_word, WamWord period_word)
+{
+  Bool wall_time = (Pl_Rd_Atom(time_word) == Pl_Create_Atom("wall"));
+
+  if (!Pl_Prof_Start(wall_time, Pl_Rd_Integer(period_word)))
+    Pl_Prof_Start(FALSE, 0);	/* no sampling: only count ports */
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_STOP_0                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Prof_Stop_0(void)
+{
+  Pl_Prof_Stop();
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_INFO_2                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Prof_Info_2(WamWord period_word, WamWord nb_sample_word)
+{
+  return Pl_Un_Integer(Pl_Prof_Period(), period_word) &&
+    Pl_Un_Integer(Pl_Prof_Nb_Samples(), nb_sample_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_REPORT_1                                                        *
+ *                                                                         *
+ * Displays the flat profile (predicates sorted by decreasing self time)   *
+ * or the call graph (callers and callees of each sampled predicate).      *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Prof_Report_1(WamWord kind_word)
+{
+  StmInf *pstm = pl_stm_tbl[pl_stm_stdout];
+  Bool call_graph = (Pl_Rd_Atom(kind_word) == Pl_Create_Atom("call_graph"));
+  double ms = Pl_Prof_Period() / 1000.0;
+  ProfLine *line, *p;
+  ProfArc *arc;
+  PlLong *cnt;
+  int nb_line, nb_arc, i, j;
+
+  line = Collect_Lines(&nb_line);
+
+  Pl_Stream_Printf(pstm, "\nProfile: %" PL_FMT_d " samples (%.3f ms)\n\n",
+		   Pl_Prof_Nb_Samples(), Pl_Prof_Nb_Samples() * ms);
+
+  if (!call_graph)
+    Pl_Stream_Printf(pstm, "%-32s %9s %9s %9s %9s %9s %11s %11s\n\n", "Predicate",
+		     "Calls", "Exits", "Fails", "Redos", "Choices", "Self(ms)", "Total(ms)");
+
+  for (i = 0, p = line; i < nb_line; i++, p++)
+    {
+      if (!call_graph)
+	{
+	  cnt = p->cnt;
+	  Pl_Stream_Printf(pstm, "%-32s %9" PL_FMT_d " %9" PL_FMT_d " %9" PL_FMT_d
+			   " %9" PL_FMT_d " %9" PL_FMT_d " %11.3f %11.3f\n",
+			   Pred_Name(p->f_n),
+			   (cnt) ? cnt[PROF_CALL] : 0, (cnt) ? cnt[PROF_EXIT] : 0,
+			   (cnt) ? cnt[PROF_FAIL] : 0, (cnt) ? cnt[PROF_REDO] : 0,
+			   (cnt) ? cnt[PROF_CHOICE] : 0,
+			   (p->ent) ? p->ent->self * ms : 0.0,
+			   (p->ent) ? p->ent->total * ms : 0.0);
+	  continue;
+	}
+
+      if (p->ent == NULL || p->ent->total == 0)
+	continue;
+
+      for (j = 0, arc = Pl_Prof_Arcs(&nb_arc); j < nb_arc; j++, arc++)
+	if (arc->callee == p->ent)
+	  Pl_Stream_Printf(pstm, "%16s %11.3f   %s\n", "", arc->nb * ms,
+			   Pred_Name(arc->caller->f_n));
+
+      Pl_Stream_Printf(pstm, "%-32s %11.3f self %11.3f total %9" PL_FMT_d " calls\n",
+		       Pred_Name(p->f_n), p->ent->self * ms, p->ent->total * ms,
+		       (p->cnt) ? p->cnt[PROF_CALL] : 0);
+
+      for (j = 0, arc = Pl_Prof_Arcs(&nb_arc); j < nb_arc; j++, arc++)
+	if (arc->caller == p->ent)
+	  Pl_Stream_Printf(pstm, "%16s %11.3f   %s\n", "", arc->nb * ms,
+			   Pred_Name(arc->callee->f_n));
+
+      Pl_Stream_Printf(pstm, "\n");
+    }
+
+  Free(line);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_PRED_LIST_1                                                     *
+ *                                                                         *
+ * Unifies list_word with a list of elements:                              *
+ *    p(Name/Arity, Calls, Exits, Redos, Fails, ChoicePoints, Self, Total) *
+ * for each predicate of the report (Self and Total are numbers of         *
+ * samples).                                                               *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Prof_Pred_List_1(WamWord list_word)
+{
+  int atom_p = Pl_Create_Atom("p");
+  ProfLine *line, *p;
+  WamWord pi_word, word;
+  int nb_line, i;
+  Bool ok = TRUE;
+
+  line = Collect_Lines(&nb_line);
+
+  for (p = line; ok && p < line + nb_line; p++)
+    {
+      pi_word = Pred_Indicator(p->f_n);
+      word = Pl_Put_Structure(atom_p, 8);
+      Pl_Unify_Value(pi_word);
+      for (i = PROF_CALL; i < PROF_NB_CNT; i++)
+	Pl_Unify_Integer((p->cnt) ? p->cnt[i] : 0);
+      Pl_Unify_Integer((p->ent) ? p->ent->self : 0);
+      Pl_Unify_Integer((p->ent) ? p->ent->total : 0);
+
+      ok = Pl_Get_List(list_word) && Pl_Unify_Value(word);
+      list_word = Pl_Unify_Variable();
+    }
+
+  Free(line);
+
+  return ok && Pl_Get_Nil(list_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_ARC_LIST_1                                                      *
+ *                                                                         *
+ * Unifies list_word with a list of elements:                              *
+ *    a(CallerName/Arity, CalleeName/Arity, Samples)                       *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Prof_Arc_List_1(WamWord list_word)
+{
+  int atom_a = Pl_Create_Atom("a");
+  ProfArc *arc;
+  WamWord caller_word, callee_word, word;
+  int nb_arc;
+
+  for (arc = Pl_Prof_Arcs(&nb_arc); nb_arc > 0; arc++, nb_arc--)
+    {
+      if (arc->caller == NULL)
+	continue;
+
+      caller_word = Pred_Indicator(arc->caller->f_n);
+      callee_word = Pred_Indicator(arc->callee->f_n);
+      word = Pl_Put_Structure(atom_a, 3);
+      Pl_Unify_Value(caller_word);
+      Pl_Unify_Value(callee_word);
+      Pl_Unify_Integer(arc->nb);
+
+      if (!Pl_Get_List(list_word) || !Pl_Unify_Value(word))
+	return FALSE;
+
+      list_word = Pl_Unify_Variable();
+    }
+
+  return Pl_Get_Nil(list_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COLLECT_LINES                                                           *
+ *                                                                         *
+ * Returns the predicates with a non null counter or sample (sorted). The  *
+ * auxiliary predicates (charged to their father) and the built-in ones    *
+ * (charged to their caller) are not listed.                               *
+ *-------------------------------------------------------------------------*/
+static ProfLine *
+Collect_Lines(int *nb_line)
+{
+  HashScan scan;
+  PredInf *pred;
+  ProfLine *line, *p;
+
+  line = p = (ProfLine *) Malloc((Pl_Hash_Nb_Elements(pl_pred_tbl) + 1) * sizeof(ProfLine));
+
+  for (pred = (PredInf *) Pl_Hash_First(pl_pred_tbl, &scan); pred;
+       pred = (PredInf *) Pl_Hash_Next(&scan))
+    {
+      p->f_n = pred->f_n;
+      p->cnt = Pl_Prof_Counters(pred);
+      p->ent = Pl_Prof_Find_Ent(pred->f_n);
+
+      if ((pred->prop & MASK_PRED_BUILTIN) ||
+	  Pl_Detect_If_Aux_Name(Functor_Of(pred->f_n)))
+	continue;
+
+      if ((p->cnt && p->cnt[PROF_CALL]) || (p->ent && p->ent->total))
+	p++;
+    }
+
+  *nb_line = (int) (p - line);
+  qsort(line, *nb_line, sizeof(ProfLine), Compar_Line);
+
+  return line;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COMPAR_LINE                                                             *
+ *                                                                         *
+ * Decreasing self time, then total time, then number of calls.            *
+ *-------------------------------------------------------------------------*/
+static int
+Compar_Line(const void *l1, const void *l2)
+{
+  ProfLine *p1 = (ProfLine *) l1;
+  ProfLine *p2 = (ProfLine *) l2;
+  PlLong x1, x2;
+
+  x1 = (p1->ent) ? p1->ent->self : 0;
+  x2 = (p2->ent) ? p2->ent->self : 0;
+  if (x1 == x2)
+    {
+      x1 = (p1->ent) ? p1->ent->total : 0;
+      x2 = (p2->ent) ? p2->ent->total : 0;
+    }
+  if (x1 == x2)
+    {
+      x1 = (p1->cnt) ? p1->cnt[PROF_CALL] : 0;
+      x2 = (p2->cnt) ? p2->cnt[PROF_CALL] : 0;
+    }
+
+  return (x1 > x2) ? -1 : (x1 < x2);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PRED_NAME                                                               *
+ *                                                                         *
+ * Returns Name/Arity in a static buffer (valid until the next call).      *
+ *-------------------------------------------------------------------------*/
+static char *
+Pred_Name(PlLong f_n)
+{
+  static char buff[1024];
+
+  sprintf(buff, "%.1000s/%d", pl_atom_tbl[Functor_Of(f_n)].name, Arity_Of(f_n));
+  return buff;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PRED_INDICATOR                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Pred_Indicator(PlLong f_n)
+{
+  WamWord word;
+
+  word = Pl_Put_Structure(ATOM_CHAR('/'), 2);
+  Pl_Unify_Atom(Functor_Of(f_n));
+  Pl_Unify_Integer(Arity_Of(f_n));
+
+  return word;
+}
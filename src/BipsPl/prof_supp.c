@@ -0,0 +1,963 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : prof_supp.c                                                     *
+ * Descr.: predicate profiler support                                      *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+#include <sys/time.h>
+#define PROF_USE_ITIMER
+#endif
+
+#define PROF_SUPP_FILE
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define START_PROF_TBL_SIZE        256
+
+#define PROF_ARC_TBL_SIZE          65536	/* must be a power of 2 */
+
+#define PROF_MAX_DEPTH             256
+
+#define PROF_EXIT_CONT             X1_2470726F665F657869745F636F6E74
+#define PROF_REDO_ALT              X1_2470726F665F7265646F5F616C74
+#define PROF_FAIL_ALT              X1_2470726F665F6661696C5F616C74
+
+	  /* frame of a call (an environment with PROF_FRAME_SIZE Y vars) */
+#define PROF_FRAME_SIZE            4
+
+#define Frame_Cnt(e)               (*(PlLong **) &Y(e, 0))
+#define Frame_B(e)                 (*(WamWord **) &Y(e, 1))
+#define Frame_F_N(e)               (*(PlLong *) &Y(e, 2))
+#define Frame_Skip(e)              (*(WamWord **) &Y(e, 3))
+
+#define Is_A_Frame(e)                                                       \
+  ((e) >= Local_Stack + ENVIR_STATIC_SIZE && (e) < Local_Stack + Local_Size)
+
+
+
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct			/* counters of a native predicate     */
+{				/* ---------------------------------- */
+  PlLong f_n;			/* key is <functor_atom,arity>        */
+  PlLong *cnt;			/* counters reserved by wam2ma        */
+}ProfReg;
+
+
+typedef struct			/* code range of a predicate          */
+{				/* ---------------------------------- */
+  char *start;			/* first address                      */
+  char *end;			/* address after the last one         */
+  ProfEnt *ent;			/* associated predicate               */
+}ProfRange;
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static char *prof_reg_tbl;	/* native counters (wam2ma --profile)  */
+
+static int period;		/* sampling period (microseconds)     */
+static PlLong nb_sample;	/* nb of samples taken                 */
+static PlLong cur_stamp;	/* stamp of the current sample         */
+
+static ProfEnt *ent_tbl;	/* predicates sorted by f_n           */
+static int nb_ent;
+
+static ProfRange *code_tbl;	/* native code sorted by address       */
+static int nb_code;
+
+static ProfRange *bc_tbl;	/* byte-code sorted by address         */
+static int nb_bc;
+
+static ProfArc *arc_tbl;	/* open addressing on caller/callee    */
+
+static WamCont bc_cont;		/* continuation inside byte-code       */
+static WamCont call_prolog_cont;	/* continuation of a C -> Prolog call  */
+
+static Bool frame_pushed;	/* some frames may still be pending    */
+
+#ifdef PROF_USE_ITIMER
+static int timer_which;
+static struct sigaction old_act;
+#endif
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static void Build_Sample_Tables(void);
+
+static void Build_BC_Table(void);
+
+static void Free_Sample_Tables(void);
+
+static void Tidy_Trail(WamWord *tr);
+
+static void Reset_Counters(void);
+
+static int Compar_Ent(const void *e1, const void *e2);
+
+static int Compar_Range(const void *r1, const void *r2);
+
+static ProfRange *Find_Range(ProfRange *tbl, int nb, char *adr);
+
+static ProfEnt *Owner_Ent(PredInf *pred);
+
+static ProfEnt *Find_Cont(WamCont cont, WamWord bci, WamWord *e);
+
+#ifdef PROF_USE_ITIMER
+static void Prof_Handler(int sig);
+#endif
+
+
+
+Prolog_Prototype(PROF_EXIT_CONT, 0);
+Prolog_Prototype(PROF_REDO_ALT, 0);
+Prolog_Prototype(PROF_FAIL_ALT, 0);
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_REGISTER                                                        *
+ *                                                                         *
+ * Called by the object initializer of a file compiled with --profile for  *
+ * each native predicate (cnt points to its PROF_NB_CNT counters).         *
+ *-------------------------------------------------------------------------*/
+void FC
+Pl_Prof_Register(int func, int arity, PlLong *cnt)
+{
+  ProfReg reg;
+
+  if (prof_reg_tbl == NULL)
+    prof_reg_tbl = Pl_Hash_Alloc_Table(START_PROF_TBL_SIZE, sizeof(ProfReg));
+
+  cnt[PROF_F_N] = Functor_Arity(func, arity);
+
+  reg.f_n = cnt[PROF_F_N];
+  reg.cnt = cnt;
+
+  Pl_Extend_Table_If_Needed(&prof_reg_tbl);
+  Pl_Hash_Insert(prof_reg_tbl, (char *) &reg, TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_CALL                                                            *
+ *                                                                         *
+ * Pushes the frame of a call: an environment saving the continuation     *
+ * (resumed by '$prof_exit_cont' at the exit) and a choice-point reached   *
+ * when the call fails. It is pushed before the cut register is read so    *
+ * that a cut inside the predicate keeps the choice-point.                 *
+ * The frames of a tail recursion all record the first one (skip) so that  *
+ * the sampler does not walk them.                                         *
+ *-------------------------------------------------------------------------*/
+void FC
+Pl_Prof_Call(PlLong *cnt)
+{
+  WamCont exit_cont = Adjust_CP(Prolog_Predicate(PROF_EXIT_CONT, 0));
+  WamWord *e;
+
+  if (!pl_prof_on)
+    return;
+
+  cnt[PROF_CALL]++;
+  frame_pushed = TRUE;
+
+  e = Local_Top + ENVIR_STATIC_SIZE + PROF_FRAME_SIZE;
+  CPE(e) = CP;
+  BCIE(e) = BCI;
+  EE(e) = E;
+#ifdef GARBAGE_COLLECTOR
+  NBYE(e) = PROF_FRAME_SIZE;
+#endif
+  Frame_Cnt(e) = cnt;
+  Frame_F_N(e) = cnt[PROF_F_N];
+  Frame_Skip(e) = (CP == exit_cont && Frame_F_N(E) == cnt[PROF_F_N]) ?
+    Frame_Skip(E) : e;
+  E = e;
+
+  Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(PROF_FAIL_ALT, 0), 1);
+  AB(B, 0) = (WamWord) e;
+  Frame_B(e) = B;
+
+  CP = exit_cont;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_EXIT_CONT_0                                                     *
+ *                                                                         *
+ * Continuation of a profiled call (E is its frame). If the choice-point   *
+ * of the frame is the last one the exit is deterministic and it is        *
+ * removed, else a choice-point is pushed to count the redo. The choice-   *
+ * point may have been removed by a cut of an enclosing clause (it is then *
+ * no longer recognized).                                                  *
+ *-------------------------------------------------------------------------*/
+WamCont
+Pl_Prof_Exit_Cont_0(void)
+{
+  WamWord *e = E;
+  WamWord *b = Frame_B(e);
+  PlLong *cnt = Frame_Cnt(e);
+
+  CP = CPE(e);
+  BCI = BCIE(e);
+  E = EE(e);
+
+  if (pl_prof_on)
+    cnt[PROF_EXIT]++;
+
+  if (B == b && ALTB(b) == (CodePtr) Prolog_Predicate(PROF_FAIL_ALT, 0) &&
+      AB(b, 0) == (WamWord) e)
+    {
+      Delete_Last_Choice_Point();
+      Tidy_Trail(TRB(b));
+    }
+  else if (B > b && pl_prof_on)
+    {
+      Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(PROF_REDO_ALT, 0), 1);
+      AB(B, 0) = (WamWord) cnt;
+    }
+
+  return UnAdjust_CP(CP);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_REDO_ALT_0                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Prof_Redo_Alt_0(void)
+{
+  PlLong *cnt = (PlLong *) AB(B, 0);
+
+  if (pl_prof_on)
+    cnt[PROF_REDO]++;
+
+  Delete_Last_Choice_Point();
+  return FALSE;			/* backtrack inside the call */
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_FAIL_ALT_0                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Prof_Fail_Alt_0(void)
+{
+  WamWord *e = (WamWord *) AB(B, 0);
+
+  if (pl_prof_on)
+    Frame_Cnt(e)[PROF_FAIL]++;
+
+  Delete_Last_Choice_Point();
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_CHOICE                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void FC
+Pl_Prof_Choice(PlLong *cnt)
+{
+  if (pl_prof_on)
+    cnt[PROF_CHOICE]++;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_BC_COUNTERS                                                     *
+ *                                                                         *
+ * Returns the counters of an emulated predicate (allocated on demand).    *
+ *-------------------------------------------------------------------------*/
+PlLong *
+Pl_Prof_BC_Counters(DynPInf *dyn)
+{
+  if (dyn->prof == NULL)
+    {
+      dyn->prof = (PlLong *) Calloc(PROF_NB_CNT, sizeof(PlLong));
+      dyn->prof[PROF_F_N] = Functor_Arity(dyn->func, dyn->arity);
+    }
+
+  return dyn->prof;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_FREE_COUNTERS                                                   *
+ *                                                                         *
+ * The counters of a deleted predicate are kept once frames have been      *
+ * pushed since a pending call may still count its ports.                  *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Prof_Free_Counters(PlLong *cnt)
+{
+  if (!frame_pushed)
+    Free(cnt);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_COUNTERS                                                        *
+ *                                                                         *
+ * Returns the counters of a predicate (or NULL if it is not profiled).    *
+ *-------------------------------------------------------------------------*/
+PlLong *
+Pl_Prof_Counters(PredInf *pred)
+{
+  ProfReg *reg;
+
+  if (pred->prop & MASK_PRED_NATIVE_CODE)
+    {
+      if (prof_reg_tbl == NULL ||
+	  (reg = (ProfReg *) Pl_Hash_Find(prof_reg_tbl, pred->f_n)) == NULL)
+	return NULL;
+
+      return reg->cnt;
+    }
+
+  return (pred->dyn) ? ((DynPInf *) pred->dyn)->prof : NULL;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_START                                                           *
+ *                                                                         *
+ * Resets all counters and starts a new profile. If period > 0 the stacks  *
+ * are sampled every period microseconds (of CPU or wall time).            *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Prof_Start(Bool wall_time, int period_us)
+{
+#ifdef PROF_USE_ITIMER
+  struct sigaction act;
+  struct itimerval it;
+#endif
+
+  if (pl_prof_on)
+    Pl_Prof_Stop();
+
+  Reset_Counters();
+  Free_Sample_Tables();
+  Build_Sample_Tables();
+  nb_sample = 0;
+  period = 0;
+
+  if (period_us > 0)
+    {
+#ifdef PROF_USE_ITIMER
+      timer_which = (wall_time) ? ITIMER_REAL : ITIMER_PROF;
+      act.sa_handler = Prof_Handler;
+      sigemptyset(&act.sa_mask);
+      act.sa_flags = SA_RESTART;
+      if (sigaction((wall_time) ? SIGALRM : SIGPROF, &act, &old_act) != 0)
+	return FALSE;
+
+      period = period_us;
+      it.it_interval.tv_sec = period / 1000000;
+      it.it_interval.tv_usec = period % 1000000;
+      it.it_value = it.it_interval;
+      setitimer(timer_which, &it, NULL);
+#else
+      return FALSE;
+#endif
+    }
+
+  pl_prof_on = TRUE;
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_STOP                                                            *
+ *                                                                         *
+ * Stops the profiler, counters and samples remain available.              *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Prof_Stop(void)
+{
+#ifdef PROF_USE_ITIMER
+  struct itimerval it;
+
+  if (period > 0)
+    {
+      memset(&it, 0, sizeof(it));
+      setitimer(timer_which, &it, NULL);
+      sigaction((timer_which == ITIMER_REAL) ? SIGALRM : SIGPROF, &old_act, NULL);
+    }
+#endif
+
+  pl_prof_on = FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_FIND_ENT                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+ProfEnt *
+Pl_Prof_Find_Ent(PlLong f_n)
+{
+  int l = 0, r = nb_ent - 1, m;
+
+  while (l <= r)
+    {
+      m = (l + r) / 2;
+      if (ent_tbl[m].f_n == f_n)
+	return ent_tbl + m;
+
+      if (ent_tbl[m].f_n < f_n)
+	l = m + 1;
+      else
+	r = m - 1;
+    }
+
+  return NULL;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_ARCS                                                            *
+ *                                                                         *
+ * Returns the arc table (free slots have a NULL caller).                  *
+ *-------------------------------------------------------------------------*/
+ProfArc *
+Pl_Prof_Arcs(int *nb_arc)
+{
+  *nb_arc = (arc_tbl) ? PROF_ARC_TBL_SIZE : 0;
+  return arc_tbl;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_NB_SAMPLES                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+PlLong
+Pl_Prof_Nb_Samples(void)
+{
+  return nb_sample;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PROF_PERIOD                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Prof_Period(void)
+{
+  return period;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * TIDY_TRAIL                                                              *
+ *                                                                         *
+ * Removes the entries above tr which are no longer needed once the        *
+ * choice-point of a frame has been removed (else the trail would keep     *
+ * all the bindings done while profiling). Function calls are kept.        *
+ *-------------------------------------------------------------------------*/
+static void
+Tidy_Trail(WamWord *tr)
+{
+  WamWord *p = TR, *dst = TR;
+  WamWord word, *adr;
+  int len;
+
+  while (p > tr)
+    {
+      word = p[-1];
+      adr = (WamWord *) (Trail_Value_Of(word));
+
+      switch (Trail_Tag_Of(word))
+	{
+	case TUV:
+	  len = 1;
+	  break;
+
+	case TOV:
+	  len = 2;
+	  break;
+
+	case TMV:
+	  len = (int) p[-2] + 2;
+	  break;
+
+	default:		/* TFC */
+	  len = (int) p[-3] + 3;
+	  adr = NULL;
+	}
+
+      p -= len;
+      if (adr == NULL || Word_Needs_Trailing(adr))
+	{
+	  dst -= len;
+	  if (dst != p)
+	    memmove(dst, p, len * sizeof(WamWord));
+	}
+    }
+
+  len = (int) (TR - dst);
+  if (dst != tr)
+    memmove(tr, dst, len * sizeof(WamWord));
+  TR = tr + len;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RESET_COUNTERS                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Reset_Counters(void)
+{
+  HashScan scan;
+  ProfReg *reg;
+  PredInf *pred;
+  DynPInf *dyn;
+
+  if (prof_reg_tbl)
+    for (reg = (ProfReg *) Pl_Hash_First(prof_reg_tbl, &scan); reg;
+	 reg = (ProfReg *) Pl_Hash_Next(&scan))
+      memset(reg->cnt + 1, 0, (PROF_NB_CNT - 1) * sizeof(PlLong));
+
+  for (pred = (PredInf *) Pl_Hash_First(pl_pred_tbl, &scan); pred;
+       pred = (PredInf *) Pl_Hash_Next(&scan))
+    if ((dyn = (DynPInf *) pred->dyn) != NULL && dyn->prof)
+      memset(dyn->prof + 1, 0, (PROF_NB_CNT - 1) * sizeof(PlLong));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * BUILD_SAMPLE_TABLES                                                     *
+ *                                                                         *
+ * The signal handler cannot allocate nor lookup hash tables: predicates,  *
+ * native code and byte-code are recorded in sorted tables at start.       *
+ *-------------------------------------------------------------------------*/
+static void
+Build_Sample_Tables(void)
+{
+  HashScan scan;
+  PredInf *pred, *pred1;
+  ProfEnt *ent;
+  int i;
+
+  nb_ent = Pl_Hash_Nb_Elements(pl_pred_tbl);
+  ent_tbl = (ProfEnt *) Calloc(nb_ent + 1, sizeof(ProfEnt));
+  code_tbl = (ProfRange *) Malloc((nb_ent + 1) * sizeof(ProfRange));
+
+  nb_ent = nb_code = 0;
+  for (pred = (PredInf *) Pl_Hash_First(pl_pred_tbl, &scan); pred;
+       pred = (PredInf *) Pl_Hash_Next(&scan))
+    ent_tbl[nb_ent++].f_n = pred->f_n;
+
+  qsort(ent_tbl, nb_ent, sizeof(ProfEnt), Compar_Ent);
+
+  for (pred = (PredInf *) Pl_Hash_First(pl_pred_tbl, &scan); pred;
+       pred = (PredInf *) Pl_Hash_Next(&scan))
+    {
+      ent = Owner_Ent(pred);
+      Pl_Prof_Find_Ent(pred->f_n)->owner = ent;
+      if ((pred->prop & MASK_PRED_NATIVE_CODE) && pred->codep)
+	{
+	  code_tbl[nb_code].start = (char *) pred->codep;
+	  code_tbl[nb_code++].ent = ent;
+	}
+    }
+
+  qsort(code_tbl, nb_code, sizeof(ProfRange), Compar_Range);
+  Build_BC_Table();
+
+  /* the code of a predicate extends up to the next one (the end of the
+   * last one is unknown, the C -> Prolog continuation is excluded apart) */
+  for (i = 0; i < nb_code; i++)
+    code_tbl[i].end = (i < nb_code - 1) ? code_tbl[i + 1].start : (char *) -1;
+
+  arc_tbl = (ProfArc *) Calloc(PROF_ARC_TBL_SIZE, sizeof(ProfArc));
+
+  pred1 = Pl_Lookup_Pred(Pl_Create_Atom("$bc_emulate_cont"), 0);
+  bc_cont = (pred1) ? Adjust_CP(pred1->codep) : NULL;
+  call_prolog_cont = Pl_Call_Prolog_Cont();
+  cur_stamp = 0;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * BUILD_BC_TABLE                                                          *
+ *                                                                         *
+ * The predicates created after the start are not sampled (no entry).      *
+ *-------------------------------------------------------------------------*/
+static void
+Build_BC_Table(void)
+{
+  HashScan scan;
+  PredInf *pred;
+  DynPInf *dyn;
+  DynCInf *clause;
+  ProfEnt *ent;
+
+  nb_bc = 0;
+  for (pred = (PredInf *) Pl_Hash_First(pl_pred_tbl, &scan); pred;
+       pred = (PredInf *) Pl_Hash_Next(&scan))
+    if ((dyn = (DynPInf *) pred->dyn) != NULL)
+      for (clause = dyn->seq_chain.first; clause; clause = clause->seq_chain.next)
+	if (clause->byte_code && !Tag_Is_ATM(clause->body_word))
+	  nb_bc++;		/* an atomic body has no continuation */
+
+  bc_tbl = (ProfRange *) Malloc((nb_bc + 1) * sizeof(ProfRange));
+  nb_bc = 0;
+
+  for (pred = (PredInf *) Pl_Hash_First(pl_pred_tbl, &scan); pred;
+       pred = (PredInf *) Pl_Hash_Next(&scan))
+    {
+      if ((dyn = (DynPInf *) pred->dyn) == NULL)
+	continue;
+
+      ent = Pl_Prof_Find_Ent(pred->f_n);
+      if (ent)
+	ent = ent->owner;
+
+      for (clause = dyn->seq_chain.first; clause; clause = clause->seq_chain.next)
+	if (clause->byte_code && !Tag_Is_ATM(clause->body_word))
+	  {
+	    bc_tbl[nb_bc].start = (char *) clause->byte_code;
+	    bc_tbl[nb_bc].end = (char *) (clause->byte_code + clause->byte_code_len);
+	    bc_tbl[nb_bc++].ent = ent;
+	  }
+    }
+
+  qsort(bc_tbl, nb_bc, sizeof(ProfRange), Compar_Range);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * OWNER_ENT                                                               *
+ *                                                                         *
+ * Returns the entry charged for the time spent in a predicate: the time   *
+ * of an auxiliary predicate is charged to its father and the time of a    *
+ * built-in predicate to its caller (NULL is returned).                    *
+ *-------------------------------------------------------------------------*/
+static ProfEnt *
+Owner_Ent(PredInf *pred)
+{
+  int func, arity;
+
+  while (!(pred->prop & MASK_PRED_BUILTIN) &&
+	 (func = Pl_Father_Pred_Of_Aux(Functor_Of(pred->f_n), &arity)) >= 0)
+    if ((pred = Pl_Lookup_Pred(func, arity)) == NULL)
+      return NULL;
+
+  return (pred->prop & MASK_PRED_BUILTIN) ? NULL : Pl_Prof_Find_Ent(pred->f_n);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FREE_SAMPLE_TABLES                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Free_Sample_Tables(void)
+{
+  if (ent_tbl == NULL)
+    return;
+
+  Free(ent_tbl);
+  Free(code_tbl);
+  Free(bc_tbl);
+  Free(arc_tbl);
+  ent_tbl = NULL;
+  code_tbl = bc_tbl = NULL;
+  arc_tbl = NULL;
+  nb_ent = nb_code = nb_bc = 0;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COMPAR_ENT                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Compar_Ent(const void *e1, const void *e2)
+{
+  PlLong f_n1 = ((ProfEnt *) e1)->f_n;
+  PlLong f_n2 = ((ProfEnt *) e2)->f_n;
+
+  return (f_n1 < f_n2) ? -1 : (f_n1 > f_n2);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COMPAR_RANGE                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Compar_Range(const void *r1, const void *r2)
+{
+  char *s1 = ((ProfRange *) r1)->start;
+  char *s2 = ((ProfRange *) r2)->start;
+
+  return (s1 < s2) ? -1 : (s1 > s2);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FIND_RANGE                                                              *
+ *                                                                         *
+ * Returns the range containing adr (or NULL).                             *
+ *-------------------------------------------------------------------------*/
+static ProfRange *
+Find_Range(ProfRange *tbl, int nb, char *adr)
+{
+  int l = 0, r = nb - 1, m;
+
+  while (l <= r)		/* find the last range starting <= adr */
+    {
+      m = (l + r) / 2;
+      if (tbl[m].start <= adr)
+	l = m + 1;
+      else
+	r = m - 1;
+    }
+
+  return (r >= 0 && adr < tbl[r].end) ? tbl + r : NULL;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FIND_CONT                                                               *
+ *                                                                         *
+ * Returns the predicate containing a continuation (or NULL). The exit of  *
+ * a profiled call (e is its frame) gives the called predicate.            *
+ *-------------------------------------------------------------------------*/
+static ProfEnt *
+Find_Cont(WamCont cont, WamWord bci, WamWord *e)
+{
+  ProfRange *r;
+  ProfEnt *ent;
+
+  if (cont == Adjust_CP(Prolog_Predicate(PROF_EXIT_CONT, 0)))
+    {
+      ent = (Is_A_Frame(e)) ? Pl_Prof_Find_Ent(Frame_F_N(e)) : NULL;
+      return (ent) ? ent->owner : NULL;
+    }
+
+  if (cont == bc_cont)
+    r = Find_Range(bc_tbl, nb_bc, (char *) ((bci >> 1) << 1));
+  else if (cont == call_prolog_cont)
+    r = NULL;
+  else
+    r = Find_Range(code_tbl, nb_code, (char *) UnAdjust_CP(cont));
+
+  return (r) ? r->ent : NULL;
+}
+
+
+
+
+#ifdef PROF_USE_ITIMER
+
+#define Chain_Add(e)                                                        \
+  do                                                                        \
+    {                                                                       \
+      ProfEnt *_e = (e);                                                    \
+      if (_e != NULL && (n == 0 || chain[n - 1] != _e))                     \
+	chain[n++] = _e;                                                    \
+    }                                                                       \
+  while (0)
+
+/*-------------------------------------------------------------------------*
+ * PROF_HANDLER                                                            *
+ *                                                                         *
+ * The current predicate is the one of CP (the frame of a profiled call    *
+ * gives its own predicate). The callers are found following the          *
+ * continuations of the environments (skipping tail recursive frames).     *
+ * Each sample counts once in the total of the predicates (and arcs) of    *
+ * the chain (recursion apart).                                            *
+ *-------------------------------------------------------------------------*/
+static void
+Prof_Handler(int sig)
+{
+  WamCont exit_cont = Adjust_CP(Prolog_Predicate(PROF_EXIT_CONT, 0));
+  ProfEnt *chain[PROF_MAX_DEPTH];
+  ProfArc *arc;
+  WamCont cont;
+  WamWord *e, *e1;
+  PlULong h;
+  int save_errno = errno;
+  int n = 0, i, k;
+
+#ifndef NO_MACHINE_REG_FOR_REG_BANK
+  pl_reg_bank = save_reg_bank;	/* restored at return from the handler */
+#endif
+
+  nb_sample++;
+  cur_stamp++;
+
+  cont = CP;
+  Chain_Add(Find_Cont(cont, BCI, E));
+
+  for (e = E; n < PROF_MAX_DEPTH && Is_A_Frame(e); e = e1)
+    {
+      if (cont == exit_cont && Is_A_Frame(Frame_Skip(e)) && Frame_Skip(e) <= e)
+	e = Frame_Skip(e);	/* a tail recursion: same predicate */
+
+      cont = CPE(e);
+      e1 = EE(e);
+      Chain_Add(Find_Cont(cont, BCIE(e), e1));
+      if (e1 >= e)
+	break;
+    }
+
+  if (n == 0)
+    goto end;
+
+  chain[0]->self++;
+
+  for (i = 0; i < n; i++)
+    {
+      if (chain[i]->stamp != cur_stamp)
+	{
+	  chain[i]->stamp = cur_stamp;
+	  chain[i]->total++;
+	}
+
+      if (i == n - 1)
+	break;
+
+      h = (PlULong) ((chain[i + 1] - ent_tbl) * 31 + (chain[i] - ent_tbl));
+      for (k = 0; k < PROF_ARC_TBL_SIZE; k++, h++)
+	{
+	  arc = arc_tbl + (h & (PROF_ARC_TBL_SIZE - 1));
+	  if (arc->caller == NULL)
+	    {
+	      arc->caller = chain[i + 1];
+	      arc->callee = chain[i];
+	    }
+	  else if (arc->caller != chain[i + 1] || arc->callee != chain[i])
+	    continue;
+
+	  if (arc->stamp != cur_stamp)
+	    {
+	      arc->stamp = cur_stamp;
+	      arc->nb++;
+	    }
+	  break;
+	}
+    }
+
+ end:
+  errno = save_errno;
+}
+
+#endif
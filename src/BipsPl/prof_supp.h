@@ -0,0 +1,131 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : prof_supp.h                                                     *
+ * Descr.: predicate profiler support - header file                        *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+	  /* counters of a predicate (if modified -> modif wam2ma.c) */
+#define PROF_F_N                   0	/* key <functor_atom,arity> */
+#define PROF_CALL                  1
+#define PROF_EXIT                  2
+#define PROF_REDO                  3
+#define PROF_FAIL                  4
+#define PROF_CHOICE                5
+
+#define PROF_NB_CNT                6
+
+
+
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct ProfEnt		/* predicate sampled by the profiler  */
+{				/* ---------------------------------- */
+  PlLong f_n;			/* key is <functor_atom,arity>        */
+  struct ProfEnt *owner;	/* itself, its father (aux) or NULL   */
+  PlLong self;			/* nb of samples inside the predicate */
+  PlLong total;			/* nb of samples inside or below it   */
+  PlLong stamp;			/* last sample counted in total       */
+}ProfEnt;
+
+
+typedef struct			/* caller -> callee arc               */
+{				/* ---------------------------------- */
+  ProfEnt *caller;		/* caller (NULL if free slot)         */
+  ProfEnt *callee;		/* callee                             */
+  PlLong nb;			/* nb of samples through the arc      */
+  PlLong stamp;			/* last sample counted in nb          */
+}ProfArc;
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+#ifdef PROF_SUPP_FILE
+
+Bool pl_prof_on;
+
+#else
+
+extern Bool pl_prof_on;
+
+#endif
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+void FC Pl_Prof_Register(int func, int arity, PlLong *cnt);
+
+void FC Pl_Prof_Call(PlLong *cnt);
+
+WamCont Pl_Prof_Exit_Cont_0(void);
+
+Bool Pl_Prof_Redo_Alt_0(void);
+
+Bool Pl_Prof_Fail_Alt_0(void);
+
+void FC Pl_Prof_Choice(PlLong *cnt);
+
+PlLong *Pl_Prof_BC_Counters(DynPInf *dyn);
+
+void Pl_Prof_Free_Counters(PlLong *cnt);
+
+PlLong *Pl_Prof_Counters(PredInf *pred);
+
+Bool Pl_Prof_Start(Bool wall_time, int period);
+
+void Pl_Prof_Stop(void);
+
+ProfEnt *Pl_Prof_Find_Ent(PlLong f_n);
+
+ProfArc *Pl_Prof_Arcs(int *nb_arc);
+
+PlLong Pl_Prof_Nb_Samples(void);
+
+int Pl_Prof_Period(void);
@@ -35,6 +35,7 @@
  * not, see http://www.gnu.org/licenses/.                                  *
  *-------------------------------------------------------------------------*/
 
+#include <string.h>
 
 #define OBJ_INIT Sort_Initializer
 
@@ -48,6 +49,12 @@
  * Constants                       *
  *---------------------------------*/
 
+#define SORT_GENERIC               0	/* kinds of arrays (see Sort_Kind) */
+#define SORT_INT                   1
+#define SORT_ATM                   2
+
+#define SORT_ON_KEY                4	/* ORed: compare keys of pairs */
+
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
@@ -65,10 +72,9 @@ static WamWord minus_2;
  * Function Prototypes             *
  *---------------------------------*/
 
-static PlLong Keysort_Cmp(WamWord u_word, WamWord v_word);
+static int Sort_Kind(WamWord *arg, int n, Bool on_key);
 
-static int Merge_Sort(WamWord *base, WamWord *aux, int n,
-		      Bool keep_dup, PlLong (*cmp) (WamWord u_word, WamWord v_word));
+static int Merge_Sort(WamWord *base, WamWord *aux, int n, Bool keep_dup, int kind);
 
 
 
@@ -159,7 +165,7 @@ Pl_Sort_List_2(WamWord list1_word, WamWord list2_word)
   if (n == 1)
     return Pl_Unify(list1_word, list2_word);
 
-  n = Merge_Sort(arg, arg + n, n, sort_type, (sort_type != 2) ? Pl_Term_Compare : Keysort_Cmp);
+  n = Merge_Sort(arg, arg + n, n, sort_type, Sort_Kind(arg, n, sort_type == 2));
 
   /* n can have changed here (if dup removed) */
 
@@ -197,7 +203,7 @@ Pl_Sort_List_1(WamWord list_word)
   if (n <= 1)
     return;
 
-  n = Merge_Sort(arg, arg + n, n, sort_type, (sort_type != 2) ? Pl_Term_Compare : Keysort_Cmp);
+  n = Merge_Sort(arg, arg + n, n, sort_type, Sort_Kind(arg, n, sort_type == 2));
   /* n can have changed here (if dup removed) */
   /* update in-place the list */
   do
@@ -216,16 +222,70 @@ Pl_Sort_List_1(WamWord list_word)
 
 
 /*-------------------------------------------------------------------------*
- * KEYSORT_CMP                                                             *
+ * SORT_KIND                                                               *
+ *                                                                         *
+ * Returns the kind of the array to sort: SORT_INT (resp. SORT_ATM) if all *
+ * elements (or keys of pairs if on_key) are integers (resp. atoms), else  *
+ * SORT_GENERIC. Scanned elements are replaced by their dereferenced value.*
+ *-------------------------------------------------------------------------*/
+static int
+Sort_Kind(WamWord *arg, int n, Bool on_key)
+{
+  WamWord word, tag_mask;
+  WamWord first_tag_mask = 0;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      if (on_key)		/* pairs are already dereferenced */
+	{
+	  DEREF(Arg(UnTag_STC(arg[i]), 0), word, tag_mask);
+	}
+      else
+	{
+	  DEREF(arg[i], word, tag_mask);
+	  arg[i] = word;
+	}
+
+      if (i == 0)
+	first_tag_mask = tag_mask;
+
+      if (tag_mask != first_tag_mask ||
+	  (tag_mask != TAG_INT_MASK && tag_mask != TAG_ATM_MASK))
+	return (on_key) ? SORT_GENERIC | SORT_ON_KEY : SORT_GENERIC;
+    }
+
+  return ((first_tag_mask == TAG_INT_MASK) ? SORT_INT : SORT_ATM) |
+    ((on_key) ? SORT_ON_KEY : 0);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SORT_CMP                                                                *
  *                                                                         *
+ * Compares 2 elements of the array according to the kind of the array.   *
  *-------------------------------------------------------------------------*/
 static PlLong
-Keysort_Cmp(WamWord u_word, WamWord v_word)
+Sort_Cmp(WamWord u_word, WamWord v_word, int kind)
 {
-  /* here we know that u_word and v_word are dereferenced (and are pairs) */
+  WamWord tag_mask;
+
+  if (kind & SORT_ON_KEY)	/* here u_word and v_word are pairs */
+    {
+      DEREF(Arg(UnTag_STC(u_word), 0), u_word, tag_mask);
+      DEREF(Arg(UnTag_STC(v_word), 0), v_word, tag_mask);
+    }
 
-  u_word = Arg(UnTag_STC(u_word), 0);
-  v_word = Arg(UnTag_STC(v_word), 0);
+  switch (kind & ~SORT_ON_KEY)
+    {
+    case SORT_INT:
+      return UnTag_INT(u_word) - UnTag_INT(v_word);
+
+    case SORT_ATM:
+      return Pl_Atom_Compare(UnTag_ATM(u_word), UnTag_ATM(v_word));
+    }
 
   return Pl_Term_Compare(u_word, v_word);
 }
@@ -237,11 +297,11 @@ Keysort_Cmp(WamWord u_word, WamWord v_word)
  * MERGE_SORT                                                              *
  *                                                                         *
  * Merge sort on an array on n WamWords starting at base using an auxiliary*
- * array for the merge at aux. The comparaison function cmp will receive 2 *
- * elements of the array (2 WamWords) and classically returns <0, 0, >0.   *
+ * array for the merge at aux. Elements are compared with Sort_Cmp (kind   *
+ * is given by Sort_Kind) which classically returns <0, 0, >0.             *
  *-------------------------------------------------------------------------*/
 static int
-Merge_Sort(WamWord *base, WamWord *aux, int n, Bool keep_dup, PlLong (*cmp) (WamWord u_word, WamWord v_word))
+Merge_Sort(WamWord *base, WamWord *aux, int n, Bool keep_dup, int kind)
 {
   WamWord *l1, *l2;
   int n1, n2;
@@ -255,14 +315,14 @@ Merge_Sort(WamWord *base, WamWord *aux, int n, Bool keep_dup, PlLong (*cmp) (Wam
   l1 = base;
   l2 = base + n1;
 
-  n1 = Merge_Sort(l1, aux, n1, keep_dup, cmp);
-  n2 = Merge_Sort(l2, aux, n2, keep_dup, cmp);
+  n1 = Merge_Sort(l1, aux, n1, keep_dup, kind);
+  n2 = Merge_Sort(l2, aux, n2, keep_dup, kind);
   n = n1 + n2;
 
   p = aux;
   while (n1 > 0 && n2 > 0)
     {
-      if ((*cmp) (*l1, *l2) <= 0)	/* copy smaller element to aux */
+      if (Sort_Cmp(*l1, *l2, kind) <= 0)	/* copy smaller element to aux */
 	{
 	  *p++ = *l1++;
 	  n1--;
@@ -295,7 +355,7 @@ Merge_Sort(WamWord *base, WamWord *aux, int n, Bool keep_dup, PlLong (*cmp) (Wam
   n1 = n - 1;
   while (n1-- > 0)		/* copy n-1 elemens to base + test dup */
     {
-      if (cmp(*base, *p) < 0)
+      if (Sort_Cmp(*base, *p, kind) < 0)
 	*++base = *p++;
       else
 	{
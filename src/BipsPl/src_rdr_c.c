@@ -356,6 +356,7 @@ Pl_SR_Open_File_2(WamWord file_name_word, WamWord from_stream_word)
 	    }
 	}
       pstm = pl_stm_tbl[stm];
+      Pl_Pin_Atom(atom_file_name); /* kept in SR structures */
       file = (SRFile *) Malloc(sizeof(SRFile));
       file->atom_file_name = atom_file_name;
       file->stm = stm;
@@ -518,6 +519,7 @@ Pl_SR_New_Pass_1(WamWord desc_word)
   SRInf *sr = Get_Descriptor(desc_word, FALSE);
   StmInf *pstm;
   SRFile *file;
+  char buff[4096];
 
   if ((sr->mask & REREAD_MASK) == 0)
     return FALSE;
@@ -525,8 +527,8 @@ Pl_SR_New_Pass_1(WamWord desc_word)
   if (!sr->file_last->reposition && !sr->file_top->eof_reached)
     {
       pstm = pl_stm_tbl[sr->file_top->stm];
-      while(Pl_Stream_Getc(pstm) != EOF) /* read until EOF for mirror */
-	;
+      while(Pl_Stream_Read_Block(buff, sizeof(buff), pstm) == sizeof(buff))
+	;			/* read until EOF for mirror */
     }
 
   sr->next_to_reread = sr->file_first->next;
@@ -797,6 +799,7 @@ Pl_SR_Start_Module_3(WamWord module_name_word, WamWord interface_word,
 	  sprintf(pl_glob_buff, "module(%s) not encoutered - interface assumed empty",
 		  pl_atom_tbl[atom_module_name].name);
 	}
+      Pl_Pin_Atom(atom_module_name);
       m = (SRModule *) Malloc(sizeof(SRModule));
       m->atom_module_name = atom_module_name;
       m->i_atom_file_def = sr->file_top->atom_file_name;
@@ -46,6 +46,11 @@ statistics :-
 	'$call_c'('Pl_Statistics_0').
 
 
+garbage_collect :-
+	set_bip_name(garbage_collect, 0),
+	'$call_c'('Pl_Garbage_Collect_0').
+
+
 statistics(Key, Values) :-
 	set_bip_name(statistics, 2),
 	'$check_stat_key'(Key), !,
@@ -80,6 +85,8 @@ statistics(Key, Values) :-
 
 '$check_stat_key'(atoms).
 
+'$check_stat_key'(garbage_collection).
+
 '$check_stat_key'(Key) :-
 	'$pl_err_domain'(statistics_key, Key).
 
@@ -119,6 +126,9 @@ statistics(Key, Values) :-
 '$stat'(atoms, Used, Free) :-
 	'$call_c_test'('Pl_Statistics_Atoms_2'(Used, Free)).
 
+'$stat'(garbage_collection, Nb, Freed) :-
+	'$call_c_test'('Pl_Statistics_Garbage_Collection_2'(Nb, Freed)).
+
 
 
 
@@ -107,6 +107,12 @@ Pl_Statistics_0(void)
 #else
   Pl_Stream_Printf(pstm, "\nAtoms: %10d  %10d max\n", pl_nb_atom, pl_max_atom);
 #endif
+
+  Pl_Stream_Printf(pstm, "\nGarbage collection %10" PL_FMT_d " times %10" PL_FMT_d " Kb freed %7.3f sec\n",
+		   pl_gc_nb_collections, (PlLong) (pl_gc_nb_freed_words * sizeof(WamWord) / 1024),
+		   (double) pl_gc_time / 1000.0);
+  Pl_Stream_Printf(pstm, "                   %10" PL_FMT_d " atoms freed\n",
+		   pl_atom_gc_nb_freed);
   
 
   t[0] = Pl_M_User_Time();
@@ -320,6 +326,38 @@ Pl_Statistics_Atoms_2(WamWord used_word, WamWord free_word)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_STATISTICS_GARBAGE_COLLECTION_2                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Statistics_Garbage_Collection_2(WamWord nb_word, WamWord freed_word)
+{
+  return Pl_Un_Integer_Check(pl_gc_nb_collections, nb_word) &&
+    Pl_Un_Integer_Check(pl_gc_nb_freed_words * sizeof(WamWord), freed_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_GARBAGE_COLLECT_0                                                    *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Garbage_Collect_0(void)
+{
+  Bool enabled = pl_gc_enabled;	/* the gc flag only controls automatic GC */
+
+  pl_atom_gc_threshold = 0;	/* also collect the atom table */
+  pl_gc_enabled = TRUE;
+  Pl_Garbage_Collect(0);
+  Pl_GC_Set_Enabled(enabled);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * STACK_SIZE                                                              *
  *                                                                         *
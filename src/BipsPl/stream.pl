@@ -96,15 +96,15 @@ set_output(SorA) :-
 
           % open mask in sys_var[0]:
           %
-          %   b8    b7 b6     b5    b4 b3         b2   b1         b0
-          %   0/1   0/1/2     0/1   0/1/2         0/1 0/1         0/1
-          %   buffering       eof_action         reposition      text
-          %   b8=specified    b5=specified       b2=specified    0=text
-          %   b7/6=if specif  b4/3=if specif     b1=if specified 1=binary
-          %     buffering       eof action         reposition
-          %     0=none          0=error            0=false
-          %     1=line          1=eof_code         1=true
-          %     2=block         2=reset
+          %   b9    b8    b7 b6     b5    b4 b3         b2   b1         b0
+          %   0/1   0/1   0/1/2     0/1   0/1/2         0/1 0/1         0/1
+          %   mmap  buffering       eof_action         reposition      text
+          %   1=yes b8=specified    b5=specified       b2=specified    0=text
+          %         b7/6=if specif  b4/3=if specif     b1=if specified 1=binary
+          %           buffering       eof action         reposition
+          %           0=none          0=error            0=false
+          %           1=line          1=eof_code         1=true
+          %           2=block         2=reset
 
 
 open(SourceSink, Mode, Stream) :-
@@ -208,6 +208,14 @@ open(SourceSink, Mode, Stream, Options) :-
 	),
 	'$sys_var_set_bit'(0, 8).
 
+'$get_open_options2'(mmap(X)) :-
+	'$check_nonvar'(X),
+	(   X = false,
+	    '$sys_var_reset_bit'(0, 9)
+	;   X = true,
+	    '$sys_var_set_bit'(0, 9)
+	).
+
 '$get_open_options2'(alias(X)) :-
 	atom(X), !,
 	(   '$call_c_test'('Pl_Test_Alias_Not_Assigned_1'(X)) ->
@@ -219,6 +219,7 @@ Pl_Open_3(WamWord source_sink_word, WamWord mode_word, WamWord stm_word)
   FILE *f;
   int mask = (int) SYS_VAR_OPTION_MASK;
   Bool reposition;
+  Bool use_mmap = (mask >> 9) & 1;
 
 
   DEREF(source_sink_word, word, tag_mask);
@@ -245,7 +246,10 @@ Pl_Open_3(WamWord source_sink_word, WamWord mode_word, WamWord stm_word)
   else
     Pl_Err_Domain(pl_domain_io_mode, mode_word);
 
-  stm = Pl_Add_Stream_For_Stdio_File(path, mode, text);
+  if (use_mmap && mode == STREAM_MODE_READ)
+    stm = Pl_Add_Stream_For_Mapped_File(path, text);
+  else
+    stm = Pl_Add_Stream_For_Stdio_File(path, mode, text);
   if (stm < 0)
     {
       if (errno == ENOENT || errno == ENOTDIR)
@@ -285,7 +289,8 @@ Pl_Open_3(WamWord source_sink_word, WamWord mode_word, WamWord stm_word)
     if (prop.buffering != (unsigned) (mask & 3)) /* cast for MSVC warning */
       {
 	prop.buffering = mask & 3;
-	Pl_Stdio_Set_Buffering(f, prop.buffering);
+	if (Pl_Stdio_Desc_Of_Stream(stm) != NULL) /* not for a mapped file */
+	  Pl_Stdio_Set_Buffering(f, prop.buffering);
       }
   mask >>= 3;
 
@@ -993,11 +998,10 @@ Pl_Current_Alias_2(WamWord stm_word, WamWord alias_word)
     {
       A(0) = stm;
       A(1) = alias_word;
-      A(2) = (WamWord) scan.endt;
-      A(3) = (WamWord) scan.cur_t;
-      A(4) = (WamWord) scan.cur_p;
-      A(5) = (WamWord) alias;
-      Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(CURRENT_ALIAS_ALT, 0), 6);
+      A(2) = (WamWord) scan.tbl;
+      A(3) = (WamWord) scan.cur;
+      A(4) = (WamWord) alias;
+      Pl_Create_Choice_Point((CodePtr) Prolog_Predicate(CURRENT_ALIAS_ALT, 0), 5);
     }
 
   Pl_Get_Atom((int) save_alias->atom, alias_word);
@@ -1025,10 +1029,9 @@ Pl_Current_Alias_Alt_0(void)
 
   stm = (int) AB(B, 0);
   alias_word = AB(B, 1);
-  scan.endt = (char *) AB(B, 2);
-  scan.cur_t = (char *) AB(B, 3);
-  scan.cur_p = (char *) AB(B, 4);
-  alias = (AliasInf *) AB(B, 5);
+  scan.tbl = (char *) AB(B, 2);
+  scan.cur = (PlLong) AB(B, 3);
+  alias = (AliasInf *) AB(B, 4);
 
 
   save_alias = alias;
@@ -1046,11 +1049,10 @@ Pl_Current_Alias_Alt_0(void)
 #if 0 /* the following data is unchanged */
       AB(B, 0) = stm;
       AB(B, 1) = alias_word;
-      AB(B, 2) = (WamWord) scan.endt;
+      AB(B, 2) = (WamWord) scan.tbl;
 #endif
-      AB(B, 3) = (WamWord) scan.cur_t;
-      AB(B, 4) = (WamWord) scan.cur_p;
-      AB(B, 5) = (WamWord) alias;
+      AB(B, 3) = (WamWord) scan.cur;
+      AB(B, 4) = (WamWord) alias;
     }
   else
     Delete_Last_Choice_Point();
@@ -1426,8 +1428,8 @@ Pl_Open_Input_Term_Stream_2(WamWord sink_term_word, WamWord stm_word)
   int stm;
   int n;
 
-  if (SYS_VAR_OPTION_MASK == TERM_STREAM_ATOM)
-    str = pl_atom_tbl[Pl_Rd_Atom_Check(sink_term_word)].name;
+  if (SYS_VAR_OPTION_MASK == TERM_STREAM_ATOM) /* a copy: the atom can be collected */
+    str = Strdup(pl_atom_tbl[Pl_Rd_Atom_Check(sink_term_word)].name);
   else
     {
       n = Pl_List_Length(sink_term_word);	/* -1 if not a list */
@@ -1474,11 +1476,8 @@ Pl_Close_Input_Term_Stream_1(WamWord sora_word)
     Pl_Err_Permission(pl_permission_operation_close,
 		      pl_permission_type_stream, sora_word);
 
-  if (type != TERM_STREAM_ATOM)
-    {
-      str_stream = pstm->file;
-      Free(str_stream->buff);
-    }
+  str_stream = pstm->file;
+  Free(str_stream->buff);
 
   Pl_Delete_Str_Stream(stm);
 }
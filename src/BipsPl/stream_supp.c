@@ -54,6 +54,14 @@ extern void clearerr(FILE *stream);
 #undef W32_GUI_CONSOLE
 #endif
 
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#define Stdio_Getc(f)              getc(f)
+#define Stdio_Putc(c, f)           putc(c, f)
+#else
+#define Stdio_Getc(f)              getc_unlocked(f)
+#define Stdio_Putc(c, f)           putc_unlocked(c, f)
+#endif
+
 #define STREAM_SUPP_FILE
 
 #include "engine_pl.h"
@@ -69,6 +77,14 @@ extern void clearerr(FILE *stream);
 #include <unistd.h>
 #endif
 
+#if defined(HAVE_MMAP) && !defined(_WIN32) && !defined(FOR_EXTERNAL_USE)
+#define USE_MMAP_STREAMS
+#include <sys/mman.h>
+#if !defined(MAP_ANON) && defined(MAP_ANONYMOUS)
+#define MAP_ANON MAP_ANONYMOUS
+#endif
+#endif
+
 
 
 
@@ -128,6 +144,8 @@ static char *tty_ptr = NULL;	/* current pointer into the buff  */
  * Function Prototypes             *
  *---------------------------------*/
 
+static void Stream_Atom_GC_Roots(void);
+
 static int Find_Free_Stream(void);
 
 static void Del_Aliases_Of_Stream(int stm);
@@ -155,6 +173,22 @@ static int Str_Stream_Getc(StrSInf *str_stream);
 
 static void Str_Stream_Putc(int c, StrSInf *str_stream);
 
+#ifdef USE_MMAP_STREAMS
+
+static int Map_Stream_Getc(MapSInf *map);
+
+static int Map_Stream_Close(MapSInf *map);
+
+static long Map_Stream_Tell(MapSInf *map);
+
+static int Map_Stream_Seek(MapSInf *map, long offset, int whence);
+
+static Bool Map_Stream_Shrink(MapSInf *map);
+
+static int Map_Stream_SIGSEGV_Handler(void *bad_addr);
+
+#endif
+
 
 
 
@@ -291,6 +325,33 @@ Init_Stream_Supp(void)
 
   pl_alias_debugger_input = Pl_Set_Alias_To_Stream(pl_atom_debugger_input, pl_stm_stdin, TRUE);
   pl_alias_debugger_output = Pl_Set_Alias_To_Stream(pl_atom_debugger_output, pl_stm_stdout, TRUE);
+
+  Pl_Atom_GC_Add_Root_Fct(Stream_Atom_GC_Roots);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * STREAM_ATOM_GC_ROOTS                                                    *
+ *                                                                         *
+ * Called by the atom garbage collector: mark the file names of the open   *
+ * streams and the aliases.                                                *
+ *-------------------------------------------------------------------------*/
+static void
+Stream_Atom_GC_Roots(void)
+{
+  int stm;
+  AliasInf *alias;
+  HashScan scan;
+
+  for (stm = 0; stm <= pl_stm_last_used; stm++)
+    if (pl_stm_tbl[stm])
+      Pl_Atom_GC_Mark(pl_stm_tbl[stm]->atom_file_name);
+
+  for (alias = (AliasInf *) Pl_Hash_First(pl_alias_tbl, &scan); alias;
+       alias = (AliasInf *) Pl_Hash_Next(&scan))
+    Pl_Atom_GC_Mark((int) alias->atom);
 }
 
 
@@ -1259,6 +1320,43 @@ TTY_Clearerr(void)
 
 
 
+	/* a stdio stream without mirror: its FILE buffer is directly used */
+
+#define Is_Stdio_Getc(pstm)					\
+  (pstm->fct_getc == (StmFct) fgetc && pstm->mirror == NULL)
+
+#define Is_Stdio_Putc(pstm)					\
+  (pstm->fct_putc == (StmFct) fputc && pstm->mirror == NULL)
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * UPDATE_COUNTERS_BLOCK                                                   *
+ *                                                                         *
+ * Same as Update_Counters() for each character of a block. For an input   *
+ * block the line positions are also pushed (as done by Pl_Stream_Getc).   *
+ *-------------------------------------------------------------------------*/
+static void
+Update_Counters_Block(StmInf *pstm, char *buff, int size, Bool input)
+{
+  char *p, *q, *end = buff + size;
+
+  pstm->char_count += size;
+
+  for (p = buff; (q = (char *) memchr(p, '\n', end - p)) != NULL; p = q + 1)
+    {
+      if (input)
+	PB_Push(pstm->pb_line_pos, pstm->line_pos + (q - p));
+      pstm->line_count++;
+      pstm->line_pos = 0;
+    }
+
+  pstm->line_pos += end - p;
+}
+
+
+
 
 /*-------------------------------------------------------------------------*
  * BASIC_CALL_FCT_GETC                                                     *
@@ -1277,6 +1375,14 @@ Basic_Call_Fct_Getc(StmInf *pstm)
       fflush(stdout);
     }
 #endif
+  if (Is_Stdio_Getc(pstm))	/* only calls fgetc on refill */
+    return Stdio_Getc((FILE *) pstm->file);
+
+#ifdef USE_MMAP_STREAMS
+  if (pstm->fct_getc == (StmFct) Map_Stream_Getc && pstm->mirror == NULL)
+    return Map_Stream_Getc((MapSInf *) pstm->file);
+#endif
+
   c = CALL_GETC(pstm);
 
   if (c != EOF)
@@ -1298,6 +1404,12 @@ Basic_Call_Fct_Putc(int c, StmInf *pstm)
 {
   StmLst *m;
 
+  if (Is_Stdio_Putc(pstm))	/* only calls fputc on flush */
+    {
+      Stdio_Putc(c, (FILE *) pstm->file);
+      return;
+    }
+
   CALL_PUTC(c, pstm);
 
   for (m = pstm->mirror; m ; m = m->next)
@@ -1307,6 +1419,56 @@ Basic_Call_Fct_Putc(int c, StmInf *pstm)
 
 
 
+/*-------------------------------------------------------------------------*
+ * BASIC_READ_BLOCK                                                        *
+ *                                                                         *
+ * Directly read a block from a stdio or a mapped file stream. Returns the *
+ * number of bytes read or -1 if the stream cannot be read by block.       *
+ *-------------------------------------------------------------------------*/
+static int
+Basic_Read_Block(StmInf *pstm, char *buff, int size)
+{
+  int n;
+#ifdef USE_MMAP_STREAMS
+  MapSInf *map;
+  char *p;
+#endif
+
+  if (pstm->mirror != NULL)
+    return -1;
+
+  if (pstm->fct_getc == (StmFct) fgetc)
+    {
+#ifndef NO_USE_PIPED_STDIN_FOR_CONSULT
+      if (SYS_VAR_SAY_GETC && pstm->file == stdin)
+	return -1;
+#endif
+      Start_Protect_Regs_For_Signal;
+      n = (int) fread(buff, 1, size, (FILE *) pstm->file);
+      Stop_Protect_Regs_For_Signal;
+      return n;
+    }
+
+#ifdef USE_MMAP_STREAMS
+  if (pstm->fct_getc == (StmFct) Map_Stream_Getc)
+    {
+      map = (MapSInf *) pstm->file;
+      p = map->ptr;
+      n = (map->end - p < size) ? (int) (map->end - p) : size;
+      memcpy(buff, p, n);
+      map->ptr = p + n;
+      if (n > 0 && memchr(buff, '\0', n) != NULL && Map_Stream_Shrink(map))
+	n = (map->end > p) ? (int) (map->end - p) : 0;
+      return n;
+    }
+#endif
+
+  return -1;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_PB_EMPTY_BUFFER                                                      *
  *                                                                         *
@@ -1538,6 +1700,73 @@ Pl_Stream_Gets_Prompt(char *prompt, StmInf *pstm_o,
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_STREAM_READ_BLOCK                                                    *
+ *                                                                         *
+ * Read at most size characters (like successive calls to Pl_Stream_Getc). *
+ * Returns the number of characters read (less than size only at the end  *
+ * of the stream). The block is directly read from a stdio or a mapped     *
+ * file stream.                                                            *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Stream_Read_Block(char *buff, int size, StmInf *pstm)
+{
+  char *p = buff, *end = buff + size;
+  int n, c;
+
+  while (p < end)
+    {
+      if (!pstm->eof_reached && PB_Is_Empty(pstm->pb_char) &&
+	  (n = Basic_Read_Block(pstm, p, (int) (end - p))) >= 0)
+	{
+	  Update_Counters_Block(pstm, p, n, TRUE);
+	  p += n;
+	  if (p < end)
+	    pstm->eof_reached = TRUE;
+	  break;
+	}
+
+      if ((c = Pl_Stream_Getc(pstm)) == EOF)
+	break;
+
+      *p++ = c;
+    }
+
+  return (int) (p - buff);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_STREAM_WRITE_BLOCK                                                   *
+ *                                                                         *
+ * Write size characters (like successive calls to Pl_Stream_Putc). The    *
+ * block is directly written to a stdio stream.                            *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Stream_Write_Block(char *buff, int size, StmInf *pstm)
+{
+  char *p, *end = buff + size;
+
+  if (Is_Stdio_Putc(pstm))
+    {
+      fwrite(buff, 1, size, (FILE *) pstm->file);
+      Update_Counters_Block(pstm, buff, size, FALSE);
+    }
+  else
+    for (p = buff; p < end; p++)
+      {
+	Basic_Call_Fct_Putc(*p, pstm); /* like Stream_Putc */
+	Update_Counters(pstm, *p);
+      }
+
+  return size;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_STREAM_PUTC                                                          *
  *                                                                         *
@@ -1559,17 +1788,7 @@ Pl_Stream_Putc(int c, StmInf *pstm)
 int
 Pl_Stream_Puts(char *str, StmInf *pstm)
 {
-  char *p;
-  int c;
-
-  for (p = str; *p; p++)
-    {
-      c = *p;
-      Basic_Call_Fct_Putc(c, pstm); /* like Stream_Putc */
-      Update_Counters(pstm, c);
-    }
-
-  return (int) (p - str);
+  return Pl_Stream_Write_Block(str, (int) strlen(str), pstm);
 }
 
 
@@ -1584,22 +1803,13 @@ Pl_Stream_Printf(StmInf *pstm, char *format, ...)
 {
   va_list arg_ptr;
   static char str[BIG_BUFFER];
-  char *p;
-  int c;
 
 
   va_start(arg_ptr, format);
   vsprintf(str, format, arg_ptr);
   va_end(arg_ptr);
 
-  for (p = str; *p; p++)
-    {
-      c = *p;
-      Basic_Call_Fct_Putc(c, pstm); /* like Stream_Putc */
-      Update_Counters(pstm, c);
-    }
-
-  return (int) (p - str);
+  return Pl_Stream_Write_Block(str, (int) strlen(str), pstm);
 }
 
 
@@ -1984,3 +2194,256 @@ Str_Stream_Putc(int c, StrSInf *str_stream)
 
   *(str_stream->ptr)++ = c;
 }
+
+
+
+
+#ifdef USE_MMAP_STREAMS
+
+/*-------------------------------------------------------------------------*
+ * Mapped file streams: an input stream on a regular file can be read      *
+ * through a memory mapping of the whole file (open/4 option mmap(true)).  *
+ * Characters are then directly taken from the mapped pages (without any   *
+ * stdio buffer) and repositioning only moves a pointer.                   *
+ *                                                                         *
+ * If the file is truncated while mapped, accessing a page past its new    *
+ * end raises SIGBUS: Map_Stream_SIGSEGV_Handler replaces these pages by   *
+ * zero-filled pages. Reading a '\0' thus checks the size of the file and *
+ * a truncated file ends at its new size (see Map_Stream_Shrink).          *
+ *-------------------------------------------------------------------------*/
+
+static MapSInf *map_list;	/* the open mapped file streams */
+static Bool map_handler_installed;
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MAP_STREAM_GETC                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Map_Stream_Getc(MapSInf *map)
+{
+  char *p = map->ptr;
+  int c;
+
+  if (p >= map->end)
+    return EOF;
+
+  map->ptr = p + 1;
+  c = *(unsigned char *) p;
+  if (c == '\0' && Map_Stream_Shrink(map) && p >= map->end)
+    return EOF;
+
+  return c;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MAP_STREAM_CLOSE                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Map_Stream_Close(MapSInf *map)
+{
+  MapSInf **p;
+  int ret = 0;
+
+  for (p = &map_list; *p != map; p = &(*p)->next)
+    ;
+  *p = map->next;
+
+  if (map->base != NULL)
+    ret = munmap(map->base, map->length);
+
+  close(map->fd);
+  Free(map);
+  return ret;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MAP_STREAM_TELL                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static long
+Map_Stream_Tell(MapSInf *map)
+{
+  return (long) (map->ptr - map->base);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MAP_STREAM_SEEK                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Map_Stream_Seek(MapSInf *map, long offset, int whence)
+{
+  char *p;
+
+  switch (whence)
+    {
+    case SEEK_SET:
+      p = map->base;
+      break;
+
+    case SEEK_CUR:
+      p = map->ptr;
+      break;
+
+    default:			/* SEEK_END */
+      p = map->end;
+    }
+
+  if (offset < map->base - p || offset > map->end - p)
+    return -1;
+
+  map->ptr = p + offset;
+  return 0;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MAP_STREAM_SHRINK                                                       *
+ *                                                                         *
+ * Check if the file has been truncated since it was mapped. If so, the    *
+ * end of the stream is moved to the new end of the file (and the current  *
+ * position too if it is past it) and TRUE is returned.                    *
+ *-------------------------------------------------------------------------*/
+static Bool
+Map_Stream_Shrink(MapSInf *map)
+{
+  struct stat st;
+  char *end;
+
+  if (fstat(map->fd, &st) != 0 || st.st_size >= map->end - map->base)
+    return FALSE;
+
+  end = map->base + st.st_size;
+  map->end = end;
+  if (map->ptr > end)
+    map->ptr = end;
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MAP_STREAM_SIGSEGV_HANDLER                                              *
+ *                                                                         *
+ * A SIGBUS occurs when reading a mapped page past the end of a truncated  *
+ * file. The remaining pages of the mapping are replaced by zero-filled    *
+ * pages and the faulting instruction is restarted.                        *
+ *-------------------------------------------------------------------------*/
+static int
+Map_Stream_SIGSEGV_Handler(void *bad_addr)
+{
+  char *addr = (char *) bad_addr;
+  char *page;
+  MapSInf *map;
+
+  for (map = map_list; map; map = map->next)
+    {
+      if (addr < map->base || addr >= map->base + map->length)
+	continue;
+
+#ifdef MAP_ANON
+      page = (char *) ((PlULong) addr & ~((PlULong) getpagesize() - 1));
+      return mmap(page, map->base + map->length - page, PROT_READ,
+		  MAP_PRIVATE | MAP_FIXED | MAP_ANON, -1, 0) != MAP_FAILED;
+#else
+      break;
+#endif
+    }
+
+  return 0;
+}
+
+#endif /* USE_MMAP_STREAMS */
+
+
+
+
+#ifndef FOR_EXTERNAL_USE
+
+/*-------------------------------------------------------------------------*
+ * PL_ADD_STREAM_FOR_MAPPED_FILE                                           *
+ *                                                                         *
+ * Open an input stream on a mapped file. If the file cannot be mapped     *
+ * (not a regular file, no mmap,...) a stdio stream is created instead.    *
+ * Returns -1 on error (errno is set).                                     *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Add_Stream_For_Mapped_File(char *path, Bool text)
+{
+#ifdef USE_MMAP_STREAMS
+  int fd;
+  struct stat st;
+  char *base = NULL;
+  MapSInf *map;
+  char open_str[10];
+  StmProp prop;
+
+  if ((fd = open(path, O_RDONLY)) < 0)
+    return -1;
+
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+      (off_t) (size_t) st.st_size != st.st_size)
+    {
+      close(fd);
+      return Pl_Add_Stream_For_Stdio_File(path, STREAM_MODE_READ, text);
+    }
+
+  if (st.st_size > 0)	/* mmap() rejects an empty mapping */
+    {
+      base = (char *) mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+			   fd, 0);
+      if (base == (char *) MAP_FAILED)
+	{
+	  close(fd);
+	  return Pl_Add_Stream_For_Stdio_File(path, STREAM_MODE_READ, text);
+	}
+#ifdef MADV_SEQUENTIAL
+      madvise(base, (size_t) st.st_size, MADV_SEQUENTIAL);
+#endif
+    }
+
+  if (!map_handler_installed)
+    {
+      Pl_Push_SIGSEGV_Handler(Map_Stream_SIGSEGV_Handler);
+      map_handler_installed = TRUE;
+    }
+
+  map = (MapSInf *) Malloc(sizeof(MapSInf));
+  map->base = map->ptr = base;
+  map->end = base + st.st_size;
+  map->length = (size_t) st.st_size;
+  map->fd = fd;			/* kept open for Map_Stream_Shrink */
+  map->next = map_list;
+  map_list = map;
+
+  prop = Pl_Prop_And_Stdio_Mode(STREAM_MODE_READ, text, open_str);
+
+  return Pl_Add_Stream(Pl_Create_Allocate_Atom(path), map, -1, prop,
+		       (StmFct) Map_Stream_Getc, STREAM_FCT_UNDEFINED,
+		       STREAM_FCT_UNDEFINED, (StmFct) Map_Stream_Close,
+		       (StmFct) Map_Stream_Tell, (StmFct) Map_Stream_Seek,
+		       STREAM_FCT_UNDEFINED);
+#else
+  return Pl_Add_Stream_For_Stdio_File(path, STREAM_MODE_READ, text);
+#endif
+}
+
+#endif /* !FOR_EXTERNAL_USE */
@@ -188,6 +188,20 @@ StrSInf;
 
 
 
+typedef struct mapsinf		/* Mapped file Stream information */
+{				/* ------------------------------ */
+  char *base;			/* the mapped file (or NULL)      */
+  char *ptr;			/* current position into the file */
+  char *end;			/* end of the mapped file         */
+  size_t length;		/* length of the mapping          */
+  int fd;			/* the file (to check its size)   */
+  struct mapsinf *next;		/* next mapped file stream        */
+}
+MapSInf;
+
+
+
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
@@ -383,6 +397,8 @@ extern int pl_atom_null;
  * Function Prototypes             *
  *---------------------------------*/
 
+StmProp Pl_Prop_And_Stdio_Mode(int mode, Bool text, char *open_str);
+
 int Pl_Add_Stream(int atom_file_name, void *file, int fileno, StmProp prop,
 		  StmFct fct_getc, StmFct fct_putc,
 		  StmFct fct_flush, StmFct fct_close,
@@ -393,6 +409,8 @@ int Pl_Add_Stream_For_Stdio_Desc(FILE *f, int atom_path, int mode, Bool text,
 
 int Pl_Add_Stream_For_Stdio_File(char *path, int mode, Bool text);
 
+int Pl_Add_Stream_For_Mapped_File(char *path, Bool text);
+
 void Pl_Delete_Stream(int stm, Bool keep_stream);
 
 int Pl_Find_Stream_By_Alias(int atom_alias);
@@ -442,6 +460,10 @@ char *Pl_Stream_Gets(char *str, int size, StmInf *pstm);
 char *Pl_Stream_Gets_Prompt(char *prompt, StmInf *pstm_o,
 			 char *str, int size, StmInf *pstm_i);
 
+int Pl_Stream_Read_Block(char *buff, int size, StmInf *pstm);
+
+int Pl_Stream_Write_Block(char *buff, int size, StmInf *pstm);
+
 void Pl_Stream_Putc(int c, StmInf *pstm);
 
 int Pl_Stream_Puts(char *str, StmInf *pstm);
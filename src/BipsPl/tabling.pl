@@ -0,0 +1,116 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : tabling.pl                                                      *
+ * Descr.: tabling management - Prolog part                                *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+:-	built_in.
+
+'$use_tabling'.
+
+
+	% A predicate declared with :- table p/n is compiled as:
+	%
+	% p(X1,...,Xn) :- '$tbl_call'(p(X1,...,Xn), '$p/n_$aux0'(X1,...,Xn)).
+	%
+	% where '$p/n_$aux0'/n has the clauses of p/n (see tabling_c.c).
+
+'$tbl_call'(Goal, Aux) :-
+	'$call_c_test'('Pl_Tbl_Lookup_3'(Goal, Tbl, State)),
+	'$tbl_call1'(State, Tbl, Goal, Aux).
+
+
+'$tbl_call1'(complete, Tbl, Goal, _) :-
+	!,
+	'$tbl_answers'(Tbl, Goal).
+
+'$tbl_call1'(evaluating, Tbl, Goal, _) :-
+	!,
+	'$call_c'('Pl_Tbl_Consume_1'(Tbl)),
+	'$tbl_answers'(Tbl, Goal).
+
+'$tbl_call1'(_, Tbl, Goal, Aux) :-          % new or evaluated
+	'$tbl_eval'(Tbl, Goal, Aux),
+	'$tbl_answers'(Tbl, Goal).
+
+
+
+
+'$tbl_eval'(Tbl, Goal, Aux) :-
+	'$call_c'('Pl_Tbl_Start_1'(Tbl)),
+	catch('$tbl_fixpoint'(Tbl, Goal, Aux), Err, '$tbl_abort'(Tbl, Err)),
+	'$call_c'('Pl_Tbl_End_1'(Tbl)).
+
+
+'$tbl_abort'(Tbl, Err) :-           % '$call_c' cannot be meta-called
+	'$call_c'('Pl_Tbl_Abort_1'(Tbl)),
+	throw(Err).
+
+
+'$tbl_fixpoint'(Tbl, Goal, Aux) :-
+	'$call_c_test'('Pl_Tbl_Nb_New_Answers_1'(Nb)),
+	(   '$call'(Aux, call, 1, true),
+	    '$call_c'('Pl_Tbl_Add_Answer_2'(Tbl, Goal)),
+	    fail
+	;   true
+	),
+	(   '$call_c_test'('Pl_Tbl_Iterate_2'(Tbl, Nb)) ->
+	    '$tbl_fixpoint'(Tbl, Goal, Aux)
+	;   true
+	).
+
+
+
+
+'$tbl_answers'(Tbl, Goal) :-
+	'$call_c_test'('Pl_Tbl_Answers_Info_3'(Tbl, Stamp, Nb)),
+	Nb > 0,
+	'$tbl_answers'(0, Nb, Tbl, Stamp, Goal).
+
+
+'$tbl_answers'(I, Nb, Tbl, Stamp, Goal) :-   % no choice-point on the last one
+	I1 is I + 1,
+	(   I1 =:= Nb ->
+	    '$call_c_test'('Pl_Tbl_Answer_4'(Tbl, Stamp, I, Goal))
+	;   (   '$call_c_test'('Pl_Tbl_Answer_4'(Tbl, Stamp, I, Goal))
+	    ;   '$tbl_answers'(I1, Nb, Tbl, Stamp, Goal)
+	    )
+	).
+
+
+
+
+abolish_all_tables :-
+	'$call_c'('Pl_Abolish_All_Tables_0').
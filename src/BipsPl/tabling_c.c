@@ -0,0 +1,839 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : tabling_c.c                                                     *
+ * Descr.: tabling management - C part                                     *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+#include <string.h>
+#include <limits.h>
+
+#define OBJ_INIT Tabling_Initializer
+
+#include "engine_pl.h"
+#include "bips_pl.h"
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * A tabled predicate p/n is compiled (see Pl2Wam/read_file.pl) as:        *
+ *                                                                         *
+ *    p(X1,...,Xn) :- '$tbl_call'(p(X1,...,Xn), '$p/n_$aux0'(X1,...,Xn)).  *
+ *                                                                         *
+ * where '$p/n_$aux0' has the original clauses of p/n. The evaluation is   *
+ * a linear tabling (see tabling.pl): a subgoal (a call, up to variant) is *
+ * evaluated by iterating its clauses until no new answer is found while   *
+ * a variant call occurring inside this evaluation (a consumer) only       *
+ * returns the answers found so far. A subgoal which consumed answers of   *
+ * an older subgoal under evaluation is a follower: it is completed with   *
+ * the oldest subgoal (the leader) of its strongly connected component.    *
+ * Answers are only returned to the initial caller once the subgoal is     *
+ * complete (local scheduling).                                            *
+ *                                                                         *
+ * Subgoals and answers are stored as contiguous copies (as for findall)   *
+ * in hash tables (see hash.c) whose key is the hash of the term (where    *
+ * all variables hash the same). Terms with a same hash are chained and    *
+ * compared up to variant. A subgoal is referenced from Prolog by its      *
+ * index in tbl_subg (with the stamp of abolish_all_tables/0).             *
+ *-------------------------------------------------------------------------*/
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define START_SUBG_TBL_SIZE        256
+#define START_ANS_TBL_SIZE         8
+
+#define NO_DEPENDENCY              INT_MAX
+
+#define TBL_NEW                    0 /* never evaluated                    */
+#define TBL_EVALUATING             1 /* under evaluation                   */
+#define TBL_EVALUATED              2 /* follower evaluated (not complete)  */
+#define TBL_COMPLETE               3 /* all answers found                  */
+
+
+
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef struct tblans *TblAnsP;
+
+typedef struct tblans		/* an answer                          */
+{				/* ---------------------------------- */
+  TblAnsP next;			/* next answer with the same hash     */
+  int term_size;		/* size of the copy                   */
+  WamWord term_word;		/* the copy (must be the last field)  */
+}
+TblAns;
+
+
+typedef struct tblsubg *TblSubgP;
+
+typedef struct tblsubg		/* a subgoal (a tabled call)          */
+{				/* ---------------------------------- */
+  TblSubgP next;		/* next subgoal with the same hash    */
+  int index;			/* index in tbl_subg                  */
+  int state;			/* TBL_NEW, TBL_EVALUATING,...        */
+  int dfn;			/* evaluation order (depth-first nb)  */
+  int link;			/* dfn of oldest incomplete consumed  */
+  int parent;			/* subgoal evaluating when called     */
+  int stack_pos;		/* position in tbl_stack or -1        */
+  char *ans_tbl;		/* hash table of answers (TblHElt)    */
+  TblAns **ans;			/* answers in the order of discovery  */
+  int nb_ans;			/* number of answers                  */
+  int ans_size;			/* allocated size of ans              */
+  int term_size;		/* size of the copy                   */
+  WamWord term_word;		/* the copy (must be the last field)  */
+}
+TblSubg;
+
+
+typedef struct			/* hash table element                 */
+{				/* ---------------------------------- */
+  PlLong key;			/* hash of the term (variant)         */
+  char *first;			/* first TblSubg/TblAns with this key */
+}
+TblHElt;
+
+
+
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static char *subg_htbl;		/* hash table of subgoals (TblHElt)   */
+
+static TblSubg **tbl_subg;	/* subgoals by index                  */
+static int tbl_subg_size;
+static int nb_subg;
+
+static int *tbl_stack;		/* incomplete subgoals being evaluated */
+static int tbl_stack_size;
+static int tbl_stack_top;
+
+static int cur_subg = -1;	/* subgoal under evaluation (running) */
+static int cur_dfn;
+
+static PlLong nb_new_ans;	/* total number of answers added      */
+static PlLong abolish_stamp;
+
+static WamWord **var_u;		/* pairs of variables for Variant     */
+static WamWord **var_v;
+static int var_size;
+static int nb_var;
+
+static int atom_new;
+static int atom_evaluating;
+static int atom_evaluated;
+static int atom_complete;
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static void Tabling_Atom_GC_Roots(void);
+
+static unsigned Tbl_Hash(WamWord start_word);
+
+static void Tbl_Hash_Rec(WamWord start_word, HashIncrInfo *hi);
+
+static Bool Variant(WamWord u_word, WamWord v_word);
+
+static Bool Variant_Rec(WamWord u_word, WamWord v_word);
+
+static TblSubg *Get_Subgoal(WamWord tbl_word);
+
+static void Free_Subgoal(TblSubg *s);
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * TABLING_INITIALIZER                                                     *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Tabling_Initializer(void)
+{
+  subg_htbl = Pl_Hash_Alloc_Table(START_SUBG_TBL_SIZE, sizeof(TblHElt));
+
+  tbl_subg_size = START_SUBG_TBL_SIZE;
+  tbl_subg = (TblSubg **) Malloc(tbl_subg_size * sizeof(TblSubg *));
+
+  tbl_stack_size = START_SUBG_TBL_SIZE;
+  tbl_stack = (int *) Malloc(tbl_stack_size * sizeof(int));
+
+  var_size = 64;
+  var_u = (WamWord **) Malloc(var_size * sizeof(WamWord *));
+  var_v = (WamWord **) Malloc(var_size * sizeof(WamWord *));
+
+  atom_new = Pl_Create_Atom("new");
+  atom_evaluating = Pl_Create_Atom("evaluating");
+  atom_evaluated = Pl_Create_Atom("evaluated");
+  atom_complete = Pl_Create_Atom("complete");
+
+  Pl_Atom_GC_Add_Root_Fct(Tabling_Atom_GC_Roots);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * TABLING_ATOM_GC_ROOTS                                                   *
+ *                                                                         *
+ * Called by the atom garbage collector: mark the atoms of the subgoals    *
+ * and of their answers.                                                   *
+ *-------------------------------------------------------------------------*/
+static void
+Tabling_Atom_GC_Roots(void)
+{
+  TblSubg *s;
+  int i, j;
+
+  for (i = 0; i < nb_subg; i++)
+    {
+      if ((s = tbl_subg[i]) == NULL)
+	continue;
+
+      Pl_Atom_GC_Mark_Words(&s->term_word, s->term_size);
+      for (j = 0; j < s->nb_ans; j++)
+	Pl_Atom_GC_Mark_Words(&s->ans[j]->term_word, s->ans[j]->term_size);
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * TBL_HASH                                                                *
+ *                                                                         *
+ * Variant terms have the same hash (all variables hash the same).         *
+ *-------------------------------------------------------------------------*/
+static unsigned
+Tbl_Hash(WamWord start_word)
+{
+  HashIncrInfo hi;
+
+  Pl_Hash_Incr_Init(&hi);
+  Tbl_Hash_Rec(start_word, &hi);
+
+  return Pl_Hash_Incr_Term(&hi);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * TBL_HASH_REC                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Tbl_Hash_Rec(WamWord start_word, HashIncrInfo *hi)
+{
+  WamWord word, tag_mask;
+  WamWord *adr;
+  int arity;
+
+terminal_rec:
+
+  DEREF(start_word, word, tag_mask);
+
+  switch (Tag_From_Tag_Mask(tag_mask))
+    {
+    case REF:
+#ifndef NO_USE_FD_SOLVER
+    case FDV:
+#endif
+      Pl_Hash_Incr_Int32(hi, 0x7A6B);
+      break;
+
+    case ATM:
+      Pl_Hash_Incr_Int32(hi, pl_atom_tbl[UnTag_ATM(word)].hash);
+      break;
+
+    case INT:
+      Pl_Hash_Incr_Int64(hi, UnTag_INT(word));
+      break;
+
+    case FLT:
+      Pl_Hash_Incr_Double(hi, Pl_Obtain_Float(UnTag_FLT(word)));
+      break;
+
+    case LST:
+      adr = UnTag_LST(word);
+      Pl_Hash_Incr_Int32(hi, 2);
+      Tbl_Hash_Rec(Car(adr), hi);
+      start_word = Cdr(adr);
+      goto terminal_rec;
+
+    case STC:
+      adr = UnTag_STC(word);
+      arity = Arity(adr);
+      Pl_Hash_Incr_Int32(hi, pl_atom_tbl[Functor(adr)].hash);
+      Pl_Hash_Incr_Int32(hi, arity);
+
+      adr = &Arg(adr, 0);
+      while (--arity)
+	Tbl_Hash_Rec(*adr++, hi);
+
+      start_word = *adr;
+      goto terminal_rec;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * VARIANT                                                                 *
+ *                                                                         *
+ * Is the term u (on the heap) a variant of v (a stored copy) ?            *
+ *-------------------------------------------------------------------------*/
+static Bool
+Variant(WamWord u_word, WamWord v_word)
+{
+  nb_var = 0;
+  return Variant_Rec(u_word, v_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * VARIANT_REC                                                             *
+ *                                                                         *
+ * The pairs of variables already met are recorded in var_u/var_v (a term  *
+ * in a tabled call has generally few variables).                          *
+ *-------------------------------------------------------------------------*/
+static Bool
+Variant_Rec(WamWord u_word, WamWord v_word)
+{
+  WamWord u_tag_mask, v_tag_mask;
+  WamWord *u_adr, *v_adr;
+  int arity, i;
+  double d1, d2;
+
+terminal_rec:
+
+  DEREF(u_word, u_word, u_tag_mask);
+  DEREF(v_word, v_word, v_tag_mask);
+
+  if (u_tag_mask == TAG_REF_MASK
+#ifndef NO_USE_FD_SOLVER
+      || u_tag_mask == TAG_FDV_MASK
+#endif
+      )
+    {
+      if (v_tag_mask != TAG_REF_MASK
+#ifndef NO_USE_FD_SOLVER
+	  && v_tag_mask != TAG_FDV_MASK
+#endif
+	  )
+	return FALSE;
+
+      u_adr = UnTag_Address(u_word);
+      v_adr = UnTag_Address(v_word);
+      for (i = 0; i < nb_var; i++)
+	if (var_u[i] == u_adr || var_v[i] == v_adr)
+	  return var_u[i] == u_adr && var_v[i] == v_adr;
+
+      if (nb_var == var_size)
+	{
+	  i = var_size;
+	  Pl_Extend_Array((char **) &var_u, &i, sizeof(WamWord *), FALSE);
+	  Pl_Extend_Array((char **) &var_v, &var_size, sizeof(WamWord *), FALSE);
+	}
+      var_u[nb_var] = u_adr;
+      var_v[nb_var++] = v_adr;
+      return TRUE;
+    }
+
+  if (u_tag_mask != v_tag_mask)
+    return FALSE;
+
+  switch (Tag_From_Tag_Mask(u_tag_mask))
+    {
+    case FLT:
+      d1 = Pl_Obtain_Float(UnTag_FLT(u_word));
+      d2 = Pl_Obtain_Float(UnTag_FLT(v_word));
+      return memcmp(&d1, &d2, sizeof(double)) == 0;
+
+    case LST:
+      u_adr = UnTag_LST(u_word);
+      v_adr = UnTag_LST(v_word);
+      if (!Variant_Rec(Car(u_adr), Car(v_adr)))
+	return FALSE;
+
+      u_word = Cdr(u_adr);
+      v_word = Cdr(v_adr);
+      goto terminal_rec;
+
+    case STC:
+      u_adr = UnTag_STC(u_word);
+      v_adr = UnTag_STC(v_word);
+      if (Functor_And_Arity(u_adr) != Functor_And_Arity(v_adr))
+	return FALSE;
+
+      arity = Arity(u_adr);
+      u_adr = &Arg(u_adr, 0);
+      v_adr = &Arg(v_adr, 0);
+      while (--arity)
+	if (!Variant_Rec(*u_adr++, *v_adr++))
+	  return FALSE;
+
+      u_word = *u_adr;
+      v_word = *v_adr;
+      goto terminal_rec;
+    }
+
+  return u_word == v_word;	/* ATM, INT */
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * GET_SUBGOAL                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static TblSubg *
+Get_Subgoal(WamWord tbl_word)
+{
+  return tbl_subg[Pl_Rd_C_Int(tbl_word)];
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_LOOKUP_3                                                         *
+ *                                                                         *
+ * Find (or create) the subgoal associated to (a variant of) goal_word.    *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Tbl_Lookup_3(WamWord goal_word, WamWord tbl_word, WamWord state_word)
+{
+  TblHElt h_elt, *h;
+  TblSubg *s;
+  unsigned hash;
+  int size, state;
+/* fix_bug is because when gcc sees &xxx where xxx is a fct argument variable
+ * it allocates a frame even with -fomit-frame-pointer.
+ * This corrupts ebp on ix86 */
+  static WamWord fix_bug;
+
+  hash = Tbl_Hash(goal_word);
+  h = (TblHElt *) Pl_Hash_Find(subg_htbl, (PlLong) hash);
+
+  for (s = (h) ? (TblSubg *) h->first : NULL; s; s = s->next)
+    if (Variant(goal_word, s->term_word))
+      break;
+
+  if (s == NULL)
+    {
+      size = Pl_Term_Size(goal_word);
+      s = (TblSubg *) Malloc(sizeof(TblSubg) - sizeof(WamWord) +
+			     size * sizeof(WamWord));
+      s->state = TBL_NEW;
+      s->dfn = 0;
+      s->link = NO_DEPENDENCY;
+      s->parent = -1;
+      s->stack_pos = -1;
+      s->ans_tbl = Pl_Hash_Alloc_Table(START_ANS_TBL_SIZE, sizeof(TblHElt));
+      s->ans_size = START_ANS_TBL_SIZE;
+      s->ans = (TblAns **) Malloc(s->ans_size * sizeof(TblAns *));
+      s->nb_ans = 0;
+      s->term_size = size;
+      fix_bug = goal_word;
+      Pl_Copy_Term(&s->term_word, &fix_bug);
+
+      if (h == NULL)
+	{
+	  Pl_Extend_Table_If_Needed(&subg_htbl);
+	  h_elt.key = (PlLong) hash;
+	  h_elt.first = NULL;
+	  h = (TblHElt *) Pl_Hash_Insert(subg_htbl, (char *) &h_elt, FALSE);
+	}
+      s->next = (TblSubg *) h->first;
+      h->first = (char *) s;
+
+      if (nb_subg == tbl_subg_size)
+	Pl_Extend_Array((char **) &tbl_subg, &tbl_subg_size, sizeof(TblSubg *), FALSE);
+      s->index = nb_subg;
+      tbl_subg[nb_subg++] = s;
+    }
+
+  switch (s->state)
+    {
+    case TBL_NEW:
+      state = atom_new;
+      break;
+
+    case TBL_EVALUATING:
+      state = atom_evaluating;
+      break;
+
+    case TBL_EVALUATED:
+      state = atom_evaluated;
+      break;
+
+    default:
+      state = atom_complete;
+      break;
+    }
+
+  return Pl_Un_Integer(s->index, tbl_word) && Pl_Un_Atom(state, state_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_START_1                                                          *
+ *                                                                         *
+ * Start (or restart for a follower) the evaluation of a subgoal.          *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Tbl_Start_1(WamWord tbl_word)
+{
+  int tbl = Pl_Rd_C_Int(tbl_word);
+  TblSubg *s = tbl_subg[tbl];
+
+  if (s->stack_pos < 0)		/* not yet on the stack */
+    {
+      if (tbl_stack_top == tbl_stack_size)
+	Pl_Extend_Array((char **) &tbl_stack, &tbl_stack_size, sizeof(int), FALSE);
+      s->stack_pos = tbl_stack_top;
+      tbl_stack[tbl_stack_top++] = tbl;
+      s->dfn = ++cur_dfn;
+    }
+
+  s->state = TBL_EVALUATING;
+  s->link = NO_DEPENDENCY;
+  s->parent = cur_subg;
+  cur_subg = tbl;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_CONSUME_1                                                        *
+ *                                                                         *
+ * The running subgoal consumes the answers of a subgoal under evaluation  *
+ * (a variant of one of its ancestors).                                    *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Tbl_Consume_1(WamWord tbl_word)
+{
+  TblSubg *s = Get_Subgoal(tbl_word);
+  TblSubg *r;
+
+  if (cur_subg < 0)
+    return;
+
+  r = tbl_subg[cur_subg];
+  if (s->dfn < r->link)
+    r->link = s->dfn;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_ADD_ANSWER_2                                                     *
+ *                                                                         *
+ * Add an answer to a subgoal (if it is not a variant of a known answer).  *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Tbl_Add_Answer_2(WamWord tbl_word, WamWord goal_word)
+{
+  TblSubg *s = Get_Subgoal(tbl_word);
+  TblHElt h_elt, *h;
+  TblAns *a;
+  unsigned hash;
+  int size;
+  static WamWord fix_bug;
+
+  hash = Tbl_Hash(goal_word);
+  h = (TblHElt *) Pl_Hash_Find(s->ans_tbl, (PlLong) hash);
+
+  for (a = (h) ? (TblAns *) h->first : NULL; a; a = a->next)
+    if (Variant(goal_word, a->term_word))
+      return;
+
+  size = Pl_Term_Size(goal_word);
+  a = (TblAns *) Malloc(sizeof(TblAns) - sizeof(WamWord) + size * sizeof(WamWord));
+  a->term_size = size;
+  fix_bug = goal_word;
+  Pl_Copy_Term(&a->term_word, &fix_bug);
+
+  if (h == NULL)
+    {
+      Pl_Extend_Table_If_Needed(&s->ans_tbl);
+      h_elt.key = (PlLong) hash;
+      h_elt.first = NULL;
+      h = (TblHElt *) Pl_Hash_Insert(s->ans_tbl, (char *) &h_elt, FALSE);
+    }
+  a->next = (TblAns *) h->first;
+  h->first = (char *) a;
+
+  if (s->nb_ans == s->ans_size)
+    Pl_Extend_Array((char **) &s->ans, &s->ans_size, sizeof(TblAns *), FALSE);
+  s->ans[s->nb_ans++] = a;
+
+  nb_new_ans++;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_NB_NEW_ANSWERS_1                                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Tbl_Nb_New_Answers_1(WamWord nb_word)
+{
+  return Pl_Un_Integer(nb_new_ans, nb_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_ITERATE_2                                                        *
+ *                                                                         *
+ * Should the subgoal be reevaluated: new answers appeared since nb_word   *
+ * and the subgoal consumed answers of an incomplete subgoal (itself or an *
+ * older one).                                                             *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Tbl_Iterate_2(WamWord tbl_word, WamWord nb_word)
+{
+  TblSubg *s = Get_Subgoal(tbl_word);
+
+  return nb_new_ans != Pl_Rd_Integer(nb_word) && s->link <= s->dfn;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_END_1                                                            *
+ *                                                                         *
+ * End the evaluation of a subgoal. A leader completes its component (all  *
+ * the subgoals above it on the stack). A follower propagates its          *
+ * dependency to its parent.                                               *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Tbl_End_1(WamWord tbl_word)
+{
+  TblSubg *s = Get_Subgoal(tbl_word);
+  TblSubg *p;
+  int i, pos;
+
+  cur_subg = s->parent;
+
+  if (s->link < s->dfn)		/* follower */
+    {
+      s->state = TBL_EVALUATED;
+      if (cur_subg >= 0)
+	{
+	  p = tbl_subg[cur_subg];
+	  if (s->link < p->link)
+	    p->link = s->link;
+	}
+      return;
+    }
+
+  pos = s->stack_pos;		/* reset below (s is on the stack) */
+  for (i = pos; i < tbl_stack_top; i++)
+    {
+      p = tbl_subg[tbl_stack[i]];
+      p->state = TBL_COMPLETE;
+      p->stack_pos = -1;
+    }
+  tbl_stack_top = pos;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_ABORT_1                                                          *
+ *                                                                         *
+ * The evaluation of a subgoal is interrupted by an exception: the         *
+ * subgoals above it on the stack are reset (their answers are kept).      *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Tbl_Abort_1(WamWord tbl_word)
+{
+  TblSubg *s = Get_Subgoal(tbl_word);
+  TblSubg *p;
+  int i, pos;
+
+  cur_subg = s->parent;
+
+  if ((pos = s->stack_pos) < 0)
+    return;
+
+  for (i = pos; i < tbl_stack_top; i++)
+    {
+      p = tbl_subg[tbl_stack[i]];
+      p->state = TBL_NEW;
+      p->stack_pos = -1;
+    }
+  tbl_stack_top = pos;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_ANSWERS_INFO_3                                                   *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Tbl_Answers_Info_3(WamWord tbl_word, WamWord stamp_word, WamWord nb_word)
+{
+  TblSubg *s = Get_Subgoal(tbl_word);
+
+  return Pl_Un_Integer(abolish_stamp, stamp_word) &&
+    Pl_Un_Integer(s->nb_ans, nb_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_TBL_ANSWER_4                                                         *
+ *                                                                         *
+ * Unify goal_word with the answer number i (from 0) of a subgoal. Fails if*
+ * the tables have been abolished since the call.                          *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_Tbl_Answer_4(WamWord tbl_word, WamWord stamp_word, WamWord i_word,
+		WamWord goal_word)
+{
+  TblSubg *s;
+  TblAns *a;
+  WamWord word;
+
+  if (Pl_Rd_Integer(stamp_word) != abolish_stamp)
+    return FALSE;
+
+  s = Get_Subgoal(tbl_word);
+  a = s->ans[Pl_Rd_C_Int(i_word)];
+
+  Pl_Copy_Contiguous_Term(H, &a->term_word);
+  word = *H;
+  H += a->term_size;
+
+  return Pl_Unify(word, goal_word);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FREE_SUBGOAL                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Free_Subgoal(TblSubg *s)
+{
+  int i;
+
+  for (i = 0; i < s->nb_ans; i++)
+    Free(s->ans[i]);
+
+  Free(s->ans);
+  Pl_Hash_Free_Table(s->ans_tbl);
+  Free(s);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ABOLISH_ALL_TABLES_0                                                 *
+ *                                                                         *
+ * Remove all the tables. The subgoals under evaluation (if any) are kept  *
+ * (at the same index since they are referenced by running evaluations).   *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Abolish_All_Tables_0(void)
+{
+  TblHElt h_elt, *h;
+  TblSubg *s;
+  int i;
+
+  Pl_Hash_Delete_All(subg_htbl);
+
+  for (i = 0; i < nb_subg; i++)
+    {
+      if ((s = tbl_subg[i]) == NULL)
+	continue;
+
+      if (s->stack_pos < 0)	/* not under evaluation */
+	{
+	  Free_Subgoal(s);
+	  tbl_subg[i] = NULL;
+	  continue;
+	}
+
+      h_elt.key = (PlLong) Tbl_Hash(s->term_word);
+      h = (TblHElt *) Pl_Hash_Find(subg_htbl, h_elt.key);
+      if (h == NULL)
+	{
+	  Pl_Extend_Table_If_Needed(&subg_htbl);
+	  h_elt.first = NULL;
+	  h = (TblHElt *) Pl_Hash_Insert(subg_htbl, (char *) &h_elt, FALSE);
+	}
+      s->next = (TblSubg *) h->first;
+      h->first = (char *) s;
+    }
+
+  if (tbl_stack_top == 0)
+    nb_subg = 0;
+
+  abolish_stamp++;
+}
@@ -0,0 +1,91 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog buit-in predicates                                       *
+ * File  : tabling_test.pl                                                 *
+ * Descr.: tabling checks (run by make check)                              *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+:- table(path/2).
+
+path(X, Y) :-
+	path(X, Z),
+	edge(Z, Y).
+
+path(X, Y) :-
+	edge(X, Y).
+
+
+edge(1, 2).
+edge(2, 3).
+edge(3, 1).
+edge(3, 4).
+
+
+:- table(ex/1).
+
+ex(X) :-
+	(   X = 1
+	;   X = 2
+	;   throw(oops)
+	).
+
+
+
+
+check(Name, Goal) :-
+	(   catch(Goal, E, (write(Name), write(' raised '), write(E), nl, fail)) ->
+	    true
+	;   write(Name), write(' failed'), nl,
+	    halt(1)
+	).
+
+
+		% an aborted evaluation after a completed component (the tabling
+		% stack must be empty, not at -1) must be reevaluated on the next call
+
+check_abort_after_complete :-
+	findall(X-Y, path(X, Y), L),
+	length(L, 12),
+	catch(findall(X, ex(X), _), oops, true),
+	catch(findall(X, ex(X), _), oops, Caught = yes),
+	Caught == yes.
+
+
+:- initialization(main).
+
+main :-
+	write('Tabling tests started...'), nl,
+	check(abort_after_complete, check_abort_after_complete),
+	write('Tabling checks succeeded'), nl,
+	halt.
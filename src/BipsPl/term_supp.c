@@ -73,12 +73,8 @@ static WamWord *top_vars;
  * Function Prototypes             *
  *---------------------------------*/
 
-static void Copy_Term_Rec(WamWord *dst_adr, WamWord *src_adr, WamWord **p);
-
 static Bool Term_Hash(WamWord start_word, PlLong depth, unsigned *hash);
 
-static Bool Term_Hash_Rec(WamWord start_word, PlLong depth, HashIncrInfo *hi);
-
 
 
 
@@ -95,9 +91,13 @@ PlLong Pl_Term_Compare(WamWord start_u_word, WamWord start_v_word)
   WamWord *u_arg_adr;
   int v_func, v_arity;
   WamWord *v_arg_adr;
-  int i;
   PlLong x;
   double d1, d2;
+  TermStk stk;
+
+  Term_Stk_Init(&stk);
+
+ terminal_rec:
 
   DEREF(start_u_word, u_word, u_tag_mask);
   DEREF(start_v_word, v_word, v_tag_mask);
@@ -108,14 +108,16 @@ PlLong Pl_Term_Compare(WamWord start_u_word, WamWord start_v_word)
   switch (u_tag)
     {
     case REF:
-      return (v_tag != REF) ? -1 :  UnTag_REF(u_word) - UnTag_REF(v_word);
+      x = (v_tag != REF) ? -1 :  UnTag_REF(u_word) - UnTag_REF(v_word);
+      goto next_arg;
 
 #ifndef NO_USE_FD_SOLVER
     case FDV:
       if (v_tag == REF)
-	return 1;
-
-      return (v_tag != FDV) ? -1 : UnTag_FDV(u_word) - UnTag_FDV(v_word);
+	x = 1;
+      else
+	x = (v_tag != FDV) ? -1 : UnTag_FDV(u_word) - UnTag_FDV(v_word);
+      goto next_arg;
 #endif
 
     case FLT:
@@ -124,14 +126,16 @@ PlLong Pl_Term_Compare(WamWord start_u_word, WamWord start_v_word)
 	  || v_tag == FDV
 #endif
 	  )
-	return 1;
-
-      if (v_tag != FLT)
-	return -1;
-
-      d1 = Pl_Obtain_Float(UnTag_FLT(u_word));
-      d2 = Pl_Obtain_Float(UnTag_FLT(v_word));
-      return (d1 < d2) ? -1 : (d1 == d2) ? 0 : 1;
+	x = 1;
+      else if (v_tag != FLT)
+	x = -1;
+      else
+	{
+	  d1 = Pl_Obtain_Float(UnTag_FLT(u_word));
+	  d2 = Pl_Obtain_Float(UnTag_FLT(v_word));
+	  x = (d1 < d2) ? -1 : (d1 == d2) ? 0 : 1;
+	}
+      goto next_arg;
 
 
     case INT:
@@ -140,9 +144,10 @@ PlLong Pl_Term_Compare(WamWord start_u_word, WamWord start_v_word)
 	  v_tag == FDV ||
 #endif
 	  v_tag == FLT)
-	return 1;
-
-      return (v_tag != INT) ? -1 : UnTag_INT(u_word) - UnTag_INT(v_word);
+	x = 1;
+      else
+	x = (v_tag != INT) ? -1 : UnTag_INT(u_word) - UnTag_INT(v_word);
+      goto next_arg;
 
     case ATM:
       if (v_tag == REF ||
@@ -150,31 +155,60 @@ PlLong Pl_Term_Compare(WamWord start_u_word, WamWord start_v_word)
 	  v_tag == FDV ||
 #endif
 	  v_tag == FLT || v_tag == INT)
-	return 1;
-
-      return (v_tag != ATM) ? -1 : strcmp(pl_atom_tbl[UnTag_ATM(u_word)].name,
-					  pl_atom_tbl[UnTag_ATM(v_word)].name);
+	x = 1;
+      else if (v_tag != ATM)
+	x = -1;
+      else
+	{
+	  u_func = (int) UnTag_ATM(u_word);
+	  v_func = (int) UnTag_ATM(v_word);
+	  x = Pl_Atom_Compare(u_func, v_func);
+	}
+      goto next_arg;
     }
 
 				/* u_tag == LST / STC */
 
   v_arg_adr = Pl_Rd_Compound(v_word, &v_func, &v_arity);
   if (v_arg_adr == NULL)	/* v_tag != LST / STC */
-    return 1;
+    {
+      x = 1;
+      goto finish;
+    }
 
   u_arg_adr = Pl_Rd_Compound(u_word, &u_func, &u_arity);
 
   if (u_arity != v_arity)
-    return u_arity - v_arity;
+    {
+      x = u_arity - v_arity;
+      goto finish;
+    }
 
   if (u_func != v_func)
-    return strcmp(pl_atom_tbl[u_func].name, pl_atom_tbl[v_func].name);
+    {
+      x = Pl_Atom_Compare(u_func, v_func);
+      goto finish;
+    }
+
+  if (u_arity > 1)
+    Term_Stk_Push(&stk, u_arg_adr + 1, v_arg_adr + 1, u_arity - 1, 0);
 
-  for (i = 0; i < u_arity; i++)
-    if ((x = Pl_Term_Compare(*u_arg_adr++, *v_arg_adr++)) != 0)
-      return x;
+  start_u_word = *u_arg_adr;
+  start_v_word = *v_arg_adr;
+  goto terminal_rec;
+
+ next_arg:
+  if (x == 0 && !Term_Stk_Is_Empty(&stk))
+    {
+      Term_Stk_Next(&stk, u_arg_adr, v_arg_adr);
+      start_u_word = *u_arg_adr;
+      start_v_word = *v_arg_adr;
+      goto terminal_rec;
+    }
 
-  return 0;
+ finish:
+  Term_Stk_Free(&stk);
+  return x;
 }
 
 
@@ -282,7 +316,10 @@ Pl_Term_Size(WamWord start_word)
   WamWord word, tag_mask;
   WamWord *adr;
   int i;
-  int n = 0;			/* init to zero for terminal_rec */
+  int n = 0;
+  TermStk stk;
+
+  Term_Stk_Init(&stk);
 
 terminal_rec:
 
@@ -292,21 +329,23 @@ terminal_rec:
     {
 #ifndef NO_USE_FD_SOLVER
     case FDV:		/* 1+ for <REF,->fdv_adr> since Dont_Separate_Tag */
-      return n + 1 + Fd_Variable_Size(UnTag_FDV(word));
+      n += 1 + Fd_Variable_Size(UnTag_FDV(word));
+      break;
 #endif
 
     case FLT:
 #if WORD_SIZE == 32
-      return n + 1 + 2;
+      n += 1 + 2;
 #else
-      return n + 1 + 1;
+      n += 1 + 1;
 #endif
+      break;
 
     case LST:
       adr = UnTag_LST(word);
-      adr = &Car(adr);
-      n += 1 + Pl_Term_Size(*adr++);
-      start_word = *adr;
+      n++;
+      Term_Stk_Push(&stk, &Cdr(adr), &Cdr(adr), 1, 0);
+      start_word = Car(adr);
       goto terminal_rec;
 
     case STC:
@@ -315,15 +354,26 @@ terminal_rec:
 
       i = Arity(adr);
       adr = &Arg(adr, 0);
-      while (--i)
-	n += Pl_Term_Size(*adr++);
+      if (i > 1)
+	Term_Stk_Push(&stk, adr + 1, adr + 1, i - 1, 0);
 
       start_word = *adr;
       goto terminal_rec;
 
     default:
-      return n + 1;
+      n++;
+      break;
     }
+
+  if (!Term_Stk_Is_Empty(&stk))
+    {
+      Term_Stk_Next1(&stk, adr);
+      start_word = *adr;
+      goto terminal_rec;
+    }
+
+  Term_Stk_Free(&stk);
+  return n;
 }
 
 
@@ -333,48 +383,24 @@ terminal_rec:
  * PL_COPY_TERM                                                            *
  *                                                                         *
  * Copy a non contiguous term, the result is a contiguous term.            *
+ * p is the next address to use to store the rest of a term.               *
  *-------------------------------------------------------------------------*/
 void
 Pl_Copy_Term(WamWord *dst_adr, WamWord *src_adr)
 {
+  WamWord word, tag_mask;
   WamWord *qtop, *base;
-  WamWord *p;
-/* fix_bug is because when gcc sees &xxx where xxx is a fct argument variable
- * it allocates a frame even with -fomit-frame-pointer.
- * This corrupts ebp on ix86 */
-  static WamWord *fix_bug;
+  WamWord *adr;
+  WamWord *p, *q;
+  int i;
+  TermStk stk;
 
-  base_copy = dst_adr++;
+  base_copy = dst_adr;
+  p = dst_adr + 1;
 
   base = top_vars = vars;
 
-  fix_bug = dst_adr;
-  Copy_Term_Rec(base_copy, src_adr, &fix_bug);
-
-				/* restore original self references */
-  qtop = top_vars;
-  while (qtop != base)
-    {
-      p = (WamWord *) (*--qtop);	/* address to restore */
-      *p = *--qtop;		        /* word    to restore */
-    }
-}
-
-
-
-
-/*-------------------------------------------------------------------------*
- * COPY_TERM_REC                                                           *
- *                                                                         *
- * p is the next address to use to store the rest of a term.               *
- *-------------------------------------------------------------------------*/
-static void
-Copy_Term_Rec(WamWord *dst_adr, WamWord *src_adr, WamWord **p)
-{
-  WamWord word, tag_mask;
-  WamWord *adr;
-  WamWord *q;
-  int i;
+  Term_Stk_Init(&stk);
 
 terminal_rec:
 
@@ -384,83 +410,86 @@ terminal_rec:
     {
     case REF:
       adr = UnTag_REF(word);
-      q = *p;
-      if (adr < q && adr >= base_copy)	/* already a copy */
+      if (adr < p && adr >= base_copy)	/* already a copy */
 	{
 	  *dst_adr = word;
-	  return;
+	  break;
 	}
 
       if (top_vars >= end_vars)
-	Pl_Err_Representation(pl_representation_too_many_variables);
+	{
+	  Term_Stk_Free(&stk);
+	  Pl_Err_Representation(pl_representation_too_many_variables);
+	}
 
       *top_vars++ = word;	                /* word to restore    */
       *top_vars++ = (WamWord) adr;	        /* address to restore */
       *adr = *dst_adr = Tag_REF(dst_adr);	/* bind to a new copy */
-      return;
+      break;
 
 #ifndef NO_USE_FD_SOLVER
     case FDV:
       adr = UnTag_FDV(word);
-      q = *p;
-      if (adr < q && adr >= base_copy)	/* already a copy */
+      if (adr < p && adr >= base_copy)	/* already a copy */
 	{
 	  *dst_adr = Tag_REF(adr);	/* since Dont_Separate_Tag */
-	  return;
+	  break;
 	}
 
       if (top_vars >= end_vars)
-	Pl_Err_Representation(pl_representation_too_many_variables);
+	{
+	  Term_Stk_Free(&stk);
+	  Pl_Err_Representation(pl_representation_too_many_variables);
+	}
 
       *top_vars++ = word;	        /* word to restore    */
       *top_vars++ = (WamWord) adr;	/* address to restore */
-      q = *p;
-      *p = q + Fd_Copy_Variable(q, adr);
+      q = p;
+      p = q + Fd_Copy_Variable(q, adr);
+      Pl_GC_Keep_Heap(q, p);
       *adr = *dst_adr = Tag_REF(q);	/* bind to a new copy */
-      return;
+      break;
 #endif
 
     case FLT:
       adr = UnTag_FLT(word);
-      q = *p;
+      q = p;
       q[0] = adr[0];
 #if WORD_SIZE == 32
       q[1] = adr[1];
-      *p = q + 2;
+      p = q + 2;
 #else
-      *p = q + 1;
+      p = q + 1;
 #endif
       *dst_adr = Tag_FLT(q);
-      return;
+      break;
 
     case LST:
       adr = UnTag_LST(word);
-      q = *p;
+      q = p;
       *dst_adr = Tag_LST(q);
 
-      *p = &Cdr(q) + 1;
-      q = &Car(q);
-      adr = &Car(adr);
-      Copy_Term_Rec(q++, adr++, p);
+      p = &Cdr(q) + 1;
+      Term_Stk_Push(&stk, &Cdr(q), &Cdr(adr), 1, 0);
 
-      dst_adr = q;
-      src_adr = adr;
+      dst_adr = &Car(q);
+      src_adr = &Car(adr);
       goto terminal_rec;
 
     case STC:
       adr = UnTag_STC(word);
-      q = *p;
+      q = p;
       *dst_adr = Tag_STC(q);
 
       Functor_And_Arity(q) = Functor_And_Arity(adr);
 
       i = Arity(adr);
-      *p = &Arg(q, i - 1) + 1;
+      p = &Arg(q, i - 1) + 1;
 
       q = &Arg(q, 0);
       adr = &Arg(adr, 0);
-      while (--i)
-	Copy_Term_Rec(q++, adr++, p);
+      if (i > 1)
+	Term_Stk_Push(&stk, q + 1, adr + 1, i - 1, 0);
 
       dst_adr = q;
       src_adr = adr;
@@ -468,7 +497,23 @@ terminal_rec:
 
     default:
       *dst_adr = word;
-      return;
+      break;
+    }
+
+  if (!Term_Stk_Is_Empty(&stk))
+    {
+      Term_Stk_Next(&stk, dst_adr, src_adr);
+      goto terminal_rec;
+    }
+
+  Term_Stk_Free(&stk);
+
+				/* restore original self references */
+  qtop = top_vars;
+  while (qtop != base)
+    {
+      p = (WamWord *) (*--qtop);	/* address to restore */
+      *p = *--qtop;		        /* word    to restore */
     }
 }
 
@@ -487,6 +532,11 @@ Pl_Copy_Contiguous_Term(WamWord *dst_adr, WamWord *src_adr)
   WamWord word, *adr;
   WamWord *q;
   int i;
+  TermStk stk;
+
+  /* NB: dst_adr - src_adr remains constant (used by Old_Adr_To_New_Adr) */
+
+  Term_Stk_Init(&stk);
 
 terminal_rec:
 
@@ -499,14 +549,18 @@ terminal_rec:
       q = Old_Adr_To_New_Adr(adr);
       *dst_adr = Tag_REF(q);
       if (adr > src_adr)	/* only useful for Dont_Separate_Tag */
-	Pl_Copy_Contiguous_Term(q, adr);
-      return;
+	{
+	  dst_adr = q;
+	  src_adr = adr;
+	  goto terminal_rec;
+	}
+      break;
 
 #ifndef NO_USE_FD_SOLVER
     case FDV:
       adr = UnTag_FDV(word);
-      Fd_Copy_Variable(dst_adr, adr);
-      return;
+      Pl_GC_Keep_Heap(dst_adr, dst_adr + Fd_Copy_Variable(dst_adr, adr));
+      break;
 #endif
 
     case FLT:
@@ -517,17 +571,15 @@ terminal_rec:
       q[1] = adr[1];
 #endif
       *dst_adr = Tag_FLT(q);
-      return;
+      break;
 
     case LST:
       adr = UnTag_LST(word);
       q = Old_Adr_To_New_Adr(adr);
       *dst_adr = Tag_LST(q);
-      q = &Car(q);
-      adr = &Car(adr);
-      Pl_Copy_Contiguous_Term(q++, adr++);
-      dst_adr = q;
-      src_adr = adr;
+      Term_Stk_Push(&stk, &Cdr(q), &Cdr(adr), 1, 0);
+      dst_adr = &Car(q);
+      src_adr = &Car(adr);
       goto terminal_rec;
 
     case STC:
@@ -541,8 +593,8 @@ terminal_rec:
 
       q = &Arg(q, 0);
       adr = &Arg(adr, 0);
-      while (--i)
-	Pl_Copy_Contiguous_Term(q++, adr++);
+      if (i > 1)
+	Term_Stk_Push(&stk, q + 1, adr + 1, i - 1, 0);
 
       dst_adr = q;
       src_adr = adr;
@@ -550,8 +602,16 @@ terminal_rec:
 
     default:
       *dst_adr = word;
-      return;
+      break;
     }
+
+  if (!Term_Stk_Is_Empty(&stk))
+    {
+      Term_Stk_Next(&stk, dst_adr, src_adr);
+      goto terminal_rec;
+    }
+
+  Term_Stk_Free(&stk);
 }
 
 
@@ -770,39 +830,27 @@ Pl_Acyclic_Term_1(WamWord start_word)
  * TERM_HASH                                                               *
  *                                                                         *
  *-------------------------------------------------------------------------*/
-static
-Bool Term_Hash(WamWord start_word, PlLong depth, unsigned *hash)
+static Bool
+Term_Hash(WamWord start_word, PlLong depth, unsigned *hash)
 {
+  WamWord word, tag_mask;
+  WamWord *adr;
+  int func, arity;
   HashIncrInfo hi;
+  TermStk stk;
 
   Pl_Hash_Incr_Init(&hi);
 
-  if (depth != 0 && !Term_Hash_Rec(start_word, depth, &hi))
-    return FALSE;
-
-  *hash = Pl_Hash_Incr_Term(&hi);
-  return TRUE;
-}
+  if (depth == 0)
+    goto finish;
 
-
-
-
-/*-------------------------------------------------------------------------*
- * TERM_HASH_REC                                                           *
- *                                                                         *
- *-------------------------------------------------------------------------*/
-static Bool 
-Term_Hash_Rec(WamWord start_word, PlLong depth, HashIncrInfo *hi)
-{
-  WamWord word, tag_mask;
-  WamWord *adr;
-  int func, arity;
+  Term_Stk_Init(&stk);
 
 terminal_rec:
 
-  /* here depth is != 0 this is checked before (recursive) call */
+  /* here depth is != 0 this is checked before pushing args */
 
-  /* NB: the depth-- should be done inside the terminal_rec label (not before !)
+  /* NB: the depth-- should be done after the terminal_rec label (not before !)
    * here it is only done for lists and structures (since atomic terms do not need it)
    */
 
@@ -814,18 +862,19 @@ terminal_rec:
 #ifndef NO_USE_FD_SOLVER
     case FDV:
 #endif
+      Term_Stk_Free(&stk);
       return FALSE;
 
     case ATM:
-      Pl_Hash_Incr_Int32(hi, pl_atom_tbl[UnTag_ATM(word)].hash);
+      Pl_Hash_Incr_Int32(&hi, pl_atom_tbl[UnTag_ATM(word)].hash);
       break;
 
     case INT:
-      Pl_Hash_Incr_Int64(hi, UnTag_INT(word));
+      Pl_Hash_Incr_Int64(&hi, UnTag_INT(word));
       break;
 
     case FLT:
-      Pl_Hash_Incr_Double(hi, Pl_Obtain_Float(UnTag_FLT(word)));
+      Pl_Hash_Incr_Double(&hi, Pl_Obtain_Float(UnTag_FLT(word)));
       break;
 
       /* For faster list hasing we simply hash Car and then Cdr
@@ -835,16 +884,15 @@ terminal_rec:
     case LST: 
       if (--depth == 0)
 	{
-	  Pl_Hash_Incr_Int32(hi, pl_atom_tbl[ATOM_CHAR('.')].hash);
-	  Pl_Hash_Incr_Int32(hi, 2);
+	  Pl_Hash_Incr_Int32(&hi, pl_atom_tbl[ATOM_CHAR('.')].hash);
+	  Pl_Hash_Incr_Int32(&hi, 2);
 	  break;
 	}
 
       adr = UnTag_LST(word);
-      if (!Term_Hash_Rec(Car(adr), depth, hi))
-	return FALSE;
+      Term_Stk_Push(&stk, &Cdr(adr), &Cdr(adr), 1, depth);
 
-      start_word = Cdr(adr);
+      start_word = Car(adr);
       goto terminal_rec;
 
     case STC:
@@ -852,22 +900,32 @@ terminal_rec:
       func = Functor(adr);
       arity = Arity(adr);	/* do not hash the word <f/n> since it is runtime dependent */
 
-      Pl_Hash_Incr_Int32(hi, pl_atom_tbl[func].hash);
-      Pl_Hash_Incr_Int32(hi, arity);
+      Pl_Hash_Incr_Int32(&hi, pl_atom_tbl[func].hash);
+      Pl_Hash_Incr_Int32(&hi, arity);
 
       if (--depth == 0)
 	break;
 
       adr = &Arg(adr, 0);
-      while(--arity)
-	{
-	  if (!Term_Hash_Rec(*adr++, depth, hi))
-	    return FALSE;
-	}
+      if (arity > 1)
+	Term_Stk_Push(&stk, adr + 1, adr + 1, arity - 1, depth);
+
       start_word = *adr;
       goto terminal_rec;      
     }
 
+  if (!Term_Stk_Is_Empty(&stk))
+    {
+      depth = Term_Stk_Depth(&stk);
+      Term_Stk_Next1(&stk, adr);
+      start_word = *adr;
+      goto terminal_rec;
+    }
+
+  Term_Stk_Free(&stk);
+
+ finish:
+  *hash = Pl_Hash_Incr_Term(&hi);
   return TRUE;
 }
 
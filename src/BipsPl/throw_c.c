@@ -46,6 +46,10 @@
  * Constants                       *
  *---------------------------------*/
 
+#define MAX_UNWIND_FCTS            8
+
+#define ERR_TOO_MANY_UNWIND_FCTS   "too many exception unwind hooks (max: %d)"
+
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
@@ -57,6 +61,9 @@
 WamWord *pl_query_top_b;		/* overwritten by foreign_supp if present */
 WamWord pl_query_exception;	/* overwritten by foreign_supp if present */
 
+static UnwindFct unwind_fct[MAX_UNWIND_FCTS];
+static int nb_unwind_fct;
+
 
 
 
@@ -67,6 +74,24 @@ WamWord pl_query_exception;	/* overwritten by foreign_supp if present */
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_ADD_UNWIND_FCT                                                       *
+ *                                                                         *
+ * Register a function called when an exception unwinds the choice points  *
+ * above b (e.g. to release data attached to an abandoned computation).    *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Add_Unwind_Fct(UnwindFct fct)
+{
+  if (nb_unwind_fct >= MAX_UNWIND_FCTS)
+    Pl_Fatal_Error(ERR_TOO_MANY_UNWIND_FCTS, MAX_UNWIND_FCTS);
+
+  unwind_fct[nb_unwind_fct++] = fct;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_THROW_2                                                              *
  *                                                                         *
@@ -77,18 +102,15 @@ Pl_Throw_2(WamWord ball_word, WamWord b_word)
   WamWord word, tag_mask;
   WamWord *b;
   StmInf *pstm;
+  int i;
 
   DEREF(b_word, word, tag_mask);
   b = From_WamWord_To_B(word);
 
   if (b <= pl_query_top_b && pl_query_top_b != NULL)
-    {
-      Assign_B(pl_query_top_b);
-      pl_query_exception = ball_word;
-      Pl_Exit_With_Exception();
-    }
+    b = pl_query_top_b;
 
-  if (b == LSSA)
+  if (b == LSSA)		/* no catcher: nothing is unwound */
     {
       pstm = pl_stm_tbl[pl_stm_top_level_output];
 
@@ -100,5 +122,15 @@ Pl_Throw_2(WamWord ball_word, WamWord b_word)
       return;
     }
 
+  for (i = 0; i < nb_unwind_fct; i++)
+    (*unwind_fct[i]) (b);
+
+  if (b == pl_query_top_b && pl_query_top_b != NULL)
+    {
+      Assign_B(pl_query_top_b);
+      pl_query_exception = ball_word;
+      Pl_Exit_With_Exception();
+    }
+
   Pl_Cut(b_word);
 }
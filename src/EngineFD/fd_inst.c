@@ -67,14 +67,35 @@
  * Type Definitions                *
  *---------------------------------*/
 
+typedef struct			/* objective bound (branch-and-bound) */
+{
+  WamWord *fdv_adr;		/* the objective FD variable          */
+  int min;			/* current bounds of the objective    */
+  int max;
+}
+FdBound;
+
+
+
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
 
 static WamWord *TP;
 
+static FdBound *bound_tbl;	/* stack of active objective bounds */
+static int bound_size;
+static int nb_bound;
+
 static WamWord dummy_fd_var[FD_VARIABLE_FRAME_SIZE];
 
+static WamWord *q_head[NB_PRIORITIES];	/* queues of deferred constraints */
+static WamWord *q_tail[NB_PRIORITIES];
+static int q_nb;			/* nb of deferred constraints in queues */
+
+static WamWord *cur_CF;			/* deferred constraint being executed */
+
 static PlULong DATE;   /* NB: PlLong/PlULong have the same size as a WamWord (intptr_t) */
 
 /*
@@ -163,6 +184,27 @@ static PlULong DATE;   /* NB: PlLong/PlULong have the same size as a WamWord (in
  * NB: if a constraint reexecution fails (in the above loop), X has the 
  * MASK_TO_KEEP_IN_QUEUE set. This is not a problem since at the next
  * constraint post the queue is cleared assigning 0 to each Queue_Propag_Mask.
+ *
+ * Deferred constraints. The above applies to X in r constraints (cheap, with
+ * priority PRIORITY_FAST). Other constraints (e.g. global constraints defined
+ * by a C function) have a priority (see Cstr_Priority(cf)) and are deferred:
+ * they are not executed when a variable is taken from the queue but added to
+ * a FIFO queue of constraints (one per priority) as soon as a variable they
+ * depend on is modified (All_Propagations). A deferred constraint is executed
+ * only when the variable queue is empty (i.e. the X in r constraints have
+ * reached their fix-point) and when no deferred constraint of a higher
+ * priority is pending. Thus it is executed once for several modifications
+ * of its variables. Deferred dependencies are recorded in Chains_Mask
+ * (shifted by DEFERRED_SHIFT) to only scan the chains containing some.
+ *
+ * A deferred constraint is in a queue iff Cstr_Queue_Next(cf) != NULL (the
+ * last one points to CSTR_QUEUE_END). As for variables, this mark is not
+ * trailed and Clear_Queue() unmarks remaining constraints after a failure.
+ *
+ * A constraint can be re-added to the queue by its own modifications (if it
+ * depends on a variable it reduces). An idempotent constraint (see
+ * Cstr_Is_Idempotent(cf)) computes a fix-point for itself: it is not re-added
+ * while it is being executed (cur_CF).
  */
 
 #define DATE_NEVER   0
@@ -188,29 +230,18 @@ static void All_Propagations(WamWord *fdv_adr, int propag);
 
 static void Clear_Queue(void);
 
+static void Reset_Deferred_Queues(void);
 
+static void Add_Deferred_Chain(WamWord *record_adr);
 
-
-/*---------------------------------*
- * Auxiliary engine macros         *
- *---------------------------------*/
-
-#define FD_Word_Needs_Trailing(adr)  ((adr) <  CSB(B))
-
-
+static Bool Tell_Bounds(void);
 
 
-#define FD_Bind_OV(adr, word)       		\
-  do						\
-    {						\
-      if (FD_Word_Needs_Trailing(adr))		\
-	Trail_OV(adr);				\
-      *(adr) = (word);				\
-    }						\
-  while (0)
-
 
 
+/*---------------------------------*
+ * Auxiliary engine macros         *
+ *---------------------------------*/
 
 #define Trail_Fd_Int_Variable_If_Necessary(fdv_adr)		\
   do								\
@@ -431,6 +462,8 @@ Pl_Fd_Reset_Solver0(void)
   STAMP = 0;
   DATE = 1;
   TP = dummy_fd_var;		/* the queue is empty */
+  Reset_Deferred_Queues();
+  nb_bound = 0;
 }
 
 
@@ -765,13 +798,16 @@ Pl_Fd_Prolog_To_Array_Fdv(WamWord list_word, Bool pl_var_ok)
  *                                                                         *
  *-------------------------------------------------------------------------*/
 WamWord *
-Pl_Fd_Create_C_Frame(CstrFct cstr_fct , WamWord *AF, WamWord *fdv_adr, Bool optim2)
+Pl_Fd_Create_C_Frame(CstrFct cstr_fct , WamWord *AF, WamWord *fdv_adr, Bool optim2,
+		     int priority, Bool idempotent)
 {
   WamWord *CF = CS;
 
   AF_Pointer(CF) = AF;
   Optim_Pointer(CF) = (optim2 && fdv_adr) ? &FD_INT_Date(fdv_adr) : &optim2_date_always;
   Cstr_Address(CF) = cstr_fct;
+  Cstr_Sched(CF) = priority | ((idempotent) ? SCHED_IDEMPOTENT : 0);
+  Cstr_Queue_Next(CF) = NULL;
 
   /* if ground Nb_Cstr not allocated (Fd_Int_Frame) */
   if (fdv_adr && !Fd_Variable_Is_Ground(fdv_adr))
@@ -799,7 +835,10 @@ Pl_Fd_Add_Dependency(WamWord *fdv_adr, int chain_nb, WamWord *CF)
 
   Trail_Chains_If_Necessary(fdv_adr);
 
-  Chains_Mask(fdv_adr) |= ((WamWord) 1 << chain_nb);
+  if (Cstr_Is_Deferred(CF))
+    Chains_Mask(fdv_adr) |= ((WamWord) 1 << (chain_nb + DEFERRED_SHIFT));
+  else
+    Chains_Mask(fdv_adr) |= ((WamWord) 1 << chain_nb);
 
   chain_adr = (&Chain_Min(fdv_adr) + chain_nb);
 
@@ -954,6 +993,9 @@ Pl_Fd_Before_Add_Cstr(void)
 #ifdef DEBUG_CHECK_DATES_AND_QUEUE
   Check_Queue_Consistency();
 #endif
+
+  if (q_nb > 0)		/* only after an exception raised while propagating */
+    Reset_Deferred_Queues(); /* (frames may be reclaimed: do not scan them) */
 }
 
 
@@ -1000,6 +1042,23 @@ Clear_Queue(void)
   WamWord *BP;
   WamWord *fdv_adr;
 
+  WamWord *CF, *next;
+  int p;
+
+  if (q_nb > 0)
+    {
+      for (p = 0; p < NB_PRIORITIES; p++)
+	for (CF = q_head[p]; CF != NULL; CF = next)
+	  {
+	    next = Cstr_Queue_Next(CF);
+	    Cstr_Queue_Next(CF) = NULL;
+	    if (next == CSTR_QUEUE_END)
+	      break;
+	  }
+    }
+
+  Reset_Deferred_Queues();
+
   if (TP == dummy_fd_var)	/* empty ? */
     return;
 
@@ -1021,6 +1080,25 @@ Clear_Queue(void)
 
 
 
+/*-------------------------------------------------------------------------*
+ * RESET_DEFERRED_QUEUES                                                   *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Reset_Deferred_Queues(void)
+{
+  int p;
+
+  for (p = 0; p < NB_PRIORITIES; p++)
+    q_head[p] = q_tail[p] = NULL;
+
+  q_nb = 0;
+  cur_CF = NULL;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_FD_TELL_VALUE                                                        *
  *                                                                         *
@@ -1319,6 +1397,13 @@ Pl_Fd_Tell_Range(WamWord *fdv_adr, Range *range)
 static void
 All_Propagations(WamWord *fdv_adr, int propag)
 {
+  WamWord deferred = (Chains_Mask(fdv_adr) >> DEFERRED_SHIFT) & propag;
+  WamWord **chain_adr;
+
+  for (chain_adr = &Chain_Min(fdv_adr); deferred; deferred >>= 1, chain_adr++)
+    if (deferred & 1)
+      Add_Deferred_Chain(*chain_adr);
+
   if (propag &= Chains_Mask(fdv_adr))
     {				     /* here propag != 0 */
       if (!Is_Var_In_Queue(fdv_adr)) /* not yet in the queue */
@@ -1335,6 +1420,49 @@ All_Propagations(WamWord *fdv_adr, int propag)
 
 
 
+/*-------------------------------------------------------------------------*
+ * ADD_DEFERRED_CHAIN                                                      *
+ *                                                                         *
+ * Adds the deferred constraints of a chain to the queue of their priority *
+ * (if not already in a queue, not stopped and not the idempotent          *
+ * constraint being executed).                                             *
+ *-------------------------------------------------------------------------*/
+static void
+Add_Deferred_Chain(WamWord *record_adr)
+{
+  WamWord *CF;
+  PlULong *pdate;
+  int p;
+
+  do
+    {
+      CF = CF_Pointer(record_adr);
+
+      if (!Cstr_Is_Deferred(CF) || Cstr_Queue_Next(CF) != NULL)
+	continue;
+
+      pdate = Optim_Pointer(CF);	/* optim #2 or stopped */
+      if (*pdate != DATE_ALWAYS && *pdate != DATE)
+	continue;
+
+      if (CF == cur_CF && Cstr_Is_Idempotent(CF))
+	continue;
+
+      p = Cstr_Priority(CF);
+      Cstr_Queue_Next(CF) = CSTR_QUEUE_END;
+      if (q_head[p] == NULL)
+	q_head[p] = CF;
+      else
+	Cstr_Queue_Next(q_tail[p]) = CF;
+      q_tail[p] = CF;
+      q_nb++;
+    }
+  while ((record_adr = Next_Chain(record_adr)) != NULL);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_FD_AFTER_ADD_CSTR                                                    *
  *                                                                         *
@@ -1352,6 +1480,7 @@ Pl_Fd_After_Add_Cstr(Bool result_of_tell)
   PlULong *pdate;
   WamWord *AF;
   CstrFct fct;
+  int p;
 
   if (!result_of_tell)
     {
@@ -1360,8 +1489,12 @@ Pl_Fd_After_Add_Cstr(Bool result_of_tell)
       return FALSE;
     }
 
+  if (nb_bound > 0 && !Tell_Bounds())
+    goto clear_queue;
+
+ var_queue:
   if (TP == dummy_fd_var)
-    return TRUE;
+    goto deferred_queue;
 
   BP = Queue_Next_Fdv_Adr(dummy_fd_var);
 
@@ -1393,6 +1526,9 @@ Pl_Fd_After_Add_Cstr(Bool result_of_tell)
 		  continue;
 #endif
 
+		if (Cstr_Is_Deferred(CF))	/* see All_Propagations */
+		  continue;
+
 		fct = Cstr_Address(CF);
 		AF = AF_Pointer(CF);
 
@@ -1435,12 +1571,143 @@ Pl_Fd_After_Add_Cstr(Bool result_of_tell)
 
   TP = dummy_fd_var;		/* queue is now empty */
 
+
+ deferred_queue:
+  if (q_nb == 0)
+    return TRUE;
+
+  for (p = 0; q_head[p] == NULL; p++) /* highest priority non-empty queue */
+    ;
+
+  CF = q_head[p];
+  q_head[p] = Cstr_Queue_Next(CF);
+  if (q_head[p] == CSTR_QUEUE_END)
+    q_head[p] = q_tail[p] = NULL;
+  Cstr_Queue_Next(CF) = NULL;
+  q_nb--;
+
+  pdate = Optim_Pointer(CF);	/* stopped since added to the queue ? */
+  if (*pdate != DATE_ALWAYS && *pdate != date)
+    goto deferred_queue;
+
+  fct = Cstr_Address(CF);
+  AF = AF_Pointer(CF);
+
+  cur_CF = CF;
+  fct = (CstrFct) (*fct) (AF);
+  cur_CF = NULL;
+
+  if (fct == (CstrFct) FALSE)
+    goto clear_queue;
+
+  if (fct != (CstrFct) TRUE)	/* FD switch case triggered */
+    {
+      if ((*fct) (AF) == FALSE)
+	goto clear_queue;
+
+      Pl_Fd_Stop_Constraint(CF);
+    }
+
+  goto var_queue;		/* process the modifications it made */
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * TELL_BOUNDS                                                             *
+ *                                                                         *
+ * Restricts each objective variable to its current bounds. Called at the  *
+ * beginning of each propagation phase so that a bound improved by a       *
+ * solution is taken into account in the running search tree.             *
+ *-------------------------------------------------------------------------*/
+static Bool
+Tell_Bounds(void)
+{
+  FdBound *b;
+
+  for (b = bound_tbl; b < bound_tbl + nb_bound; b++)
+    if (!Pl_Fd_Tell_Interval(b->fdv_adr, b->min, b->max))
+      return FALSE;
+
   return TRUE;
 }
 
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_FD_PUSH_BOUND                                                        *
+ *                                                                         *
+ * Pushes a new objective bound and returns its index. The FD variable     *
+ * must not be reclaimed before the bound is popped.                       *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Fd_Push_Bound(WamWord *fdv_adr, int min, int max)
+{
+  FdBound *b;
+
+  if (nb_bound == bound_size)
+    {
+      bound_size = (bound_size == 0) ? 8 : bound_size * 2;
+      bound_tbl = (FdBound *) Realloc((char *) bound_tbl,
+				      bound_size * sizeof(FdBound));
+    }
+
+  b = bound_tbl + nb_bound;
+  b->fdv_adr = fdv_adr;
+  b->min = min;
+  b->max = max;
+
+  return nb_bound++;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_SET_BOUND                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Set_Bound(int i, int min, int max)
+{
+  bound_tbl[i].min = min;
+  bound_tbl[i].max = max;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_GET_BOUND                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Get_Bound(int i, int *min, int *max)
+{
+  *min = bound_tbl[i].min;
+  *max = bound_tbl[i].max;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_FD_POP_BOUND                                                         *
+ *                                                                         *
+ * Pops the bound i and all bounds pushed after it.                        *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Fd_Pop_Bound(int i)
+{
+  if (i < nb_bound)
+    nb_bound = i;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_FD_STOP_CONSTRAINT                                                   *
  *                                                                         *
@@ -1455,6 +1722,22 @@ Pl_Fd_Stop_Constraint(WamWord *CF)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_FD_PROPAGATION_DATE                                                  *
+ *                                                                         *
+ * Returns the DATE of the current propagation phase. Inside a same phase  *
+ * the domains can only be reduced (used by global constraints to detect   *
+ * that nothing changed since their last execution).                       *
+ *-------------------------------------------------------------------------*/
+PlULong
+Pl_Fd_Propagation_Date(void)
+{
+  return DATE;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_FD_IN_INTERVAL                                                       *
  *                                                                         *
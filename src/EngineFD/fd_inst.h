@@ -141,13 +141,36 @@
 
 typedef PlLong (*CstrFct) (WamWord *af);
 
-#define CONSTRAINT_FRAME_SIZE      3
+#define CONSTRAINT_FRAME_SIZE      5
 
 #define OFFSET_OF_OPTIM_POINTER    1	/* this offset must correspond to >>> */
 
 #define AF_Pointer(cf)             (*(WamWord **)    &(cf[0]))
 #define Optim_Pointer(cf)          (*(PlULong **)    &(cf[1]))	/* >>> this cell */
 #define Cstr_Address(cf)           (*(CstrFct *) &(cf[2]))
+#define Cstr_Sched(cf)             (*(WamWord *)     &(cf[3]))
+#define Cstr_Queue_Next(cf)        (*(WamWord **)    &(cf[4]))
+
+
+
+
+	  /* Constraint scheduling (see Pl_Fd_After_Add_Cstr) */
+
+#define NB_PRIORITIES              3
+
+#define PRIORITY_FAST              0	/* X in r constraints (not deferred) */
+#define PRIORITY_NORMAL            1	/* default for C constraints         */
+#define PRIORITY_SLOW              2	/* expensive global constraints      */
+
+#define SCHED_IDEMPOTENT           4	/* fix-point for its own changes     */
+
+#define Cstr_Priority(cf)          ((int) (Cstr_Sched(cf) & 3))
+#define Cstr_Is_Deferred(cf)       (Cstr_Priority(cf) != PRIORITY_FAST)
+#define Cstr_Is_Idempotent(cf)     (Cstr_Sched(cf) & SCHED_IDEMPOTENT)
+
+#define CSTR_QUEUE_END             ((WamWord *) 1) /* next of the last in queue */
+
+#define DEFERRED_SHIFT             16	/* Chains_Mask: chains with deferred */
 
 
 
@@ -163,6 +186,20 @@ typedef PlLong (*CstrFct) (WamWord *af);
 
 
 
+#define FD_Word_Needs_Trailing(adr)  ((adr) <  CSB(B))
+
+
+#define FD_Bind_OV(adr, word)       		\
+  do						\
+    {						\
+      if (FD_Word_Needs_Trailing(adr))		\
+	Trail_OV(adr);				\
+      *(adr) = (word);				\
+    }						\
+  while (0)
+
+
+
 
 #define math_min(x, y)             ((x) <= (y) ? (x) : (y))
 #define math_max(x, y)             ((x) >= (y) ? (x) : (y))
@@ -219,7 +256,8 @@ WamWord *Pl_Fd_New_Variable_Range(Range *r);
 
 WamWord *Pl_Fd_New_Int_Variable(int n);
 
-WamWord *Pl_Fd_Create_C_Frame(CstrFct cstr_fct, WamWord *AF, WamWord *fdv_adr, Bool optim2);
+WamWord *Pl_Fd_Create_C_Frame(CstrFct cstr_fct, WamWord *AF, WamWord *fdv_adr, Bool optim2,
+			      int priority, Bool idempotent);
 
 void Pl_Fd_Add_Dependency(WamWord *fdv_adr, int chain_nb, WamWord *CF);
 
@@ -233,6 +271,16 @@ Bool Pl_Fd_After_Add_Cstr(Bool result_of_tell);
 
 void Pl_Fd_Stop_Constraint(WamWord *CF);
 
+PlULong Pl_Fd_Propagation_Date(void);
+
+int Pl_Fd_Push_Bound(WamWord *fdv_adr, int min, int max);
+
+void Pl_Fd_Set_Bound(int i, int min, int max);
+
+void Pl_Fd_Get_Bound(int i, int *min, int *max);
+
+void Pl_Fd_Pop_Bound(int i);
+
 
 
 Bool Pl_Fd_Tell_Value(WamWord *fdv_adr, int n);
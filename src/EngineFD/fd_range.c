@@ -105,6 +105,8 @@
  * Function Prototypes             *
  *---------------------------------*/
 
+static void Vector_Or_Shifted(Vector vec, Vector vec1, int shift);
+
 
 
 
@@ -198,19 +200,32 @@ Pl_Vector_Nb_Elem(Vector vec)
 int
 Pl_Vector_Ith_Elem(Vector vec, int i)
 {
-  int vec_elem;
+  Vector end = vec + pl_vec_size;
+  Vector start = vec;
+  VecWord word;
+  int nb;
+
+  if (i <= 0)			/* 1 <= i  <= nb_elem */
+    return -1;
 
-  if (i > 0)			/* 1 <= i  <= nb_elem */
+  for (;;)			/* skip whole words using popcount */
     {
-      VECTOR_BEGIN_ENUM(vec, vec_elem);
+      if (start >= end)
+	return -1;
 
-      if (--i == 0)
-	return vec_elem;
+      nb = Pl_Count_Set_Bits(*start);
+      if (i <= nb)
+	break;
 
-      VECTOR_END_ENUM;
+      i -= nb;
+      start++;
     }
 
-  return -1;
+  word = *start;
+  while (--i)
+    word &= word - 1;		/* reset the least significant bit */
+
+  return Word_No_And_Bit_No(start - vec, Pl_Least_Significant_Bit(word));
 }
 
 
@@ -450,12 +465,33 @@ Pl_Vector_Add_Vector(Vector vec, Vector vec1)
 {
   Vector aux_vec;
   int vec_elem, vec_elem1;
+  int nb_elem, nb_elem1;
   int x;
 
   Vector_Allocate(aux_vec);
   Pl_Vector_Copy(aux_vec, vec);
   Pl_Vector_Empty(vec);
 
+  nb_elem = Pl_Vector_Nb_Elem(aux_vec);
+  nb_elem1 = Pl_Vector_Nb_Elem(vec1);
+
+  if (math_max(nb_elem, nb_elem1) >= pl_vec_size)
+    {				/* dense: shift the largest by each elem of the other */
+      if (nb_elem < nb_elem1)
+	{
+	  VECTOR_BEGIN_ENUM(aux_vec, vec_elem);
+	  Vector_Or_Shifted(vec, vec1, vec_elem);
+	  VECTOR_END_ENUM;
+	}
+      else
+	{
+	  VECTOR_BEGIN_ENUM(vec1, vec_elem1);
+	  Vector_Or_Shifted(vec, aux_vec, vec_elem1);
+	  VECTOR_END_ENUM;
+	}
+      return;
+    }
+
   VECTOR_BEGIN_ENUM(aux_vec, vec_elem);
 
   VECTOR_BEGIN_ENUM(vec1, vec_elem1);
@@ -492,6 +528,14 @@ Pl_Vector_Sub_Vector(Vector vec, Vector vec1)
   Pl_Vector_Copy(aux_vec, vec);
   Pl_Vector_Empty(vec);
 
+  if (Pl_Vector_Nb_Elem(aux_vec) >= pl_vec_size)
+    {				/* dense: shift it by each elem of vec1 */
+      VECTOR_BEGIN_ENUM(vec1, vec_elem1);
+      Vector_Or_Shifted(vec, aux_vec, -vec_elem1);
+      VECTOR_END_ENUM;
+      return;
+    }
+
   VECTOR_BEGIN_ENUM(aux_vec, vec_elem);
 
   VECTOR_BEGIN_ENUM(vec1, vec_elem1);
@@ -693,6 +737,56 @@ Pl_Vector_Add_Value(Vector vec, int n)
 
 
 
+/*-------------------------------------------------------------------------*
+ * VECTOR_OR_SHIFTED                                                       *
+ *                                                                         *
+ * vec |= vec1 shifted by shift (i.e. each elem x of vec1 gives x+shift).  *
+ * Elements out of 0..pl_vec_max_integer are lost. Works a word at a time. *
+ *-------------------------------------------------------------------------*/
+static void
+Vector_Or_Shifted(Vector vec, Vector vec1, int shift)
+{
+  int word_no;
+  int bit_no;
+  int i;
+
+  if (shift >= 0)
+    {
+      word_no = Word_No(shift);
+      bit_no = Bit_No(shift);
+
+      if (bit_no == 0)
+	for (i = word_no; i < pl_vec_size; i++)
+	  vec[i] |= vec1[i - word_no];
+      else if (word_no < pl_vec_size)
+	{
+	  vec[word_no] |= vec1[0] << bit_no;
+	  for (i = word_no + 1; i < pl_vec_size; i++)
+	    vec[i] |= (vec1[i - word_no] << bit_no) |
+	      (vec1[i - word_no - 1] >> (WORD_SIZE - bit_no));
+	}
+    }
+  else
+    {
+      word_no = Word_No(-shift);
+      bit_no = Bit_No(-shift);
+
+      if (bit_no == 0)
+	for (i = 0; i < pl_vec_size - word_no; i++)
+	  vec[i] |= vec1[i + word_no];
+      else if (word_no < pl_vec_size)
+	{
+	  for (i = 0; i < pl_vec_size - word_no - 1; i++)
+	    vec[i] |= (vec1[i + word_no] >> bit_no) |
+	      (vec1[i + word_no + 1] << (WORD_SIZE - bit_no));
+	  vec[i] |= vec1[i + word_no] >> bit_no;
+	}
+    }
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_VECTOR_MUL_VALUE                                                     *
  *                                                                         *
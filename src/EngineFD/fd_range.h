@@ -241,21 +241,21 @@ char *Pl_Range_To_String(Range *range);
 	   * ...                                                           *
 	   * VECTOR_BEGIN_ENUM(the_vector,vec_elem)                        *
 	   *    your code (vec_elem contains the current range element)    *
-	   * VECTOR_END_ENUM                                               */
-
-#define VECTOR_BEGIN_ENUM(vec, vec_elem)                              	  \
-{									  \
-  Vector enum_end = vec + pl_vec_size, enum_i = vec;			  \
-  int enum_j;								  \
-  VecWord enum_word;							  \
-									  \
-  vec_elem = 0;								  \
-  do									  \
-    {									  \
-      enum_word = *enum_i;						  \
-      for (enum_j = 0; enum_j++ < WORD_SIZE; enum_word >>= 1, vec_elem++) \
-	{								  \
-	  if (enum_word & 1)						  \
+	   * VECTOR_END_ENUM                                               *
+	   * Only the set bits are visited (null words are skipped).       */
+
+#define VECTOR_BEGIN_ENUM(vec, vec_elem)                              \
+{									\
+  Vector enum_vec = vec;						\
+  Vector enum_end = enum_vec + pl_vec_size, enum_i = enum_vec;		\
+  VecWord enum_word;							\
+									\
+  do									\
+    {									\
+      for (enum_word = *enum_i; enum_word; enum_word &= enum_word - 1)	\
+	{								\
+	  vec_elem = Word_No_And_Bit_No(enum_i - enum_vec,		\
+				Pl_Least_Significant_Bit(enum_word));	\
 	    {
 
 
@@ -228,10 +228,10 @@
 
 	  /* Install instructions */
 
-#define fd_create_c_frame(fct_name, tell_fv, optim2)			      \
+#define fd_create_c_frame(fct_name, tell_fv, optim2, prio, idempotent)	      \
   CF = Pl_Fd_Create_C_Frame(fct_name, AF, 				      \
 			    (tell_fv == -1) ? NULL : Frame_Variable(tell_fv), \
-			    optim2);
+			    optim2, prio, idempotent);
 
 
 
@@ -41,6 +41,7 @@
 #include <string.h>
 #include <locale.h>
 #include <ctype.h>
+#include <limits.h>
 
 #define ATOM_FILE
 
@@ -57,15 +58,51 @@
 
 
 
+/*-------------------------------------------------------------------------*
+ * The atom number (the index in pl_atom_tbl) is independent of the hash   *
+ * code of its name: atoms are numbered sequentially (so 0..255 are the    *
+ * 1-char atoms and [] is ATOM_NIL) and names are found via a separate     *
+ * open addressing hash index (atom_index) which doubles when it is half   *
+ * full. Atom numbers are compiled into the code and stored everywhere so  *
+ * an atom is never renumbered: when the table is full it is doubled with  *
+ * realloc (pl_max_atom is its current size, initially MAX_ATOM) so the    *
+ * numbers remain valid but a pointer into pl_atom_tbl must not be kept    *
+ * across the creation of an atom.                                         *
+ *                                                                         *
+ * Atoms created by built-ins from run-time data (atom_codes/2, the reader,*
+ * the C interface...) are collectable: they own their name and can be    *
+ * reclaimed by the atom garbage collector. Any other creation (compiled   *
+ * code, Pl_Create_Atom(), ...) makes the atom permanent (pinned).         *
+ * The atom GC is run by the garbage collector (at a safe point) when      *
+ * pl_nb_atom reaches pl_atom_gc_threshold. Marking is conservative: the   *
+ * ATM words (and the functors of STC words) found in the stacks, in the   *
+ * pred/oper tables and in the areas visited by the registered root        *
+ * functions (dynamic clauses, global variables, streams,...). An unmarked *
+ * collectable atom is freed and its number is recycled.                   *
+ *-------------------------------------------------------------------------*/
+
+
+
+
 /*---------------------------------*
  * Constants                       *
  *---------------------------------*/
 
 #define ERR_ATOM_NIL_INVALID       "atom: invalid ATOM_NIL (should be %d)"
 
-#define ERR_TABLE_FULL_ENV         "Atom table full (max atom: %d, environment variable used: %s)"
+#define ERR_TABLE_FULL             "Atom table full (max atom: %lu)"
 
-#define ERR_TABLE_FULL_NO_ENV      "Atom table full (max atom: %d - fixed size)"
+#define ERR_TOO_MANY_ATOM_GC_FCTS  "too many atom garbage collector hooks (max: %d)"
+
+#define INDEX_INITIAL_SIZE         4096	/* a power of 2 */
+
+	  /* atom numbers are ints and must fit in f/n words (see wam_inst.h) */
+#define ATOM_TBL_LIMIT             (((PlULong) 1 << ATOM_MAX_BITS) < (PlULong) INT_MAX ? \
+                                    ((PlULong) 1 << ATOM_MAX_BITS) : (PlULong) INT_MAX)
+
+#define MAX_ATOM_GC_FCTS           16
+
+#define BITS_PER_WORD              ((PlLong) sizeof(PlULong) * 8)
 
 
 
@@ -116,17 +153,36 @@ char pl_escape_char[] = "\a\b\f\n\r\t\v";
 static char str_char[256][2];
 
 
+static int *atom_index;		/* hash index: atom number or -1 */
+static PlULong index_mask;	/* index size - 1 */
+
+static PlULong atom_top;	/* atoms >= atom_top never used */
+static int free_atom = -1;	/* reclaimed atoms (chained via hash) */
+
+static AtomGCRootFct root_fct[MAX_ATOM_GC_FCTS];
+static int nb_root_fct;
+
+static PlULong *atom_marks;
+
+
 
 
 /*---------------------------------*
  * Function Prototypes             *
  *---------------------------------*/
 
-static int Add_Atom(char *name, int len, unsigned hash, 
-		    AtomInf *patom, Bool allocate);
+static int Create_Atom(char *name, Bool allocate, Bool collectable);
+
+static int Add_Atom(char *name, int len, unsigned hash, PlULong slot,
+		    Bool allocate, Bool collectable);
+
+static int Locate_Atom(char *name, unsigned hash, PlULong *slot);
 
+static void Build_Index(PlULong size);
 
-static AtomInf *Locate_Atom(char *name, unsigned hash);
+static void Grow_Table(void);
+
+static void Set_Atom_GC_Threshold(void);
 
 static unsigned Hash_String(char *str, int len);
 
@@ -134,6 +190,11 @@ static void Error_Table_Full(void);
 
 
 
+#define Is_Atom_Marked(a)          (atom_marks[(a) / BITS_PER_WORD] & \
+                                    ((PlULong) 1 << ((a) % BITS_PER_WORD)))
+
+
+
 
 /*-------------------------------------------------------------------------*
  * PL_INIT_ATOM                                                            *
@@ -148,14 +209,17 @@ Pl_Init_Atom(void)
     pl_max_atom = 256;
 
   if (pl_max_atom <= ATOM_NIL)
-    pl_max_atom = ATOM_NIL + 1;	/* to be sure h([]) % pl_max_atom == ATOM_NIL */
+    pl_max_atom = ATOM_NIL + 1;	/* to be sure [] can be numbered ATOM_NIL */
 
-  if (pl_max_atom > ((PlULong) 1 << ATOM_MAX_BITS)) /* be sure f/n words can be encoded (see wam_inst.h) */
-    pl_max_atom = ((PlULong) 1 << ATOM_MAX_BITS);
+  if (pl_max_atom > ATOM_TBL_LIMIT)
+    pl_max_atom = ATOM_TBL_LIMIT;
 
   pl_atom_tbl = (AtomInf *) Calloc(pl_max_atom, sizeof(AtomInf));
   pl_nb_atom = 0;
-    
+  atom_top = 0;
+
+  Build_Index(INDEX_INITIAL_SIZE);
+  Set_Atom_GC_Threshold();
 
   for (c = 128; c < 256; c++) 
     {
@@ -199,11 +263,7 @@ Pl_Init_Atom(void)
 int
 Pl_Create_Allocate_Atom(char *name)
 {
-  int len = (int) strlen(name);
-  unsigned hash = Hash_String(name, len);
-  AtomInf *patom = Locate_Atom(name, hash);
-
-  return Add_Atom(name, len, hash, patom, TRUE);
+  return Create_Atom(name, TRUE, FALSE);
 }
 
 
@@ -216,13 +276,66 @@ Pl_Create_Allocate_Atom(char *name)
  *-------------------------------------------------------------------------*/
 int
 Pl_Create_Atom(char *name)
+{
+  return Create_Atom(name, FALSE, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_CREATE_COLLECTABLE_ATOM                                              *
+ *                                                                         *
+ * Create an atom which can be reclaimed when no longer referenced.        *
+ * If allocate is FALSE, name is a malloc'ed string which is given to the  *
+ * atom table if the atom is created (the caller frees it otherwise, i.e.  *
+ * if pl_nb_atom is unchanged).                                            *
+ *-------------------------------------------------------------------------*/
+int
+Pl_Create_Collectable_Atom(char *name, Bool allocate)
+{
+  return Create_Atom(name, allocate, TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_PIN_ATOM                                                             *
+ *                                                                         *
+ * Make an atom permanent (e.g. when it is stored in a C structure not     *
+ * visited by the atom garbage collector).                                 *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Pin_Atom(int atom)
+{
+  pl_atom_tbl[atom].prop.collectable = FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CREATE_ATOM                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Create_Atom(char *name, Bool allocate, Bool collectable)
 {
   int len = (int) strlen(name);
   unsigned hash = Hash_String(name, len);
+  PlULong slot;
+  int atom;
 
-  AtomInf *patom = Locate_Atom(name, hash);
+  atom = Locate_Atom(name, hash, &slot);
+  if (atom >= 0)		/* already exists */
+    {
+      if (!collectable)
+	pl_atom_tbl[atom].prop.collectable = FALSE;
+      return atom;
+    }
 
-  return Add_Atom(name, len, hash, patom, FALSE);
+  return Add_Atom(name, len, hash, slot, allocate, collectable);
 }
 
 
@@ -231,31 +344,54 @@ Pl_Create_Atom(char *name)
 /*-------------------------------------------------------------------------*
  * ADD_ATOM                                                                *
  *                                                                         *
+ * slot: the free slot of the hash index (see Locate_Atom).                *
  *-------------------------------------------------------------------------*/
 static int
-Add_Atom(char *name, int len, unsigned hash, AtomInf *patom, Bool allocate)
+Add_Atom(char *name, int len, unsigned hash, PlULong slot,
+	 Bool allocate, Bool collectable)
 {
+  AtomInf *patom;
   AtomProp prop;
   char *p;
   int c_type;
   Bool identifier;
   Bool graphic;
+  int atom;
+  int i;
 
-  if (patom == NULL)
-    Error_Table_Full();
-
-  if (patom->name != NULL)
-    return (int) (patom - pl_atom_tbl);	/* already exists */
+  if (free_atom >= 0)
+    {
+      atom = free_atom;
+      free_atom = (int) pl_atom_tbl[atom].hash;
+    }
+  else
+    {
+      if (atom_top == pl_max_atom)
+	Grow_Table();
+      atom = (int) atom_top++;
+    }
 
   if (allocate)
     name = Strdup(name);
 
-  pl_nb_atom++;
-
+  patom = pl_atom_tbl + atom;
   patom->name = name;
   patom->hash = hash;
+  patom->order = 0;
+  for (i = 0; i < (int) sizeof(PlULong); i++) /* see Pl_Atom_Compare */
+    patom->order = (patom->order << 8) | (unsigned char) ((i < len) ? name[i] : '\0');
+
+  atom_index[slot] = atom;
+  pl_nb_atom++;
+
+  if (pl_nb_atom > index_mask / 2)
+    Build_Index((index_mask + 1) * 2);
+
+  if (pl_nb_atom >= pl_atom_gc_threshold)
+    pl_gc_trigger = Global_Stack; /* ask for a collection at next safe point */
 
   prop.needs_scan = FALSE;
+  prop.collectable = collectable;
 
   identifier = graphic = (*name != '\0');
 
@@ -322,7 +458,7 @@ finish:
   prop.op_mask = 0;
   patom->prop = prop;
 
-  return (int) (patom - pl_atom_tbl);
+  return atom;
 }
 
 
@@ -352,10 +488,9 @@ Pl_Find_Atom(char *name)
 {
   int len = (int) strlen(name);
   unsigned hash = Hash_String(name, len);
-  AtomInf *patom;
+  PlULong slot;
 
-  patom = Locate_Atom(name, hash);
-  return (patom == NULL || patom->name == NULL) ? -1 : (int) (patom - pl_atom_tbl);
+  return Locate_Atom(name, hash, &slot);
 }
 
 
@@ -364,66 +499,93 @@ Pl_Find_Atom(char *name)
 /*-------------------------------------------------------------------------*
  * LOCATE_ATOM                                                             *
  *                                                                         *
- * We use a specific hash table for atoms that cannot be extended but which*
- * provides a unique integer (0..pl_max_atom-1) that could be used in the  *
- * future for tagged ATM words (and for structures).                       *
+ * The hash index is an open addressing (linear probing) table whose size  *
+ * is a power of 2 and which is never more than half full.                 *
  *                                                                         *
- * index (in the table) = hash code % pl_max_atom                          *
- *                                                                         *
- * return the address of the found atom (if exists)                        *
- *        the address of the corresponding free cell (if not exist)        *
- *        NULL if the table is full                                        *
+ * return the found atom (if exists)                                       *
+ *        -1 if not exist (*slot is then the free slot to use)             *
  *-------------------------------------------------------------------------*/
-static AtomInf *
-Locate_Atom(char *name, unsigned hash)
+static int
+Locate_Atom(char *name, unsigned hash, PlULong *slot)
 {
-  int index;
-  AtomInf *patom0, *patom, *endt;
-
-  index = hash % pl_max_atom;
-  patom = patom0 = pl_atom_tbl + index;
-  endt = pl_atom_tbl + pl_max_atom;
+  PlULong i = hash & index_mask;
+  int atom;
 
-  while (patom->name && (patom->hash != hash || strcmp(patom->name, name) != 0))
+  while ((atom = atom_index[i]) >= 0)
     {
-      patom++;
-      if (patom == endt)
-	patom = pl_atom_tbl;
-      if (patom == patom0)	/* one complete round: the table is full */
-	return NULL;
+      if (pl_atom_tbl[atom].hash == hash && strcmp(pl_atom_tbl[atom].name, name) == 0)
+	return atom;
+
+      i = (i + 1) & index_mask;
     }
 
-#if 0
-  if (patom->name == NULL)
-    {
-      if (patom != patom0)
-	{
-	  printf("atom: (%s) collision ixd: %ld -> %ld\n", name, patom0 - pl_atom_tbl, patom - pl_atom_tbl);
-	}
+  *slot = i;
+  return -1;
+}
 
-      if (hash !=  patom - pl_atom_tbl)
-	{
-	  printf("atom: (%s)   hash: %u   idx: %ld\n", name, hash, patom - pl_atom_tbl);
-	}
-    }
-#endif
 
-#if 0
-  if (patom->name == NULL)
-    {
-      if (hash != index)
-	{
-	  printf("atom: (%s)   hash: %u   initial idx: %d\n", name, hash, index);
-	}
-    }
-#endif
 
-  return patom;
+
+/*-------------------------------------------------------------------------*
+ * GROW_TABLE                                                              *
+ *                                                                         *
+ * Double the atom table (atom numbers are unchanged).                     *
+ *-------------------------------------------------------------------------*/
+static void
+Grow_Table(void)
+{
+  PlULong size = pl_max_atom * 2;
+
+  if (pl_max_atom >= ATOM_TBL_LIMIT)
+    Error_Table_Full();
+
+  if (size > ATOM_TBL_LIMIT)
+    size = ATOM_TBL_LIMIT;
+
+  pl_atom_tbl = (AtomInf *) Realloc(pl_atom_tbl, size * sizeof(AtomInf));
+  memset(pl_atom_tbl + pl_max_atom, 0, (size - pl_max_atom) * sizeof(AtomInf));
+  pl_max_atom = size;
+
+  Set_Atom_GC_Threshold();
 }
 
 
 
 
+/*-------------------------------------------------------------------------*
+ * BUILD_INDEX                                                             *
+ *                                                                         *
+ * (Re)build the hash index with a given size (a power of 2).              *
+ *-------------------------------------------------------------------------*/
+static void
+Build_Index(PlULong size)
+{
+  PlULong i, atom;
+
+  if (atom_index)
+    Free(atom_index);
+
+  atom_index = (int *) Malloc(size * sizeof(int));
+  index_mask = size - 1;
+
+  for (i = 0; i < size; i++)
+    atom_index[i] = -1;
+
+  for (atom = 0; atom < atom_top; atom++)
+    {
+      if (pl_atom_tbl[atom].name == NULL)
+	continue;
+
+      i = pl_atom_tbl[atom].hash & index_mask;
+      while (atom_index[i] >= 0)
+	i = (i + 1) & index_mask;
+
+      atom_index[i] = (int) atom;
+    }
+}
+
+
+
 
 /*-------------------------------------------------------------------------*
  * HASH_STRING                                                             *
@@ -492,13 +654,9 @@ Pl_Gen_New_Atom(char *prefix)
   unsigned hash;
   char *str;
   int c;
-  AtomInf *patom;
+  PlULong slot;
   int atom;
 
-  if (pl_nb_atom >= pl_max_atom)
-    Error_Table_Full();
-
-
 #ifdef DEBUG
   nb++;
   /* printf("GEN_SYM PREFIX : %s\n", prefix); */
@@ -517,18 +675,14 @@ Pl_Gen_New_Atom(char *prefix)
 
       hash = Hash_String(gen_sym_buff, len);
 
-#if 1
-      patom = Locate_Atom(gen_sym_buff, hash);
-#else
-      patom = pl_atom_tbl + (hash % pl_max_atom);
-#endif
+      atom = Locate_Atom(gen_sym_buff, hash, &slot);
 
 #ifdef DEBUG
       try_count++;
       /*      printf("GEN_SYM TRY %3d: %s   len: %d\n", try_count, gen_sym_buff, len); */
 #endif
 
-      if (patom->name == NULL)
+      if (atom < 0)
 	break;
 
       if (++try_no == TRY_MAX)
@@ -544,7 +698,7 @@ Pl_Gen_New_Atom(char *prefix)
     }
 
 
-  atom = Add_Atom(gen_sym_buff, len, hash, patom, TRUE);
+  atom = Add_Atom(gen_sym_buff, len, hash, slot, TRUE, TRUE);
 
 #ifdef DEBUG
   sum_try += try_count;
@@ -582,7 +736,7 @@ Pl_Gen_New_Atom(char *prefix)
 int
 Pl_Find_Next_Atom(int last_atom)
 {
-  while ((PlULong) ++last_atom < pl_max_atom)
+  while ((PlULong) ++last_atom < atom_top)
     {
       if (pl_atom_tbl[last_atom].name)
 	return last_atom;
@@ -593,6 +747,176 @@ Pl_Find_Next_Atom(int last_atom)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_ATOM_GC_ADD_ROOT_FCT                                                 *
+ *                                                                         *
+ * Register a function which marks (via Pl_Atom_GC_Mark and                *
+ * Pl_Atom_GC_Mark_Words) the atoms referenced by the data of a module.    *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Atom_GC_Add_Root_Fct(AtomGCRootFct fct)
+{
+  if (nb_root_fct >= MAX_ATOM_GC_FCTS)
+    Pl_Fatal_Error(ERR_TOO_MANY_ATOM_GC_FCTS, MAX_ATOM_GC_FCTS);
+
+  root_fct[nb_root_fct++] = fct;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ATOM_GC_MARK                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Atom_GC_Mark(int atom)
+{
+  if ((PlULong) atom < atom_top)
+    atom_marks[atom / BITS_PER_WORD] |= (PlULong) 1 << (atom % BITS_PER_WORD);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ATOM_GC_MARK_WORDS                                                   *
+ *                                                                         *
+ * Conservatively mark the atoms of n words: the ATM words and the functor *
+ * of the STC words pointing inside the words or into the heap.            *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Atom_GC_Mark_Words(WamWord *adr, PlLong n)
+{
+  Pl_Atom_GC_Mark_Words_In(adr, n, Global_Stack, H);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ATOM_GC_MARK_WORDS_IN                                                *
+ *                                                                         *
+ * Same as Pl_Atom_GC_Mark_Words with the heap [heap, h[ (e.g. the heap of *
+ * a suspended engine).                                                    *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Atom_GC_Mark_Words_In(WamWord *adr, PlLong n, WamWord *heap, WamWord *h)
+{
+  WamWord *end = adr + n;
+  WamWord *p, *q;
+  WamWord word;
+
+  for (p = adr; p < end; p++)
+    {
+      word = *p;
+      if (Tag_Mask_Of(word) == TAG_ATM_MASK)
+	Pl_Atom_GC_Mark(UnTag_ATM(word));
+      else if (Tag_Mask_Of(word) == TAG_STC_MASK)
+	{
+	  q = UnTag_STC(word);
+	  if ((q >= adr && q < end) || (q >= heap && q < h))
+	    Pl_Atom_GC_Mark(Functor(q));
+	}
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ATOM_GARBAGE_COLLECT                                                 *
+ *                                                                         *
+ * Called by the garbage collector (safe point, see gc.c).                 *
+ * nb_live_x: the number of live X registers (A(0)...A(nb_live_x-1)).      *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Atom_Garbage_Collect(int nb_live_x)
+{
+  AtomInf *patom;
+  PredInf *pred;
+  OperInf *oper;
+  HashScan scan;
+  PlULong atom;
+  PlLong nb_freed = 0;
+  int i;
+
+  atom_marks = (PlULong *) Calloc(atom_top / BITS_PER_WORD + 1, sizeof(PlULong));
+
+  for (i = 0; i < nb_live_x; i++)
+    Pl_Atom_GC_Mark_Words(&A(i), 1);
+
+  Pl_Atom_GC_Mark_Words(Global_Stack, H - Global_Stack);
+  Pl_Atom_GC_Mark_Words(Local_Stack, Local_Top - Local_Stack);
+  Pl_Atom_GC_Mark_Words(Trail_Stack, TR - Trail_Stack);
+
+  for (pred = (PredInf *) Pl_Hash_First(pl_pred_tbl, &scan); pred;
+       pred = (PredInf *) Pl_Hash_Next(&scan))
+    {
+      Pl_Atom_GC_Mark(Functor_Of(pred->f_n));
+      Pl_Atom_GC_Mark(pred->pl_file);
+    }
+
+  for (oper = (OperInf *) Pl_Hash_First(pl_oper_tbl, &scan); oper;
+       oper = (OperInf *) Pl_Hash_Next(&scan))
+    Pl_Atom_GC_Mark((int) (oper->a_t >> 2));
+
+  for (i = 0; i < nb_root_fct; i++)
+    (*root_fct[i]) ();
+
+  for (atom = 0; atom < atom_top; atom++)
+    {
+      patom = pl_atom_tbl + atom;
+      if (patom->name == NULL || !patom->prop.collectable ||
+	  patom->info != NULL || Is_Atom_Marked(atom))
+	continue;
+
+#ifndef NO_USE_LINEDIT
+      Pl_LE_Compl_Remove_Word(patom->name);
+#endif
+      Free(patom->name);
+      patom->name = NULL;
+      patom->hash = (unsigned) free_atom;
+      free_atom = (int) atom;
+      pl_nb_atom--;
+      nb_freed++;
+    }
+
+  Free(atom_marks);
+
+  if (nb_freed > 0)
+    Build_Index(index_mask + 1);
+
+  pl_atom_gc_nb_freed += nb_freed;
+  Set_Atom_GC_Threshold();
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SET_ATOM_GC_THRESHOLD                                                   *
+ *                                                                         *
+ * The next atom collection occurs when the number of atoms has doubled    *
+ * (at least half of the table), without exceeding half of the free part.  *
+ *-------------------------------------------------------------------------*/
+static void
+Set_Atom_GC_Threshold(void)
+{
+  PlULong t = pl_nb_atom * 2;
+
+  if (t < pl_max_atom / 2)
+    t = pl_max_atom / 2;
+
+  if (t > pl_nb_atom + (pl_max_atom - pl_nb_atom) / 2)
+    t = pl_nb_atom + (pl_max_atom - pl_nb_atom) / 2;
+
+  pl_atom_gc_threshold = t;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * ERROR_TABLE_FULL                                                        *
  *                                                                         *
@@ -600,8 +924,5 @@ Pl_Find_Next_Atom(int last_atom)
 static void
 Error_Table_Full(void)
 {
-  if (pl_fixed_sizes)
-    Pl_Fatal_Error(ERR_TABLE_FULL_NO_ENV, pl_max_atom);
-  else
-    Pl_Fatal_Error(ERR_TABLE_FULL_ENV, pl_max_atom, ENV_VAR_MAX_ATOM);
+  Pl_Fatal_Error(ERR_TABLE_FULL, (unsigned long) pl_max_atom);
 }
@@ -65,7 +65,7 @@
 
 
 
-/* NB: (hash) atom table size should not be < ATOM_NIL (else module will change it) */
+/* NB: atom table size should not be < ATOM_NIL (else module will change it) */
 
 #define ATOM_NIL                 256
 
@@ -101,6 +101,7 @@ typedef struct			/* Atom properties                */
   unsigned type:2;		/* IDENTIFIER GRAPHIC SOLO OTHER  */
   unsigned needs_quote:1;	/* needs ' around it ?            */
   unsigned needs_scan:1;	/* contains ' or control char ?   */
+  unsigned collectable:1;	/* can be reclaimed (owns name) ? */
 }
 AtomProp;
 
@@ -112,13 +113,19 @@ typedef struct			/* Atom information               */
   char *name;			/* key is <name> (the string)     */
   unsigned hash;		/* the hash code of string (name) */
   AtomProp prop;		/* associated properties          */
-  void *info;			/* a user info (used by g_var)    */
+  void *info;			/* a user info (pins the atom)    */
+  PlULong order;		/* 1st chars of name (for compare)*/
 }
 AtomInf;
 
 
 
 
+typedef void (*AtomGCRootFct) (void);
+
+
+
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
@@ -128,6 +135,8 @@ AtomInf;
 AtomInf *pl_atom_tbl;
 PlULong pl_max_atom;
 PlULong pl_nb_atom;
+PlULong pl_atom_gc_threshold;
+PlLong pl_atom_gc_nb_freed;
 
 int pl_atom_void;
 int pl_atom_curly_brackets;
@@ -153,6 +162,8 @@ char pl_char_conv[256];
 extern AtomInf *pl_atom_tbl;
 extern PlULong pl_max_atom;
 extern PlULong pl_nb_atom;
+extern PlULong pl_atom_gc_threshold;
+extern PlLong pl_atom_gc_nb_freed;
 
 extern int pl_atom_void;
 extern int pl_atom_curly_brackets;
@@ -188,6 +199,10 @@ int Pl_Create_Allocate_Atom(char *name);
 
 int Pl_Create_Atom(char *name);
 
+int Pl_Create_Collectable_Atom(char *name, Bool allocate);
+
+void Pl_Pin_Atom(int atom);
+
 WamWord FC Pl_Create_Atom_Tagged(char *name);
 
 int Pl_Find_Atom(char *name);
@@ -196,6 +211,31 @@ int Pl_Gen_New_Atom(char *prefix);
 
 int Pl_Find_Next_Atom(int last_atom);
 
+void Pl_Atom_Garbage_Collect(int nb_live_x);
+
+void Pl_Atom_GC_Add_Root_Fct(AtomGCRootFct fct);
+
+void Pl_Atom_GC_Mark(int atom);
+
+void Pl_Atom_GC_Mark_Words(WamWord *adr, PlLong n);
+
+void Pl_Atom_GC_Mark_Words_In(WamWord *adr, PlLong n, WamWord *heap, WamWord *h);
+
+
+
+/* Standard order of 2 atoms (a1 and a2 are evaluated several times).
+ * order packs the first chars of the name (big-endian) so that comparing
+ * orders is comparing the beginning of the names with strcmp. Names are
+ * unique, thus if orders are equal both names are longer than an order.
+ */
+
+#define Pl_Atom_Compare(a1, a2)                                          \
+  (((a1) == (a2)) ? 0 :                                                  \
+   (pl_atom_tbl[a1].order != pl_atom_tbl[a2].order) ?                    \
+   ((pl_atom_tbl[a1].order < pl_atom_tbl[a2].order) ? -1 : 1) :          \
+   strcmp(pl_atom_tbl[a1].name + sizeof(PlULong),                        \
+          pl_atom_tbl[a2].name + sizeof(PlULong)))
+
 
 
 #ifdef OPTIM_1_CHAR_ATOM
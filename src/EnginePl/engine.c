@@ -70,6 +70,15 @@
 
 #define ERR_DIRECTIVE_FAILED       "warning: %s:%d: %s directive failed\n"
 
+#define MAX_ENGINE_STATES          32
+#define MAX_ENGINE_INIT_FCTS       16
+
+#define ERR_TOO_MANY_ENGINE_STATES "too many engine states (max: %d)"
+#define ERR_TOO_MANY_ENGINE_FCTS   "too many engine init functions (max: %d)"
+#define ERR_ENGINE_STATE_TOO_LATE  "engine state added after the creation of an engine"
+#define ERR_ENGINE_RUNNING         "cannot switch engines while Prolog code is running"
+#define ERR_ENGINE_DESTROY         "cannot destroy the main or the current engine"
+
 
 
 
@@ -77,6 +86,29 @@
  * Type Definitions                *
  *---------------------------------*/
 
+typedef struct
+{
+  void *adr;			/* a global data of a module */
+  int size;			/* its size (in bytes) */
+}
+EngineState;
+
+
+struct engine_inf		/* a Prolog engine (see PlEngine) */
+{
+  WamWord *stacks;		/* base of its stacks (see Pl_Reserve_Stacks) */
+  WamWord *reg_bank;
+  WamWord regs[NB_OF_REGS + 1];	/* +1 if = 0 */
+  WamWord *global, *h;		/* stacks of a suspended engine (atom GC) */
+  WamWord *local, *local_top;
+  WamWord *trail, *tr;
+  char *state;			/* copy of the registered global data */
+  PlEngine next;
+};
+
+
+
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
@@ -97,6 +129,21 @@ static WamWord *p_buff_save;
 
 static CodePtr cont_jmp;        /* we use a global var to support DEC alpha */
 
+static EngineState engine_state[MAX_ENGINE_STATES];
+static int nb_engine_state;
+static int engine_state_size;
+static char *init_state;	/* registered global data of a new engine */
+
+static EngineFct engine_init_fct[MAX_ENGINE_INIT_FCTS];
+static int nb_engine_init_fct;
+
+static EngineFct engine_destroy_fct[MAX_ENGINE_INIT_FCTS];
+static int nb_engine_destroy_fct;
+
+static struct engine_inf main_engine;
+static PlEngine cur_engine = &main_engine;
+static int nb_engine = 1;
+
 
 
 /*---------------------------------*
@@ -109,6 +156,16 @@ static void Call_Prolog_Success(void);
 
 static int Call_Next(CodePtr codep);
 
+static void Save_Engine(PlEngine eng);
+
+static void Restore_Engine(PlEngine eng);
+
+static void Copy_State(char *state, Bool save);
+
+static void Call_In_Engine(PlEngine eng, EngineFct fct);
+
+static void Engine_Atom_GC_Roots(void);
+
 void Pl_Call_Compiled(CodePtr codep);   /* defined in engine1.c */
 
 
@@ -186,6 +243,14 @@ Pl_Start_Prolog(int argc, char *argv[])
 #endif
     }
 
+  Pl_Engine_Add_State(pl_stk_tbl, NB_OF_STACKS * sizeof(InfStack));
+  Pl_Engine_Add_State(&heap_actual_start, sizeof(heap_actual_start));
+  Pl_Engine_Add_State(&pl_gc_trigger, sizeof(pl_gc_trigger));
+  Pl_Engine_Add_State(&pl_gc_keep_top, sizeof(pl_gc_keep_top));
+#ifdef NO_MACHINE_REG_FOR_REG_BANK
+  Pl_Engine_Add_State(pl_reg_bank, REG_BANK_SIZE * sizeof(WamWord));
+#endif
+
   Pl_Allocate_Stacks();
   Save_Machine_Regs(init_buff_regs);
 
@@ -198,6 +263,8 @@ Pl_Start_Prolog(int argc, char *argv[])
   /* must be changed to store global info (see the debugger) */
   heap_actual_start = Global_Stack;
 
+  Pl_Init_GC();
+
   pl_le_mode = 0;	/* not compiled with linedit or deactivated (using env var) */
 
 #ifndef NO_USE_LINEDIT
@@ -206,6 +273,7 @@ Pl_Start_Prolog(int argc, char *argv[])
 #endif
 
   Pl_Init_Atom();
+  Pl_Atom_GC_Add_Root_Fct(Engine_Atom_GC_Roots);
   Pl_Init_Pred();
   Pl_Init_Oper();
 
@@ -291,6 +359,353 @@ Pl_Set_Heap_Actual_Start(WamWord *new_heap_actual_start)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_GET_HEAP_ACTUAL_START                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+WamWord *
+Pl_Get_Heap_Actual_Start(void)
+{
+  return heap_actual_start;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ENGINE_ADD_STATE                                                     *
+ *                                                                         *
+ * Register a global data of a module whose value is specific to each      *
+ * engine (saved/restored when switching engines). Its current value is    *
+ * the initial value for the new engines. Called at initialization.        *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Engine_Add_State(void *adr, int size)
+{
+  if (nb_engine_state >= MAX_ENGINE_STATES)
+    Pl_Fatal_Error(ERR_TOO_MANY_ENGINE_STATES, MAX_ENGINE_STATES);
+
+  if (nb_engine > 1 || main_engine.state != NULL)
+    Pl_Fatal_Error(ERR_ENGINE_STATE_TOO_LATE);
+
+  engine_state[nb_engine_state].adr = adr;
+  engine_state[nb_engine_state].size = size;
+  nb_engine_state++;
+
+  init_state = Realloc(init_state, engine_state_size + size);
+  memcpy(init_state + engine_state_size, adr, size);
+  engine_state_size += size;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ENGINE_ADD_INIT_FCT                                                  *
+ *                                                                         *
+ * Register a function called when a new engine is created (the engine is *
+ * current and its heap is empty, e.g. to reserve some heap space).        *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Engine_Add_Init_Fct(EngineFct fct)
+{
+  if (nb_engine_init_fct >= MAX_ENGINE_INIT_FCTS)
+    Pl_Fatal_Error(ERR_TOO_MANY_ENGINE_FCTS, MAX_ENGINE_INIT_FCTS);
+
+  engine_init_fct[nb_engine_init_fct++] = fct;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ENGINE_ADD_DESTROY_FCT                                               *
+ *                                                                         *
+ * Register a function called when an engine is destroyed to free the data *
+ * of a module specific to this engine (its registered global data is set).*
+ *-------------------------------------------------------------------------*/
+void
+Pl_Engine_Add_Destroy_Fct(EngineFct fct)
+{
+  if (nb_engine_destroy_fct >= MAX_ENGINE_INIT_FCTS)
+    Pl_Fatal_Error(ERR_TOO_MANY_ENGINE_FCTS, MAX_ENGINE_INIT_FCTS);
+
+  engine_destroy_fct[nb_engine_destroy_fct++] = fct;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ENGINE_FOR_EACH_SUSPENDED                                            *
+ *                                                                         *
+ * Calls fct for each suspended engine with its registered global data set *
+ * (e.g. for the atom GC to mark the data of a module in all engines).     *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Engine_For_Each_Suspended(EngineFct fct)
+{
+  PlEngine eng;
+
+  for (eng = &main_engine; eng; eng = eng->next)
+    if (eng != cur_engine && eng->state != NULL)
+      Call_In_Engine(eng, fct);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ENGINE_CREATE                                                        *
+ *                                                                         *
+ * Creates a new engine with its own stacks, registers and registered      *
+ * global data (global variables, findall solutions,...). The compiled     *
+ * code and the tables (atoms, predicates, operators, flags, streams,...)  *
+ * are shared. The current engine is not changed.                          *
+ *                                                                         *
+ * An engine is not a thread: switching engines copies the registered      *
+ * global data in and out, so only one engine can run at a time in a      *
+ * process (see Pl_Engine_Switch).                                         *
+ *-------------------------------------------------------------------------*/
+PlEngine
+Pl_Engine_Create(void)
+{
+  PlEngine eng;
+  PlEngine cur = cur_engine;
+  int i;
+
+  if (p_jumper != NULL)
+    Pl_Fatal_Error(ERR_ENGINE_RUNNING);
+
+  if (cur)
+    Save_Engine(cur);
+
+  eng = (PlEngine) Calloc(1, sizeof(struct engine_inf));
+  Copy_State(init_state, FALSE);
+
+  eng->stacks = Pl_Reserve_Stacks();
+
+#ifndef NO_MACHINE_REG_FOR_REG_BANK
+  Init_Reg_Bank(Global_Stack);  /* allocated X regs + other non alloc regs */
+  Global_Stack += REG_BANK_SIZE; /* at the beginning of the heap */
+  Global_Size -= REG_BANK_SIZE;
+#endif
+
+  heap_actual_start = Global_Stack;
+  Pl_Init_GC();
+
+  Pl_Reset_Prolog();
+  for (i = 0; i < nb_engine_init_fct; i++)
+    (*engine_init_fct[i]) ();
+  Pl_Reset_Prolog();
+
+  Save_Engine(eng);
+  eng->next = main_engine.next;
+  main_engine.next = eng;
+  nb_engine++;
+
+  if (cur)
+    Restore_Engine(cur);
+
+  return eng;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ENGINE_DESTROY                                                       *
+ *                                                                         *
+ * Frees an engine created by Pl_Engine_Create (it must not be current).   *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Engine_Destroy(PlEngine eng)
+{
+  PlEngine *p;
+  int i;
+
+  if (eng == &main_engine || eng == cur_engine)
+    Pl_Fatal_Error(ERR_ENGINE_DESTROY);
+
+  for (p = &main_engine.next; *p != eng; p = &(*p)->next)
+    if (*p == NULL)
+      return;
+
+  for (i = 0; i < nb_engine_destroy_fct; i++)
+    Call_In_Engine(eng, engine_destroy_fct[i]);
+
+  *p = eng->next;
+  nb_engine--;
+
+  Pl_Release_Stacks(eng->stacks);
+  Free(eng->state);
+  Free(eng);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ENGINE_CURRENT                                                       *
+ *                                                                         *
+ * Returns the current engine (the main engine is created by Start_Prolog)*
+ *-------------------------------------------------------------------------*/
+PlEngine
+Pl_Engine_Current(void)
+{
+  return cur_engine;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ENGINE_SWITCH                                                        *
+ *                                                                         *
+ * Suspends the current engine and resumes eng (NULL: no current engine,   *
+ * e.g. before another OS thread resumes an engine). The queries of an    *
+ * engine remain open while it is suspended.                               *
+ * Engines CANNOT run in parallel: the WAM registers and the registered    *
+ * global data are process-wide variables whose values are copied in and   *
+ * out here. Several OS threads must serialize all their calls (from      *
+ * Pl_Engine_Switch(eng) to Pl_Engine_Switch(NULL)), e.g. with a mutex.    *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Engine_Switch(PlEngine eng)
+{
+  if (eng == cur_engine)
+    return;
+
+  if (p_jumper != NULL)
+    Pl_Fatal_Error(ERR_ENGINE_RUNNING);
+
+  if (cur_engine)
+    Save_Engine(cur_engine);
+
+  if (eng)
+    Restore_Engine(eng);
+
+  cur_engine = eng;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SAVE_ENGINE                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Save_Engine(PlEngine eng)
+{
+  if (eng->state == NULL)
+    eng->state = Malloc(engine_state_size + 1);
+
+  Copy_State(eng->state, TRUE);
+
+  Save_All_Regs(eng->regs);
+#ifndef NO_MACHINE_REG_FOR_REG_BANK
+  eng->reg_bank = pl_reg_bank;
+#endif
+
+  eng->global = Global_Stack;
+  eng->h = H;
+  eng->local = Local_Stack;
+  eng->local_top = Local_Top;
+  eng->trail = Trail_Stack;
+  eng->tr = TR;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RESTORE_ENGINE                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Restore_Engine(PlEngine eng)
+{
+  Copy_State(eng->state, FALSE);
+
+#ifndef NO_MACHINE_REG_FOR_REG_BANK
+  Init_Reg_Bank(eng->reg_bank);
+#endif
+  Restore_All_Regs(eng->regs);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COPY_STATE                                                              *
+ *                                                                         *
+ * Copies the registered global data to state (save) or from state.       *
+ *-------------------------------------------------------------------------*/
+static void
+Copy_State(char *state, Bool save)
+{
+  int i;
+
+  for (i = 0; i < nb_engine_state; i++)
+    {
+      if (save)
+	memcpy(state, engine_state[i].adr, engine_state[i].size);
+      else
+	memcpy(engine_state[i].adr, state, engine_state[i].size);
+      state += engine_state[i].size;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CALL_IN_ENGINE                                                          *
+ *                                                                         *
+ * Calls fct with the registered global data of a suspended engine (its    *
+ * WAM registers are not restored).                                        *
+ *-------------------------------------------------------------------------*/
+static void
+Call_In_Engine(PlEngine eng, EngineFct fct)
+{
+  char *save = Malloc(engine_state_size + 1);
+
+  Copy_State(save, TRUE);
+  Copy_State(eng->state, FALSE);
+  (*fct) ();
+  Copy_State(eng->state, TRUE);
+  Copy_State(save, FALSE);
+  Free(save);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * ENGINE_ATOM_GC_ROOTS                                                    *
+ *                                                                         *
+ * Marks the atoms referenced by the stacks of the suspended engines.      *
+ *-------------------------------------------------------------------------*/
+static void
+Engine_Atom_GC_Roots(void)
+{
+  PlEngine eng;
+
+  for (eng = &main_engine; eng; eng = eng->next)
+    {
+      if (eng == cur_engine || eng->state == NULL)
+	continue;
+
+      Pl_Atom_GC_Mark_Words_In(eng->global, eng->h - eng->global, eng->global, eng->h);
+      Pl_Atom_GC_Mark_Words_In(eng->local, eng->local_top - eng->local, eng->global, eng->h);
+      Pl_Atom_GC_Mark_Words_In(eng->trail, eng->tr - eng->trail, eng->global, eng->h);
+    }
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_EXECUTE_DIRECTIVE                                                    *
  *                                                                         *
@@ -407,6 +822,21 @@ Pl_Call_Prolog_Next_Sol(WamWord *query_b)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_CALL_PROLOG_CONT                                                     *
+ *                                                                         *
+ * Returns the continuation installed by Pl_Call_Prolog (used by the       *
+ * profiler to recognize a C to Prolog boundary in a continuation chain).  *
+ *-------------------------------------------------------------------------*/
+WamCont
+Pl_Call_Prolog_Cont(void)
+{
+  return Adjust_CP(Call_Prolog_Success);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_KEEP_REST_FOR_PROLOG                                                 *
  *                                                                         *
@@ -457,6 +887,9 @@ Call_Next(CodePtr codep)
   p_jumper = &new_jumper;
   p_buff_save = buff_save_machine_regs;
 
+  if (old_jumper != NULL)	/* the C caller can hold heap pointers */
+    Pl_GC_Inhibit(TRUE);
+
 #if 0
   Save_All_Regs(buff_save_all_regs);
 #endif
@@ -476,6 +909,9 @@ Call_Next(CodePtr codep)
   p_jumper = old_jumper;
   p_buff_save = old_buff_save;
 
+  if (old_jumper != NULL)
+    Pl_GC_Inhibit(FALSE);
+
   if (jmp_val < 0)              /* false: restore WAM registers */
     {
 #if 0
@@ -61,6 +61,9 @@
  * Type Definitions                *
  *---------------------------------*/
 
+typedef struct engine_inf *PlEngine;	/* an engine (see engine.c) */
+
+typedef void (*EngineFct) (void);
 
 
 /*---------------------------------*
@@ -115,6 +118,26 @@ void Pl_Reset_Prolog_In_Signal(void);
 
 void Pl_Set_Heap_Actual_Start(WamWord *heap_actual_start);
 
+WamWord *Pl_Get_Heap_Actual_Start(void);
+
+
+
+PlEngine Pl_Engine_Create(void);
+
+void Pl_Engine_Destroy(PlEngine eng);
+
+PlEngine Pl_Engine_Current(void);
+
+void Pl_Engine_Switch(PlEngine eng);
+
+void Pl_Engine_Add_State(void *adr, int size);
+
+void Pl_Engine_Add_Init_Fct(EngineFct fct);
+
+void Pl_Engine_Add_Destroy_Fct(EngineFct fct);
+
+void Pl_Engine_For_Each_Suspended(EngineFct fct);
+
 
 
 void Pl_Execute_Directive(int pl_file, int pl_line, Bool is_system, CodePtr proc);
@@ -125,6 +148,8 @@ int Pl_Call_Prolog(CodePtr codep);
 
 int Pl_Call_Prolog_Next_Sol(WamWord *query_b);
 
+WamCont Pl_Call_Prolog_Cont(void);
+
 void Pl_Keep_Rest_For_Prolog(WamWord *query_b);
 
 void Pl_Exit_With_Exception(void);
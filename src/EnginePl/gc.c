@@ -0,0 +1,937 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog engine                                                   *
+ * File  : gc.c                                                            *
+ * Descr.: garbage collector for the global stack                          *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GC_FILE
+
+#include "engine_pl.h"
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * The garbage collector is a sliding mark & compact collector for the     *
+ * global stack (heap). It is only called at safe points where the set of  *
+ * live registers is known: at the entry of Pl_Allocate() (the number of   *
+ * live X registers is then the arity of the predicate, passed by the      *
+ * compiled code) and via garbage_collect/0 (no live X register).          *
+ *                                                                         *
+ * Roots: the live X registers, the permanent variables of all reachable   *
+ * environments (from E and from each EB(b)), the arguments of all choice  *
+ * points, the trail (trailed cells and TOV old values) and the roots      *
+ * registered by other modules (e.g. global variables).                    *
+ *                                                                         *
+ * Mark phase: the marks are stored in a bitmap (1 bit per heap cell). A   *
+ * second bitmap records raw cells (functor cells and float values) which  *
+ * must not be relocated. An explicit mark stack is used.                  *
+ * The environments are marked as visited by negating their NBYE field     *
+ * (the number of Y variables is thus required, cf. GARBAGE_COLLECTOR in   *
+ * wam_inst.h), it is restored when pointers are updated.                  *
+ *                                                                         *
+ * Update phase: the new address of a live cell is its rank among live     *
+ * cells. It is computed from the bitmap and the number of live cells      *
+ * before each bitmap word. All pointers to the heap (in the roots and in  *
+ * live cells) are updated, together with HB(b) for each choice point.     *
+ *                                                                         *
+ * Compaction phase: live cells are slided down. Their order is preserved  *
+ * so the segments delimited by the choice points (HB(b)) remain valid.    *
+ *                                                                         *
+ * Some C non-deterministic built-ins store raw data in the arguments of   *
+ * their choice points (counters, malloc'ed pointers). Such a word can     *
+ * only be mistaken for a term if it looks like a pointer into the heap,   *
+ * which does not occur in practice (small integers, C heap addresses).    *
+ * Offsets between heap cells (e.g. term_ref/2) do not survive a GC.       *
+ *                                                                         *
+ * The cells below the heap actual start (permanent terms, cf. debugger)   *
+ * are never moved. Neither are the cells below the last FD variable       *
+ * copied in the heap (e.g. by copy_term/2): the constraint stack refers   *
+ * to it and its range is trailed with TMV entries (the FD variables       *
+ * created by the solver live in the constraint stack and are not          *
+ * concerned). The collection is inhibited while some C code holds         *
+ * pointers to the heap (nested Pl_Call_Prolog, foreign queries).          *
+ *                                                                         *
+ * Besides Pl_Allocate(), the choice point creation of compiled code is a  *
+ * safe point (the live X registers are the saved arguments), so that some *
+ * environment-less recursions are collected too. When the heap reaches    *
+ * its size (a soft limit, see stacks_sigsegv.c) a collection is requested *
+ * for the next safe point and the heap can temporarily grow beyond.       *
+ *                                                                         *
+ * The atom table is collected at the same safe points when it has grown   *
+ * enough (see atom.c), even if the heap collection is disabled (gc flag). *
+ *-------------------------------------------------------------------------*/
+
+
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+#define GC_INITIAL_GAP             (1024 * 1024)	/* in WamWords */
+#define GC_MIN_GAP                 (256 * 1024)
+#define GC_NO_MORE_GAP             1024
+
+#define MARK_STACK_INIT_SIZE       4096
+
+#define MAX_GC_FCTS                16
+
+#define BITS_PER_WORD              ((PlLong) sizeof(PlULong) * 8)
+
+#if WORD_SIZE == 32
+#define FLOAT_WORDS                2
+#else
+#define FLOAT_WORDS                1
+#endif
+
+#define ERR_TOO_MANY_GC_FCTS       "too many garbage collector hooks (max: %d)"
+
+
+
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+static int inhibit_level;
+
+static GCRootFct root_fct[MAX_GC_FCTS];
+static int nb_root_fct;
+
+static GCTrailFct trail_fct[MAX_GC_FCTS];
+static int nb_trail_fct;
+
+static WamWord *heap_lo;	/* heap part handled by the collection */
+static WamWord *heap_hi;
+static WamWord *heap_floor;	/* cells below are never moved */
+static PlLong floor_live;
+
+static PlULong *mark_bits;
+static PlULong *raw_bits;	/* functor and float cells */
+static PlLong *block_live;	/* nb of live cells before each block */
+
+static WamWord **mark_stack;
+static PlLong mark_stack_size;
+static PlLong mark_stack_top;
+
+static Bool gc_abort;
+
+
+
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+static void Collect_Heap(int nb_live_x);
+
+static void Set_Trigger(PlLong gap);
+
+static void Scan_Roots(int nb_live_x, GCVisitFct visit, Bool marking);
+
+static void Scan_Environments(WamWord *e, GCVisitFct visit, Bool marking);
+
+static void Scan_Trail(GCVisitFct visit, Bool marking);
+
+static void Restore_Environments(void);
+
+static void Mark_Root(WamWord *adr);
+
+static void Mark_Cell(WamWord *adr);
+
+static void Mark_Word(WamWord word);
+
+static void Count_Live_Cells(PlLong nb_blocks);
+
+static WamWord *Forward(WamWord *adr);
+
+static void Update_Root(WamWord *adr);
+
+static WamWord Relocate_Word(WamWord word);
+
+static void Update_Heap(PlLong nb_blocks);
+
+static WamWord *Compact_Heap(PlLong nb_blocks);
+
+static int Pop_Count(PlULong x);
+
+static int Count_Trailing_Zeros(PlULong x);
+
+
+
+#define In_Heap(adr)               ((adr) >= heap_lo && (adr) < heap_hi)
+
+#define Bit_Block(i)               ((i) / BITS_PER_WORD)
+#define Bit_Mask(i)                ((PlULong) 1 << ((i) % BITS_PER_WORD))
+
+#define Is_Marked(i)               (mark_bits[Bit_Block(i)] & Bit_Mask(i))
+#define Set_Mark(i)                (mark_bits[Bit_Block(i)] |= Bit_Mask(i))
+#define Set_Raw(i)                 (raw_bits[Bit_Block(i)] |= Bit_Mask(i))
+
+#define Live_Before(i)             (block_live[Bit_Block(i)] + \
+                                    Pop_Count(mark_bits[Bit_Block(i)] & \
+                                              (Bit_Mask(i) - 1)))
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_INIT_GC                                                              *
+ *                                                                         *
+ * Called by Pl_Start_Prolog() once the stacks are allocated.              *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Init_GC(void)
+{
+  PlLong gap = GC_INITIAL_GAP;
+
+  if (!pl_gc_enabled)
+    gap = Global_Size;
+  else if (gap > Global_Size / 2)
+    gap = Global_Size / 2;
+
+  pl_gc_trigger = Global_Stack + gap;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_GC_SET_ENABLED                                                       *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_GC_Set_Enabled(Bool enabled)
+{
+  pl_gc_enabled = enabled;
+  Set_Trigger(GC_MIN_GAP);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_GC_REQUEST                                                           *
+ *                                                                         *
+ * Ask for a collection at the next safe point (called when the heap       *
+ * reaches its size). Returns FALSE if no collection can occur.            *
+ *-------------------------------------------------------------------------*/
+Bool
+Pl_GC_Request(void)
+{
+  if (!pl_gc_enabled || inhibit_level > 0)
+    return FALSE;
+
+  pl_gc_trigger = Global_Stack;
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_GC_KEEP_HEAP                                                         *
+ *                                                                         *
+ * The heap cells below end (e.g. a copied FD variable) must not be moved  *
+ * since some other stack refers to them. adr is the start of the cells.   *
+ *-------------------------------------------------------------------------*/
+void
+Pl_GC_Keep_Heap(WamWord *adr, WamWord *end)
+{
+  if (adr >= Global_Stack && adr < Local_Stack && end > pl_gc_keep_top)
+    pl_gc_keep_top = end;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_GC_INHIBIT                                                           *
+ *                                                                         *
+ * Called with TRUE when some C code starts to hold pointers to the heap   *
+ * (and with FALSE when it is done). Calls can be nested.                  *
+ *-------------------------------------------------------------------------*/
+void
+Pl_GC_Inhibit(Bool inhibit)
+{
+  if (inhibit)
+    inhibit_level++;
+  else if (inhibit_level > 0)
+    inhibit_level--;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_GC_ADD_ROOT_FCT                                                      *
+ *                                                                         *
+ * Register a function which visits (via the visit argument) the C words   *
+ * which refer to the heap (the words must not be themselves in the heap). *
+ *-------------------------------------------------------------------------*/
+void
+Pl_GC_Add_Root_Fct(GCRootFct fct)
+{
+  if (nb_root_fct >= MAX_GC_FCTS)
+    Pl_Fatal_Error(ERR_TOO_MANY_GC_FCTS, MAX_GC_FCTS);
+
+  root_fct[nb_root_fct++] = fct;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_GC_ADD_TRAIL_FCT                                                     *
+ *                                                                         *
+ * Register a function called for each function call entry (TFC) of the    *
+ * trail. It receives the trailed function and its argument frame and can  *
+ * visit the words of its own data which refer to the heap.                *
+ *-------------------------------------------------------------------------*/
+void
+Pl_GC_Add_Trail_Fct(GCTrailFct fct)
+{
+  if (nb_trail_fct >= MAX_GC_FCTS)
+    Pl_Fatal_Error(ERR_TOO_MANY_GC_FCTS, MAX_GC_FCTS);
+
+  trail_fct[nb_trail_fct++] = fct;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_GARBAGE_COLLECT                                                      *
+ *                                                                         *
+ * nb_live_x: the number of live X registers (A(0)...A(nb_live_x-1)).      *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Garbage_Collect(int nb_live_x)
+{
+  PlLong t0;
+
+  if (inhibit_level > 0)
+    {
+      Set_Trigger(GC_MIN_GAP);
+      return;
+    }
+
+  t0 = Pl_M_User_Time();
+
+  if (pl_gc_enabled)
+    Collect_Heap(nb_live_x);
+
+  if (pl_nb_atom >= pl_atom_gc_threshold)
+    Pl_Atom_Garbage_Collect(nb_live_x);
+
+  pl_gc_time += Pl_M_User_Time() - t0;
+
+  Set_Trigger(H - Global_Stack);
+  Pl_Shrink_Stacks();
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COLLECT_HEAP                                                            *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Collect_Heap(int nb_live_x)
+{
+  PlLong size, nb_blocks;
+  WamWord *b;
+
+  heap_lo = Global_Stack;
+  heap_hi = H;
+  heap_floor = Pl_Get_Heap_Actual_Start();
+
+  if (pl_gc_keep_top > H)	/* the cells above H are no longer used */
+    pl_gc_keep_top = H;
+
+  if (pl_gc_keep_top > heap_floor)
+    heap_floor = pl_gc_keep_top;
+
+  size = heap_hi - heap_lo;
+  nb_blocks = size / BITS_PER_WORD + 1;
+
+  mark_bits = (PlULong *) Calloc(nb_blocks, sizeof(PlULong));
+  raw_bits = (PlULong *) Calloc(nb_blocks, sizeof(PlULong));
+  block_live = (PlLong *) Malloc(nb_blocks * sizeof(PlLong));
+
+  mark_stack_size = MARK_STACK_INIT_SIZE;
+  mark_stack = (WamWord **) Malloc(mark_stack_size * sizeof(WamWord *));
+  mark_stack_top = 0;
+
+  gc_abort = FALSE;
+
+  Scan_Roots(nb_live_x, Mark_Root, TRUE);
+
+  if (gc_abort)
+    Restore_Environments();
+  else
+    {
+      Count_Live_Cells(nb_blocks);
+
+      Scan_Roots(nb_live_x, Update_Root, FALSE);
+      for (b = B; b > Local_Stack; b = BB(b))
+	HB(b) = Forward(HB(b));
+
+      Update_Heap(nb_blocks);
+      H = Compact_Heap(nb_blocks);
+      HB1 = HB(B);
+
+      pl_gc_nb_collections++;
+      pl_gc_nb_freed_words += heap_hi - H;
+    }
+
+  Free(mark_bits);
+  Free(raw_bits);
+  Free(block_live);
+  Free(mark_stack);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SET_TRIGGER                                                             *
+ *                                                                         *
+ * The next collection occurs after gap words have been allocated (if      *
+ * possible, at most half of the free space). A full heap is left to the   *
+ * stack overflow detection (which requests a collection, see             *
+ * Pl_GC_Request). If the live cells already exceed the size of the heap,  *
+ * no collection is triggered until the overflow.                          *
+ *-------------------------------------------------------------------------*/
+static void
+Set_Trigger(PlLong gap)
+{
+  WamWord *end = Global_Stack + Global_Size;
+  PlLong free = end - H;
+
+  if (!pl_gc_enabled || free / 2 < GC_NO_MORE_GAP)
+    {
+      pl_gc_trigger = (H < end) ? end : Local_Stack;
+      return;
+    }
+
+  if (gap < GC_MIN_GAP)
+    gap = GC_MIN_GAP;
+
+  if (gap > free / 2)
+    gap = free / 2;
+
+  pl_gc_trigger = H + gap;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCAN_ROOTS                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Scan_Roots(int nb_live_x, GCVisitFct visit, Bool marking)
+{
+  WamWord *b, *b_top;
+  PlLong n, i;
+
+  for (i = 0; i < nb_live_x; i++)
+    (*visit) (&A(i));
+
+  Scan_Environments(E, visit, marking);
+
+  for (b = B; b > Local_Stack; b = BB(b))
+    {				/* Local_Top at creation time gives the arity */
+      b_top = (EB(b) > BB(b)) ? EB(b) : BB(b);
+      n = b - CHOICE_STATIC_SIZE - b_top;
+
+      for (i = 0; i < n; i++)
+	(*visit) (&AB(b, i));
+
+      Scan_Environments(EB(b), visit, marking);
+    }
+
+  Scan_Trail(visit, marking);
+
+  for (i = 0; i < nb_root_fct; i++)
+    (*root_fct[i]) (visit);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCAN_ENVIRONMENTS                                                       *
+ *                                                                         *
+ * Marking: an environment is flagged as visited by negating its NBYE (a   *
+ * visited environment implies its ancestors are visited too).             *
+ * Updating: an environment is visited iff it is flagged (then unflagged). *
+ *-------------------------------------------------------------------------*/
+static void
+Scan_Environments(WamWord *e, GCVisitFct visit, Bool marking)
+{
+  PlLong n, i;
+
+  for (; e > Local_Stack; e = EE(e))
+    {
+      n = (PlLong) NBYE(e);
+      if (marking)
+	{
+	  if (n < 0)
+	    break;
+	  NBYE(e) = -n - 1;
+	}
+      else
+	{
+	  if (n >= 0)
+	    break;
+	  n = -n - 1;
+	  NBYE(e) = n;
+	}
+
+      if (visit)
+	for (i = 0; i < n; i++)
+	  (*visit) (&Y(e, i));
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RESTORE_ENVIRONMENTS                                                    *
+ *                                                                         *
+ * Unflag all environments (after an aborted mark phase).                  *
+ *-------------------------------------------------------------------------*/
+static void
+Restore_Environments(void)
+{
+  WamWord *b;
+
+  Scan_Environments(E, NULL, FALSE);
+
+  for (b = B; b > Local_Stack; b = BB(b))
+    Scan_Environments(EB(b), NULL, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SCAN_TRAIL                                                              *
+ *                                                                         *
+ * A trailed heap cell is kept alive since it will be reset at backtrack.  *
+ *-------------------------------------------------------------------------*/
+static void
+Scan_Trail(GCVisitFct visit, Bool marking)
+{
+  WamWord *tr = TR;
+  WamWord *entry;
+  WamWord *adr;
+  WamWord fct;
+  int tag, nb, i;
+
+  while (tr > Trail_Stack)
+    {
+      entry = --tr;
+      tag = Trail_Tag_Of(*entry);
+      adr = (WamWord *) Trail_Value_Of(*entry);
+
+      switch (tag)
+	{
+	case TOV:
+	  (*visit) (--tr);	/* the old value */
+	  /* fall through */
+
+	case TUV:
+	  if (!In_Heap(adr))
+	    break;
+
+	  if (marking)
+	    {
+	      Mark_Cell(adr);
+	      Mark_Root(NULL);
+	    }
+	  else
+	    *entry = Trail_Tag_Value(tag, Forward(adr));
+	  break;
+
+	case TMV:		/* only used by FD (cf. pl_gc_keep_top) */
+	  nb = (int) *--tr;
+	  tr -= nb;
+	  if (In_Heap(adr) && adr >= heap_floor)
+	    gc_abort = TRUE;
+	  break;
+
+	default:		/* TFC */
+	  fct = *--tr;
+	  nb = (int) *--tr;
+	  tr -= nb;
+	  for (i = 0; i < nb_trail_fct; i++)
+	    (*trail_fct[i]) (fct, nb, tr, visit);
+	}
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MARK_ROOT                                                               *
+ *                                                                         *
+ * Mark all cells reachable from the word at adr (adr = NULL: only mark    *
+ * the pending cells).                                                     *
+ *-------------------------------------------------------------------------*/
+static void
+Mark_Root(WamWord *adr)
+{
+  if (gc_abort)
+    return;
+
+  if (adr)
+    Mark_Word(*adr);
+
+  while (mark_stack_top > 0 && !gc_abort)
+    Mark_Word(*mark_stack[--mark_stack_top]);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MARK_CELL                                                               *
+ *                                                                         *
+ * Mark a heap cell and push it to scan its content.                       *
+ *-------------------------------------------------------------------------*/
+static void
+Mark_Cell(WamWord *adr)
+{
+  PlLong i;
+
+  if (!In_Heap(adr))
+    return;
+
+  i = adr - heap_lo;
+  if (Is_Marked(i))
+    return;
+
+  Set_Mark(i);
+
+  if (mark_stack_top == mark_stack_size)
+    {
+      mark_stack_size *= 2;
+      mark_stack = (WamWord **) Realloc((char *) mark_stack,
+					mark_stack_size * sizeof(WamWord *));
+    }
+
+  mark_stack[mark_stack_top++] = adr;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * MARK_WORD                                                               *
+ *                                                                         *
+ * The cells of a list/structure are pushed such that the first argument   *
+ * is scanned first (the mark stack remains small for lists).              *
+ *-------------------------------------------------------------------------*/
+static void
+Mark_Word(WamWord word)
+{
+  WamWord *adr;
+  PlLong i;
+  int n;
+
+  switch (Tag_Mask_Of(word))
+    {
+    case TAG_REF_MASK:
+      Mark_Cell(UnTag_REF(word));
+      break;
+
+    case TAG_LST_MASK:
+      adr = UnTag_LST(word);
+      Mark_Cell(&Cdr(adr));
+      Mark_Cell(&Car(adr));
+      break;
+
+    case TAG_STC_MASK:
+      adr = UnTag_STC(word);
+      if (!In_Heap(adr))
+	break;
+
+      i = adr - heap_lo;
+      if (Is_Marked(i))
+	break;
+
+      Set_Mark(i);
+      Set_Raw(i);
+      n = Arity(adr);
+      if (&Arg(adr, n - 1) >= heap_hi)
+	{
+	  gc_abort = TRUE;
+	  break;
+	}
+
+      while (--n >= 0)
+	Mark_Cell(&Arg(adr, n));
+      break;
+
+    case TAG_FLT_MASK:
+      adr = UnTag_FLT(word);
+      for (n = 0; n < FLOAT_WORDS && In_Heap(adr); n++, adr++)
+	{
+	  i = adr - heap_lo;
+	  Set_Mark(i);
+	  Set_Raw(i);
+	}
+      break;
+
+    case TAG_FDV_MASK:		/* raw cells kept below the floor */
+      adr = UnTag_FDV(word);
+      if (In_Heap(adr) && adr >= heap_floor)
+	gc_abort = TRUE;
+      break;
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COUNT_LIVE_CELLS                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Count_Live_Cells(PlLong nb_blocks)
+{
+  PlLong k, n = 0;
+
+  for (k = 0; k < nb_blocks; k++)
+    {
+      block_live[k] = n;
+      n += Pop_Count(mark_bits[k]);
+    }
+
+  floor_live = Live_Before(heap_floor - heap_lo);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * FORWARD                                                                 *
+ *                                                                         *
+ * Return the address of a heap cell after compaction.                     *
+ *-------------------------------------------------------------------------*/
+static WamWord *
+Forward(WamWord *adr)
+{
+  if (adr < heap_floor)
+    return adr;
+
+  return heap_floor + (Live_Before(adr - heap_lo) - floor_live);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * UPDATE_ROOT                                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Update_Root(WamWord *adr)
+{
+  *adr = Relocate_Word(*adr);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * RELOCATE_WORD                                                           *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static WamWord
+Relocate_Word(WamWord word)
+{
+  WamWord *adr;
+
+  switch (Tag_Mask_Of(word))
+    {
+    case TAG_REF_MASK:
+      adr = UnTag_REF(word);
+      if (In_Heap(adr))
+	word = Tag_REF(Forward(adr));
+      break;
+
+    case TAG_LST_MASK:
+      adr = UnTag_LST(word);
+      if (In_Heap(adr))
+	word = Tag_LST(Forward(adr));
+      break;
+
+    case TAG_STC_MASK:
+      adr = UnTag_STC(word);
+      if (In_Heap(adr))
+	word = Tag_STC(Forward(adr));
+      break;
+
+    case TAG_FLT_MASK:
+      adr = UnTag_FLT(word);
+      if (In_Heap(adr))
+	word = Tag_FLT(Forward(adr));
+      break;
+    }
+
+  return word;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * UPDATE_HEAP                                                             *
+ *                                                                         *
+ * Relocate the content of all live cells (except raw cells).              *
+ *-------------------------------------------------------------------------*/
+static void
+Update_Heap(PlLong nb_blocks)
+{
+  PlLong k;
+  PlULong bits;
+  WamWord *adr;
+
+  for (k = 0; k < nb_blocks; k++)
+    {
+      bits = mark_bits[k] & ~raw_bits[k];
+      while (bits)
+	{
+	  adr = heap_lo + k * BITS_PER_WORD + Count_Trailing_Zeros(bits);
+	  *adr = Relocate_Word(*adr);
+	  bits &= bits - 1;
+	}
+    }
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COMPACT_HEAP                                                            *
+ *                                                                         *
+ * Slide the live cells above the floor. Return the new top of the heap.   *
+ *-------------------------------------------------------------------------*/
+static WamWord *
+Compact_Heap(PlLong nb_blocks)
+{
+  PlLong k, i = heap_floor - heap_lo;
+  PlULong bits;
+  WamWord *dst = heap_floor;
+
+  for (k = Bit_Block(i); k < nb_blocks; k++)
+    {
+      bits = mark_bits[k];
+      if (k == Bit_Block(i))
+	bits &= ~(Bit_Mask(i) - 1);
+
+      while (bits)
+	{
+	  *dst++ = heap_lo[k * BITS_PER_WORD + Count_Trailing_Zeros(bits)];
+	  bits &= bits - 1;
+	}
+    }
+
+  return dst;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * POP_COUNT                                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Pop_Count(PlULong x)
+{
+#ifdef __GNUC__
+  return __builtin_popcountll((unsigned long long) x);
+#else
+  int n = 0;
+
+  for (; x; x &= x - 1)
+    n++;
+
+  return n;
+#endif
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * COUNT_TRAILING_ZEROS                                                    *
+ *                                                                         *
+ * x must be != 0.                                                         *
+ *-------------------------------------------------------------------------*/
+static int
+Count_Trailing_Zeros(PlULong x)
+{
+#ifdef __GNUC__
+  return __builtin_ctzll((unsigned long long) x);
+#else
+  int n = 0;
+
+  for (; (x & 1) == 0; x >>= 1)
+    n++;
+
+  return n;
+#endif
+}
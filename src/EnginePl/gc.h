@@ -0,0 +1,98 @@
+/*-------------------------------------------------------------------------*
+ * GNU Prolog                                                              *
+ *                                                                         *
+ * Part  : Prolog engine                                                   *
+ * File  : gc.h                                                            *
+ * Descr.: garbage collector for the global stack - header file            *
+ * Author: Daniel Diaz                                                     *
+ *                                                                         *
+ * Copyright (C) 1999-2023 Daniel Diaz                                     *
+ *                                                                         *
+ * This file is part of GNU Prolog                                         *
+ *                                                                         *
+ * GNU Prolog is free software: you can redistribute it and/or             *
+ * modify it under the terms of either:                                    *
+ *                                                                         *
+ *   - the GNU Lesser General Public License as published by the Free      *
+ *     Software Foundation; either version 3 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or                                                                      *
+ *                                                                         *
+ *   - the GNU General Public License as published by the Free             *
+ *     Software Foundation; either version 2 of the License, or (at your   *
+ *     option) any later version.                                          *
+ *                                                                         *
+ * or both in parallel, as here.                                           *
+ *                                                                         *
+ * GNU Prolog is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU       *
+ * General Public License for more details.                                *
+ *                                                                         *
+ * You should have received copies of the GNU General Public License and   *
+ * the GNU Lesser General Public License along with this program.  If      *
+ * not, see http://www.gnu.org/licenses/.                                  *
+ *-------------------------------------------------------------------------*/
+
+
+/*---------------------------------*
+ * Constants                       *
+ *---------------------------------*/
+
+/*---------------------------------*
+ * Type Definitions                *
+ *---------------------------------*/
+
+typedef void (*GCVisitFct) (WamWord *adr);
+
+typedef void (*GCRootFct) (GCVisitFct visit);
+
+typedef void (*GCTrailFct) (WamWord fct, int nb, WamWord *arg_frame,
+			    GCVisitFct visit);
+
+/*---------------------------------*
+ * Global Variables                *
+ *---------------------------------*/
+
+#ifdef GC_FILE
+
+WamWord *pl_gc_trigger;
+WamWord *pl_gc_keep_top;	/* top of the FD variables in the heap */
+Bool pl_gc_enabled = FALSE;
+
+PlLong pl_gc_nb_collections;
+PlLong pl_gc_nb_freed_words;
+PlLong pl_gc_time;
+
+#else
+
+extern WamWord *pl_gc_trigger;
+extern WamWord *pl_gc_keep_top;
+extern Bool pl_gc_enabled;
+
+extern PlLong pl_gc_nb_collections;
+extern PlLong pl_gc_nb_freed_words;
+extern PlLong pl_gc_time;
+
+#endif
+
+/*---------------------------------*
+ * Function Prototypes             *
+ *---------------------------------*/
+
+void Pl_Init_GC(void);
+
+void Pl_Garbage_Collect(int nb_live_x);
+
+void Pl_GC_Set_Enabled(Bool enabled);
+
+Bool Pl_GC_Request(void);
+
+void Pl_GC_Keep_Heap(WamWord *adr, WamWord *end);
+
+void Pl_GC_Inhibit(Bool inhibit);
+
+void Pl_GC_Add_Root_Fct(GCRootFct fct);
+
+void Pl_GC_Add_Trail_Fct(GCTrailFct fct);
@@ -91,6 +91,8 @@ typedef uintptr_t PlULong;
 
 typedef intptr_t PlTerm;
 
+typedef struct engine_inf *PlEngine;
+
 typedef struct
 {
   PlBool is_var;
@@ -223,6 +225,14 @@ void Pl_Reset_Prolog(void);
 
 PlBool Pl_Try_Execute_Top_Level(void);
 
+PlEngine Pl_Engine_Create(void);
+
+void Pl_Engine_Destroy(PlEngine engine);
+
+PlEngine Pl_Engine_Current(void);
+
+void Pl_Engine_Switch(PlEngine engine);
+
 
 
 
@@ -54,6 +54,9 @@
 #define Free(ptr)          free(ptr)
 
 typedef long PlLong;
+typedef unsigned long PlULong;
+
+#define WORD_SIZE          64
 
 #else
 
@@ -66,18 +69,53 @@ typedef long PlLong;
  * Constants                       *
  *---------------------------------*/
 
+#define HASH_MIN_SLOTS             8
+
+#define HASH_MIN_CHUNK_ELEMS       4
+
+#define HASH_ELEM_ALIGN            8
+
+#define HASH_DELETED               ((char *) 1)
+
+#if WORD_SIZE == 32
+#define HASH_FIBO_MULT             ((PlULong) 0x9E3779B9UL)
+#else
+#define HASH_FIBO_MULT             ((PlULong) 0x9E3779B97F4A7C15ULL)
+#endif
+
+
+
+
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
 
-typedef struct hash_node *HashNode;
+typedef struct			/* Slot of the open addressing table */
+{				/* ------------------------------ */
+  PlLong key;			/* copy of the key of the elem    */
+  char *elem;			/* NULL (free), HASH_DELETED, elem*/
+}
+HashSlot;
+
+
+typedef struct			/* Hash table header              */
+{				/* ------------------------------ */
+  int tbl_size;			/* nb of elems before extension   */
+  int elem_size;		/* size of an elem (user)         */
+  int nb_elem;			/* nb of elems in the table       */
+  int nb_used;			/* nb_elem + nb of deleted slots  */
+  int nb_slot;			/* nb of slots (a power of 2)     */
+  int shift;			/* WORD_SIZE - log2(nb_slot)      */
+  HashSlot *slot;		/* the open addressing table      */
+  int chunk_elem_size;		/* elem_size aligned              */
+  int nb_chunk_elem;		/* nb of elems in all chunks      */
+  char *chunk;			/* list of chunks of elems        */
+  char *chunk_top;		/* next free elem in 1st chunk    */
+  char *chunk_end;		/* end of the 1st chunk           */
+  char *free_elem;		/* list of deleted elems          */
+}
+HashTbl;
 
-struct hash_node
-{
-  HashNode next;
-  PlLong key;
-  /* the rest of the elem comes here */
-};
 
 
 
@@ -89,32 +127,51 @@ struct hash_node
  * Function Prototypes             *
  *---------------------------------*/
 
-static HashNode *Hash_Locate(HashNode *t, int tbl_size, PlLong key);
+static int Hash_Nb_Slot(int tbl_size);
+
+static void Hash_Init_Slots(HashTbl *h, int nb_slot, HashSlot *slot);
 
+static void Hash_Rehash(HashTbl *h, int tbl_size);
 
+static char *Hash_Alloc_Elem(HashTbl *h);
 
-#define HASH_STATIC_SIZE           3
+static void Hash_Free_Chunks(HashTbl *h);
 
-#define Tbl_Size(t)                (((int *)(t))[0])
 
-#define Elem_Size(t)               (((int *)(t))[1])
 
-#define Nb_Elem(t)                 (((int *)(t))[2])
+#define Hsh_Tbl(t)                 ((HashTbl *) (t))
 
-#define Hsh_Table(t)               (((HashNode *) (t)) + HASH_STATIC_SIZE)
+#define Hash_Function(k, h)        ((int) (((PlULong) (k) * HASH_FIBO_MULT) >> (h)->shift))
 
+#define Hash_Next_Slot(n, h)       (((n) + 1) & ((h)->nb_slot - 1))
 
+#define Slot_Is_Elem(s)            ((s)->elem > HASH_DELETED)
 
-#define Hash_Function(k, size)     ((PlULong) (k) % (size))
+#define Chunk_Header_Size          HASH_ELEM_ALIGN
+
+#define Inline_Slots(h)            ((HashSlot *) ((h) + 1))
 
 
 
 
 /*-------------------------------------------------------------------------*
- * A hash table consists of a header (tbl_size, elem_size, nb_elem) and a  *
- * table of tbl_size pointers to nodes.                                    *
- * Each node records a pointer to the next node, and a user element whose  *
- * size is elem_size. Each element must begin with the key (a PlLong).     *
+ * A hash table consists of a header (see HashTbl) and a table of nb_slot  *
+ * slots managed with open addressing (linear probing). nb_slot is a power *
+ * of 2 and tbl_size is 3/4 of nb_slot. The hash code of a key is computed *
+ * by Fibonacci (multiplicative) hashing: the keys are mainly atoms and    *
+ * functors (dense integers) which must be scattered, else they form long  *
+ * runs of used slots (and an unsuccessful search scans the whole run). A  *
+ * slot records the key of its elem (so that probing does not touch the    *
+ * elems) and a pointer to the elem. Deleted slots are marked (so that a   *
+ * scan is not disturbed by a delete) and recycled by next insertions and  *
+ * when the slots are reallocated.                                         *
+ *                                                                         *
+ * The user elements (whose size is elem_size and which must begin with    *
+ * the key, a PlLong) are allocated by chunks and never move: a pointer to *
+ * an element remains valid until the element is deleted. Deleted elements *
+ * are reused by next insertions. The table grows by itself (when 7/8 of   *
+ * the slots are used) and the header never moves. Pl_Hash_Realloc_Table() *
+ * only reallocates the slots and returns the same table.                  *
  *-------------------------------------------------------------------------*/
 
 
@@ -125,22 +182,71 @@ static HashNode *Hash_Locate(HashNode *t, int tbl_size, PlLong key);
 char *
 Pl_Hash_Alloc_Table(int tbl_size, int elem_size)
 {
-  char *tbl;
+  HashTbl *h;
+  int nb_slot = Hash_Nb_Slot(tbl_size);
 
-  tbl = (char *) Calloc(HASH_STATIC_SIZE + tbl_size, sizeof(HashNode));
+				/* the first slots follow the header */
+  h = (HashTbl *) Malloc(sizeof(HashTbl) + nb_slot * sizeof(HashSlot));
 #ifdef USE_ALONE
-  if (tbl == NULL)
+  if (h == NULL)
     return NULL;
 #endif
 
-  if (tbl_size < 1)
-    tbl_size = 1;		/* at least one cell in a table */
+  h->elem_size = elem_size;
+  h->chunk_elem_size = (elem_size + HASH_ELEM_ALIGN - 1) & ~(HASH_ELEM_ALIGN - 1);
+  h->nb_chunk_elem = 0;
+  h->chunk = NULL;
+  h->chunk_top = h->chunk_end = NULL;
+  h->free_elem = NULL;
 
-  Tbl_Size(tbl) = tbl_size;
-  Elem_Size(tbl) = elem_size;
-  Nb_Elem(tbl) = 0;
+  Hash_Init_Slots(h, nb_slot, Inline_Slots(h));
 
-  return tbl;
+  return (char *) h;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * HASH_NB_SLOT                                                            *
+ *                                                                         *
+ * Returns the nb of slots needed for (at least) tbl_size elements.        *
+ *-------------------------------------------------------------------------*/
+static int
+Hash_Nb_Slot(int tbl_size)
+{
+  int nb_slot = HASH_MIN_SLOTS;
+
+  while (nb_slot / 4 * 3 < tbl_size)
+    nb_slot *= 2;
+
+  return nb_slot;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * HASH_INIT_SLOTS                                                         *
+ *                                                                         *
+ * Installs an empty table of nb_slot slots.                               *
+ *-------------------------------------------------------------------------*/
+static void
+Hash_Init_Slots(HashTbl *h, int nb_slot, HashSlot *slot)
+{
+  int shift = WORD_SIZE;
+  int n;
+
+  for (n = nb_slot; n > 1; n /= 2)
+    shift--;
+
+  h->tbl_size = nb_slot / 4 * 3;
+  h->nb_slot = nb_slot;
+  h->shift = shift;
+  h->nb_elem = 0;
+  h->nb_used = 0;
+  h->slot = slot;
+  memset(slot, 0, nb_slot * sizeof(HashSlot));
 }
 
 
@@ -149,44 +255,63 @@ Pl_Hash_Alloc_Table(int tbl_size, int elem_size)
 /*-------------------------------------------------------------------------*
  * PL_HASH_REALLOC_TABLE                                                   *
  *                                                                         *
- * NB: user information is not moved elsewhere                             *
+ * NB: user information is not moved elsewhere (and the table neither)     *
  *-------------------------------------------------------------------------*/
 char *
 Pl_Hash_Realloc_Table(char *tbl, int new_tbl_size)
 {
-  int tbl_size = Tbl_Size(tbl);
-  int elem_size = Elem_Size(tbl);
-  HashNode *t = Hsh_Table(tbl);
-  HashNode *endt = t + tbl_size;
-  HashNode p, p1;
-  HashNode *prev;
-  char *new_tbl;
-  HashNode *new_t;
-
-  if ((new_tbl = Pl_Hash_Alloc_Table(new_tbl_size, elem_size)) == NULL)
-    return NULL;
+  HashTbl *h = Hsh_Tbl(tbl);
 
-  Nb_Elem(new_tbl) = Nb_Elem(tbl);
+  if (new_tbl_size < h->nb_elem)
+    new_tbl_size = h->nb_elem;
+
+  Hash_Rehash(h, new_tbl_size);
+
+  return tbl;
+}
 
-  new_t = Hsh_Table(new_tbl);
 
-  do
+
+
+/*-------------------------------------------------------------------------*
+ * HASH_REHASH                                                             *
+ *                                                                         *
+ * Reallocates the slots for tbl_size elements (deleted slots vanish).     *
+ *-------------------------------------------------------------------------*/
+static void
+Hash_Rehash(HashTbl *h, int tbl_size)
+{
+  HashSlot *old_slot = h->slot;
+  HashSlot *s = old_slot;
+  HashSlot *ends = s + h->nb_slot;
+  int nb_elem = h->nb_elem;
+  int nb_slot = Hash_Nb_Slot(tbl_size);
+  HashSlot *slot;
+  int n;
+
+  slot = (HashSlot *) Malloc(nb_slot * sizeof(HashSlot));
+#ifdef USE_ALONE
+  if (slot == NULL)
+    return;
+#endif
+  Hash_Init_Slots(h, nb_slot, slot);
+
+  for (; s < ends; s++)
     {
-      p = *t;
-      while (p)
-	{			/* here *prev==NULL */
-	  prev = Hash_Locate(new_t, new_tbl_size, p->key);
-	  p1 = p;
-	  p = p->next;
-	  *prev = p1;
-	  p1->next = NULL;
-	}
+      if (!Slot_Is_Elem(s))
+	continue;
+
+      n = Hash_Function(s->key, h);
+      while (h->slot[n].elem)
+	n = Hash_Next_Slot(n, h);
+
+      h->slot[n] = *s;
     }
-  while (++t < endt);
 
-  Free(tbl);
+  h->nb_elem = h->nb_used = nb_elem;
 
-  return new_tbl;
+  if (old_slot != Inline_Slots(h))
+    Free(old_slot);
 }
 
 
@@ -199,24 +324,12 @@ Pl_Hash_Realloc_Table(char *tbl, int new_tbl_size)
 void
 Pl_Hash_Free_Table(char *tbl)
 {
-  int tbl_size = Tbl_Size(tbl);
-  HashNode *t = Hsh_Table(tbl);
-  HashNode *endt = t + tbl_size;
-  HashNode p, p1;
-
-  do
-    {
-      p = *t;
-      while (p)
-	{
-	  p1 = p;
-	  p = p->next;
-	  Free(p1);
-	}
-    }
-  while (++t < endt);
+  HashTbl *h = Hsh_Tbl(tbl);
 
-  Free(tbl);
+  Hash_Free_Chunks(h);
+  if (h->slot != Inline_Slots(h))
+    Free(h->slot);
+  Free(h);
 }
 
 
@@ -229,147 +342,214 @@ Pl_Hash_Free_Table(char *tbl)
 void
 Pl_Hash_Delete_All(char *tbl)
 {
-  int tbl_size = Tbl_Size(tbl);
-  HashNode *t = Hsh_Table(tbl);
-  HashNode *endt = t + tbl_size;
-  HashNode p, p1;
+  HashTbl *h = Hsh_Tbl(tbl);
 
-  do
-    {
-      p = *t;
-      while (p)
-	{
-	  p1 = p;
-	  p = p->next;
-	  Free(p1);
-	}
+  Hash_Free_Chunks(h);
+  memset(h->slot, 0, h->nb_slot * sizeof(HashSlot));
+  h->nb_elem = 0;
+  h->nb_used = 0;
+}
 
-      *t = NULL;
+
+
+
+/*-------------------------------------------------------------------------*
+ * HASH_FREE_CHUNKS                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Hash_Free_Chunks(HashTbl *h)
+{
+  char *p, *p1;
+
+  for (p = h->chunk; p; p = p1)
+    {
+      p1 = *(char **) p;
+      Free(p);
     }
-  while (++t < endt);
 
-  Nb_Elem(tbl) = 0;
+  h->nb_chunk_elem = 0;
+  h->chunk = NULL;
+  h->chunk_top = h->chunk_end = NULL;
+  h->free_elem = NULL;
 }
 
 
 
 
 /*-------------------------------------------------------------------------*
- * HASH_UPDATE                                                             *
+ * HASH_ALLOC_ELEM                                                         *
  *                                                                         *
+ * Returns a free elem (a deleted one or a new one from the current chunk, *
+ * a new chunk being allocated if needed).                                 *
  *-------------------------------------------------------------------------*/
-char *
-Pl_Hash_Insert(char *tbl, char *elem, int replace)
+static char *
+Hash_Alloc_Elem(HashTbl *h)
 {
-  int tbl_size = Tbl_Size(tbl);
-  int elem_size = Elem_Size(tbl);
-  HashNode *t = Hsh_Table(tbl);
-  PlLong key = *(PlLong *) elem;
-  HashNode *prev;
-  HashNode p;
+  char *elem;
+  int n;
 
-  prev = Hash_Locate(t, tbl_size, key);
-  p = *prev;
-
-  if (p == NULL)		/* the key does not exist */
+  if (h->free_elem)
     {
-      p = (HashNode) Malloc(sizeof(struct hash_node) - sizeof(PlLong) + elem_size);
+      elem = h->free_elem;
+      h->free_elem = *(char **) elem;
+      return elem;
+    }
+
+  if (h->chunk_top == h->chunk_end)
+    {				/* chunks grow geometrically */
+      n = h->nb_chunk_elem;
+      if (n < HASH_MIN_CHUNK_ELEMS)
+	n = HASH_MIN_CHUNK_ELEMS;
+
+      elem = (char *) Malloc(Chunk_Header_Size + n * h->chunk_elem_size);
 #ifdef USE_ALONE
-      if (p == NULL)
+      if (elem == NULL)
 	return NULL;
 #endif
-
-      p->next = NULL;
-      Nb_Elem(tbl)++;
-      *prev = p;
+      *(char **) elem = h->chunk;
+      h->chunk = elem;
+      h->chunk_top = elem + Chunk_Header_Size;
+      h->chunk_end = h->chunk_top + n * h->chunk_elem_size;
+      h->nb_chunk_elem += n;
     }
-  else if (!replace)
-    goto finish;
 
-  memcpy((char *) (&(p->key)), elem, elem_size);
+  elem = h->chunk_top;
+  h->chunk_top += h->chunk_elem_size;
 
-finish:
-  return (char *) (&(p->key));
+  return elem;
 }
 
 
 
 
 /*-------------------------------------------------------------------------*
- * PL_HASH_FIND                                                            *
+ * HASH_UPDATE                                                             *
  *                                                                         *
  *-------------------------------------------------------------------------*/
 char *
-Pl_Hash_Find(char *tbl, PlLong key)
+Pl_Hash_Insert(char *tbl, char *elem, int replace)
 {
-  int tbl_size = Tbl_Size(tbl);
-  HashNode *t = Hsh_Table(tbl);
-  HashNode *prev;
-  HashNode p;
+  HashTbl *h = Hsh_Tbl(tbl);
+  PlLong key = *(PlLong *) elem;
+  HashSlot *s, *del;
+  char *p;
+  int n;
 
-  prev = Hash_Locate(t, tbl_size, key);
-  p = *prev;
+  n = Hash_Function(key, h);
+  del = NULL;
+  for (;;)
+    {
+      s = h->slot + n;
+      if (s->elem == NULL)
+	break;
+
+      if (s->elem == HASH_DELETED)
+	{
+	  if (del == NULL)
+	    del = s;
+	}
+      else if (s->key == key)
+	{
+	  p = s->elem;
+	  if (replace)
+	    memcpy(p, elem, h->elem_size);
+
+	  return p;
+	}
+
+      n = Hash_Next_Slot(n, h);
+    }
+
+				/* the key does not exist */
+  if (del)
+    s = del;
+  else
+    {
+      if (8 * (h->nb_used + 1) > 7 * h->nb_slot)
+	{			/* only keep live elements if enough room */
+	  Hash_Rehash(h, (4 * h->nb_elem < h->nb_slot) ? h->tbl_size : 2 * h->tbl_size);
+	  n = Hash_Function(key, h);
+	  while (h->slot[n].elem)
+	    n = Hash_Next_Slot(n, h);
+	  s = h->slot + n;
+	}
+      h->nb_used++;
+    }
 
-  if (p == NULL)		/* the key does not exist */
+  p = Hash_Alloc_Elem(h);
+#ifdef USE_ALONE
+  if (p == NULL)
     return NULL;
+#endif
+
+  memcpy(p, elem, h->elem_size);
+  s->key = key;
+  s->elem = p;
+  h->nb_elem++;
 
-  return (char *) (&(p->key));
+  return p;
 }
 
 
 
 
 /*-------------------------------------------------------------------------*
- * PL_HASH_DELETE                                                          *
+ * PL_HASH_FIND                                                            *
  *                                                                         *
  *-------------------------------------------------------------------------*/
 char *
-Pl_Hash_Delete(char *tbl, PlLong key)
+Pl_Hash_Find(char *tbl, PlLong key)
 {
-  int tbl_size = Tbl_Size(tbl);
-  HashNode *t = Hsh_Table(tbl);
-  HashNode *prev;
-  HashNode p;
+  HashTbl *h = Hsh_Tbl(tbl);
+  HashSlot *s;
+  int n = Hash_Function(key, h);
 
-  prev = Hash_Locate(t, tbl_size, key);
-  p = *prev;
-
-  if (p == NULL)		/* the key does not exist */
-    return NULL;
+  for (;;)
+    {
+      s = h->slot + n;
+      if (s->key == key && Slot_Is_Elem(s))
+	return s->elem;
 
-  *prev = p->next;
-  Free(p);
-  Nb_Elem(tbl)--;
+      if (s->elem == NULL)	/* the key does not exist */
+	return NULL;
 
-  return tbl;
+      n = Hash_Next_Slot(n, h);
+    }
 }
 
 
 
 
 /*-------------------------------------------------------------------------*
- * HASH_LOCATE                                                             *
+ * PL_HASH_DELETE                                                          *
  *                                                                         *
- * This function returns the address of the pointer to the node associated *
- * to the key (if the pointer is NULL the key is not in the table).        *
  *-------------------------------------------------------------------------*/
-static HashNode *
-Hash_Locate(HashNode *t, int tbl_size, PlLong key)
+char *
+Pl_Hash_Delete(char *tbl, PlLong key)
 {
-  int n = Hash_Function(key, tbl_size);
-  HashNode p;
+  HashTbl *h = Hsh_Tbl(tbl);
+  HashSlot *s;
+  int n = Hash_Function(key, h);
 
-  t += n;
-
-  for (p = *t; p; p = p->next)
+  for (;;)
     {
-      if (p->key == key)
+      s = h->slot + n;
+      if (s->key == key && Slot_Is_Elem(s))
 	break;
 
-      t = &p->next;
+      if (s->elem == NULL)	/* the key does not exist */
+	return NULL;
+
+      n = Hash_Next_Slot(n, h);
     }
 
-  return t;
+  *(char **) s->elem = h->free_elem;
+  h->free_elem = s->elem;
+  s->elem = HASH_DELETED;
+  h->nb_elem--;
+
+  return tbl;
 }
 
 
@@ -387,18 +567,14 @@ Hash_Locate(HashNode *t, int tbl_size, PlLong key)
  * for(buff_ptr=Pl_Hash_First(tbl,&scan); buff_ptr;                        *
  *     buff_ptr=Pl_Hash_Next(&scan))                                       *
  *       Display_Element(buff_ptr);                                        *
+ *                                                                         *
+ * The current element can be deleted during the scan.                     *
  *-------------------------------------------------------------------------*/
 char *
 Pl_Hash_First(char *tbl, HashScan *scan)
 {
-  int tbl_size = Tbl_Size(tbl);
-  HashNode *t = Hsh_Table(tbl);
-  HashNode *endt = t + tbl_size;
-
-
-  scan->endt = (char *) endt;
-  scan->cur_t = (char *) t;
-  scan->cur_p = (char *) (*t);
+  scan->tbl = tbl;
+  scan->cur = 0;
 
   return Pl_Hash_Next(scan);
 }
@@ -413,29 +589,14 @@ Pl_Hash_First(char *tbl, HashScan *scan)
 char *
 Pl_Hash_Next(HashScan *scan)
 {
-  HashNode *t;
-  HashNode *endt;
-  HashNode p;
+  HashTbl *h = Hsh_Tbl(scan->tbl);
+  HashSlot *s;
 
-  p = (HashNode) (scan->cur_p);
-  if (p)
+  while (scan->cur < h->nb_slot)
     {
-      scan->cur_p = (char *) (p->next);
-      return (char *) (&(p->key));
-    }
-
-  t = (HashNode *) (scan->cur_t);
-  endt = (HashNode *) (scan->endt);
-
-  while (++t < endt)
-    {
-      p = *t;
-      if (p)
-	{
-	  scan->cur_t = (char *) t;
-	  scan->cur_p = (char *) (p->next);
-	  return (char *) (&(p->key));
-	}
+      s = h->slot + scan->cur++;
+      if (Slot_Is_Elem(s))
+	return s->elem;
     }
 
   return NULL;
@@ -451,7 +612,7 @@ Pl_Hash_Next(HashScan *scan)
 int
 Pl_Hash_Table_Size(char *tbl)
 {
-  return Tbl_Size(tbl);
+  return Hsh_Tbl(tbl)->tbl_size;
 }
 
 
@@ -464,7 +625,7 @@ Pl_Hash_Table_Size(char *tbl)
 int
 Pl_Hash_Nb_Elements(char *tbl)
 {
-  return Nb_Elem(tbl);
+  return Hsh_Tbl(tbl)->nb_elem;
 }
 
 
@@ -479,24 +640,40 @@ Pl_Hash_Nb_Elements(char *tbl)
 void
 Hash_Check_Table(char *tbl)
 {
-  int tbl_size = Tbl_Size(tbl);
-  HashNode *t = Hsh_Table(tbl);
-  HashNode *endt = t + tbl_size;
-  HashNode p;
-  int i = 0;
+  HashTbl *h = Hsh_Tbl(tbl);
+  HashSlot *s;
+  int i, n;
+  int nb_elem = 0, nb_used = 0;
 
-  do
+  for (i = 0; i < h->nb_slot; i++)
     {
-      printf("Hash Code:%d\n", t - Hsh_Table(tbl));
-
-      for (p = *t; p; p = p->next, i++)
-	printf("\tadr:%#x  key:%" PL_FMT_d "\n", (int) p, p->key);
+      s = h->slot + i;
+      if (s->elem == NULL)
+	continue;
+
+      nb_used++;
+      if (s->elem == HASH_DELETED)
+	continue;
+
+      nb_elem++;
+      n = Hash_Function(s->key, h);
+      printf("Slot:%d  Hash Code:%d  adr:%#lx  key:%ld\n", i, n,
+	     (long) s->elem, s->key);
+      if (*(PlLong *) s->elem != s->key)
+	printf("\tkey of the elem erroneous: %ld\n", *(PlLong *) s->elem);
+
+      for (; n != i; n = Hash_Next_Slot(n, h))
+	if (h->slot[n].elem == NULL)
+	  printf("\tfree slot %d on the probe sequence\n", n);
     }
-  while (++t < endt);
 
-  if (i != Nb_Elem(tbl))
-    printf("Nb_Elem counter erroneous = %d insted of %d\n", Nb_Elem(tbl),
-	   i);
+  if (nb_elem != h->nb_elem)
+    printf("Nb_Elem counter erroneous = %d insted of %d\n", h->nb_elem,
+	   nb_elem);
+
+  if (nb_used != h->nb_used)
+    printf("Nb_Used counter erroneous = %d insted of %d\n", h->nb_used,
+	   nb_used);
 }
 
 
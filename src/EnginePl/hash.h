@@ -47,9 +47,8 @@
 
 typedef struct
 {
-  char *endt;
-  char *cur_t;
-  char *cur_p;
+  char *tbl;
+  PlLong cur;
 }
 HashScan;
 
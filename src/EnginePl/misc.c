@@ -194,6 +194,36 @@ Pl_Extend_Array(char **ptbl, int *nb_elem, int elem_size, Bool bzero)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_TERM_STK_EXTEND                                                      *
+ *                                                                         *
+ * Called when the stack is full: doubles its size (moving the initial     *
+ * elements to the heap the first time). Returns the new top.              *
+ *-------------------------------------------------------------------------*/
+TermStkElem *
+Pl_Term_Stk_Extend(TermStk *stk)
+{
+  int nb_elem = stk->end - stk->base;
+  TermStkElem *new_base;
+
+  if (stk->base == stk->init)
+    {
+      new_base = (TermStkElem *) Malloc(nb_elem * 2 * sizeof(TermStkElem));
+      memcpy(new_base, stk->init, nb_elem * sizeof(TermStkElem));
+    }
+  else
+    new_base = (TermStkElem *) Realloc(stk->base, nb_elem * 2 * sizeof(TermStkElem));
+
+  stk->base = new_base;
+  stk->top = new_base + nb_elem;
+  stk->end = new_base + nb_elem * 2;
+
+  return stk->top;
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_EXIT_WITH_VALUE                                                      *
  *                                                                         *
@@ -42,10 +42,37 @@
  * Constants                       *
  *---------------------------------*/
 
+#define TERM_STK_INIT_SIZE         64
+
 /*---------------------------------*
  * Type Definitions                *
  *---------------------------------*/
 
+	  /* Term traversal stack: used by the term kernels (unify, compare, */
+	  /* copy, hash,...) instead of C recursion. An element records the  */
+	  /* remaining args of a compound (or of 2 compounds for a binary    */
+	  /* kernel). The last arg is never pushed (it is directly iterated) */
+	  /* so that lists are traversed in constant space. The first        */
+	  /* elements live on the C stack (init), then it grows in the heap. */
+
+typedef struct			/* term traversal stack element    */
+{				/* ------------------------------- */
+  WamWord *u_adr;		/* next arg of the 1st term        */
+  WamWord *v_adr;		/* next arg of the 2nd term        */
+  int nb_arg;			/* nb of remaining args            */
+  PlLong depth;			/* depth of these args (if needed) */
+}
+TermStkElem;
+
+typedef struct			/* term traversal stack            */
+{				/* ------------------------------- */
+  TermStkElem *base;		/* base (init or malloc'ed)        */
+  TermStkElem *top;		/* next free element               */
+  TermStkElem *end;		/* end of the allocated elements   */
+  TermStkElem init[TERM_STK_INIT_SIZE];	/* initial elements        */
+}
+TermStk;
+
 /*---------------------------------*
  * Global Variables                *
  *---------------------------------*/
@@ -76,6 +103,63 @@ void Pl_Extend_Table_If_Needed(char **hash_tbl);
 
 void Pl_Extend_Array(char **ptbl, int *nb_elem, int elem_size, Bool bzero);
 
+TermStkElem *Pl_Term_Stk_Extend(TermStk *stk);
+
+#define Term_Stk_Init(stk)                                                 \
+  ((stk)->base = (stk)->top = (stk)->init,                                 \
+   (stk)->end = (stk)->init + TERM_STK_INIT_SIZE)
+
+#define Term_Stk_Is_Empty(stk)      ((stk)->top == (stk)->base)
+
+#define Term_Stk_Depth(stk)         ((stk)->top[-1].depth)
+
+#define Term_Stk_Free(stk)                                                 \
+  do                                                                       \
+    {                                                                      \
+      if ((stk)->base != (stk)->init)                                      \
+	Free((stk)->base);                                                 \
+    }                                                                      \
+  while (0)
+
+#define Term_Stk_Push(stk, u, v, n, d)                                     \
+  do                                                                       \
+    {                                                                      \
+      TermStkElem *_e = (stk)->top;                                        \
+      if (_e == (stk)->end)                                                \
+	_e = Pl_Term_Stk_Extend(stk);                                      \
+      _e->u_adr = (u);                                                     \
+      _e->v_adr = (v);                                                     \
+      _e->nb_arg = (n);                                                    \
+      _e->depth = (d);                                                     \
+      (stk)->top = _e + 1;                                                 \
+    }                                                                      \
+  while (0)
+
+	  /* get the addresses of the next args (pop if they are the last) */
+
+#define Term_Stk_Next(stk, u, v)                                           \
+  do                                                                       \
+    {                                                                      \
+      TermStkElem *_e = (stk)->top - 1;                                    \
+      (u) = _e->u_adr++;                                                   \
+      (v) = _e->v_adr++;                                                   \
+      if (--_e->nb_arg == 0)                                               \
+	(stk)->top = _e;                                                   \
+    }                                                                      \
+  while (0)
+
+	  /* same for a single term traversal (only u is used) */
+
+#define Term_Stk_Next1(stk, u)                                             \
+  do                                                                       \
+    {                                                                      \
+      TermStkElem *_e = (stk)->top - 1;                                    \
+      (u) = _e->u_adr++;                                                   \
+      if (--_e->nb_arg == 0)                                               \
+	(stk)->top = _e;                                                   \
+    }                                                                      \
+  while (0)
+
 void Pl_Exit_With_Value(int ret_val);
 
 void Pl_Fatal_Error(char *format, ...);
@@ -152,6 +152,7 @@ Pl_Create_Pred(int func, int arity, int pl_file, int pl_line, int prop, PlLong *
   pred_info.codep = codep;
   pred_info.dyn = NULL;
 
+  Next_Pred_Stamp();		/* the table can be extended (see bc_supp.c) */
   Pl_Extend_Table_If_Needed(&pl_pred_tbl);
   pred = (PredInf *) Pl_Hash_Insert(pl_pred_tbl, (char *) &pred_info, FALSE);
 
@@ -197,5 +198,6 @@ Pl_Delete_Pred(int func, int arity)
 {
   PlLong key = Functor_Arity(func, arity);
 
+  Next_Pred_Stamp();
   Pl_Hash_Delete(pl_pred_tbl, key);
 }
@@ -80,10 +80,12 @@ PredInf;
 #ifdef PRED_FILE
 
 char *pl_pred_tbl;
+unsigned pl_pred_stamp = 1;	/* changes when a PredInf can move (never 0) */
 
 #else
 
 extern char *pl_pred_tbl;
+extern unsigned pl_pred_stamp;
 
 #endif
 
@@ -102,3 +104,17 @@ PredInf * FC Pl_Create_Pred(int func, int arity, int pl_file, int pl_line,
 PredInf * FC Pl_Lookup_Pred(int func, int arity);
 
 void FC Pl_Delete_Pred(int func, int arity);
+
+
+
+/* Change pl_pred_stamp. It is never 0 (the value of a fresh cache entry,
+ * see bc_supp.c), also when it wraps around.
+ */
+
+#define Next_Pred_Stamp()                                                \
+  do                                                                     \
+    {                                                                    \
+      if (++pl_pred_stamp == 0)                                          \
+	pl_pred_stamp = 1;                                               \
+    }                                                                    \
+  while (0)
@@ -79,6 +79,20 @@
 #if !defined(MAP_ANON) && defined(MAP_ANONYMOUS)
 #define MAP_ANON MAP_ANONYMOUS
 #endif
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#endif
+
+	/* the stacks are reserved and their pages are committed on demand
+	 * (by the SIGSEGV handler) if the faulting address is known. The
+	 * sizes (GLOBALSZ,...) are then soft limits inside a larger range */
+
+#if defined(HAVE_MMAP) && defined(HAVE_MPROTECT) && defined(HAVE_WORKING_SIGACTION) && \
+  defined(MAP_ANON) && !defined(MMAP_NEEDS_FIXED) && \
+  !defined(__MSYS__) && (defined(__unix__) || defined(__CYGWIN__))
+#define STACK_GROWTH
 #endif
 
 #ifdef __GNUC__
@@ -104,6 +118,14 @@
 
 #define MAX_SIGSEGV_HANDLER        10
 
+#define STACK_INITIAL_COMMIT       (256 * 1024)	/* in WamWords */
+
+#if WORD_SIZE == 64
+#define STACK_MIN_RESERVE          ((PlLong) 1 << 30)	/* in WamWords */
+#else
+#define STACK_MIN_RESERVE          0
+#endif
+
 
           /* Error Messages */
 
@@ -111,6 +133,8 @@
 
 #define ERR_CANNOT_OPEN_DEV0       "Cannot open /dev/zero : %s"
 #define ERR_CANNOT_UNMAP           "unmap failed : %s"
+#define ERR_CANNOT_COMMIT          "mprotect failed : %s"
+#define ERR_CANNOT_DECOMMIT        "mmap (decommit) failed : %s"
 
 #define ERR_CANNOT_FREE            "VirtualFree failed : %" PL_FMT_u
 #define ERR_CANNOT_PROTECT         "VirtualProtect failed : %" PL_FMT_u
@@ -131,10 +155,17 @@
  *---------------------------------*/
 
 static int page_size;
+static size_t stacks_length;	/* in bytes (stacks and guard pages) */
 
 static SegvHdlr tbl_handler[MAX_SIGSEGV_HANDLER];
 static int nb_handler = 0;
 
+static WamWord *reserve_end[NB_OF_STACKS]; /* end of the reserved pages */
+
+#ifdef STACK_GROWTH
+static WamWord *commit_end[NB_OF_STACKS]; /* end of the committed pages */
+#endif
+
 
 /*---------------------------------*
  * Function Prototypes             *
@@ -150,12 +181,24 @@ static int Default_SIGSEGV_Handler(void *bad_addr);
 
 static char *Stack_Overflow_Err_Msg(int stk_nb);
 
+#ifdef STACK_GROWTH
+
+static void Virtual_Mem_Commit(void *addr, size_t length);
+
+static void Virtual_Mem_Decommit(void *addr, size_t length);
+
+static int Stack_Growth_SIGSEGV_Handler(void *bad_addr);
+
+#endif
+
 
 
 #define Round_Up(x, y)          (((x) + (y) - 1) / (y) * (y))
 
 #define Round_Down(x, y)        ((x) / (y) * (y))
 
+#define Page_Round_Up(adr)      ((WamWord *) Round_Up((PlULong) (adr), page_size * sizeof(WamWord)))
+
 
 
 
@@ -200,8 +243,13 @@ Virtual_Mem_Alloc(void *addr, size_t length)
     Pl_Fatal_Error(ERR_CANNOT_OPEN_DEV0, Pl_M_Sys_Err_String(errno));
 #endif /* !MAP_ANON */
 
+#ifdef STACK_GROWTH		/* only reserve (see Virtual_Mem_Commit) */
+  addr = (void *) mmap((void *) addr, length, PROT_NONE,
+                          MAP_PRIVATE | MAP_NORESERVE
+#else
   addr = (void *) mmap((void *) addr, length, PROT_READ | PROT_WRITE,
                           MAP_PRIVATE
+#endif
 #ifdef MMAP_NEEDS_FIXED
                           | MAP_FIXED
 #endif
@@ -226,7 +274,6 @@ Virtual_Mem_Alloc(void *addr, size_t length)
 
 
 
-#if TAG_SIZE_HIGH > 0
 /*-------------------------------------------------------------------------*
  * VIRTUAL_MEM_FREE                                                        *
  *                                                                         *
@@ -250,7 +297,6 @@ Virtual_Mem_Free(void *addr, size_t length)
 
 #endif
 }
-#endif  /* TAG_SIZE_HIGH > 0 */
 
 
 
@@ -289,15 +335,61 @@ Virtual_Mem_Protect(void *addr, size_t length)
 
 
 
+#ifdef STACK_GROWTH
+
 /*-------------------------------------------------------------------------*
- * PL_ALLOCATE_STACKS                                                      *
+ * VIRTUAL_MEM_COMMIT                                                      *
  *                                                                         *
  *-------------------------------------------------------------------------*/
-void
-Pl_Allocate_Stacks(void)
+static void
+Virtual_Mem_Commit(void *addr, size_t length)
 {
-  size_t length = 0, stk_sz;
-  WamWord *addr;
+  if (mprotect(addr, length, PROT_READ | PROT_WRITE) == -1)
+    Pl_Fatal_Error(ERR_CANNOT_COMMIT, Pl_M_Sys_Err_String(errno));
+
+#ifdef DEBUG
+  DBGPRINTF("Commit at %p len: %d\n", addr, length);
+#endif
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * VIRTUAL_MEM_DECOMMIT                                                    *
+ *                                                                         *
+ * Mapping again the pages releases their physical memory.                 *
+ *-------------------------------------------------------------------------*/
+static void
+Virtual_Mem_Decommit(void *addr, size_t length)
+{
+  if (mmap(addr, length, PROT_NONE, MAP_PRIVATE | MAP_NORESERVE | MAP_FIXED | MAP_ANON,
+	   -1, 0) == (void *) -1)
+    Pl_Fatal_Error(ERR_CANNOT_DECOMMIT, Pl_M_Sys_Err_String(errno));
+
+#ifdef DEBUG
+  DBGPRINTF("Decommit at %p len: %d\n", addr, length);
+#endif
+}
+
+#endif	/* STACK_GROWTH */
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_RESERVE_STACKS                                                       *
+ *                                                                         *
+ * Reserves a new set of stacks (described in pl_stk_tbl) and returns its  *
+ * base address (see Pl_Release_Stacks). Also used for each new engine.    *
+ * With STACK_GROWTH, each stack reserves at least STACK_MIN_RESERVE words *
+ * and its size only limits the committed pages (soft limit).              *
+ *-------------------------------------------------------------------------*/
+WamWord *
+Pl_Reserve_Stacks(void)
+{
+  size_t length = 0, stk_sz, rsv_sz[NB_OF_STACKS];
+  WamWord *addr, *base;
   int i;
   WamWord *addr_to_try[] = {
 #ifndef MMAP_NEEDS_FIXED
@@ -314,16 +406,19 @@ Pl_Allocate_Stacks(void)
 #endif
     (WamWord *) -1 };
 
-  page_size = getpagesize() / sizeof(WamWord);
-
   for (i = 0; i < NB_OF_STACKS; i++)
     {
       stk_sz = pl_stk_tbl[i].size = Round_Up(pl_stk_tbl[i].size, page_size);
       if (stk_sz == 0)
 	stk_sz = page_size;	/* at leat one page to write magic numbers */
+#ifdef STACK_GROWTH
+      else if (stk_sz < STACK_MIN_RESERVE)
+	stk_sz = STACK_MIN_RESERVE;
+#endif
+      rsv_sz[i] = stk_sz;
       length += stk_sz + page_size;
     }
-  length *= sizeof(WamWord);
+  stacks_length = length *= sizeof(WamWord);
 
   addr = NULL;
   for(i = 0; addr == NULL && addr_to_try[i] != (WamWord *) -1; i++)
@@ -360,6 +455,8 @@ Pl_Allocate_Stacks(void)
   if (addr == NULL)
     Pl_Fatal_Error(ERR_STACKS_ALLOCATION);
 
+  base = addr;
+
   for (i = 0; i < NB_OF_STACKS; i++)
     {
       pl_stk_tbl[i].stack = addr;
@@ -368,16 +465,62 @@ Pl_Allocate_Stacks(void)
 	stk_sz = page_size;	/* at least one page for magic numbers */
 #ifdef DEBUG
       DBGPRINTF("  stack: %d %-10s length: %5ld Kb   addr:[%p..%p[ + 1 free page, next addr: %p\n", 
-		i, pl_stk_tbl[i].name, stk_sz * sizeof(WamWord) / 1024, 
-		addr, addr + stk_sz, addr + stk_sz + page_size);
-#endif
-      addr += stk_sz;
+		i, pl_stk_tbl[i].name, rsv_sz[i] * sizeof(WamWord) / 1024, 
+		addr, addr + rsv_sz[i], addr + rsv_sz[i] + page_size);
+#endif
+      reserve_end[i] = addr + rsv_sz[i];
+#ifdef STACK_GROWTH		/* the rest (and the guard page) remains reserved */
+      commit_end[i] = addr + ((stk_sz < STACK_INITIAL_COMMIT) ? stk_sz : STACK_INITIAL_COMMIT);
+      Virtual_Mem_Commit(addr, (commit_end[i] - addr) * sizeof(WamWord));
+      addr = reserve_end[i];
+#else
+      addr = reserve_end[i];
       Virtual_Mem_Protect(addr, page_size * sizeof(WamWord));
+#endif
       addr += page_size;
     }
 
+  return base;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_RELEASE_STACKS                                                       *
+ *                                                                         *
+ * Frees a set of stacks obtained by Pl_Reserve_Stacks (base address).     *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Release_Stacks(WamWord *base)
+{
+  Virtual_Mem_Free(base, stacks_length);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_ALLOCATE_STACKS                                                      *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Allocate_Stacks(void)
+{
+  page_size = getpagesize() / sizeof(WamWord);
+
+  Pl_Engine_Add_State(reserve_end, sizeof(reserve_end));
+#ifdef STACK_GROWTH
+  Pl_Engine_Add_State(commit_end, sizeof(commit_end));
+#endif
+
+  Pl_Reserve_Stacks();
+
   Install_SIGSEGV_Handler();	/* install the real (and unique) SIGSEGV handler */
   Pl_Push_SIGSEGV_Handler(Default_SIGSEGV_Handler); /* install initial user SIGSEGV handler */
+#ifdef STACK_GROWTH
+  Pl_Push_SIGSEGV_Handler(Stack_Growth_SIGSEGV_Handler);
+#endif
 
 #if 0 /* cause an exception */
   addr -= page_size;
@@ -625,6 +768,102 @@ Pl_Pop_SIGSEGV_Handler(void)
 
 
 
+#ifdef STACK_GROWTH
+
+/*-------------------------------------------------------------------------*
+ * STACK_GROWTH_SIGSEGV_HANDLER                                            *
+ *                                                                         *
+ * Commits the pages of a stack up to the faulting address (at least the   *
+ * double of the committed size). The faulting instruction is then        *
+ * restarted. A fault beyond the size of the stack (its soft limit) is     *
+ * left to the default handler which reports the overflow, except for the  *
+ * heap: a garbage collection is then requested and the heap can use 1/8   *
+ * more of its size until the next safe point (see gc.c).                  *
+ *-------------------------------------------------------------------------*/
+static int
+Stack_Growth_SIGSEGV_Handler(void *bad_addr)
+{
+  WamWord *addr = (WamWord *) bad_addr;
+  WamWord *end, *new_end;
+  PlLong grace;
+  int i;
+
+  for (i = 0; i < NB_OF_STACKS; i++)
+    {
+      end = pl_stk_tbl[i].stack + pl_stk_tbl[i].size;
+      if (addr < commit_end[i] || addr >= reserve_end[i])
+	continue;
+
+      if (addr >= end)
+	{
+	  grace = Round_Up(pl_stk_tbl[i].size / 8, page_size);
+	  if (grace < STACK_INITIAL_COMMIT)
+	    grace = STACK_INITIAL_COMMIT;
+	  if (grace > reserve_end[i] - end)
+	    grace = reserve_end[i] - end;
+
+	  if (pl_stk_tbl[i].stack != Global_Stack || addr >= end + grace ||
+	      !Pl_GC_Request())
+	    return 0;
+
+	  end += grace;
+	  addr = end - 1;	/* commit the whole grace area */
+	}
+
+      new_end = commit_end[i] + (commit_end[i] - pl_stk_tbl[i].stack);
+      if (new_end <= addr)
+	new_end = addr + 1;
+      new_end = Page_Round_Up(new_end);
+      if (new_end > end)
+	new_end = end;
+
+      Virtual_Mem_Commit(commit_end[i], (new_end - commit_end[i]) * sizeof(WamWord));
+      commit_end[i] = new_end;
+      return 1;
+    }
+
+  return 0;
+}
+
+#endif	/* STACK_GROWTH */
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * PL_SHRINK_STACKS                                                        *
+ *                                                                         *
+ * Releases the committed pages of a stack when less than a quarter of     *
+ * them is used (e.g. after a deep recursion or a garbage collection).     *
+ * The top of each stack must be up-to-date (called at a safe point).      *
+ *-------------------------------------------------------------------------*/
+void
+Pl_Shrink_Stacks(void)
+{
+#ifdef STACK_GROWTH
+  WamWord *keep_end;
+  PlLong keep;
+  int i;
+
+  for (i = 0; i < NB_OF_STACKS; i++)
+    {
+      keep = 2 * (Stack_Top(i) - pl_stk_tbl[i].stack);
+      if (keep < STACK_INITIAL_COMMIT)
+	keep = STACK_INITIAL_COMMIT;
+
+      keep_end = Page_Round_Up(pl_stk_tbl[i].stack + keep);
+      if (commit_end[i] - pl_stk_tbl[i].stack <= 2 * keep)
+	continue;
+
+      Virtual_Mem_Decommit(keep_end, (commit_end[i] - keep_end) * sizeof(WamWord));
+      commit_end[i] = keep_end;
+    }
+#endif
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * DEFAULT_SIGSEGV_HANDLER                                                 *
  *                                                                         *
@@ -647,23 +886,21 @@ Default_SIGSEGV_Handler(void *bad_addr)
   DBGPRINTF("BAD ADDRESS:%p \n", addr);
 #endif
 
-  i = NB_OF_STACKS - 1;
-  if (addr < pl_stk_tbl[i].stack + pl_stk_tbl[i].size + page_size)
-    while (i >= 0)
-      {
+  for (i = 0; i < NB_OF_STACKS; i++)
+    {
 #ifdef DEBUG
-        DBGPRINTF("STACK[%d].stack + size: %p\n",
-		  i, pl_stk_tbl[i].stack + pl_stk_tbl[i].size);
+      DBGPRINTF("STACK[%d].stack + size: %p\n",
+		i, pl_stk_tbl[i].stack + pl_stk_tbl[i].size);
 #endif
-        if (addr >= pl_stk_tbl[i].stack + pl_stk_tbl[i].size)
-	  {
+      if (addr >= pl_stk_tbl[i].stack + pl_stk_tbl[i].size &&
+	  addr < reserve_end[i] + page_size)
+	{
 #ifdef DEBUG
-	    DBGPRINTF("Found overflow on stack[%d]\n", i);
+	  DBGPRINTF("Found overflow on stack[%d]\n", i);
 #endif
-	    Pl_Fatal_Error(Stack_Overflow_Err_Msg(i));
-	  }
-        i--;
-      }
+	  Pl_Fatal_Error(Stack_Overflow_Err_Msg(i));
+	}
+    }
 
   Pl_Fatal_Error("Segmentation Violation (bad address: %p)", addr);
 
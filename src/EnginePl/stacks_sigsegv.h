@@ -59,10 +59,16 @@ typedef int (*SegvHdlr)(void *bad_addr);
 
 void Pl_Allocate_Stacks(void);
 
+WamWord *Pl_Reserve_Stacks(void);
+
+void Pl_Release_Stacks(WamWord *base);
+
 void Pl_Push_SIGSEGV_Handler(SegvHdlr handler);
 
 void Pl_Pop_SIGSEGV_Handler(void);
 
+void Pl_Shrink_Stacks(void);
+
 
 
 #endif	/* !_STACKS_SIGSEGV */
@@ -52,6 +52,9 @@ UNIFY_FCT_NAME(WamWord start_u_word, WamWord start_v_word)
   WamWord v_word, v_tag_mask;
   WamWord *u_adr, *v_adr;
   int i;
+  TermStk stk;
+
+  Term_Stk_Init(&stk);
 
  terminal_rec:
 
@@ -75,13 +78,13 @@ UNIFY_FCT_NAME(WamWord start_u_word, WamWord start_v_word)
 #ifdef OCCURS_CHECK
 	  if (!Is_A_Local_Adr(u_adr) &&	/* no binding from heap to local */
 	      Check_If_Var_Occurs(u_adr, v_word))
-	    return FALSE;
+	    goto fail;
 #endif
 	  Do_Copy_Of_Word(v_tag_mask, v_word);
 	  Bind_UV(u_adr, v_word);
 	}
 
-      return TRUE;
+      goto next_arg;
     }
 
 
@@ -92,53 +95,48 @@ UNIFY_FCT_NAME(WamWord start_u_word, WamWord start_v_word)
 #ifdef OCCURS_CHECK
       if (!Is_A_Local_Adr(v_adr) &&	/* no binding from heap to local */
 	  Check_If_Var_Occurs(v_adr, u_word))
-	return FALSE;
+	goto fail;
 #endif
       Do_Copy_Of_Word(u_tag_mask, u_word);
       Bind_UV(v_adr, u_word);
 
-      return TRUE;
+      goto next_arg;
     }
 
   if (u_word == v_word)
-    return TRUE;
+    goto next_arg;
 
   if (v_tag_mask == TAG_LST_MASK)
     {
       if (u_tag_mask != v_tag_mask)
-	return FALSE;
+	goto fail;
 
       u_adr = UnTag_LST(u_word);
       v_adr = UnTag_LST(v_word);
 
-      u_adr = &Car(u_adr);
-      v_adr = &Car(v_adr);
-
-      if (!UNIFY_FCT_NAME(*u_adr++, *v_adr++))
-	return FALSE;
+      Term_Stk_Push(&stk, &Cdr(u_adr), &Cdr(v_adr), 1, 0);
 
-      start_u_word = *u_adr;
-      start_v_word = *v_adr;
+      start_u_word = Car(u_adr);
+      start_v_word = Car(v_adr);
       goto terminal_rec;
     }
 
   if (v_tag_mask == TAG_STC_MASK)
     {
       if (u_tag_mask != v_tag_mask)
-	return FALSE;
+	goto fail;
 
       u_adr = UnTag_STC(u_word);
       v_adr = UnTag_STC(v_word);
 
       if (Functor_And_Arity(u_adr) != Functor_And_Arity(v_adr))
-	return FALSE;
+	goto fail;
 
       i = Arity(u_adr);
       u_adr = &Arg(u_adr, 0);
       v_adr = &Arg(v_adr, 0);
-      while (--i)
-	if (!UNIFY_FCT_NAME(*u_adr++, *v_adr++))
-	  return FALSE;
+      if (i > 1)
+	Term_Stk_Push(&stk, u_adr + 1, v_adr + 1, i - 1, 0);
 
       start_u_word = *u_adr;
       start_v_word = *v_adr;
@@ -147,27 +145,50 @@ UNIFY_FCT_NAME(WamWord start_u_word, WamWord start_v_word)
 
 #ifndef NO_USE_FD_SOLVER
   if (v_tag_mask == TAG_INT_MASK && u_tag_mask == TAG_FDV_MASK)
-    return Fd_Unify_With_Integer(UnTag_FDV(u_word), (int) UnTag_INT(v_word));
+    {
+      if (!Fd_Unify_With_Integer(UnTag_FDV(u_word), (int) UnTag_INT(v_word)))
+	goto fail;
+      goto next_arg;
+    }
 
   if (v_tag_mask == TAG_FDV_MASK)
     {
       v_adr = UnTag_FDV(v_word);
 
       if (u_tag_mask == TAG_INT_MASK)
-	return Fd_Unify_With_Integer(v_adr, (int) UnTag_INT(u_word));
+	{
+	  if (!Fd_Unify_With_Integer(v_adr, (int) UnTag_INT(u_word)))
+	    goto fail;
+	  goto next_arg;
+	}
 
       if (u_tag_mask != v_tag_mask) /* i.e. TAG_FDV_MASK */
-	return FALSE;
+	goto fail;
 
-      return Fd_Unify_With_Fd_Var(UnTag_FDV(u_word), v_adr);
+      if (!Fd_Unify_With_Fd_Var(UnTag_FDV(u_word), v_adr))
+	goto fail;
+      goto next_arg;
     }
 #endif
 
-  if (v_tag_mask == TAG_FLT_MASK)
-    return (u_tag_mask == v_tag_mask &&
-	    Pl_Obtain_Float(UnTag_FLT(u_word)) ==
-	    Pl_Obtain_Float(UnTag_FLT(v_word)));
+  if (v_tag_mask != TAG_FLT_MASK || u_tag_mask != v_tag_mask ||
+      Pl_Obtain_Float(UnTag_FLT(u_word)) != Pl_Obtain_Float(UnTag_FLT(v_word)))
+    goto fail;
+
+ next_arg:
+  if (!Term_Stk_Is_Empty(&stk))
+    {
+      Term_Stk_Next(&stk, u_adr, v_adr);
+      start_u_word = *u_adr;
+      start_v_word = *v_adr;
+      goto terminal_rec;
+    }
+
+  Term_Stk_Free(&stk);
+  return TRUE;
 
+ fail:
+  Term_Stk_Free(&stk);
   return FALSE;
 }
 
@@ -188,39 +209,51 @@ Check_If_Var_Occurs(WamWord *var_adr, WamWord term_word)
   WamWord word, tag_mask;
   WamWord *adr;
   int i;
+  TermStk stk;
+
+  Term_Stk_Init(&stk);
 
  terminal_rec:
 
   DEREF(term_word, word, tag_mask);
 
   if (tag_mask == TAG_REF_MASK)
-    return UnTag_REF(word) == var_adr;
-
-  if (tag_mask == TAG_LST_MASK)
+    {
+      if (UnTag_REF(word) == var_adr)
+	{
+	  Term_Stk_Free(&stk);
+	  return TRUE;
+	}
+    }
+  else if (tag_mask == TAG_LST_MASK)
     {
       adr = UnTag_LST(word);
-      adr = &Car(adr);
-      if (Check_If_Var_Occurs(var_adr, *adr++))
-	return TRUE;
+      Term_Stk_Push(&stk, &Cdr(adr), &Cdr(adr), 1, 0);
 
-      term_word = *adr;
+      term_word = Car(adr);
       goto terminal_rec;
     }
-
-  if (tag_mask == TAG_STC_MASK)
+  else if (tag_mask == TAG_STC_MASK)
     {
       adr = UnTag_STC(word);
 
       i = Arity(adr);
       adr = &Arg(adr, 0);
-      while (--i)
-	if (Check_If_Var_Occurs(var_adr, *adr++))
-	  return TRUE;
+      if (i > 1)
+	Term_Stk_Push(&stk, adr + 1, adr + 1, i - 1, 0);
 
       term_word = *adr;
       goto terminal_rec;
     }
 
+  if (!Term_Stk_Is_Empty(&stk))
+    {
+      Term_Stk_Next1(&stk, adr);
+      term_word = *adr;
+      goto terminal_rec;
+    }
+
+  Term_Stk_Free(&stk);
   return FALSE;
 }
 
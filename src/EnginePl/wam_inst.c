@@ -1024,10 +1024,17 @@ Pl_Globalize_If_In_Local(WamWord start_word)
  * Called by compiled prolog code.                                         *
  *-------------------------------------------------------------------------*/
 void FC
-Pl_Allocate(int n)
+Pl_Allocate(int n, int nb_live_x)
 {
-  WamWord *old_E = E;
-  WamWord *cur_E = Local_Top + ENVIR_STATIC_SIZE + n;
+  WamWord *old_E, *cur_E;
+
+#ifdef GARBAGE_COLLECTOR
+  if (H >= pl_gc_trigger)	/* safe point: A(0..nb_live_x-1) are live */
+    Pl_Garbage_Collect(nb_live_x);
+#endif
+
+  old_E = E;
+  cur_E = Local_Top + ENVIR_STATIC_SIZE + n;
 
   E = cur_E;
 
@@ -1284,6 +1291,92 @@ Pl_Switch_On_Structure(SwtTbl t, int size)
 
 
 
+/*-------------------------------------------------------------------------*
+ * PL_SWITCH_ON_TERM_ARG / ATOM_ARG / INTEGER_ARG / STRUCTURE_ARG          *
+ *                                                                         *
+ * Same as above but switch on the register A(a) instead of A(0). They are *
+ * used to index on another argument or on the first sub-argument of a     *
+ * compound argument (loaded in a temporary register). As above, the       *
+ * switch_on_atom/integer/structure_arg always occur after a               *
+ * switch_on_term_arg on the same register.                                *
+ *                                                                         *
+ * Called by compiled prolog code.                                         *
+ *-------------------------------------------------------------------------*/
+CodePtr FC
+Pl_Switch_On_Term_Arg(int a, CodePtr c_var, CodePtr c_atm, CodePtr c_int,
+		      CodePtr c_lst, CodePtr c_stc)
+{
+  WamWord word, tag_mask;
+  CodePtr codep;
+
+  DEREF(A(a), word, tag_mask);
+  A(a) = word;
+
+  if (tag_mask == TAG_INT_MASK)
+    codep = c_int;
+  else if (tag_mask == TAG_ATM_MASK)
+    codep = c_atm;
+  else if (tag_mask == TAG_LST_MASK)
+    codep = c_lst;
+  else if (tag_mask == TAG_STC_MASK)
+    codep = c_stc;
+  else				/* REF or FDV */
+    codep = c_var;
+
+  return (codep) ? codep : ALTB(B);
+}
+
+
+
+
+CodePtr FC
+Pl_Switch_On_Atom_Arg(int a, SwtTbl t, int size)
+{
+  SwtInf *swt;
+
+  swt = Locate_Swt_Element(t, size, (PlLong) UnTag_ATM(A(a)));
+
+  return (swt->codep) ? swt->codep : ALTB(B);
+}
+
+
+
+
+CodePtr FC
+Pl_Switch_On_Integer_Arg(int a, SwtTbl t, int size)
+{
+  SwtInf *swt;
+
+  swt = Locate_Swt_Element(t, size, (PlLong) UnTag_INT(A(a)));
+
+  return (swt->codep) ? swt->codep : ALTB(B);
+}
+
+
+
+
+PlLong FC
+Pl_Switch_On_Integer_Arg_For_Dichotomy(int a)
+{
+  return UnTag_INT(A(a));
+}
+
+
+
+
+CodePtr FC
+Pl_Switch_On_Structure_Arg(int a, SwtTbl t, int size)
+{
+  SwtInf *swt;
+
+  swt = Locate_Swt_Element(t, size, Functor_And_Arity(UnTag_STC(A(a))));
+
+  return (swt->codep) ? swt->codep : ALTB(B);
+}
+
+
+
+
 /*-------------------------------------------------------------------------*
  * PL_GET_CURRENT_CHOICE                                                   *
  *                                                                         *
@@ -1401,13 +1494,25 @@ Pl_Obtain_Float(WamWord *adr)
 /*-------------------------------------------------------------------------*
  * CREATE_CHOICE_POINT and specialized versions                            *
  *                                                                         *
- * Called by compiled prolog code.                                         *
+ * Called by compiled prolog code. The specialized versions (and the N     *
+ * version) are only called at the entry of a predicate, which is a safe   *
+ * point for the garbage collector (the arguments are the live registers). *
+ * C code must use Pl_Create_Choice_Point() (it can hold heap pointers).   *
  *-------------------------------------------------------------------------*/
 
-#define CREATE_CHOICE_COMMON_PART(arity)                   \
+#ifdef GARBAGE_COLLECTOR
+#define GC_SAFE_POINT(safe, nb_live_x)                     \
+  if (safe && H >= pl_gc_trigger)                          \
+    Pl_Garbage_Collect(nb_live_x)
+#else
+#define GC_SAFE_POINT(safe, nb_live_x)
+#endif
+
+#define CREATE_CHOICE_COMMON_PART(arity, safe)             \
   WamWord *old_B = B;                                      \
   WamWord *cur_B = Local_Top + CHOICE_STATIC_SIZE + arity; \
                                                            \
+  GC_SAFE_POINT(safe, arity);                              \
   B = cur_B;                                               \
                                                            \
   ALTB(cur_B) = codep_alt;                                 \
@@ -1457,7 +1562,20 @@ void FC
 Pl_Create_Choice_Point(CodePtr codep_alt, int arity)
 {
   int i;
-  CREATE_CHOICE_COMMON_PART(arity);
+  CREATE_CHOICE_COMMON_PART(arity, FALSE);
+
+  for (i = 0; i < arity; i++)
+    AB(cur_B, i) = A(i);
+}
+
+
+
+
+void FC
+Pl_Create_Choice_PointN(CodePtr codep_alt, int arity)
+{
+  int i;
+  CREATE_CHOICE_COMMON_PART(arity, TRUE);
 
   for (i = 0; i < arity; i++)
     AB(cur_B, i) = A(i);
@@ -1469,7 +1587,7 @@ Pl_Create_Choice_Point(CodePtr codep_alt, int arity)
 void FC
 Pl_Create_Choice_Point0(CodePtr codep_alt)
 {
-  CREATE_CHOICE_COMMON_PART(0);
+  CREATE_CHOICE_COMMON_PART(0, TRUE);
 }
 
 
@@ -1478,7 +1596,7 @@ Pl_Create_Choice_Point0(CodePtr codep_alt)
 void FC
 Pl_Create_Choice_Point1(CodePtr codep_alt)
 {
-  CREATE_CHOICE_COMMON_PART(1);
+  CREATE_CHOICE_COMMON_PART(1, TRUE);
 
   AB(cur_B, 0) = A(0);
 }
@@ -1489,7 +1607,7 @@ Pl_Create_Choice_Point1(CodePtr codep_alt)
 void FC
 Pl_Create_Choice_Point2(CodePtr codep_alt)
 {
-  CREATE_CHOICE_COMMON_PART(2);
+  CREATE_CHOICE_COMMON_PART(2, TRUE);
 
   AB(cur_B, 0) = A(0);
   AB(cur_B, 1) = A(1);
@@ -1501,7 +1619,7 @@ Pl_Create_Choice_Point2(CodePtr codep_alt)
 void FC
 Pl_Create_Choice_Point3(CodePtr codep_alt)
 {
-  CREATE_CHOICE_COMMON_PART(3);
+  CREATE_CHOICE_COMMON_PART(3, TRUE);
 
   AB(cur_B, 0) = A(0);
   AB(cur_B, 1) = A(1);
@@ -1514,7 +1632,7 @@ Pl_Create_Choice_Point3(CodePtr codep_alt)
 void FC
 Pl_Create_Choice_Point4(CodePtr codep_alt)
 {
-  CREATE_CHOICE_COMMON_PART(4);
+  CREATE_CHOICE_COMMON_PART(4, TRUE);
 
   AB(cur_B, 0) = A(0);
   AB(cur_B, 1) = A(1);
@@ -36,7 +36,7 @@
  *-------------------------------------------------------------------------*/
 
 
-#if 0
+#if 1
 #define GARBAGE_COLLECTOR
 #endif
 
@@ -348,7 +348,7 @@ Bool FC Pl_Unify_Structure(int func, int arity);
 
 WamWord FC Pl_Globalize_If_In_Local(WamWord start_word);
 
-void FC Pl_Allocate(int n);
+void FC Pl_Allocate(int n, int nb_live_x);
 
 void FC Pl_Deallocate(void);
 
@@ -365,6 +365,16 @@ PlLong FC Pl_Switch_On_Integer_For_Dichotomy(void);
 
 CodePtr FC Pl_Switch_On_Structure(SwtTbl t, int size);
 
+CodePtr FC Pl_Switch_On_Term_Arg(int a, CodePtr c_var, CodePtr c_atm, CodePtr c_int,
+				 CodePtr c_lst, CodePtr c_stc);
+
+CodePtr FC Pl_Switch_On_Atom_Arg(int a, SwtTbl t, int size);
+
+CodePtr FC Pl_Switch_On_Integer_Arg(int a, SwtTbl t, int size);
+PlLong FC Pl_Switch_On_Integer_Arg_For_Dichotomy(int a);
+
+CodePtr FC Pl_Switch_On_Structure_Arg(int a, SwtTbl t, int size);
+
 WamWord FC Pl_Get_Current_Choice(void);
 
 void FC Pl_Cut(WamWord b_word);
@@ -377,6 +387,7 @@ double FC Pl_Obtain_Float(WamWord *adr);
 
 
 void FC Pl_Create_Choice_Point(CodePtr codep_alt, int arity);
+void FC Pl_Create_Choice_PointN(CodePtr codep_alt, int arity);
 void FC Pl_Create_Choice_Point0(CodePtr codep_alt);
 void FC Pl_Create_Choice_Point1(CodePtr codep_alt);
 void FC Pl_Create_Choice_Point2(CodePtr codep_alt);
@@ -176,7 +176,7 @@ bloc_lst([]) -->
 
 
 
-bloc_one(bl(BNo, LDep, LUse, LWInst, TellFdv, Always)) -->
+bloc_one(bl(BNo, LDep, LUse, LWInst, TellFdv, Always, Sched)) -->
 	{ clause(hvar(LVar), _) },
 	foreach(LVar, LUse, LWInst1, LWInst, HasForEach),
 	terminal(start),
@@ -196,6 +196,7 @@ bloc_one(bl(BNo, LDep, LUse, LWInst, TellFdv, Always)) -->
 	},
 	trig(LVar, LUse, LDep),
 	always(Always),
+	sched(TellFdv, Sched),
 	{ close_list(LDep), close_list(LUse) }.
 
 
@@ -280,6 +281,34 @@ always(optimized) -->
 
 
 
+sched(TellFdv, s(Prio, Idem)) -->
+	priority(TellFdv, Prio),
+	idempotent(Idem).
+
+
+priority(_, Prio) -->
+	terminal(priority), !,
+	(   int(Prio), { Prio >= 0, Prio =< 2 } ->
+	    []
+	;   syn_error('priority (0, 1 or 2)')
+	).
+
+priority(-1, 1) -->                                 % C function: normal
+	[], !.
+
+priority(_, 0) -->                                  % X in r: fast
+	[].
+
+
+idempotent(1) -->
+	terminal(idempotent), !.
+
+idempotent(0) -->
+	[].
+
+
+
+
 elem_lst(LVar, LUse, LWNext, LWInst) -->
 	elem_one(LVar, LUse, LWInst1, LWInst),
 	elem_lst(LVar, LUse, LWNext, LWInst1).
@@ -1127,6 +1127,14 @@ Pl_Create_Atom(char *name)
 {
   return 1;
 }
+void
+Pl_Atom_GC_Add_Root_Fct(AtomGCRootFct fct)
+{
+}
+void
+Pl_Atom_GC_Mark_Words_In(WamWord *adr, PlLong n, WamWord *heap, WamWord *h)
+{
+}
 
 PredInf * FC
 Pl_Lookup_Pred(int func, int arity)
@@ -1138,6 +1146,15 @@ void
 Pl_Allocate_Stacks(void)
 {
 }
+WamWord *
+Pl_Reserve_Stacks(void)
+{
+  return NULL;
+}
+void
+Pl_Release_Stacks(WamWord *base)
+{
+}
 AtomInf *pl_atom_tbl;
 void FC
 Pl_Create_Choice_Point(CodePtr codep_alt, int arity)
@@ -1153,6 +1170,17 @@ Pl_Fd_Reset_Solver(void)
 {
 }
 
+WamWord *pl_gc_trigger;
+WamWord *pl_gc_keep_top;
+void
+Pl_Init_GC(void)
+{
+}
+void
+Pl_GC_Inhibit(Bool inhibit)
+{
+}
+
 void
 SIGSEGV_Handler(void)
 {
@@ -1184,3 +1212,21 @@ Pl_Dummy_Ptr(void *p)
 { 
   return p;
 }
+
+void *
+Pl_Malloc_Check(size_t size, char *src_file, int src_line)
+{
+  return malloc(size);
+}
+
+void *
+Pl_Calloc_Check(size_t nb, size_t size, char *src_file, int src_line)
+{
+  return calloc(nb, size);
+}
+
+void *
+Pl_Realloc_Check(void *ptr, size_t size, char *src_file, int src_line)
+{
+  return realloc(ptr, size);
+}
@@ -107,6 +107,7 @@ char *file_name_out;
 Bool comment;
 Bool pic_code;
 Bool ignore_fc;
+Bool no_inline;
 
 MapperInf mi;
 
@@ -896,6 +897,7 @@ Parse_Arguments(int argc, char *argv[])
   comment = FALSE;
   pic_code = FALSE;
   ignore_fc = FALSE;
+  no_inline = FALSE;
 
   for (i = 1; i < argc; i++)
     {
@@ -928,6 +930,12 @@ Parse_Arguments(int argc, char *argv[])
 	      continue;
 	    }
 
+	  if (Check_Arg(i, "--no-inline"))
+	    {
+	      no_inline = TRUE;
+	      continue;
+	    }
+
 	  if (Check_Arg(i, "--comment"))
 	    {
 	      comment = TRUE;
@@ -994,6 +1002,7 @@ Display_Help(void)
   L("  -o FILE, --output FILE      set output file name");
   L("  --pic, -fPIC, --dynamic     produce position independent code (PIC)");
   L("  --ignore-fast               ignore fast call (FC) declarations");
+  L("  --no-inline                 do not inline WAM instructions (always call C)");
   L("  --comment                   include comments in the output file");
   L("  -h, --help                  print this help and exit");
   L("  --version                   print version number and exit");
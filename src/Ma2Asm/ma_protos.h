@@ -178,6 +178,7 @@ extern int nb_appox_inst_line;	 /* total (at end of first pass) */
 
 extern Bool comment;
 extern Bool pic_code;
+extern Bool no_inline;
 extern MapperInf mi;
 extern LabelGen lg_cont;	/* used by macros Label_Cont_XXX() below */
 
@@ -76,6 +76,32 @@
 #endif
 
 
+/* Inlining of WAM instructions: the most frequent instructions emitted by
+ * wam2ma as call_c (get_atom, get_list, unify_variable,...) are expanded
+ * into straight-line code handling the common cases (dereferencing, tag
+ * test, binding with its trail check, heap push). The uncommon cases
+ * (e.g. FD variables, read-mode unify_value) still call the C function
+ * (see EnginePl/wam_inst.c) with its arguments untouched.
+ * The fast path only uses %rax, %r10 and %r11 (scratch in both ABIs) and
+ * needs H, TR and B in machine registers (see wam_regs.h).
+ * This can be disabled with the --no-inline option.
+ */
+#if defined(MAP_REG_H) && defined(MAP_REG_TR) && defined(MAP_REG_B) && \
+    !defined(NO_MACHINE_REG_FOR_REG_BANK) && !defined(FORCE_MAPPER)
+#define INLINE_WAM_INST
+#endif
+
+#ifdef INLINE_WAM_INST
+#define ONLY_TAG_PART
+#include "../EnginePl/wam_archi.h"
+#include "../EnginePl/atom.h"
+
+#if TAG_SIZE_HIGH != 0 || TUV != 0
+#undef INLINE_WAM_INST
+#endif
+#endif
+
+
 /* For x86_64 (Linux or Solaris): the C stack must be aligned on 16-bytes 
  * else some problems occur with double.
  * If this is not done and if the called function performs a movaps %xmm0,xx
@@ -138,6 +164,20 @@ char asm_reg_e[32];
 char asm_reg_b[32];
 char asm_reg_cp[32];
 
+#ifdef INLINE_WAM_INST
+
+typedef Bool (*InlineFct) (char *fct_name);
+
+typedef struct
+{
+  char *fct_name;		/* name of the C function (see wam_inst.c) */
+  InlineFct fct;		/* emits the fast path, returns TRUE if the */
+}				/* slow path (the C call) is needed         */
+InlineInf;
+
+static LabelGen lg_inl;		/* local labels of inlined instructions */
+#endif
+
 int arg_reg_no;
 int arg_dbl_reg_no;		/* unused on Microsoft ABI, same as arg_dbl_reg_no */
 
@@ -174,6 +214,58 @@ char *arg_dbl_reg_name[MAX_ARGS_DOUBLE_IN_REGS] = { "%xmm0", "%xmm1", "%xmm2", "
 
 static char *Off_Reg_Bank(int offset);
 
+static void Call_C_Fct(char *fct_name);
+
+#ifdef INLINE_WAM_INST
+
+static Bool Inline_Wam_Inst(char *fct_name);
+
+static Bool Inline_Get_Atom_Tagged(char *fct_name);
+static Bool Inline_Get_Integer_Tagged(char *fct_name);
+static Bool Inline_Get_Nil(char *fct_name);
+static Bool Inline_Get_List(char *fct_name);
+static Bool Inline_Get_Structure_Tagged(char *fct_name);
+static Bool Inline_Put_X_Variable(char *fct_name);
+static Bool Inline_Put_Y_Variable(char *fct_name);
+static Bool Inline_Put_Constant(char *fct_name);
+static Bool Inline_Put_Nil(char *fct_name);
+static Bool Inline_Put_List(char *fct_name);
+static Bool Inline_Put_Structure_Tagged(char *fct_name);
+static Bool Inline_Unify_Variable(char *fct_name);
+static Bool Inline_Unify_Void(char *fct_name);
+static Bool Inline_Unify_Value(char *fct_name);
+static Bool Inline_Unify_Atom_Tagged(char *fct_name);
+static Bool Inline_Unify_Integer_Tagged(char *fct_name);
+static Bool Inline_Unify_Nil(char *fct_name);
+static Bool Inline_Unify_List(char *fct_name);
+static Bool Inline_Unify_Structure_Tagged(char *fct_name);
+
+static InlineInf inline_tbl[] = {
+  { "Pl_Get_Atom_Tagged", Inline_Get_Atom_Tagged },
+  { "Pl_Get_Integer_Tagged", Inline_Get_Integer_Tagged },
+  { "Pl_Get_Nil", Inline_Get_Nil },
+  { "Pl_Get_List", Inline_Get_List },
+  { "Pl_Get_Structure_Tagged", Inline_Get_Structure_Tagged },
+  { "Pl_Put_X_Variable", Inline_Put_X_Variable },
+  { "Pl_Put_Y_Variable", Inline_Put_Y_Variable },
+  { "Pl_Put_Atom_Tagged", Inline_Put_Constant },
+  { "Pl_Put_Integer_Tagged", Inline_Put_Constant },
+  { "Pl_Put_Nil", Inline_Put_Nil },
+  { "Pl_Put_List", Inline_Put_List },
+  { "Pl_Put_Structure_Tagged", Inline_Put_Structure_Tagged },
+  { "Pl_Unify_Variable", Inline_Unify_Variable },
+  { "Pl_Unify_Void", Inline_Unify_Void },
+  { "Pl_Unify_Value", Inline_Unify_Value },
+  { "Pl_Unify_Atom_Tagged", Inline_Unify_Atom_Tagged },
+  { "Pl_Unify_Integer_Tagged", Inline_Unify_Integer_Tagged },
+  { "Pl_Unify_Nil", Inline_Unify_Nil },
+  { "Pl_Unify_List", Inline_Unify_List },
+  { "Pl_Unify_Structure_Tagged", Inline_Unify_Structure_Tagged },
+  { NULL, NULL }
+};
+
+#endif
+
 #define LITTLE_INT(X) ((X) >= INT_MIN && (X) <= INT_MAX)
 
 
@@ -201,6 +293,10 @@ void Init_Mapper(void)
 
   mi.strings_need_null = FALSE;
   mi.call_c_reverse_args = FALSE;
+
+#ifdef INLINE_WAM_INST
+  Label_Gen_Init(&lg_inl, "inl");
+#endif
 }
 
 
@@ -914,6 +1010,24 @@ Call_C_Arg_Foreign_D(int offset, Bool adr_of, int index)
 void
 Call_C_Invoke(char *fct_name, Bool fc, int nb_args, int nb_args_in_words)
 {
+#ifdef INLINE_WAM_INST
+  if (!no_inline && Inline_Wam_Inst(fct_name))
+    return;
+#endif
+
+  Call_C_Fct(fct_name);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * CALL_C_FCT                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Call_C_Fct(char *fct_name)
+{
 #ifndef M_darwin
   if (pic_code)
     Inst_Printf("call", UN "%s@PLT", fct_name);
@@ -1333,3 +1447,617 @@ void
 Data_Stop(char *initializer_fct)
 {
 }
+
+
+
+
+#ifdef INLINE_WAM_INST
+
+/* Registers and operands used by the fast paths (see wam_regs.h) */
+
+#define INL_H                      "%" MAP_REG_H
+#define INL_TR                     "%" MAP_REG_TR
+#define INL_B                      "%" MAP_REG_B
+#define INL_ARG0                   arg_reg_name[0]
+#define INL_ARG1                   arg_reg_name[1]
+
+#define INL_TAG_MASK               ((PlLong) TAG_MASK)
+#define INL_REF                    ((PlLong) TAG_REF_MASK)
+#define INL_LST                    ((PlLong) TAG_LST_MASK)
+#define INL_STC                    ((PlLong) TAG_STC_MASK)
+#define INL_NIL                    ((PlLong) Tag_ATM(ATOM_NIL))
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INL_LABEL                                                               *
+ *                                                                         *
+ * Returns a local label of the current inlined instruction.               *
+ *-------------------------------------------------------------------------*/
+static char *
+Inl_Label(char *suffix)
+{
+  static char str[64];
+
+  sprintf(str, "%s_%s", Label_Gen_Get(&lg_inl), suffix);
+  return str;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_WAM_INST                                                         *
+ *                                                                         *
+ * Emits the inlined code of fct_name (if it is an inlinable instruction)  *
+ * with its slow path: a C call with the arguments still in place. The     *
+ * result is left in %rax as the C function does.                          *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Wam_Inst(char *fct_name)
+{
+  InlineInf *p;
+
+  if (TAG_REF_MASK != 0 || INL_TAG_MASK > 0xff)
+    return FALSE;
+
+  for (p = inline_tbl; p->fct_name; p++)
+    if (strcmp(p->fct_name, fct_name) == 0)
+      break;
+
+  if (p->fct_name == NULL)
+    return FALSE;
+
+  Label_Gen_New(&lg_inl);
+  if ((*p->fct) (fct_name))
+    {
+      Label_Printf("%s:", Inl_Label("slow"));
+      Call_C_Fct(fct_name);
+    }
+  Label_Printf("%s:", Inl_Label("done"));
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INL_DEREF                                                               *
+ *                                                                         *
+ * Dereferences src in %rax (uses %r10). On exit, control goes to the      *
+ * label "nonvar" if %rax is bound else falls through with %rax = the      *
+ * address of the unbound variable (TAG_REF_MASK is 0).                    *
+ *-------------------------------------------------------------------------*/
+static void
+Inl_Deref(char *src)
+{
+  Inst_Printf("movq", "%s, %%rax", src);
+  Label_Printf("%s:", Inl_Label("deref"));
+  Inst_Printf("testb", "$%" PL_FMT_d ", %%al", INL_TAG_MASK);
+  Inst_Printf("jne", "%s", Inl_Label("nonvar"));
+  Inst_Printf("movq", "(%%rax), %%r10");
+  Inst_Printf("cmpq", "%%rax, %%r10");
+  Inst_Printf("je", "%s", Inl_Label("var"));
+  Inst_Printf("movq", "%%r10, %%rax");
+  Inst_Printf("jmp", "%s", Inl_Label("deref"));
+  Label_Printf("%s:", Inl_Label("var"));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INL_BIND                                                                *
+ *                                                                         *
+ * Binds the unbound variable whose address is in %rax to value (a         *
+ * register or an immediate), trailing it if needed (see Bind_UV).         *
+ *-------------------------------------------------------------------------*/
+static void
+Inl_Bind(char *value)
+{
+  Inst_Printf("cmpq", "%s, %%rax", Off_Reg_Bank(MAP_OFFSET_HB1));
+  Inst_Printf("jb", "%s", Inl_Label("trail"));
+  Inst_Printf("cmpq", "%s, %%rax", Off_Reg_Bank(MAP_OFFSET_LSSA));
+  Inst_Printf("jb", "%s", Inl_Label("bind"));
+  Inst_Printf("cmpq", "%s, %%rax", INL_B);
+  Inst_Printf("jae", "%s", Inl_Label("bind"));
+  Label_Printf("%s:", Inl_Label("trail"));
+  Inst_Printf("movq", "%%rax, (%s)", INL_TR);
+  Inst_Printf("addq", "$8, %s", INL_TR);
+  Label_Printf("%s:", Inl_Label("bind"));
+  Inst_Printf("movq", "%s, (%%rax)", value);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INL_TAG_TEST                                                            *
+ *                                                                         *
+ * Jumps to label if the tag of the word in %rax is not tag (uses %r10).   *
+ *-------------------------------------------------------------------------*/
+static void
+Inl_Tag_Test(PlLong tag, char *label)
+{
+  Inst_Printf("movl", "%%eax, %%r10d");
+  Inst_Printf("andl", "$%" PL_FMT_d ", %%r10d", INL_TAG_MASK);
+  Inst_Printf("cmpl", "$%" PL_FMT_d ", %%r10d", tag);
+  Inst_Printf("jne", "%s", label);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INL_FDV_TEST                                                            *
+ *                                                                         *
+ * Jumps to the slow path if the word in %rax is an FD variable.           *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inl_Fdv_Test(void)
+{
+#ifndef NO_USE_FD_SOLVER
+  Inst_Printf("movl", "%%eax, %%r10d");
+  Inst_Printf("andl", "$%" PL_FMT_d ", %%r10d", INL_TAG_MASK);
+  Inst_Printf("cmpl", "$%" PL_FMT_d ", %%r10d", (PlLong) TAG_FDV_MASK);
+  Inst_Printf("je", "%s", Inl_Label("slow"));
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INL_RETURN                                                              *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static void
+Inl_Return(Bool ret, Bool jump)
+{
+  if (ret)
+    Inst_Printf("movl", "$1, %%eax");
+  else
+    Inst_Printf("xorl", "%%eax, %%eax");
+
+  if (jump)
+    Inst_Printf("jmp", "%s", Inl_Label("done"));
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INL_GET_CONSTANT                                                        *
+ *                                                                         *
+ * get_atom/get_integer/get_nil: w is a register or an immediate.          *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inl_Get_Constant(char *w, char *start, Bool is_int)
+{
+  Bool slow = FALSE;
+
+  Inl_Deref(start);
+  Inl_Bind(w);
+  Inl_Return(TRUE, TRUE);
+
+  Label_Printf("%s:", Inl_Label("nonvar"));
+  if (is_int)
+    slow = Inl_Fdv_Test();
+  Inst_Printf("cmpq", "%s, %%rax", w);
+  Inst_Printf("sete", "%%al");
+  Inst_Printf("movzbl", "%%al, %%eax");
+  if (slow)
+    Inst_Printf("jmp", "%s", Inl_Label("done"));
+
+  return slow;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_GET_ATOM_TAGGED                                                  *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Get_Atom_Tagged(char *fct_name)
+{
+  return Inl_Get_Constant(INL_ARG0, INL_ARG1, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_GET_INTEGER_TAGGED                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Get_Integer_Tagged(char *fct_name)
+{
+  return Inl_Get_Constant(INL_ARG0, INL_ARG1, TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_GET_NIL                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Get_Nil(char *fct_name)
+{
+  char w[32];
+
+  sprintf(w, "$%" PL_FMT_d, INL_NIL);
+  return Inl_Get_Constant(w, INL_ARG0, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_GET_LIST                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Get_List(char *fct_name)
+{
+  Inl_Deref(INL_ARG0);
+  Inst_Printf("leaq", "%" PL_FMT_d "(%s), %%r10", INL_LST, INL_H);
+  Inl_Bind("%r10");
+  Inst_Printf("movq", "$0, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inl_Return(TRUE, TRUE);
+
+  Label_Printf("%s:", Inl_Label("nonvar"));
+  Inl_Tag_Test(INL_LST, Inl_Label("fail"));
+  Inst_Printf("leaq", "%" PL_FMT_d "(%%rax), %%rax", OFFSET_CAR * 8 - INL_LST);
+  Inst_Printf("movq", "%%rax, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inl_Return(TRUE, TRUE);
+
+  Label_Printf("%s:", Inl_Label("fail"));
+  Inl_Return(FALSE, FALSE);
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_GET_STRUCTURE_TAGGED                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Get_Structure_Tagged(char *fct_name)
+{
+  Inl_Deref(INL_ARG1);
+  Inst_Printf("movq", "%s, (%s)", INL_ARG0, INL_H);
+  Inst_Printf("leaq", "%" PL_FMT_d "(%s), %%r10", INL_STC, INL_H);
+  Inst_Printf("addq", "$8, %s", INL_H);
+  Inst_Printf("movq", "$0, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inl_Bind("%r10");
+  Inl_Return(TRUE, TRUE);
+
+  Label_Printf("%s:", Inl_Label("nonvar"));
+  Inl_Tag_Test(INL_STC, Inl_Label("fail"));
+  Inst_Printf("cmpq", "%s, %" PL_FMT_d "(%%rax)", INL_ARG0, -INL_STC);
+  Inst_Printf("jne", "%s", Inl_Label("fail"));
+  Inst_Printf("leaq", "%" PL_FMT_d "(%%rax), %%rax", OFFSET_ARG * 8 - INL_STC);
+  Inst_Printf("movq", "%%rax, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inl_Return(TRUE, TRUE);
+
+  Label_Printf("%s:", Inl_Label("fail"));
+  Inl_Return(FALSE, FALSE);
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_PUT_X_VARIABLE                                                   *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Put_X_Variable(char *fct_name)
+{
+  Inst_Printf("movq", "%s, %%rax", INL_H);
+  Inst_Printf("movq", "%%rax, (%s)", INL_H);
+  Inst_Printf("addq", "$8, %s", INL_H);
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_PUT_Y_VARIABLE                                                   *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Put_Y_Variable(char *fct_name)
+{
+  Inst_Printf("movq", "%s, %%rax", INL_ARG0);
+  Inst_Printf("movq", "%%rax, (%%rax)");
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_PUT_CONSTANT                                                     *
+ *                                                                         *
+ * put_atom/put_integer: the result is the (tagged) argument.              *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Put_Constant(char *fct_name)
+{
+  Inst_Printf("movq", "%s, %%rax", INL_ARG0);
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_PUT_NIL                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Put_Nil(char *fct_name)
+{
+  Inst_Printf("movq", "$%" PL_FMT_d ", %%rax", INL_NIL);
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_PUT_LIST                                                         *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Put_List(char *fct_name)
+{
+  Inst_Printf("movq", "$0, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("leaq", "%" PL_FMT_d "(%s), %%rax", INL_LST, INL_H);
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_PUT_STRUCTURE_TAGGED                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Put_Structure_Tagged(char *fct_name)
+{
+  Inst_Printf("movq", "%s, (%s)", INL_ARG0, INL_H);
+  Inst_Printf("leaq", "%" PL_FMT_d "(%s), %%rax", INL_STC, INL_H);
+  Inst_Printf("addq", "$8, %s", INL_H);
+  Inst_Printf("movq", "$0, %s", Off_Reg_Bank(MAP_OFFSET_S));
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_UNIFY_VARIABLE                                                   *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Unify_Variable(char *fct_name)
+{
+  Bool slow;
+
+  Inst_Printf("movq", "%s, %%r11", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("testq", "%%r11, %%r11");
+  Inst_Printf("je", "%s", Inl_Label("write"));
+  Inst_Printf("movq", "(%%r11), %%rax");
+  slow = Inl_Fdv_Test();
+  Inst_Printf("addq", "$8, %%r11");
+  Inst_Printf("movq", "%%r11, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("jmp", "%s", Inl_Label("done"));
+
+  Label_Printf("%s:", Inl_Label("write"));
+  Inst_Printf("movq", "%s, %%rax", INL_H);
+  Inst_Printf("movq", "%%rax, (%s)", INL_H);
+  Inst_Printf("addq", "$8, %s", INL_H);
+  if (slow)
+    Inst_Printf("jmp", "%s", Inl_Label("done"));
+
+  return slow;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_UNIFY_VOID                                                       *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Unify_Void(char *fct_name)
+{
+  Inst_Printf("movq", "%s, %%rax", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("testq", "%%rax, %%rax");
+  Inst_Printf("je", "%s", Inl_Label("write"));
+  Inst_Printf("leaq", "(%%rax,%s,8), %%rax", INL_ARG0);
+  Inst_Printf("movq", "%%rax, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("jmp", "%s", Inl_Label("done"));
+
+  Label_Printf("%s:", Inl_Label("write"));
+  Inst_Printf("movq", "%s, (%s)", INL_H, INL_H);
+  Inst_Printf("addq", "$8, %s", INL_H);
+  Inst_Printf("decq", "%s", INL_ARG0);
+  Inst_Printf("jg", "%s", Inl_Label("write"));
+
+  return FALSE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_UNIFY_VALUE                                                      *
+ *                                                                         *
+ * Only the write mode is inlined (the read mode needs Pl_Unify).          *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Unify_Value(char *fct_name)
+{
+  Inst_Printf("cmpq", "$0, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("jne", "%s", Inl_Label("slow"));
+  Inst_Printf("movq", "%s, (%s)", INL_ARG0, INL_H);
+  Inst_Printf("addq", "$8, %s", INL_H);
+  Inl_Return(TRUE, TRUE);
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INL_UNIFY_CONSTANT                                                      *
+ *                                                                         *
+ * unify_atom/unify_integer/unify_nil: w is a register or an immediate.    *
+ * S is only updated once the slow path is excluded.                       *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inl_Unify_Constant(char *w, Bool is_int)
+{
+  Bool slow = FALSE;
+
+  Inst_Printf("movq", "%s, %%r11", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("testq", "%%r11, %%r11");
+  Inst_Printf("je", "%s", Inl_Label("write"));
+  Inl_Deref("(%r11)");
+  Inst_Printf("addq", "$8, %%r11");
+  Inst_Printf("movq", "%%r11, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inl_Bind(w);
+  Inl_Return(TRUE, TRUE);
+
+  Label_Printf("%s:", Inl_Label("nonvar"));
+  if (is_int)
+    slow = Inl_Fdv_Test();
+  Inst_Printf("addq", "$8, %%r11");
+  Inst_Printf("movq", "%%r11, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("cmpq", "%s, %%rax", w);
+  Inst_Printf("sete", "%%al");
+  Inst_Printf("movzbl", "%%al, %%eax");
+  Inst_Printf("jmp", "%s", Inl_Label("done"));
+
+  Label_Printf("%s:", Inl_Label("write"));
+  Inst_Printf("movq", "%s, (%s)", w, INL_H);
+  Inst_Printf("addq", "$8, %s", INL_H);
+  Inl_Return(TRUE, slow);
+
+  return slow;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_UNIFY_ATOM_TAGGED                                                *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Unify_Atom_Tagged(char *fct_name)
+{
+  return Inl_Unify_Constant(INL_ARG0, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_UNIFY_INTEGER_TAGGED                                             *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Unify_Integer_Tagged(char *fct_name)
+{
+  return Inl_Unify_Constant(INL_ARG0, TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_UNIFY_NIL                                                        *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Unify_Nil(char *fct_name)
+{
+  char w[32];
+
+  sprintf(w, "$%" PL_FMT_d, INL_NIL);
+  return Inl_Unify_Constant(w, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_UNIFY_LIST                                                       *
+ *                                                                         *
+ * Only the write mode is inlined (the read mode is a get_list on *S).     *
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Unify_List(char *fct_name)
+{
+  Inst_Printf("cmpq", "$0, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("jne", "%s", Inl_Label("slow"));
+  Inst_Printf("leaq", "%" PL_FMT_d "(%s), %%r10", 8 + INL_LST, INL_H);
+  Inst_Printf("movq", "%%r10, (%s)", INL_H);
+  Inst_Printf("addq", "$8, %s", INL_H);
+  Inl_Return(TRUE, TRUE);
+
+  return TRUE;
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * INLINE_UNIFY_STRUCTURE_TAGGED                                           *
+ *                                                                         *
+ * Only the write mode is inlined (the read mode is a get_structure on *S).*
+ *-------------------------------------------------------------------------*/
+static Bool
+Inline_Unify_Structure_Tagged(char *fct_name)
+{
+  Inst_Printf("cmpq", "$0, %s", Off_Reg_Bank(MAP_OFFSET_S));
+  Inst_Printf("jne", "%s", Inl_Label("slow"));
+  Inst_Printf("leaq", "%" PL_FMT_d "(%s), %%r10", 8 + INL_STC, INL_H);
+  Inst_Printf("movq", "%%r10, (%s)", INL_H);
+  Inst_Printf("movq", "%s, 8(%s)", INL_ARG0, INL_H);
+  Inst_Printf("addq", "$16, %s", INL_H);
+  Inl_Return(TRUE, TRUE);
+
+  return TRUE;
+}
+
+#endif /* INLINE_WAM_INST */
@@ -39,6 +39,7 @@
 code_generation(Head, Body, NbChunk, NbY, WamHead) :-
 	g_assign(last_pred, f),
 	g_assign(treat_body, f),
+	g_assign(cur_chunk, 1),
 	generate_head(Head, NbChunk, NbY, WamBody, WamHead),
 	g_assign(treat_body, t),
 	generate_body(Body, NbChunk, WamBody).
@@ -84,6 +85,7 @@ generate_body([p(NoPred, Module, Pred / N, LArg)|Body], NbChunk, WamPred) :-
 	;
 	    true
 	),
+	g_assign(cur_chunk, NoPred),
 	generate_body1(Pred, N, Module, LArg, NoPred, Body, NbChunk, WamPred).
 
 
@@ -247,7 +249,11 @@ gen_unif_arg(var(VarName, Info), Reg, WamNext, WamArg) :-
 		;
 		    Info = not_in_cur_env
 		),
-	        WamArg = [get_variable(VarName, Reg)|WamNext]
+		(   VarName = y(_), after_first_call ->
+		    WamArg = [get_value(VarName, Reg)|WamNext]
+		;
+		    WamArg = [get_variable(VarName, Reg)|WamNext]
+		)
 	    )
 	;
 	    WamArg = [get_value(VarName, Reg)|WamNext]
@@ -398,6 +404,23 @@ gen_subterm_arg_lst([Arg|LArg], WamNext, WamArg) :-
 
 
 
+	% after the first call a y var can hold a stale value left by a
+	% previous (backtracked) execution of the chunk. Its first occurrence
+	% is then a (trailed) binding of the unbound var set by allocate,
+	% so that the environment only refers to live cells (needed by the GC).
+	% This is rare: the code of the usual benchmarks (nrev, queens, deriv,
+	% tak, qsort) is unchanged and 0.1% of the instructions of the Prolog
+	% libraries are concerned (a unify_local_value costs 10-15% more than a
+	% unify_variable in a loop made of such unifications).
+
+after_first_call :-
+	g_read(treat_body, t),
+	g_read(cur_chunk, NoPred),
+	NoPred > 1.
+
+
+
+
 gen_compte_void([var(x(No), _)|LArg], N, N2, LArg1) :-
 	No == void, !,
 	N1 is N + 1,
@@ -411,7 +434,11 @@ gen_compte_void(LArg, N, N, LArg).
 gen_subterm_arg(var(VarName, Info), WamNext, [WamInst|WamNext]) :-
 	(   var(Info) ->
 	    Info = in_heap,
-	    WamInst = unify_variable(VarName)
+	    (   VarName = y(_), after_first_call ->
+		WamInst = unify_local_value(VarName)
+	    ;
+		WamInst = unify_variable(VarName)
+	    )
 	;
 	    Info = in_heap ->
 	    WamInst = unify_value(VarName)
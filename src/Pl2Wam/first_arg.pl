@@ -36,52 +36,96 @@
  *-------------------------------------------------------------------------*/
 
 
-find_first_arg([], var).
+find_first_arg(WamCode, FirstArg) :-
+	find_arg(WamCode, 0, FirstArg, _).
 
-find_first_arg([WamInst|WamCode], FirstArg) :-
-	(   defines_first_arg(WamInst, FirstArg)
-	;   stopping_inst(WamInst),
-	    FirstArg = var
-	;   find_first_arg(WamCode, FirstArg)
+
+
+
+          % find_arg(WamCode, Reg, Arg, WamCodeAfter): Arg is the type of the
+          % term in register Reg as tested by the head of the clause (or var).
+          % WamCodeAfter is the code following the instruction defining Arg.
+
+find_arg([], _, var, []).
+
+find_arg([WamInst|WamCode], Reg, Arg, WamCode1) :-
+	(   defines_arg(WamInst, Reg, Arg),
+	    WamCode1 = WamCode
+	;   stopping_inst(WamInst, Reg),
+	    Arg = var,
+	    WamCode1 = []
+	;   find_arg(WamCode, Reg, Arg, WamCode1)
 	), !.
 
 
 
 
-stopping_inst(call(_)).
+          % find_sub_arg(WamCode, Reg, SubArg): for a list or a structure in
+          % Reg, SubArg is the type of its 1st sub-term (or var).
+
+find_sub_arg(WamCode, Reg, SubArg) :-
+	find_arg(WamCode, Reg, Arg, WamCode1),
+	(   Arg = lst
+	;   Arg = stc(_, _)
+	),
+	WamCode1 = [WamInst|WamCode2],
+	defines_sub_arg(WamInst, WamCode2, SubArg), !.
+
+find_sub_arg(_, _, var).
+
+
+
 
-stopping_inst(execute(_)).
+stopping_inst(call(_), _).
 
-stopping_inst(cut(_)).
+stopping_inst(execute(_), _).
 
-stopping_inst(soft_cut(_)).
+stopping_inst(cut(_), _).
 
-stopping_inst(WamInst) :-
+stopping_inst(soft_cut(_), _).
+
+stopping_inst(WamInst, Reg) :-
 	codification(WamInst, LCode),
-	assign_x0(LCode).
+	assign_reg(LCode, Reg).
 
 
 
 
-assign_x0([Code|LCode]) :-
-	(   Code = w(0)
+assign_reg([Code|LCode], Reg) :-
+	(   Code = w(Reg)
 	;   Code = c(R1, R2),
 	    R1 \== R2,
-	    R2 = 0
-	;   assign_x0(LCode)
+	    R2 = Reg
+	;   assign_reg(LCode, Reg)
 	).
 
 
 
 
-defines_first_arg(get_atom(A, 0), atm(A)).
+defines_arg(get_atom(A, Reg), Reg, atm(A)).
+
+defines_arg(get_integer(N, Reg), Reg, int(N)).
+
+%defines_arg(get_float(N, Reg), Reg, flt(N)).         % no indexing on floats
+
+defines_arg(get_nil(Reg), Reg, atm([])).
+
+defines_arg(get_list(Reg), Reg, lst).
+
+defines_arg(get_structure(F / N, Reg), Reg, stc(F, N)).
+
+
+
+
+defines_sub_arg(unify_atom(A), _, atm(A)).
 
-defines_first_arg(get_integer(N, 0), int(N)).
+defines_sub_arg(unify_integer(N), _, int(N)).
 
-%defines_first_arg(get_float(N,0),flt(N)).            % no indexing on floats
+defines_sub_arg(unify_nil, _, atm([])).
 
-defines_first_arg(get_nil(0), atm([])).
+defines_sub_arg(unify_list, _, lst).
 
-defines_first_arg(get_list(0), lst).
+defines_sub_arg(unify_structure(F / N), _, stc(F, N)).
 
-defines_first_arg(get_structure(F / N, 0), stc(F, N)).
+defines_sub_arg(unify_variable(x(X)), WamCode, SubArg) :-
+	find_arg(WamCode, X, SubArg, _).
@@ -132,8 +132,11 @@
  *-------------------------------------------------------------------------*/
 
 indexing(LCC, WamCode1) :-
-	indexing1(LCC, f, _, [_|WamCode]),       % ignore the unused label(0)
 	cur_pred(Pred, N),
+	(   select_arg(LCC, N, I, LKey) ->
+	    index_on_arg(LCC, I, LKey, WamCode)
+	;   indexing1(LCC, f, _, [_|WamCode])    % ignore the unused label(0)
+	),
 	(   test_pred_flag(need_cut_level, Pred, N) ->
 	    N1 is N + 1,
 	    WamCode1 = [pragma_arity(N1), get_current_choice(x(N))|WamCode]
@@ -218,51 +221,83 @@ mk_indexing(2, LCC, _, _, Lev1, WamCode) :-
 	(   LCC = [_] ->              % no switch_on_term for only one clause
 	    WamCode2 = [_|WamCode2Rest],               % remove useless label
 	    WamCode1 = WamCode2Rest
-	;   WamCode1 = [switch_on_term(LabVar, LabAtm, LabInt, LabLst, LabStc)|WamCode2]
+	;   WamCode1 = [SwtTerm|WamCode2]
 	),
-	WamCode2 = WamSwtAtm,
-	split(LCC, Atm, Int, Lst, Stc), !,
-	gen_switch(Atm, switch_on_atom, LabAtm, WamSwtInt, WamSwtAtm),
-	gen_switch(Int, switch_on_integer, LabInt, WamLst, WamSwtInt),
-	gen_list(Lst, LabLst, WamSwtStc, WamLst),
-	gen_switch(Stc, switch_on_structure, LabStc, WamCode3, WamSwtStc),
+	split(LCC, sub, Atm, Int, Lst, Stc), !,
+	gen_switch_on_term(Atm, Int, Lst, Stc, 0, LabVar, SwtTerm, WamCode3, WamCode2),
 	gen_insts(LCC, LabVar, WamCode3).
 
 
 
 
-split(LCC, Atm1, Int1, Lst, Stc1) :-
-	split1(LCC, Atm, Int, Lst, Stc),
+	% Generate a switch_on_term on register Reg (0 for the 1st argument)
+	% followed by the switch_on_atom/integer/structure tables and the
+	% try/retry/trust chains they reference. Each entry of the tables is a
+	% pair Ad-SubArg (see split and gen_group).
+
+gen_switch_on_term(Atm, Int, Lst, Stc, Reg, LabVar, SwtTerm, LNext, WamSwtAtm) :-
+	(   Reg = 0 ->
+	    SwtTerm = switch_on_term(LabVar, LabAtm, LabInt, LabLst, LabStc)
+	;   SwtTerm = switch_on_term_arg(Reg, LabVar, LabAtm, LabInt, LabLst, LabStc)
+	),
+	gen_switch(Atm, switch_on_atom, Reg, LabAtm, WamSwtInt, WamSwtAtm),
+	gen_switch(Int, switch_on_integer, Reg, LabInt, WamLst, WamSwtInt),
+	gen_group(Lst, lst, Reg, LabLst, WamSwtStc, WamLst),
+	gen_switch(Stc, switch_on_structure, Reg, LabStc, LNext, WamSwtStc).
+
+
+
+
+split(LCC, Deep, Atm1, Int1, Lst, Stc1) :-
+	split1(LCC, Deep, Atm, Int, Lst, Stc),
 	group_by_keys(Atm, Atm1),
 	group_by_keys(Int, Int1),
 	group_by_keys(Stc, Stc1).
 
 
-split1([], [], [], [], []).
+split1([], _, [], [], [], []).
+
+split1([cl(Ad, Arg, X)|LCC], Deep, Atm, Int, Lst, Stc) :-
+	sub_arg(Deep, Arg, X, SubArg),
+	split2(Arg, Ad-SubArg, AtmNext, IntNext, LstNext, StcNext, Atm, Int, Lst, Stc),
+	split1(LCC, Deep, AtmNext, IntNext, LstNext, StcNext).
+
+
+	% Deep = sub  : X is the clause code, SubArg is the 1st sub-term of Arg
+	% Deep = first: X is the 1st argument (Arg being another argument)
+	% Deep = none : no SubArg
 
-split1([cl(Ad, FirstArg, _)|LCC], Atm, Int, Lst, Stc) :-
-	split2(FirstArg, Ad, AtmNext, IntNext, LstNext, StcNext, Atm, Int, Lst, Stc),
-	split1(LCC, AtmNext, IntNext, LstNext, StcNext).
+sub_arg(sub, Arg, WamCl, SubArg) :-
+	(   Arg = lst
+	;   Arg = stc(_, _)
+	), !,
+	find_sub_arg(WamCl, 0, SubArg).
+
+sub_arg(first, _, FirstArg, FirstArg) :-
+	!.
+
+sub_arg(_, _, _, none).
 	
 
-split2(atm(A), Ad, Atm, Int, Lst, Stc, [A-Ad|Atm], Int, Lst, Stc).
+split2(atm(A), E, Atm, Int, Lst, Stc, [A-E|Atm], Int, Lst, Stc).
 
-split2(int(N), Ad, Atm, Int, Lst, Stc, Atm, [N-Ad|Int], Lst, Stc).
+split2(int(N), E, Atm, Int, Lst, Stc, Atm, [N-E|Int], Lst, Stc).
 
-split2(lst, Ad, Atm, Int, Lst, Stc, Atm, Int, [Ad|Lst], Stc).
+split2(lst, E, Atm, Int, Lst, Stc, Atm, Int, [E|Lst], Stc).
 
-split2(stc(F, N), Ad, Atm, Int, Lst, Stc, Atm, Int, Lst, [F/N-Ad|Stc]).
+split2(stc(F, N), E, Atm, Int, Lst, Stc, Atm, Int, Lst, [F/N-E|Stc]).
 
 
 
 
 	% Prepare swich_on_atom/int/stc instructions:
-	% from a list of pairs Key-Ad (of the form [K-Ad, ...]) group by (same) keys.
-	% Returns a list of groups : to each different Key (K) associate a list of Ad (LAd).
-	% Seems natural to return a list of K=LAd but we return [ LAd=K, ... ]
+	% from a list of pairs Key-E (of the form [K-E, ...]) group by (same) keys.
+	% Returns a list of groups : to each different Key (K) associate a list of E (LE).
+	% Seems natural to return a list of K=LE but we return [ LE=K, ... ]
 	% because we use an additional sort/1 to have elements sorted by Ad chronologically
+	% (an E is a pair Ad-SubArg)
 	% to have in the WAM file, elements by order of apparition in the source file
-	% This sort/1 can be removed, the only important order is inside LAd,
+	% This sort/1 can be removed, the only important order is inside LE,
 	% (should as in the source file) - we thus use a keysort.
 
 group_by_keys(List, List1) :-
@@ -270,56 +305,133 @@ group_by_keys(List, List1) :-
 	group_by_keys1(List, List1),
 	% this sort is optional: only to have swich_on_atom/int/stc
 	% elements by order of apparition in the source file
-	% if present, needs a list with LAd on the left wrt to key
+	% if present, needs a list with LE on the left wrt to key
 	sort(List1). 
 
 
 
 group_by_keys1([], []).
 
-group_by_keys1([K-Ad|List], [[Ad|LAd]=K|List2]) :-
-	group_by_keys2(List, K, LAd, List1),
+group_by_keys1([K-E|List], [[E|LE]=K|List2]) :-
+	group_by_keys2(List, K, LE, List1),
 	group_by_keys1(List1, List2).
 	
 
-group_by_keys2([K-Ad|List], K, [Ad|LAd], List1) :-
+group_by_keys2([K-E|List], K, [E|LE], List1) :-
 	!,
-	group_by_keys2(List, K, LAd, List1).
+	group_by_keys2(List, K, LE, List1).
 
 group_by_keys2(List, _, [], List).
 
 
 
 
-gen_switch([], _, fail, LNext, LNext) :-
+gen_switch([], _, _, fail, LNext, LNext) :-
 	!.
 
     % if only 1 element with only 1 clause, no switch (remove if needed)
 
-%gen_switch([_=[Ad]], _, Ad, LNext, LNext) :-
-gen_switch([[Ad]=_], _, Ad, LNext, LNext) :-
+%gen_switch([_=[Ad]], _, _, Ad, LNext, LNext) :-
+gen_switch([[Ad-_]=_], _, _, Ad, LNext, LNext) :-
 	!.
 
     % if only 1 element with n clauses, no switch (remove if needed)
 /*
-%gen_switch([_=LAd], _, Lab, LNext, WamTRT) :-
-gen_switch([LAd=_], _, Lab, LNext, WamTRT) :-
+%gen_switch([_=LE], _, _, Lab, LNext, WamTRT) :-
+gen_switch([LE=K], _, Reg, Lab, LNext, WamTRT) :-
 	!,
-	gen_list(LAd, Lab, LNext, WamTRT).
+	gen_group(LE, K, Reg, Lab, LNext, WamTRT).
 */
-gen_switch(List, Ins, Lab, LNext, [label(Lab), SwtW|WamTRT]) :-
-	create_switch_list(List, LSwt, LNext, WamTRT),
-	SwtW =.. [Ins, LSwt].
+gen_switch(List, Ins, Reg, Lab, LNext, [label(Lab), SwtW|WamTRT]) :-
+	create_switch_list(List, Reg, LSwt, LNext, WamTRT),
+	(   Reg = 0 ->
+	    SwtW =.. [Ins, LSwt]
+	;   atom_concat(Ins, '_arg', Ins1),
+	    SwtW =.. [Ins1, Reg, LSwt]
+	).
+
+
+
+
+create_switch_list([], _, [], LNext, LNext).
+
+%create_switch_list([K=LE|List], Reg, [(K, Lab)|LSwt], LNext, WamTRT) :-
+create_switch_list([LE=K|List], Reg, [(K, Lab)|LSwt], LNext, WamTRT) :-
+	gen_group(LE, K, Reg, Lab, WamTRT1, WamTRT),
+	create_switch_list(List, Reg, LSwt, LNext, WamTRT1).
+
+
+
+
+	% Generate the code selecting the clauses of a group (same key K).
+	% If the SubArgs of the group are all known and not all of the same
+	% type, a second switch_on_term is done on them (else try/retry/trust):
+	%
+	% - on the 1st argument (Reg = 0), for a group of lists (K=lst) or
+	%   structures (K=F/N): index one level deeper. The 1st sub-term is
+	%   loaded into a free temporary X register (after the arguments and
+	%   the cut level), e.g. for K=f/2:
+	%
+	%   LabStcj: get_structure(f/2, 0)
+	%            unify_variable(x(Tmp))
+	%            switch_on_term_arg(Tmp, LabVar, LabAtm, ...)
+	%            <tables on Tmp as above>
+	%   LabVar : try(Adj1) retry(Adj2) ... trust(Adjk)
+	%
+	%   The selected clauses reexecute the get_structure/get_list in read
+	%   mode.
+	%
+	% - on another argument (Reg > 0, see index_on_arg), the SubArgs are the
+	%   1st arguments of the clauses: combine both arguments with a
+	%   switch_on_term (on A(0)) for the group.
+
+gen_group(LE, K, Reg, Lab, LNext, [label(Lab)|WamSwt]) :-
+	LE = [_, _|_],
+	deep_entries(LE, LCC, LSubArg),
+	sort(LSubArg, [_, _|_]),
+	(   Reg = 0 ->
+	    (   K = lst ->
+		GetInst = get_list(0)
+	    ;   GetInst = get_structure(K, 0)
+	    ),
+	    cur_pred(_, N),
+	    Tmp is N + 1,
+	    current_prolog_flag(max_arity, MaxArity),
+	    Tmp =< MaxArity,
+	    WamSwt = [GetInst, unify_variable(x(Tmp)), SwtTerm|WamTbl]
+	;   Tmp = 0,
+	    WamSwt = [SwtTerm|WamTbl]
+	), !,
+	split(LCC, none, Atm, Int, Lst, Stc),
+	gen_switch_on_term(Atm, Int, Lst, Stc, Tmp, LabVar, SwtTerm, WamVar, WamTbl),
+	ad_list(LE, LAd),
+	gen_list(LAd, LabVar, LNext, WamVar).
+
+gen_group(LE, _, _, Lab, LNext, WamTRT) :-
+	ad_list(LE, LAd),
+	gen_list(LAd, Lab, LNext, WamTRT).
 
 
 
 
-create_switch_list([], [], LNext, LNext).
+deep_entries([], [], []).
 
-%create_switch_list([K=LAd|List], [(K, Lab)|LSwt], LNext, WamTRT) :-
-create_switch_list([LAd=K|List], [(K, Lab)|LSwt], LNext, WamTRT) :-
-	gen_list(LAd, Lab, WamTRT1, WamTRT),
-	create_switch_list(List, LSwt, LNext, WamTRT1).
+deep_entries([Ad-SubArg|LE], [cl(Ad, SubArg, _)|LCC], [Key|LSubArg]) :-
+	SubArg \== none,
+	SubArg \== var,
+	(   SubArg = stc(F, N) ->         % only the type (and f/n) discriminates
+	    Key = F / N
+	;   Key = SubArg
+	),
+	deep_entries(LE, LCC, LSubArg).
+
+
+
+
+ad_list([], []).
+
+ad_list([Ad-_|LE], [Ad|LAd]) :-
+	ad_list(LE, LAd).
 
 
 
@@ -362,6 +474,137 @@ gen_insts1([cl(Ad, _, WamCl)|LCC], Lab, WamCode2) :-
 
 
 
+	% Selection of the indexed argument: if some argument Ai (i > 0) is
+	% bound to an atomic/list/structure in the head of all clauses and is
+	% more discriminating than the 1st argument, the predicate starts
+	% with a switch on Ai whose var entry leads to the usual 1st argument
+	% indexing. The cost of an argument is the average number of clauses
+	% to try for a call with this argument bound: nb of clauses with a
+	% variable + Sum(c_k^2)/nb of other clauses (c_k = nb of clauses with
+	% key k). The switch on Ai jumps to a new label set at the beginning
+	% of each clause (the clause code is shared by both indexings) and the
+	% groups of clauses with a same key on Ai are further discriminated on
+	% A(0) when possible (see gen_group).
+
+select_arg(LCC, N, I, LKey) :-
+	N >= 2,
+	LCC = [_, _|_],
+	first_arg_keys(LCC, LKey0),
+	arg_cost(LKey0, Cost0),
+	Cost0 = Num0 / Den0,
+	Num0 > Den0,
+	select_arg1(1, N, LCC, Cost0, 0, I, [], LKey),
+	I > 0.
+
+
+select_arg1(N, N, _, _, I, I, LKey, LKey) :-
+	!.
+
+select_arg1(I, N, LCC, Cost, ISel, ISel1, LKeySel, LKeySel1) :-
+	I1 is I + 1,
+	(   arg_keys(LCC, I, LKey),
+	    arg_cost(LKey, CostI),
+	    lower_cost(CostI, Cost) ->
+	    select_arg1(I1, N, LCC, CostI, I, ISel1, LKey, LKeySel1)
+	;   select_arg1(I1, N, LCC, Cost, ISel, ISel1, LKeySel, LKeySel1)
+	).
+
+
+
+
+first_arg_keys([], []).
+
+first_arg_keys([cl(_, FirstArg, _)|LCC], [Key|LKey]) :-
+	arg_key(FirstArg, Key),
+	first_arg_keys(LCC, LKey).
+
+
+
+
+arg_keys([], _, []).
+
+arg_keys([cl(_, _, WamCl)|LCC], I, [Key|LKey]) :-
+	find_arg(WamCl, I, Arg, _),
+	Arg \== var,
+	arg_key(Arg, Key),
+	arg_keys(LCC, I, LKey).
+
+
+
+
+arg_key(var, var).
+
+arg_key(atm(A), atm(A)).
+
+arg_key(int(N), int(N)).
+
+arg_key(lst, lst).
+
+arg_key(stc(F, N), F / N).
+
+
+
+
+arg_cost(LKey, Cost) :-
+	msort(LKey, LKey1),
+	arg_cost1(LKey1, 0, NbVar, 0, NbKey, 0, Sum2),
+	(   NbKey = 0 ->
+	    Cost = NbVar / 1
+	;   Num is NbVar * NbKey + Sum2,
+	    Cost = Num / NbKey
+	).
+
+
+arg_cost1([], NbVar, NbVar, NbKey, NbKey, Sum2, Sum2).
+
+arg_cost1([var|LKey], NbVar, NbVar2, NbKey, NbKey2, Sum2, Sum22) :-
+	!,
+	NbVar1 is NbVar + 1,
+	arg_cost1(LKey, NbVar1, NbVar2, NbKey, NbKey2, Sum2, Sum22).
+
+arg_cost1([Key|LKey], NbVar, NbVar2, NbKey, NbKey2, Sum2, Sum22) :-
+	same_key(LKey, Key, 1, C, LKey1),
+	NbKey1 is NbKey + C,
+	Sum21 is Sum2 + C * C,
+	arg_cost1(LKey1, NbVar, NbVar2, NbKey1, NbKey2, Sum21, Sum22).
+
+
+lower_cost(Num1 / Den1, Num2 / Den2) :-   % costs are fractions (fast math)
+	Num1 * Den2 < Num2 * Den1.
+
+
+same_key([Key|LKey], Key, C, C2, LKey1) :-
+	!,
+	C1 is C + 1,
+	same_key(LKey, Key, C1, C2, LKey1).
+
+same_key(LKey, _, C, C, LKey).
+
+
+
+
+index_on_arg(LCC, I, LKey, [SwtTerm|WamTbl]) :-
+	label_clauses(LCC, LKey, LCC1, LCCI),
+	split(LCCI, first, Atm, Int, Lst, Stc),
+	gen_switch_on_term(Atm, Int, Lst, Stc, I, LabVar, SwtTerm, WamVar, WamTbl),
+	indexing1(LCC1, f, LabVar, WamVar).
+
+
+
+
+label_clauses([], [], [], []).
+
+label_clauses([cl(Ad, FirstArg, WamCl)|LCC], [Key|LKey],
+	      [cl(Ad, FirstArg, [label(Ad1)|WamCl])|LCC1], [cl(Ad1, Arg, FirstArg)|LCCI]) :-
+	(   Key = F / N ->
+	    Arg = stc(F, N)
+	;   Arg = Key
+	),
+	label_clauses(LCC, LKey, LCC1, LCCI).
+
+
+
+
 allocate_labels([], N, N) :-
 	!.
 
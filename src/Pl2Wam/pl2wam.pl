@@ -303,6 +303,7 @@ cmd_line_args(LArg, PlFile, WamFile, LInclude) :-
 	g_assign(fast_math, f),
 	g_assign(statistics, f),
 	g_assign(compile_msg, f),
+	g_assign(pipe, f),
 	cmd_line_args(LArg, LInclude),
 	g_read(plfile, PlFile),
 	(   PlFile = '' ->
@@ -412,6 +413,9 @@ cmd_line_arg1('--statistics', LArg, LArg) :-
 cmd_line_arg1('--compile-msg', LArg, LArg) :-
 	g_assign(compile_msg, t).
 
+cmd_line_arg1('--pipe', LArg, LArg) :-
+	g_assign(pipe, t).
+
 cmd_line_arg1('--version', LArg, LArg) :-
 	display_copying,
 	stop.
@@ -504,6 +508,7 @@ h('  --fast-math                 fast mathematical mode (assume integer arithmet
 h('  --keep-void-inst            keep void instructions in the output file').
 h('  --compile-msg               print a compile message').
 h('  --statistics                print statistics information').
+h('  --pipe                      emit the code on stdout for consult/1 (internal)').
 h('  --help                      print this help and exit').
 h('  --version                   print version number and exit').
 h('').
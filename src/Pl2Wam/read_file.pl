@@ -64,6 +64,7 @@
  * buff_aux_pred(Pred,N,LSrcCl):                                           *
  *    records the clauses of an auxiliary predicate.                       *
  *    Asserted by Pass 1 (syntactic sugar removing) when splitting ;/2,etc.*
+ *    and when renaming the clauses of a tabled predicate (:- table).      *
  *    Retracted at the very next invocation of read_predicate/3 to         *
  *    ensure that aux. predicates always follow their "father" predicate.  *
  *                                                                         *
@@ -250,7 +251,8 @@ close_last_prolog_file :-
 
 read_predicate(Pred, N, LSrcCl) :-
 	repeat,
-	read_predicate1(Pred, N, LSrcCl),                % standard predicate
+	read_predicate1(Pred, N, LSrcCl1),               % standard predicate
+	tabled_predicate(Pred, N, LSrcCl1, LSrcCl),
 % !,
 	(   g_read(reading_dyn_pred, f),
 	    g_read(native_code, t) ->
@@ -261,6 +263,42 @@ read_predicate(Pred, N, LSrcCl) :-
 
 
 
+	% a tabled predicate p/n is renamed '$p/n_$aux0'/n (an aux. predicate)
+	% and p/n is defined by an interface clause (see BipsPl/tabling.pl).
+
+tabled_predicate(Pred, N, LSrcCl, LSrcCl) :-
+	\+ test_pred_flag(tabled, Pred, N), !.
+
+tabled_predicate(Pred, N, LSrcCl, LSrcCl) :-
+	(test_pred_flag(dyn, Pred, N) ; test_pred_flag(multi, Pred, N)), !,
+	unset_pred_flag(tabled, Pred, N),
+	warn('dynamic or multifile predicate ~q cannot be tabled - directive ignored', [Pred / N]).
+
+tabled_predicate(Pred, N, LSrcCl, [Where + (Head :- '$tbl_call'(Head, AuxHead))]) :-
+	LSrcCl = [Where + _|_],
+	'$make_aux_name'(Pred, N, 0, AuxPred),
+	functor(Head, Pred, N),
+	Head =.. [_|LArg],
+	AuxHead =.. [AuxPred|LArg],
+	tabled_rename_clauses(LSrcCl, AuxPred, LAuxSrcCl),
+	asserta(buff_aux_pred(AuxPred, N, LAuxSrcCl)).
+
+
+tabled_rename_clauses([], _, []).
+
+tabled_rename_clauses([Where + Cl|LSrcCl], AuxPred, [Where + Cl1|LAuxSrcCl]) :-
+	(   Cl = (Head :- Body) ->
+	    Cl1 = (Head1 :- Body)
+	;   Head = Cl,
+	    Cl1 = Head1
+	),
+	Head =.. [_|LArg],
+	Head1 =.. [AuxPred|LArg],
+	tabled_rename_clauses(LSrcCl, AuxPred, LAuxSrcCl).
+
+
+
+
 read_predicate_next(Pred, N, LSrcCl) :-
 	(test_pred_flag(dyn, Pred, N) ; test_pred_flag(multi, Pred, N)), !,
 	LSrcCl = [Where + _|_],
@@ -689,6 +727,11 @@ handle_directive(discontiguous, DLst, _) :-
 	check_pi_list(DLst, f),
 	set_flag_for_preds(DLst, discontig).
 
+handle_directive(table, DLst, _) :-
+	!,
+	check_pi_list(DLst, f),
+	set_flag_for_preds(DLst, tabled).
+
 handle_directive(compiler_mode, [CompMode], _) :-
 	!,
 	(   memberchk(CompMode, [default, embed, compile]),
@@ -1239,6 +1282,7 @@ flag_bit(need_cut_level, 6).
 flag_bit(meta, 7).
 flag_bit(multi, 8).
 flag_bit(embed, 9).
+flag_bit(tabled, 10).
 
 
 
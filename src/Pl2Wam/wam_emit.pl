@@ -70,6 +70,11 @@
  * switch_on_integer([(N,L),...])                                          *
  * switch_on_structure([(F/N,L),...])                                      *
  *                                                                         *
+ * switch_on_term_arg(A, Lvar, Latm, Lint, Llst, Lstc)  (idem on A instead *
+ * switch_on_atom_arg(A, [(F,L),...])                    of the 1st arg)   *
+ * switch_on_integer_arg(A, [(N,L),...])                                   *
+ * switch_on_structure_arg(A, [(F/N,L),...])                               *
+ *                                                                         *
  * try_me_else(L)                           try(L)                         *
  * retry_me_else(L)                         retry(L)                       *
  * trust_me_else_fail                       trust(L)                       *
@@ -99,6 +104,13 @@
  * L      : integer >= 1 (with no "holes") or 'fail' inside switch_on_term *
  *-------------------------------------------------------------------------*/
 
+emit_code_init(_, _) :-
+	g_read(pipe, t), !,
+	current_output(Stream),
+	set_stream_buffering(Stream, block),     % stdout is a pipe (line buffered)
+	g_assign(streamwamfile, Stream),
+	g_assign(cur_pl_file, '').
+
 emit_code_init(WamFile, PlFile) :-
 	emit_code_files(WamFile, PlFile, WamFile1),
 	(   WamFile1 = user ->
@@ -121,6 +133,26 @@ emit_code_init(WamFile, PlFile) :-
 
 
 
+          % With --pipe (used by consult/1) the code is written on stdout
+          % (as the messages) inside chunks delimited by \2 and \3
+          % (see consult_c.c).
+
+emit_chunk_begin(Stream) :-
+	g_read(pipe, t), !,
+	put_char(Stream, '\2\').
+
+emit_chunk_begin(_).
+
+
+emit_chunk_end(Stream) :-
+	g_read(pipe, t), !,
+	put_char(Stream, '\3\').
+
+emit_chunk_end(_).
+
+
+
+
 emit_code_files('', user, user) :-
 	!.
 
@@ -154,17 +186,22 @@ emit_code_term(Bytes, Lines) :-
 	g_read(streamwamfile, Stream),
 	character_count(Stream, Bytes),
 	line_count(Stream, Lines),
-	close(Stream).
+	(   g_read(pipe, t) ->
+	    flush_output(Stream)
+	;   close(Stream)
+	).
 
 
 
 
 emit_code(Pred, N, PlFile, PlLine, WamCode) :-
 	g_read(streamwamfile, Stream),
+	emit_chunk_begin(Stream),
 	emit_pred_start(Pred, N, PlFile, PlLine, Stream, _),
 	emit_wam_code(WamCode, _, Stream),
 	write(Stream, ']).'),
-	nl(Stream).
+	nl(Stream),
+	emit_chunk_end(Stream).
 
 
 
@@ -342,6 +379,7 @@ emit_list([X|L], PrefixTab, PrefixSpc, Stream) :-
 emit_ensure_linked :-
 	g_read(streamwamfile, Stream),
 	retract(ensure_linked(Name, Arity)), !,
+	emit_chunk_begin(Stream),
 	format(Stream, '~n~nensure_linked([~q', [Name / Arity]),
 	(   clause(ensure_linked(Name1, Arity1), _),
 	    format(Stream, ',~q', [Name1 / Arity1]),
@@ -349,7 +387,8 @@ emit_ensure_linked :-
 	;   true
 	),
 	write(Stream, ']).'),
-	nl(Stream).
+	nl(Stream),
+	emit_chunk_end(Stream).
 
 emit_ensure_linked.
 
@@ -358,6 +397,7 @@ emit_ensure_linked.
 
 bc_emit_code(Pred, N, PlFile, PlLine, LCompCl) :-
 	g_read(streamwamfile, Stream),
+	emit_chunk_begin(Stream),
 	emit_pred_start(Pred, N, PlFile, PlLine, Stream, Type),
 	(   nonvar(Type) ->
 	    LCompCl = [bc((_ :- Body), _)],
@@ -372,7 +412,8 @@ bc_emit_code(Pred, N, PlFile, PlLine, LCompCl) :-
 	    ),
 	    format(Stream, '~d).~n', [NbCl1]),
 	    bc_emit_lst_clause(LCompCl1, Stream)
-	).
+	),
+	emit_chunk_end(Stream).
 
 
 
@@ -1096,6 +1096,12 @@ Parse_Arguments(int argc, char *argv[])
 	      continue;
 	    }
 
+	  if (Check_Arg(i, "--profile"))
+	    {
+	      Add_Last_Option(cmd_wam2ma.opt);
+	      continue;
+	    }
+
 	  if (Check_Arg(i, "--pic") || Check_Arg(i, "-fPIC") || Check_Arg(i, "--dynamic")) /* TODO pass --pic to gcc as -fPIC for C code */
 	    {		
 	      Add_Last_Option(cmd_ma2asm.opt);
@@ -1529,6 +1535,7 @@ Display_Help(void)
   L(" ");
   L("WAM to mini-assembly translator options:");
   L("  --comment                   include comments in the output file");
+  L("  --profile                   count the ports of predicates for profile/1");
   L(" ");
   L("Mini-assembly to assembly translator options:");
   L("  --comment                   include comments in the output file");
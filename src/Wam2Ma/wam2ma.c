@@ -118,6 +118,8 @@
 #define FOREIGN_MODE_OUT           1
 #define FOREIGN_MODE_IN_OUT        2
 
+#define PROF_NB_CNT                6	/* cf. BipsPl/prof_supp.h */
+
 
 
 
@@ -171,6 +173,7 @@ typedef struct predinf
   struct map_entry *pl_file;
   int pl_line;
   SwtTbl *swt_tbl[3];
+  int prof_no;			/* counters in pf() or -1 if none */
   PredP next;
 }
 Pred;
@@ -197,6 +200,7 @@ Direct;
 char *file_name_in;
 char *file_name_out;
 Bool comment;
+Bool profile;
 
 FILE *file_out;
 
@@ -223,6 +227,9 @@ int cur_sub_label;
 
 int cur_direct_no = 0;
 
+int nb_prof = 0;
+int cur_prof_no = -1;
+
 char *foreign_tbl[FOREIGN_TBL_SIZE];
 
 
@@ -234,6 +241,14 @@ char *foreign_tbl[FOREIGN_TBL_SIZE];
 
 SwtTbl *Create_Switch_Table(int type, int nb_elem);
 
+void Switch_On_Term(ArgVal arg[], Bool with_reg);
+
+void Switch_On_Atom(ArgVal arg[], Bool with_reg);
+
+void Switch_On_Integer(ArgVal arg[], Bool with_reg);
+
+void Switch_On_Structure(ArgVal arg[], Bool with_reg);
+
 void Init_Foreign_Table(void);
 
 
@@ -386,10 +401,10 @@ void Display_Help(void);
 
 
 #define CREATE_CHOICE_INST(l)                                               \
-  if (cur_arity >= 1 && cur_arity <= 4)                                     \
+  if (cur_arity <= 4)                                                       \
     Inst_Printf("call_c", FAST "Pl_Create_Choice_Point%d(&%s)", cur_arity, l); \
   else                                                                      \
-    Inst_Printf("call_c", FAST "Pl_Create_Choice_Point(&%s,%d)", l, cur_arity)
+    Inst_Printf("call_c", FAST "Pl_Create_Choice_PointN(&%s,%d)", l, cur_arity)
 
 
 #define UPDATE_CHOICE_INST(l)                                               \
@@ -406,6 +421,11 @@ void Display_Help(void);
     Inst_Printf("call_c", FAST "Pl_Delete_Choice_Point(%d)", cur_arity)
 
 
+#define PROF_INST(hook)                                                     \
+  if (cur_prof_no >= 0)                                                     \
+    Inst_Printf("call_c", FAST "Pl_Prof_" hook "(&pf(%d))", cur_prof_no * PROF_NB_CNT)
+
+
 
 
 /*-------------------------------------------------------------------------*
@@ -578,6 +598,7 @@ F_predicate(ArgVal arg[])
   cur_pred->swt_tbl[0] = NULL;
   cur_pred->swt_tbl[1] = NULL;
   cur_pred->swt_tbl[2] = NULL;
+  cur_pred->prof_no = (profile && (prop & MASK_PRED_NATIVE_CODE)) ? nb_prof++ : -1;
   cur_pred->next = NULL;
 
   pred_end->next = cur_pred;
@@ -599,6 +620,9 @@ F_predicate(ArgVal arg[])
   cur_pred->hexa = strdup(buff_hexa);
 
   Label_Printf("\n\npl_code %s %s", (local_symbol) ? "local" : "global", buff_hexa + 1);
+
+  cur_prof_no = cur_pred->prof_no;
+  PROF_INST("Call");
 }
 
 
@@ -643,6 +667,9 @@ F_directive(ArgVal arg[])
   direct_end->next = p;
   direct_end = p;
 
+  cur_arity = 0;
+  cur_prof_no = -1;
+
   if (comment)
     Label_Printf("\n\n; *** %s Directive (%s:%d)", (system) ? "System" : "User", cur_pl_file->key, pl_line);
 
@@ -1174,7 +1201,7 @@ void
 F_allocate(ArgVal arg[])
 {
   Args1(C_INT(n));
-  Inst_Printf("call_c", FAST "Pl_Allocate(%d)", n);
+  Inst_Printf("call_c", FAST "Pl_Allocate(%d,%d)", n, cur_arity); /* nb live X (GC) */
 }
 
 
@@ -1273,6 +1300,33 @@ F_label(ArgVal arg[])
  *-------------------------------------------------------------------------*/
 void
 F_switch_on_term(ArgVal arg[])
+{
+  Switch_On_Term(arg, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * F_SWITCH_ON_TERM_ARG                                                    *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+F_switch_on_term_arg(ArgVal arg[])
+{
+  Switch_On_Term(arg, TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SWITCH_ON_TERM                                                          *
+ *                                                                         *
+ * with_reg: is the register given (1st arg) or is it A(0) ?               *
+ *-------------------------------------------------------------------------*/
+void
+Switch_On_Term(ArgVal arg[], Bool with_reg)
 {
 #define NB_SWT_LIST 5
 
@@ -1283,10 +1337,15 @@ F_switch_on_term(ArgVal arg[])
 #define LSTC 16
 
   Args0;
+  DEF_C_INT(a);
   DEF_C_INT(val_label);
   static char l[NB_SWT_LIST][MAX_LABEL_LENGTH];
   int mask = 0, i;
 
+  a = 0;
+  if (with_reg)
+    LOAD_C_INT(a);
+
   for (i = 0; i < NB_SWT_LIST; i++)
     {
       LOAD_C_INT(val_label);
@@ -1300,6 +1359,9 @@ F_switch_on_term(ArgVal arg[])
 	}
     }
 
+  if (a != 0)
+    mask = -1;			/* no specialized function */
+
   switch(mask)			/* some specialized functions */
     {
     case LVAR | LATM:
@@ -1318,6 +1380,11 @@ F_switch_on_term(ArgVal arg[])
       Inst_Printf("call_c", FAST "Pl_Switch_On_Term_Var_Atm_Stc(%s,%s,%s)", l[0], l[1], l[4]);
       break;
 
+    case -1:
+      Inst_Printf("call_c", FAST "Pl_Switch_On_Term_Arg(%d,%s,%s,%s,%s,%s)", a,
+		  l[0], l[1], l[2], l[3], l[4]);
+      break;
+
     default:
       Inst_Printf("call_c", FAST "Pl_Switch_On_Term(%s,%s,%s,%s,%s)", l[0], l[1], l[2], l[3], l[4]);
       break;
@@ -1364,14 +1431,47 @@ Create_Switch_Table(int type, int nb_elem)
  *-------------------------------------------------------------------------*/
 void
 F_switch_on_atom(ArgVal arg[])
+{
+  Switch_On_Atom(arg, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * F_SWITCH_ON_ATOM_ARG                                                    *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+F_switch_on_atom_arg(ArgVal arg[])
+{
+  Switch_On_Atom(arg, TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SWITCH_ON_ATOM                                                          *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Switch_On_Atom(ArgVal arg[], Bool with_reg)
 {
   SwtTbl *t;
   SwtElt *elem;
 
+  Args0;
+  DEF_C_INT(a);
   DEF_STR(str);
   DEF_C_INT(label);
-  Args1(C_INT(nb_elem));
+  DEF_C_INT(nb_elem);
 
+  a = 0;
+  if (with_reg)
+    LOAD_C_INT(a);
+
+  LOAD_C_INT(nb_elem);
 
   t = Create_Switch_Table(TBL_ATM, (int) nb_elem);
 
@@ -1383,7 +1483,11 @@ F_switch_on_atom(ArgVal arg[])
       elem->label = label;
     }
 
-  Inst_Printf("call_c", FAST "Pl_Switch_On_Atom(st(%d),%d)", nb_swt_tbl - 1, t->nb_elem);
+  if (a != 0)
+    Inst_Printf("call_c", FAST "Pl_Switch_On_Atom_Arg(%d,st(%d),%d)", a, nb_swt_tbl - 1,
+		t->nb_elem);
+  else
+    Inst_Printf("call_c", FAST "Pl_Switch_On_Atom(st(%d),%d)", nb_swt_tbl - 1, t->nb_elem);
   Inst_Printf("jump_ret", "");
 }
 
@@ -1396,14 +1500,48 @@ F_switch_on_atom(ArgVal arg[])
  *-------------------------------------------------------------------------*/
 void
 F_switch_on_integer(ArgVal arg[])
+{
+  Switch_On_Integer(arg, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * F_SWITCH_ON_INTEGER_ARG                                                 *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+F_switch_on_integer_arg(ArgVal arg[])
+{
+  Switch_On_Integer(arg, TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SWITCH_ON_INTEGER                                                       *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Switch_On_Integer(ArgVal arg[], Bool with_reg)
 {
 #ifndef SWT_INT_DICHOTOMY	/* basic switch_on_integer */
   SwtTbl *t;
   SwtElt *elem;
 
+  Args0;
+  DEF_C_INT(a);
   DEF_INTEGER(n);
   DEF_C_INT(label);
-  Args1(C_INT(nb_elem));
+  DEF_C_INT(nb_elem);
+
+  a = 0;
+  if (with_reg)
+    LOAD_C_INT(a);
+
+  LOAD_C_INT(nb_elem);
 
   t = Create_Switch_Table(TBL_INT, nb_elem);
 
@@ -1415,7 +1553,11 @@ F_switch_on_integer(ArgVal arg[])
       elem->label = label;
     }
 
-  Inst_Printf("call_c", FAST "Pl_Switch_On_Integer(st(%d),%d)", nb_swt_tbl - 1, t->nb_elem);
+  if (a != 0)
+    Inst_Printf("call_c", FAST "Pl_Switch_On_Integer_Arg(%d,st(%d),%d)", a, nb_swt_tbl - 1,
+		t->nb_elem);
+  else
+    Inst_Printf("call_c", FAST "Pl_Switch_On_Integer(st(%d),%d)", nb_swt_tbl - 1, t->nb_elem);
   Inst_Printf("jump_ret", "");
 
 #else
@@ -1423,11 +1565,22 @@ F_switch_on_integer(ArgVal arg[])
   char c;
   int i;
 
+  Args0;
+  DEF_C_INT(a);
   DEF_INTEGER(n);
   DEF_LABEL(l);
-  Args1(C_INT(nb_elem));
+  DEF_C_INT(nb_elem);
 
-  Inst_Printf("call_c", FAST "Pl_Switch_On_Integer_For_Dichotomy()");
+  a = 0;
+  if (with_reg)
+    LOAD_C_INT(a);
+
+  LOAD_C_INT(nb_elem);
+
+  if (a != 0)
+    Inst_Printf("call_c", FAST "Pl_Switch_On_Integer_Arg_For_Dichotomy(%d)", a);
+  else
+    Inst_Printf("call_c", FAST "Pl_Switch_On_Integer_For_Dichotomy()");
   Inst_Printf("switch_ret", NULL);	/* NULL to avoid newline */
   c = '(';
   for(i = 0; i < nb_elem; i++)
@@ -1455,15 +1608,48 @@ F_switch_on_integer(ArgVal arg[])
  *-------------------------------------------------------------------------*/
 void
 F_switch_on_structure(ArgVal arg[])
+{
+  Switch_On_Structure(arg, FALSE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * F_SWITCH_ON_STRUCTURE_ARG                                               *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+F_switch_on_structure_arg(ArgVal arg[])
+{
+  Switch_On_Structure(arg, TRUE);
+}
+
+
+
+
+/*-------------------------------------------------------------------------*
+ * SWITCH_ON_STRUCTURE                                                     *
+ *                                                                         *
+ *-------------------------------------------------------------------------*/
+void
+Switch_On_Structure(ArgVal arg[], Bool with_reg)
 {
   SwtTbl *t;
   SwtElt *elem;
 
+  Args0;
+  DEF_C_INT(a);
   DEF_STR(str);
   DEF_C_INT(arity);
   DEF_C_INT(label);
-  Args1(C_INT(nb_elem));
+  DEF_C_INT(nb_elem);
 
+  a = 0;
+  if (with_reg)
+    LOAD_C_INT(a);
+
+  LOAD_C_INT(nb_elem);
 
   t = Create_Switch_Table(TBL_STC, (int) nb_elem);
 
@@ -1477,7 +1663,11 @@ F_switch_on_structure(ArgVal arg[])
       elem->label = label;
     }
 
-  Inst_Printf("call_c", FAST "Pl_Switch_On_Structure(st(%d),%d)", nb_swt_tbl - 1, t->nb_elem);
+  if (a != 0)
+    Inst_Printf("call_c", FAST "Pl_Switch_On_Structure_Arg(%d,st(%d),%d)", a, nb_swt_tbl - 1,
+		t->nb_elem);
+  else
+    Inst_Printf("call_c", FAST "Pl_Switch_On_Structure(st(%d),%d)", nb_swt_tbl - 1, t->nb_elem);
   Inst_Printf("jump_ret", "");
 }
 
@@ -1493,6 +1683,7 @@ F_try_me_else(ArgVal arg[])
 {
   Args1(LABEL(l));
   CREATE_CHOICE_INST(l);
+  PROF_INST("Choice");
 }
 
 
@@ -1539,6 +1730,7 @@ F_try(ArgVal arg[])
   sprintf(sl, FORMAT_SUB_LABEL(cur_sub_label++));
 
   CREATE_CHOICE_INST(sl);
+  PROF_INST("Choice");
   Inst_Printf("jump", "%s", l);
   Label_Printf("%s:", sl);
 }
@@ -2046,6 +2238,9 @@ Emit_Obj_Initializer(void)
   if (nb_swt_tbl)
     Label_Printf("long local st(%d)", nb_swt_tbl);
 
+  if (nb_prof)
+    Label_Printf("long local pf(%d)", nb_prof * PROF_NB_CNT);
+
   Label_Printf("\n");
 
   Label_Printf("c_code  initializer Object_Initializer\n");
@@ -2093,6 +2288,10 @@ Emit_Obj_Initializer(void)
 		  p->prop, q);
 #endif
 
+      if (p->prof_no >= 0)
+	Inst_Printf("call_c", FAST "Pl_Prof_Register(at(%d),%d,&pf(%d))",
+		    p->functor->value, p->arity, p->prof_no * PROF_NB_CNT);
+
       cur_pred_no++;		/* for FORMAT_LABEL */
 
       for (i = 0; i < 3; i++)
@@ -2338,6 +2537,7 @@ Parse_Arguments(int argc, char *argv[])
 
   file_name_in = file_name_out = NULL;
   comment = FALSE;
+  profile = FALSE;
 
   for (i = 1; i < argc; i++)
     {
@@ -2361,6 +2561,12 @@ Parse_Arguments(int argc, char *argv[])
 	      continue;
 	    }
 
+	  if (Check_Arg(i, "--profile"))
+	    {
+	      profile = TRUE;
+	      continue;
+	    }
+
 	  if (Check_Arg(i, "--version"))
 	    {
 	      Display_Copying("WAM to Mini-Assembly Compiler");
@@ -2420,6 +2626,7 @@ Display_Help(void)
   L("Options:");
   L("  -o FILE, --output FILE      set output file name");
   L("  --comment                   include comments in the output file");
+  L("  --profile                   count the ports of predicates for profile/1");
   L("  -h, --help                  print this help and exit");
   L("  --version                   print version number and exit");
   L("");
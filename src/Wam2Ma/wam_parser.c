@@ -143,6 +143,10 @@ ParseInf inst[] = {
   {"switch_on_atom", F_switch_on_atom, 1, {L2(ATOM, C_INT)}},
   {"switch_on_integer", F_switch_on_integer, 1, {L2(INTEGER, C_INT)}},
   {"switch_on_structure", F_switch_on_structure, 1, {L2(F_N, C_INT)}},
+  {"switch_on_term_arg", F_switch_on_term_arg, 6, {C_INT, LABEL, LABEL, LABEL, LABEL, LABEL}},
+  {"switch_on_atom_arg", F_switch_on_atom_arg, 2, {C_INT, L2(ATOM, C_INT)}},
+  {"switch_on_integer_arg", F_switch_on_integer_arg, 2, {C_INT, L2(INTEGER, C_INT)}},
+  {"switch_on_structure_arg", F_switch_on_structure_arg, 2, {C_INT, L2(F_N, C_INT)}},
 
   {"try_me_else", F_try_me_else, 1, {C_INT}},
   {"retry_me_else", F_retry_me_else, 1, {C_INT}},
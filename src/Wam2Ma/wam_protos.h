@@ -153,6 +153,14 @@ void F_switch_on_integer(ArgVal arg[]);
 
 void F_switch_on_structure(ArgVal arg[]);
 
+void F_switch_on_term_arg(ArgVal arg[]);
+
+void F_switch_on_atom_arg(ArgVal arg[]);
+
+void F_switch_on_integer_arg(ArgVal arg[]);
+
+void F_switch_on_structure_arg(ArgVal arg[]);
+
 void F_try_me_else(ArgVal arg[]);
 
 void F_retry_me_else(ArgVal arg[]);